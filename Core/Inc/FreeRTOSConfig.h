@@ -165,6 +165,17 @@ standard names. */
 
 /* USER CODE BEGIN Defines */
 /* Section where parameter definitions can be added (for instance, to override default ones in FreeRTOS.h) */
+/* 运行时统计：以 DWT 周期计数器作为任务运行时间计数源，实现见 runtime_monitor.cpp */
+#define configGENERATE_RUN_TIME_STATS            1
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+  void configureTimerForRunTimeStats(void);
+  unsigned long getRunTimeCounterValue(void);
+  void trace_task_switched_in(void* task);
+#endif
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() configureTimerForRunTimeStats()
+#define portGET_RUN_TIME_COUNTER_VALUE()         getRunTimeCounterValue()
+/* 事件追踪：任务切入时记录到追踪环形缓冲区，实现见 trace.cpp */
+#define traceTASK_SWITCHED_IN()                  trace_task_switched_in((void*)pxCurrentTCB)
 /* USER CODE END Defines */
 
 #endif /* FREERTOS_CONFIG_H */
@@ -254,6 +254,39 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
   APP_UART_RxCpltCallback(huart);
 }
 
+//SPI传输完成回调函数
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+  APP_SPI_TxRxCpltCallback(hspi);
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+  APP_SPI_ErrorCallback(hspi);
+}
+
+//串口发送完成回调函数
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  APP_UART_TxCpltCallback(huart);
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+  APP_UART_ErrorCallback(huart);
+}
+
+//FDCAN接收FIFO回调函数
+void HAL_FDCAN_RxFifo0Callback(FDCAN_HandleTypeDef *hfdcan, uint32_t RxFifo0ITs)
+{
+  APP_FDCAN_RxFifoCallback(hfdcan, FDCAN_RX_FIFO0);
+}
+
+void HAL_FDCAN_RxFifo1Callback(FDCAN_HandleTypeDef *hfdcan, uint32_t RxFifo1ITs)
+{
+  APP_FDCAN_RxFifoCallback(hfdcan, FDCAN_RX_FIFO1);
+}
+
 /* USER CODE END 4 */
 
  /* MPU Configuration */
@@ -23,6 +23,7 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "test.h"
+#include "runtime_monitor.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -66,7 +67,15 @@ extern UART_HandleTypeDef huart1;
 extern TIM_HandleTypeDef htim7;
 
 /* USER CODE BEGIN EV */
-
+extern DMA_HandleTypeDef hdma_spi4_rx;
+extern DMA_HandleTypeDef hdma_spi4_tx;
+extern SPI_HandleTypeDef hspi4;
+extern DMA_HandleTypeDef hdma_usart3_rx;
+extern DMA_HandleTypeDef hdma_usart3_tx;
+extern UART_HandleTypeDef huart3;
+extern FDCAN_HandleTypeDef hfdcan1;
+extern FDCAN_HandleTypeDef hfdcan2;
+extern DMA_HandleTypeDef hdma_tim1_up;
 /* USER CODE END EV */
 
 /******************************************************************************/
@@ -173,11 +182,11 @@ void DebugMon_Handler(void)
 void DMA1_Stream0_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA1_Stream0_IRQn 0 */
-
+  RUNTIME_ISR_ENTER();
   /* USER CODE END DMA1_Stream0_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_tim4_ch1);
   /* USER CODE BEGIN DMA1_Stream0_IRQn 1 */
-
+  RUNTIME_ISR_EXIT();
   /* USER CODE END DMA1_Stream0_IRQn 1 */
 }
 
@@ -187,11 +196,11 @@ void DMA1_Stream0_IRQHandler(void)
 void DMA1_Stream1_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA1_Stream1_IRQn 0 */
-
+  RUNTIME_ISR_ENTER();
   /* USER CODE END DMA1_Stream1_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_uart4_rx);
   /* USER CODE BEGIN DMA1_Stream1_IRQn 1 */
-
+  RUNTIME_ISR_EXIT();
   /* USER CODE END DMA1_Stream1_IRQn 1 */
 }
 
@@ -201,11 +210,11 @@ void DMA1_Stream1_IRQHandler(void)
 void DMA1_Stream2_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA1_Stream2_IRQn 0 */
-
+  RUNTIME_ISR_ENTER();
   /* USER CODE END DMA1_Stream2_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_usart1_rx);
   /* USER CODE BEGIN DMA1_Stream2_IRQn 1 */
-
+  RUNTIME_ISR_EXIT();
   /* USER CODE END DMA1_Stream2_IRQn 1 */
 }
 
@@ -215,11 +224,11 @@ void DMA1_Stream2_IRQHandler(void)
 void USART1_IRQHandler(void)
 {
   /* USER CODE BEGIN USART1_IRQn 0 */
-
+  RUNTIME_ISR_ENTER();
   /* USER CODE END USART1_IRQn 0 */
   HAL_UART_IRQHandler(&huart1);
   /* USER CODE BEGIN USART1_IRQn 1 */
-
+  RUNTIME_ISR_EXIT();
   /* USER CODE END USART1_IRQn 1 */
 }
 
@@ -229,11 +238,11 @@ void USART1_IRQHandler(void)
 void EXTI15_10_IRQHandler(void)
 {
   /* USER CODE BEGIN EXTI15_10_IRQn 0 */
-
+  RUNTIME_ISR_ENTER();
   /* USER CODE END EXTI15_10_IRQn 0 */
   HAL_GPIO_EXTI_IRQHandler(PC13_NRF_IRQ_Pin);
   /* USER CODE BEGIN EXTI15_10_IRQn 1 */
-
+  RUNTIME_ISR_EXIT();
   /* USER CODE END EXTI15_10_IRQn 1 */
 }
 
@@ -243,11 +252,11 @@ void EXTI15_10_IRQHandler(void)
 void UART4_IRQHandler(void)
 {
   /* USER CODE BEGIN UART4_IRQn 0 */
-
+  RUNTIME_ISR_ENTER();
   /* USER CODE END UART4_IRQn 0 */
   HAL_UART_IRQHandler(&huart4);
   /* USER CODE BEGIN UART4_IRQn 1 */
-
+  RUNTIME_ISR_EXIT();
   /* USER CODE END UART4_IRQn 1 */
 }
 
@@ -257,11 +266,11 @@ void UART4_IRQHandler(void)
 void TIM6_DAC_IRQHandler(void)
 {
   /* USER CODE BEGIN TIM6_DAC_IRQn 0 */
-
+  RUNTIME_ISR_ENTER();
   /* USER CODE END TIM6_DAC_IRQn 0 */
   HAL_TIM_IRQHandler(&htim6);
   /* USER CODE BEGIN TIM6_DAC_IRQn 1 */
-
+  RUNTIME_ISR_EXIT();
   /* USER CODE END TIM6_DAC_IRQn 1 */
 }
 
@@ -271,11 +280,11 @@ void TIM6_DAC_IRQHandler(void)
 void TIM7_IRQHandler(void)
 {
   /* USER CODE BEGIN TIM7_IRQn 0 */
-
+  RUNTIME_ISR_ENTER();
   /* USER CODE END TIM7_IRQn 0 */
   HAL_TIM_IRQHandler(&htim7);
   /* USER CODE BEGIN TIM7_IRQn 1 */
-
+  RUNTIME_ISR_EXIT();
   /* USER CODE END TIM7_IRQn 1 */
 }
 
@@ -285,14 +294,104 @@ void TIM7_IRQHandler(void)
 void UART8_IRQHandler(void)
 {
   /* USER CODE BEGIN UART8_IRQn 0 */
-
+  RUNTIME_ISR_ENTER();
   /* USER CODE END UART8_IRQn 0 */
   HAL_UART_IRQHandler(&huart8);
   /* USER CODE BEGIN UART8_IRQn 1 */
-
+  RUNTIME_ISR_EXIT();
   /* USER CODE END UART8_IRQn 1 */
 }
 
 /* USER CODE BEGIN 1 */
 
+/**
+  * @brief This function handles DMA1 stream3 global interrupt (SPI4 RX).
+  */
+void DMA1_Stream3_IRQHandler(void)
+{
+  RUNTIME_ISR_ENTER();
+  HAL_DMA_IRQHandler(&hdma_spi4_rx);
+  RUNTIME_ISR_EXIT();
+}
+
+/**
+  * @brief This function handles DMA1 stream4 global interrupt (SPI4 TX).
+  */
+void DMA1_Stream4_IRQHandler(void)
+{
+  RUNTIME_ISR_ENTER();
+  HAL_DMA_IRQHandler(&hdma_spi4_tx);
+  RUNTIME_ISR_EXIT();
+}
+
+/**
+  * @brief This function handles SPI4 global interrupt.
+  */
+void SPI4_IRQHandler(void)
+{
+  RUNTIME_ISR_ENTER();
+  HAL_SPI_IRQHandler(&hspi4);
+  RUNTIME_ISR_EXIT();
+}
+
+/**
+  * @brief This function handles DMA1 stream5 global interrupt (USART3 RX).
+  */
+void DMA1_Stream5_IRQHandler(void)
+{
+  RUNTIME_ISR_ENTER();
+  HAL_DMA_IRQHandler(&hdma_usart3_rx);
+  RUNTIME_ISR_EXIT();
+}
+
+/**
+  * @brief This function handles DMA1 stream6 global interrupt (USART3 TX).
+  */
+void DMA1_Stream6_IRQHandler(void)
+{
+  RUNTIME_ISR_ENTER();
+  HAL_DMA_IRQHandler(&hdma_usart3_tx);
+  RUNTIME_ISR_EXIT();
+}
+
+/**
+  * @brief This function handles DMA1 stream7 global interrupt (TIM1_UP, DShot).
+  */
+void DMA1_Stream7_IRQHandler(void)
+{
+  RUNTIME_ISR_ENTER();
+  HAL_DMA_IRQHandler(&hdma_tim1_up);
+  RUNTIME_ISR_EXIT();
+}
+
+/**
+  * @brief This function handles USART3 global interrupt.
+  */
+void USART3_IRQHandler(void)
+{
+  RUNTIME_ISR_ENTER();
+  HAL_UART_IRQHandler(&huart3);
+  RUNTIME_ISR_EXIT();
+}
+
+/**
+  * @brief This function handles FDCAN1 interrupt 0.
+  */
+void FDCAN1_IT0_IRQHandler(void)
+{
+  RUNTIME_ISR_ENTER();
+  HAL_FDCAN_IRQHandler(&hfdcan1);
+  RUNTIME_ISR_EXIT();
+}
+
+/**
+  * @brief This function handles FDCAN2 interrupt 0.
+  */
+void FDCAN2_IT0_IRQHandler(void)
+{
+  RUNTIME_ISR_ENTER();
+  HAL_FDCAN_IRQHandler(&hfdcan2);
+  RUNTIME_ISR_EXIT();
+}
+
 /* USER CODE END 1 */
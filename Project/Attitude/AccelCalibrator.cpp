@@ -0,0 +1,272 @@
+/**
+ * @file AccelCalibrator.cpp
+ * @brief 在线加速度计椭球拟合校准实现
+ */
+
+#include "AccelCalibrator.h"
+#include "math_utils.h"
+#include <math.h>
+
+static const float PRIOR_VARIANCE = 10.0f; // 参数先验方差，先验约相当于十分之一个拟合点的权重
+
+/**
+ * @brief 构造函数
+ */
+AccelCalibrator::AccelCalibrator(const AccelCalibratorConfig_t &config)
+    : _config(config),
+      _calibrated(false)
+{
+    for (int i = 0; i < 3; i++) {
+        _scale[i] = 1.0f;
+        _bias[i] = 0.0f;
+    }
+    restart();
+}
+
+/**
+ * @brief 丢弃未结束的窗口
+ */
+void AccelCalibrator::resetWindow()
+{
+    for (int i = 0; i < 3; i++) {
+        _accelSum[i] = 0.0f;
+        _accelSqSum[i] = 0.0f;
+        _gyroSum[i] = 0.0f;
+    }
+    _accelCount = 0;
+    _gyroCount = 0;
+    _windowTime = 0.0f;
+}
+
+/**
+ * @brief 以当前输出结果为先验重新拟合
+ */
+void AccelCalibrator::restart()
+{
+    resetWindow();
+
+    // 当前结果对应的椭球 sum(s^2 * (u - c)^2) = 1 展开，系数缩放到二次项之和为 3 后换算为参数先验
+    float quad[3];
+    float sum = 0.0f;
+    float constant = 1.0f;
+    for (int i = 0; i < 3; i++) {
+        float c = _bias[i] / GRAVITY_CONST;
+        quad[i] = _scale[i] * _scale[i];
+        sum += quad[i];
+        constant -= quad[i] * c * c;
+    }
+    const float k = 3.0f / sum;
+    _theta[0] = (quad[2] - quad[0]) * k / 3.0f;
+    _theta[1] = (quad[1] - quad[0]) * k / 3.0f;
+    for (int i = 0; i < 3; i++) {
+        _theta[2 + i] = 2.0f * quad[i] * (_bias[i] / GRAVITY_CONST) * k;
+    }
+    _theta[5] = constant * k;
+
+    for (int i = 0; i < PARAMS; i++) {
+        for (int j = 0; j < PARAMS; j++) {
+            _P[i][j] = (i == j) ? PRIOR_VARIANCE : 0.0f;
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        _lastPoint[i] = 0.0f;
+    }
+    _points = 0;
+}
+
+/**
+ * @brief 以保存的结果作为初值与拟合先验
+ */
+void AccelCalibrator::seed(const float scale[3], const float bias[3])
+{
+    for (int i = 0; i < 3; i++) {
+        _scale[i] = scale[i];
+        _bias[i] = bias[i];
+    }
+    _calibrated = true;
+    restart();
+}
+
+/**
+ * @brief 获取最近一次输出的校准结果
+ */
+void AccelCalibrator::getCalibration(float scale[3], float bias[3]) const
+{
+    for (int i = 0; i < 3; i++) {
+        scale[i] = _scale[i];
+        bias[i] = _bias[i];
+    }
+}
+
+/**
+ * @brief 协方差对角元的最大值
+ */
+float AccelCalibrator::getMaxVariance() const
+{
+    float maxVar = 0.0f;
+    for (int i = 0; i < PARAMS; i++) {
+        if (_P[i][i] > maxVar) {
+            maxVar = _P[i][i];
+        }
+    }
+    return maxVar;
+}
+
+/**
+ * @brief 输入一批原始IMU样本
+ */
+bool AccelCalibrator::push(const ImuSample *samples, size_t count)
+{
+    bool updated = false;
+    for (size_t n = 0; n < count; n++) {
+        for (int i = 0; i < 3; i++) {
+            _gyroSum[i] += samples[n].gyro[i];
+        }
+        _gyroCount++;
+        if (samples[n].accelValid) {
+            for (int i = 0; i < 3; i++) {
+                _accelSum[i] += samples[n].accel[i];
+                _accelSqSum[i] += samples[n].accel[i] * samples[n].accel[i];
+            }
+            _accelCount++;
+        }
+        _windowTime += (samples[n].dt > 0.0f) ? samples[n].dt : _config.defaultDt;
+
+        if (_windowTime >= _config.window) {
+            updated |= closeWindow();
+            resetWindow();
+        }
+    }
+    return updated;
+}
+
+/**
+ * @brief 窗口结束时判定准静止并更新拟合
+ */
+bool AccelCalibrator::closeWindow()
+{
+    if (_accelCount < 2 || _gyroCount == 0) {
+        return false;
+    }
+
+    const float invA = 1.0f / (float)_accelCount;
+    const float invG = 1.0f / (float)_gyroCount;
+    const float accelVarMax = _config.accelStdMax * _config.accelStdMax;
+    float mean[3];
+    for (int i = 0; i < 3; i++) {
+        mean[i] = _accelSum[i] * invA;
+        float var = _accelSqSum[i] * invA - mean[i] * mean[i];
+        float gyro = _gyroSum[i] * invG;
+        if (var > accelVarMax || gyro > _config.gyroMax || gyro < -_config.gyroMax) {
+            return false; // 转动或振动，不是椭球面上的点
+        }
+    }
+
+    // 比力模长应接近重力加速度，排除匀加速与自由落体；容差需覆盖待估计的比例与零偏误差
+    float norm = math_sqrtf(mean[0] * mean[0] + mean[1] * mean[1] + mean[2] * mean[2]);
+    float ratio = norm / GRAVITY_CONST;
+    if (ratio > 1.0f + _config.accelNormTol || ratio < 1.0f - _config.accelNormTol) {
+        return false;
+    }
+
+    // 与上一拟合点方向过近时不加入
+    float dir[3] = {mean[0] / norm, mean[1] / norm, mean[2] / norm};
+    if (_points > 0) {
+        float dot = dir[0] * _lastPoint[0] + dir[1] * _lastPoint[1] + dir[2] * _lastPoint[2];
+        if (dot > cosf(_config.minAngle)) {
+            return false;
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        _lastPoint[i] = dir[i];
+    }
+
+    float u[3] = {mean[0] / GRAVITY_CONST, mean[1] / GRAVITY_CONST, mean[2] / GRAVITY_CONST};
+    addPoint(u);
+
+    if (_points < _config.minPoints || getMaxVariance() > _config.varianceMax) {
+        return false;
+    }
+    float scale[3], bias[3];
+    if (!solve(scale, bias)) {
+        return false;
+    }
+    for (int i = 0; i < 3; i++) {
+        _scale[i] = scale[i];
+        _bias[i] = bias[i];
+    }
+    _calibrated = true;
+    return true;
+}
+
+/**
+ * @brief 加入一个拟合点 (递推最小二乘)
+ */
+void AccelCalibrator::addPoint(const float u[3])
+{
+    const float xx = u[0] * u[0], yy = u[1] * u[1], zz = u[2] * u[2];
+    const float phi[PARAMS] = {xx + yy - 2.0f * zz, xx - 2.0f * yy + zz, u[0], u[1], u[2], 1.0f};
+
+    // Pphi = P * phi，P 对称，phi^T * P = Pphi^T
+    float Pphi[PARAMS];
+    float denom = 1.0f;
+    float residual = xx + yy + zz;
+    for (int i = 0; i < PARAMS; i++) {
+        float sum = 0.0f;
+        for (int j = 0; j < PARAMS; j++) {
+            sum += _P[i][j] * phi[j];
+        }
+        Pphi[i] = sum;
+        denom += phi[i] * sum;
+        residual -= phi[i] * _theta[i];
+    }
+
+    const float invDenom = 1.0f / denom;
+    for (int i = 0; i < PARAMS; i++) {
+        _theta[i] += Pphi[i] * invDenom * residual;
+    }
+    // P -= Pphi * Pphi^T / denom，只算上三角再镜像，保持对称
+    for (int i = 0; i < PARAMS; i++) {
+        float ki = Pphi[i] * invDenom;
+        for (int j = i; j < PARAMS; j++) {
+            _P[i][j] -= ki * Pphi[j];
+            _P[j][i] = _P[i][j];
+        }
+    }
+    _points++;
+}
+
+/**
+ * @brief 由拟合参数求比例因子与零偏
+ */
+bool AccelCalibrator::solve(float scale[3], float bias[3]) const
+{
+    // 还原椭球 A*x^2 + B*y^2 + C*z^2 - p3*x - p4*y - p5*z = p5'，再配方求中心
+    const float quad[3] = {
+        1.0f - _theta[0] - _theta[1],
+        1.0f - _theta[0] + 2.0f * _theta[1],
+        1.0f + 2.0f * _theta[0] - _theta[1],
+    };
+    float center[3];
+    float g = _theta[5];
+    for (int i = 0; i < 3; i++) {
+        if (quad[i] <= 0.0f) {
+            return false; // 不是椭球
+        }
+        center[i] = _theta[2 + i] / (2.0f * quad[i]);
+        g += quad[i] * center[i] * center[i];
+    }
+    if (g <= 0.0f) {
+        return false;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        scale[i] = math_sqrtf(quad[i] / g);
+        bias[i] = center[i] * GRAVITY_CONST;
+        if (scale[i] > 1.0f + _config.scaleMax || scale[i] < 1.0f - _config.scaleMax ||
+            bias[i] > _config.biasMax || bias[i] < -_config.biasMax) {
+            return false;
+        }
+    }
+    return true;
+}
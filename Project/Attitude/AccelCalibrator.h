@@ -0,0 +1,134 @@
+/**
+ * @file AccelCalibrator.h
+ * @brief 在线加速度计椭球拟合校准
+ * @details 在姿态解算循环中逐批接收原始IMU样本，取各准静止窗口的加速度均值作为椭球面上的点，
+ *          以递推最小二乘拟合轴对齐椭球，得到三轴比例因子与零偏，无需单独的六面校准
+ */
+
+#ifndef ACCEL_CALIBRATOR_H
+#define ACCEL_CALIBRATOR_H
+
+#include "Attitude.h"
+
+/**
+ * @brief 在线加速度计校准配置
+ */
+typedef struct {
+    float window;           // 准静止判定窗口时长，单位：s
+    float defaultDt;        // 样本未携带时间间隔时使用的默认间隔，单位：s
+    float gyroMax;          // 窗口内陀螺仪各轴均值绝对值上限，单位：rad/s
+    float accelStdMax;      // 窗口内加速度计各轴标准差上限，单位：m/s^2
+    float accelNormTol;     // 窗口加速度均值模长与重力加速度之比偏离 1 的上限
+    float minAngle;         // 相邻两个拟合点方向的最小夹角，单位：rad
+    uint32_t minPoints;     // 输出结果前至少需要的拟合点数
+    float varianceMax;      // 输出结果时各参数协方差对角元的上限 (以 g 为单位归一化)
+    float scaleMax;         // 比例因子偏离 1 的上限，超出视为拟合失败
+    float biasMax;          // 零偏各轴绝对值上限，单位：m/s^2
+} AccelCalibratorConfig_t;
+
+/**
+ * @brief 在线加速度计椭球拟合校准器
+ * @details 校准模型为 a = scale * (raw - bias)，按轴独立，不含交叉项：
+ *          完整椭球的对称平方根会引入加速度计相对陀螺仪的旋转，直接变成倾角误差，故只拟合轴对齐椭球。
+ *          以 g 归一化后把轴对齐椭球写成对 6 个参数线性的形式
+ *          x^2 + y^2 + z^2 = a*(x^2 + y^2 - 2z^2) + b*(x^2 - 2y^2 + z^2) + c*x + d*y + e*z + f，
+ *          回归量与常数项近似正交 (直接以 1 为观测值时三个二次项之和与常数项几乎共线，协方差难以收敛)，
+ *          每个拟合点做一次 6 维递推最小二乘 (RLS) 更新，状态只有参数向量与 6x6 协方差，
+ *          内存固定，每点约 150 次乘加。
+ *          准静止窗口 (陀螺仪均值小、加速度方差小、模长接近 g) 的均值才作为拟合点，
+ *          且与上一拟合点方向夹角不小于 minAngle，避免长时间静止在同一姿态时该方向独占权重。
+ *          参数以单位球 (或保存的结果) 为弱先验，未被激励的方向保持在先验附近；
+ *          所有参数的协方差降到 varianceMax 以下 (各方向都被充分激励) 且结果合理时才输出。
+ */
+class AccelCalibrator
+{
+public:
+    static const int PARAMS = 6;
+
+    /**
+     * @brief 构造函数
+     * @param config 校准配置
+     */
+    explicit AccelCalibrator(const AccelCalibratorConfig_t &config);
+
+    /**
+     * @brief 输入一批原始IMU样本 (未做加速度计校准)
+     * @param samples 样本数组，按时间先后排列
+     * @param count 样本数量
+     * @return 是否得到新的校准结果，为真时可用 getCalibration() 取出
+     */
+    bool push(const ImuSample *samples, size_t count);
+
+    /**
+     * @brief 获取最近一次输出的校准结果
+     * @param scale 三轴比例因子
+     * @param bias 三轴零偏，单位：m/s^2
+     */
+    void getCalibration(float scale[3], float bias[3]) const;
+
+    /**
+     * @brief 是否已输出过校准结果
+     */
+    bool isCalibrated() const { return _calibrated; }
+
+    /**
+     * @brief 以保存的结果作为初值与拟合先验，视为已校准
+     * @param scale 三轴比例因子
+     * @param bias 三轴零偏，单位：m/s^2
+     */
+    void seed(const float scale[3], const float bias[3]);
+
+    /**
+     * @brief 丢弃已有拟合点，以当前输出结果 (未校准时为单位球) 为先验重新拟合
+     */
+    void restart();
+
+    /**
+     * @brief 丢弃未结束的窗口，已加入的拟合点保留
+     * @details 暂停送入样本时调用，恢复后从新的窗口开始，避免暂停前后的样本混在同一窗口
+     */
+    void resetWindow();
+
+    /**
+     * @brief 已加入拟合的点数
+     */
+    uint32_t getPointCount() const { return _points; }
+
+    /**
+     * @brief 协方差对角元的最大值，降到 varianceMax 以下时可输出结果
+     */
+    float getMaxVariance() const;
+
+private:
+    AccelCalibratorConfig_t _config;
+
+    // 当前窗口
+    float _accelSum[3];
+    float _accelSqSum[3];
+    float _gyroSum[3];
+    uint32_t _accelCount;
+    uint32_t _gyroCount;
+    float _windowTime;      // 当前窗口已累计的时长，单位：s
+
+    // 递推最小二乘
+    float _theta[PARAMS];         // [a b c d e f]
+    float _P[PARAMS][PARAMS];     // 参数协方差
+    float _lastPoint[3];          // 上一拟合点方向 (单位向量)
+    uint32_t _points;
+
+    float _scale[3];
+    float _bias[3];
+    bool _calibrated;
+
+    // 窗口结束时判定准静止并更新拟合，返回是否输出新结果
+    bool closeWindow();
+
+    // 加入一个以 g 归一化的拟合点
+    void addPoint(const float u[3]);
+
+    // 由拟合参数求比例因子与零偏，结果不合理时返回 false
+    bool solve(float scale[3], float bias[3]) const;
+
+};
+
+#endif // ACCEL_CALIBRATOR_H
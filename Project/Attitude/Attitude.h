@@ -1,6 +1,20 @@
 #ifndef __ATTITUDE_H__
 #define __ATTITUDE_H__
 #include <stdint.h>
+#include <stddef.h>
+#include "seqlock.h"
+#include "math_biquad.h"
+
+/**
+ * @brief 单次IMU采样
+ * @details 用于FIFO批量读取，一个批次内陀螺仪逐样本积分，加速度计只做一次修正
+ */
+struct ImuSample {
+    float gyro[3];      // 陀螺仪数据，单位：rad/s
+    float accel[3];     // 加速度计数据，单位：m/s^2
+    float dt;           // 与上一样本的时间间隔，单位：s，<=0 时使用估计器的采样周期
+    bool accelValid;    // 该样本的加速度计数据是否有效
+};
 
 
 /**
@@ -21,6 +35,24 @@ public:
      * @param accel 加速度计数据，单位：m/s^2
      */
     virtual void read(float gyro[3], float accel[3]) = 0;
+
+    /**
+     * @brief 批量读取IMU样本（FIFO模式）
+     * @param samples 样本缓冲区
+     * @param maxCount 缓冲区最多可容纳的样本数
+     * @return 实际读取的样本数
+     * @note 默认实现退化为单次read，支持硬件FIFO的传感器应重写此函数
+     */
+    virtual size_t readBatch(ImuSample* samples, size_t maxCount)
+    {
+        if (maxCount == 0) {
+            return 0;
+        }
+        read(samples[0].gyro, samples[0].accel);
+        samples[0].dt = 0.0f;
+        samples[0].accelValid = true;
+        return 1;
+    }
     
     /**
      * @brief 虚析构函数，确保派生类被正确析构
@@ -41,6 +73,14 @@ public:
      * @param mag 磁力计数据（可选），单位：任意，仅用于磁北对准
      */
     virtual void update(float gyro[3], float accel[3], float mag[3] = nullptr) = 0;
+
+    /**
+     * @brief 批量更新姿态估计
+     * @details 对每个样本的陀螺仪数据做高频积分，整个批次只做一次加速度计修正
+     * @param samples 样本数组，按时间先后排列
+     * @param count 样本数量
+     */
+    virtual void updateBatch(const ImuSample* samples, size_t count) = 0;
     
     /**
      * @brief 获取欧拉角
@@ -66,6 +106,20 @@ public:
      * @param dt 采样周期，单位：秒
      */
     virtual void setSamplePeriod(float dt) = 0;
+
+    /**
+     * @brief 设置外部航向误差
+     * @details 误差由外部航向与测量时刻的估计偏航比较得到，估计器在后续更新中逐步消除；
+     *          默认忽略，不支持航向修正的估计器无需实现
+     * @param yawError 外部航向减估计偏航，单位：rad
+     */
+    virtual void setHeadingError(float yawError) { (void)yawError; }
+
+    /**
+     * @brief 清除估计器内部的陀螺仪零偏估计
+     * @details 输入样本已扣除新的外部校准零偏时调用，避免内部估计重复补偿；默认忽略
+     */
+    virtual void resetGyroBias() {}
     
     /**
      * @brief 虚析构函数，确保派生类被正确析构
@@ -76,6 +130,45 @@ public:
 
 
 
+/**
+ * @brief 姿态状态快照
+ * @details 每次估计器更新后由 AttitudeManager 整体发布一次，按缓存行对齐，
+ *          读者得到的四元数、欧拉角与传感器数据属于同一次更新
+ */
+struct alignas(32) StateSnapshot {
+    float q[4];         // 四元数，q[0]为实部
+    float roll;         // 滚转角，单位：rad
+    float pitch;        // 俯仰角，单位：rad
+    float yaw;          // 偏航角，单位：rad
+    float gyro[3];      // 最新陀螺仪数据，单位：rad/s
+    float accel[3];     // 最新加速度计数据，单位：m/s^2
+    uint64_t timestamp; // 发布时刻 (全局时钟计数)
+    uint32_t sample_cycle; // 最新样本的数据就绪中断时刻 (DWT 周期计数)，用于端到端延迟统计
+    uint32_t count;     // 发布次数
+};
+
+
+/**
+ * @brief 外部航向融合配置
+ */
+typedef struct {
+    float delay_ms;         // 外部航向测量时刻早于接收时刻的时间，单位：ms
+    float sign;             // 外部航向相对估计偏航的方向，1 或 -1
+    float gate;             // 对准后单次误差门限，单位：rad，超出的观测不采用
+    uint32_t realign_count; // 连续超出门限的次数达到该值时重新对准
+} HeadingFusionConfig_t;
+
+
+class DeltaAngleIntegrator;
+class DynamicNotch;
+class GyroCalibrator;
+class AccelCalibrator;
+
+/**
+ * @brief IMU三轴滤波器组，最多4个二阶节 (低通与陷波共用)
+ */
+typedef utils::BiquadBank<3, 4> ImuFilterBank;
+
 /**
  * @brief 姿态管理器类
  * @details 将IMU数据采集、姿态解算和数据传输整合在一起
@@ -102,9 +195,17 @@ public:
     
     /**
      * @brief 单步更新（适用于循环调用）
+     * @param sample_cycle 本批样本的数据就绪时刻 (DWT 周期计数)，随快照发布
      */
-    void update();
+    void update(uint32_t sample_cycle = 0);
     
+    /**
+     * @brief 获取一致的姿态状态快照
+     * @details 无锁读取，可在任意任务中调用
+     * @param snapshot 输出快照
+     */
+    void getSnapshot(StateSnapshot& snapshot) const;
+
     /**
      * @brief 获取当前欧拉角姿态
      * @param roll 横滚角（rad）
@@ -130,12 +231,113 @@ public:
      * @param q 四元数数组，q[0]为实部，q[1:3]为虚部
      */
     void getQuaternion(float q[4]);
+
+    /**
+     * @brief 设置角增量前端积分器
+     * @details 设置后IMU样本先经积分器做圆锥补偿，累计满输出周期后才调用一次估计器；
+     *          传入nullptr则每批样本直接送入估计器
+     * @param integrator 角增量积分器
+     */
+    void setDeltaAngleIntegrator(DeltaAngleIntegrator* integrator);
+
+    /**
+     * @brief 设置IMU数字滤波器
+     * @details 陀螺仪滤波器按FIFO采样率逐样本运行，加速度计滤波器只在有效样本上运行；
+     *          滤波在积分器与估计器之前进行，传入nullptr则不滤波
+     * @param gyroFilter 陀螺仪三轴滤波器组
+     * @param accelFilter 加速度计三轴滤波器组
+     */
+    void setImuFilters(ImuFilterBank* gyroFilter, ImuFilterBank* accelFilter);
+
+    /**
+     * @brief 设置陀螺仪动态陷波
+     * @details 滤波前的陀螺仪样本送入频谱分析，每次更新执行一个分析阶段，
+     *          陷波节位于陀螺仪滤波器组中，传入nullptr则停止分析
+     * @param notch 动态陷波对象，须已绑定陀螺仪滤波器组
+     */
+    void setDynamicNotch(DynamicNotch* notch);
+
+    /**
+     * @brief 设置外部航向融合参数并重新对准
+     * @param config 融合配置
+     */
+    void setHeadingFusion(const HeadingFusionConfig_t& config);
+
+    /**
+     * @brief 融合一次外部航向 (延迟偏航观测)
+     * @details 在偏航历史中取测量时刻的估计偏航，首次观测记录两者的固定偏差，
+     *          之后将扣除偏差后的误差交给估计器逐步修正；偏差只在对准时改变，
+     *          估计偏航不会跳变，Move 记录的偏航原点与位置估计的坐标旋转保持一致。
+     *          须与 update() 在同一线程中调用
+     * @param yaw 外部航向，单位：rad
+     * @param rx_cycle 接收时刻 (DWT 周期计数)
+     * @return 是否被采用
+     */
+    bool fuseHeading(float yaw, uint32_t rx_cycle);
+
+    /**
+     * @brief 设置后台陀螺仪零偏校准器
+     * @details 原始样本在滤波前送入校准器，得到零偏后从每个样本中扣除并清除估计器内部的零偏估计；
+     *          传入nullptr则不扣除零偏
+     * @param calibrator 零偏校准器
+     */
+    void setGyroCalibrator(GyroCalibrator* calibrator);
+
+    /**
+     * @brief 允许/暂停后台零偏校准，可在任意任务中调用
+     * @details 电机运转时应暂停，重新允许后从新的窗口开始累计
+     * @param enable 是否允许
+     */
+    void enableGyroCalibration(bool enable) { _gyroCalibrationEnabled = enable; }
+
+    /**
+     * @brief 是否已得到陀螺仪零偏 (未设置校准器时视为已校准)
+     */
+    bool isGyroCalibrated() const { return _gyroCalibrated; }
+
+    /**
+     * @brief 获取当前扣除的陀螺仪零偏
+     * @param bias 陀螺仪零偏，单位：rad/s
+     */
+    void getGyroBias(float bias[3]) const;
+
+    /**
+     * @brief 设置在线加速度计校准器
+     * @details 原始样本在滤波前送入校准器，得到结果后对每个有效加速度样本做比例与零偏校正；
+     *          传入nullptr则不校正
+     * @param calibrator 加速度计校准器
+     */
+    void setAccelCalibrator(AccelCalibrator* calibrator);
+
+    /**
+     * @brief 允许/暂停在线加速度计校准，可在任意任务中调用
+     * @details 电机运转时振动与推力使准静止判定失效，应暂停；已得到的校正结果继续使用，
+     *          暂停前未结束的窗口作废，恢复后从新的窗口开始
+     * @param enable 是否允许
+     */
+    void enableAccelCalibration(bool enable) { _accelCalibrationEnabled = enable; }
+
+    /**
+     * @brief 获取当前使用的加速度计校正
+     * @param scale 三轴比例因子
+     * @param bias 三轴零偏，单位：m/s^2
+     */
+    void getAccelCalibration(float scale[3], float bias[3]) const;
+
+    uint32_t getHeadingFuseCount() const { return _headingFuseCount; }
+    uint32_t getHeadingRejectCount() const { return _headingRejectCount; }
     
     
 private:
     // 依赖的组件
     IMU* _imu;
     AttitudeEstimator* _estimator;
+    DeltaAngleIntegrator* _integrator;
+    ImuFilterBank* _gyroFilter;
+    ImuFilterBank* _accelFilter;
+    DynamicNotch* _dynamicNotch;
+    GyroCalibrator* _gyroCalibrator;
+    AccelCalibrator* _accelCalibrator;
     
     // 内部状态
     bool _isInitialized;
@@ -143,6 +345,58 @@ private:
     // IMU数据缓冲
     float _gyro[3];
     float _accel[3];
+
+    // 后台零偏校准
+    float _gyroBias[3];
+    volatile bool _gyroCalibrationEnabled;
+    volatile bool _gyroCalibrated;
+    bool _gyroCalibrationActive; // 上一批样本是否送入了校准器
+
+    // 在线加速度计校准
+    float _accelScale[3];
+    float _accelBias[3];
+    volatile bool _accelCalibrationEnabled;
+    bool _accelCalibrationActive; // 上一批样本是否送入了校准器
+
+    // FIFO批量样本缓冲
+    static const size_t BATCH_MAX = 16;
+    ImuSample _batch[BATCH_MAX];
+    float _gyroChannels[3][BATCH_MAX]; // 按轴分组的陀螺仪样本，供滤波器组块处理
+
+    // 偏航历史，供延迟航向观测查找测量时刻的估计值
+    struct YawHistoryEntry {
+        uint32_t cycle;
+        float yaw;
+    };
+    static const size_t YAW_HISTORY_SIZE = 64; // 500Hz 下约 128ms
+    YawHistoryEntry _yawHistory[YAW_HISTORY_SIZE];
+    size_t _yawHistoryHead;  // 下一个写入位置
+    size_t _yawHistoryCount;
+
+    // 外部航向融合状态
+    HeadingFusionConfig_t _headingConfig;
+    bool _headingEnabled;
+    bool _headingAligned;
+    float _headingOffset;         // 外部航向减估计偏航的固定偏差，单位：rad
+    uint32_t _headingGateRejects; // 连续超出门限的次数
+    uint32_t _headingFuseCount;
+    uint32_t _headingRejectCount;
+
+    // 对外发布的状态快照
+    StateSnapshot _working;
+    utils::SeqLock<StateSnapshot> _snapshot;
+
+    // 对批量样本做陀螺仪零偏与加速度计比例/零偏的校准与校正
+    void calibrateBatch(size_t count);
+
+    // 对批量样本做数字滤波
+    void filterBatch(size_t count);
+
+    // 发布一次状态快照
+    void publish();
+
+    // 查找指定时刻的估计偏航
+    bool yawAt(uint32_t cycle, float& yaw) const;
 };
 
 
@@ -1,4 +1,12 @@
+#include "main.h"
 #include "Attitude.h"
+#include "DeltaAngleIntegrator.h"
+#include "DynamicNotch.h"
+#include "GyroCalibrator.h"
+#include "AccelCalibrator.h"
+#include "time_utils.h"
+#include "trace.h"
+#include "math_angle.h"
 
 
 /**
@@ -7,13 +15,39 @@
 AttitudeManager::AttitudeManager(IMU* imu, AttitudeEstimator* estimator)
     : _imu(imu),
       _estimator(estimator),
-      _isInitialized(false)
+      _integrator(nullptr),
+      _gyroFilter(nullptr),
+      _accelFilter(nullptr),
+      _dynamicNotch(nullptr),
+      _gyroCalibrator(nullptr),
+      _accelCalibrator(nullptr),
+      _isInitialized(false),
+      _gyroCalibrationEnabled(true),
+      _gyroCalibrated(true),
+      _gyroCalibrationActive(false),
+      _accelCalibrationEnabled(true),
+      _accelCalibrationActive(false),
+      _yawHistoryHead(0),
+      _yawHistoryCount(0),
+      _headingConfig{},
+      _headingEnabled(false),
+      _headingAligned(false),
+      _headingOffset(0.0f),
+      _headingGateRejects(0),
+      _headingFuseCount(0),
+      _headingRejectCount(0)
 {
     // 初始化数据缓冲区
     for (int i = 0; i < 3; i++) {
         _gyro[i] = 0.0f;
         _accel[i] = 0.0f;
+        _gyroBias[i] = 0.0f;
+        _accelScale[i] = 1.0f;
+        _accelBias[i] = 0.0f;
     }
+    _working = StateSnapshot{};
+    _working.q[0] = 1.0f;
+    _snapshot.write(_working);
 }
 
 /**
@@ -41,18 +75,303 @@ bool AttitudeManager::init()
 /**
  * @brief 单步更新（适用于循环调用）
  */
-void AttitudeManager::update()
+void AttitudeManager::update(uint32_t sample_cycle)
 {
+    TRACE_SCOPE(TRACE_ID_ATTITUDE_UPDATE);
     // 检查是否已初始化
     if (!_isInitialized) {
         return;
     }
     
-    // 1. 读取IMU数据
-    _imu->read(_gyro, _accel);
-    
-    // 2. 更新姿态估计
-    _estimator->update(_gyro, _accel);
+    // 1. 读取IMU数据（FIFO模式下一次取出多个样本）
+    size_t count = _imu->readBatch(_batch, BATCH_MAX);
+    if (count == 0) {
+        return;
+    }
+
+    // 2. 后台零偏与加速度计校准，校正样本
+    calibrateBatch(count);
+
+    // 3. 数字滤波
+    filterBatch(count);
+
+    // 4. 更新姿态估计
+    if (_integrator == nullptr) {
+        _estimator->updateBatch(_batch, count);
+    } else {
+        // 经前端积分器做圆锥补偿，累计满输出周期后才运行一次估计器
+        for (size_t n = 0; n < count; n++) {
+            if (_integrator->put(_batch[n])) {
+                ImuSample compensated;
+                _integrator->take(compensated);
+                _estimator->updateBatch(&compensated, 1);
+            }
+        }
+    }
+
+    // 5. 缓存最新的陀螺仪和加速度计数据
+    for (size_t n = 0; n < count; n++) {
+        for (int i = 0; i < 3; i++) {
+            _gyro[i] = _batch[n].gyro[i];
+            if (_batch[n].accelValid) {
+                _accel[i] = _batch[n].accel[i];
+            }
+        }
+    }
+
+    // 6. 整体发布状态快照
+    _working.sample_cycle = sample_cycle;
+    publish();
+
+    // 7. 记录偏航历史
+    if (_headingEnabled) {
+        YawHistoryEntry& entry = _yawHistory[_yawHistoryHead];
+        entry.cycle = sample_cycle;
+        entry.yaw = _working.yaw;
+        _yawHistoryHead = (_yawHistoryHead + 1) % YAW_HISTORY_SIZE;
+        if (_yawHistoryCount < YAW_HISTORY_SIZE) {
+            _yawHistoryCount++;
+        }
+    }
+}
+
+/**
+ * @brief 设置后台陀螺仪零偏校准器
+ */
+void AttitudeManager::setGyroCalibrator(GyroCalibrator* calibrator)
+{
+    _gyroCalibrator = calibrator;
+    _gyroCalibrationActive = false;
+    _gyroCalibrated = (calibrator == nullptr) || calibrator->isCalibrated();
+    if (calibrator != nullptr) {
+        calibrator->getBias(_gyroBias);
+    } else {
+        for (int i = 0; i < 3; i++) {
+            _gyroBias[i] = 0.0f;
+        }
+    }
+}
+
+/**
+ * @brief 设置在线加速度计校准器
+ */
+void AttitudeManager::setAccelCalibrator(AccelCalibrator* calibrator)
+{
+    _accelCalibrator = calibrator;
+    _accelCalibrationActive = false;
+    if (calibrator != nullptr) {
+        calibrator->getCalibration(_accelScale, _accelBias);
+    } else {
+        for (int i = 0; i < 3; i++) {
+            _accelScale[i] = 1.0f;
+            _accelBias[i] = 0.0f;
+        }
+    }
+}
+
+/**
+ * @brief 获取当前使用的加速度计校正
+ */
+void AttitudeManager::getAccelCalibration(float scale[3], float bias[3]) const
+{
+    for (int i = 0; i < 3; i++) {
+        scale[i] = _accelScale[i];
+        bias[i] = _accelBias[i];
+    }
+}
+
+/**
+ * @brief 获取当前扣除的陀螺仪零偏
+ */
+void AttitudeManager::getGyroBias(float bias[3]) const
+{
+    for (int i = 0; i < 3; i++) {
+        bias[i] = _gyroBias[i];
+    }
+}
+
+/**
+ * @brief 设置外部航向融合参数
+ */
+void AttitudeManager::setHeadingFusion(const HeadingFusionConfig_t& config)
+{
+    _headingConfig = config;
+    _headingAligned = false;
+    _headingGateRejects = 0;
+    _yawHistoryCount = 0;
+    _headingEnabled = true;
+}
+
+/**
+ * @brief 融合一次外部航向
+ */
+bool AttitudeManager::fuseHeading(float yaw, uint32_t rx_cycle)
+{
+    if (!_headingEnabled || !_isInitialized) {
+        return false;
+    }
+
+    // 测量时刻的估计偏航，早于全部历史时不采用
+    const uint32_t cycles_per_ms = SystemCoreClock / 1000u;
+    const uint32_t meas_cycle = rx_cycle - (uint32_t)(_headingConfig.delay_ms * (float)cycles_per_ms);
+    float estimated;
+    if (!yawAt(meas_cycle, estimated)) {
+        _headingRejectCount++;
+        return false;
+    }
+
+    const float heading = math_normalize_radian_pi(_headingConfig.sign * yaw);
+    if (!_headingAligned) {
+        _headingOffset = math_angle_diff_rad(estimated, heading);
+        _headingAligned = true;
+        _headingGateRejects = 0;
+        return true;
+    }
+
+    const float error = math_angle_diff_rad(estimated, math_normalize_radian_pi(heading - _headingOffset));
+    if (_headingConfig.gate > 0.0f && (error > _headingConfig.gate || error < -_headingConfig.gate)) {
+        // 持续超出门限说明外部航向坐标系已变化 (如雷达重定位)，重新对准而不是拉动估计偏航
+        _headingRejectCount++;
+        if (++_headingGateRejects >= _headingConfig.realign_count) {
+            _headingAligned = false;
+        }
+        return false;
+    }
+
+    _headingGateRejects = 0;
+    _estimator->setHeadingError(error);
+    _headingFuseCount++;
+    return true;
+}
+
+/**
+ * @brief 查找指定时刻的估计偏航
+ */
+bool AttitudeManager::yawAt(uint32_t cycle, float& yaw) const
+{
+    // 从最新向最旧查找测量时刻所在的历史点
+    for (size_t back = 0; back < _yawHistoryCount; back++) {
+        const YawHistoryEntry& entry = _yawHistory[(_yawHistoryHead + YAW_HISTORY_SIZE - 1 - back) % YAW_HISTORY_SIZE];
+        if ((int32_t)(cycle - entry.cycle) >= 0) {
+            yaw = entry.yaw;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 对批量样本做陀螺仪零偏与加速度计的校准与校正
+ */
+void AttitudeManager::calibrateBatch(size_t count)
+{
+    // 加速度计校准器判定准静止时需要原始陀螺仪，先于零偏扣除送入
+    if (_accelCalibrator != nullptr) {
+        bool active = _accelCalibrationEnabled;
+        if (active && !_accelCalibrationActive) {
+            // 暂停前未结束的窗口作废，从新的窗口开始
+            _accelCalibrator->resetWindow();
+        }
+        _accelCalibrationActive = active;
+        if (active && _accelCalibrator->push(_batch, count)) {
+            _accelCalibrator->getCalibration(_accelScale, _accelBias);
+        }
+        for (size_t n = 0; n < count; n++) {
+            if (_batch[n].accelValid) {
+                for (int i = 0; i < 3; i++) {
+                    _batch[n].accel[i] = _accelScale[i] * (_batch[n].accel[i] - _accelBias[i]);
+                }
+            }
+        }
+    }
+
+    if (_gyroCalibrator == nullptr) {
+        return;
+    }
+
+    bool active = _gyroCalibrationEnabled;
+    if (active && !_gyroCalibrationActive) {
+        // 暂停期间的样本未送入，从新的窗口开始
+        _gyroCalibrator->restart();
+    }
+    _gyroCalibrationActive = active;
+
+    if (active && _gyroCalibrator->push(_batch, count)) {
+        _gyroCalibrator->getBias(_gyroBias);
+        _estimator->resetGyroBias();
+        _gyroCalibrated = true;
+    }
+
+    for (size_t n = 0; n < count; n++) {
+        for (int i = 0; i < 3; i++) {
+            _batch[n].gyro[i] -= _gyroBias[i];
+        }
+    }
+}
+
+/**
+ * @brief 对批量样本做数字滤波
+ */
+void AttitudeManager::filterBatch(size_t count)
+{
+    if (_dynamicNotch != nullptr) {
+        for (size_t n = 0; n < count; n++) {
+            _dynamicNotch->push(_batch[n].gyro);
+        }
+    }
+
+    if (_gyroFilter != nullptr) {
+        // 三轴按通道分组后一次调用滤波器组
+        float* channels[3] = {_gyroChannels[0], _gyroChannels[1], _gyroChannels[2]};
+        for (size_t n = 0; n < count; n++) {
+            for (int i = 0; i < 3; i++) {
+                _gyroChannels[i][n] = _batch[n].gyro[i];
+            }
+        }
+        _gyroFilter->process(channels, (uint32_t)count);
+        for (size_t n = 0; n < count; n++) {
+            for (int i = 0; i < 3; i++) {
+                _batch[n].gyro[i] = _gyroChannels[i][n];
+            }
+        }
+    }
+
+    if (_accelFilter != nullptr) {
+        for (size_t n = 0; n < count; n++) {
+            if (_batch[n].accelValid) {
+                _accelFilter->apply(_batch[n].accel);
+            }
+        }
+    }
+
+    // 频谱分析分摊到每次更新，新的陷波系数从下一批样本开始生效
+    if (_dynamicNotch != nullptr) {
+        _dynamicNotch->step();
+    }
+}
+
+/**
+ * @brief 发布一次状态快照
+ */
+void AttitudeManager::publish()
+{
+    _estimator->getQuaternion(_working.q);
+    _estimator->getEulerRadians(_working.roll, _working.pitch, _working.yaw);
+    for (int i = 0; i < 3; i++) {
+        _working.gyro[i] = _gyro[i];
+        _working.accel[i] = _accel[i];
+    }
+    _working.timestamp = utils::time::getGlobalTick();
+    _working.count++;
+    _snapshot.write(_working);
+}
+
+/**
+ * @brief 获取一致的姿态状态快照
+ */
+void AttitudeManager::getSnapshot(StateSnapshot& snapshot) const
+{
+    _snapshot.read(snapshot);
 }
 
 /**
@@ -60,20 +379,28 @@ void AttitudeManager::update()
  */
 void AttitudeManager::getAttitude(float& roll, float& pitch, float& yaw)
 {
-    _estimator->getEulerRadians(roll, pitch, yaw);
+    StateSnapshot snapshot;
+    _snapshot.read(snapshot);
+    roll = snapshot.roll;
+    pitch = snapshot.pitch;
+    yaw = snapshot.yaw;
 }
 
 void AttitudeManager::getGyro(float gyro[3])
 {
+    StateSnapshot snapshot;
+    _snapshot.read(snapshot);
     for (int i = 0; i < 3; i++) {
-        gyro[i] = _gyro[i];
+        gyro[i] = snapshot.gyro[i];
     }
 }
 
 void AttitudeManager::getAccel(float accel[3])
 {
+    StateSnapshot snapshot;
+    _snapshot.read(snapshot);
     for (int i = 0; i < 3; i++) {
-        accel[i] = _accel[i];
+        accel[i] = snapshot.accel[i];
     }
 }
 
@@ -82,5 +409,43 @@ void AttitudeManager::getAccel(float accel[3])
  */
 void AttitudeManager::getQuaternion(float q[4])
 {
-    _estimator->getQuaternion(q);
+    StateSnapshot snapshot;
+    _snapshot.read(snapshot);
+    for (int i = 0; i < 4; i++) {
+        q[i] = snapshot.q[i];
+    }
+}
+
+/**
+ * @brief 设置角增量前端积分器
+ */
+void AttitudeManager::setDeltaAngleIntegrator(DeltaAngleIntegrator* integrator)
+{
+    _integrator = integrator;
+    if (_integrator != nullptr) {
+        _integrator->reset();
+    }
 }
+
+/**
+ * @brief 设置IMU数字滤波器
+ */
+void AttitudeManager::setImuFilters(ImuFilterBank* gyroFilter, ImuFilterBank* accelFilter)
+{
+    _gyroFilter = gyroFilter;
+    _accelFilter = accelFilter;
+    if (_gyroFilter != nullptr) {
+        _gyroFilter->reset();
+    }
+    if (_accelFilter != nullptr) {
+        _accelFilter->reset();
+    }
+}
+
+/**
+ * @brief 设置陀螺仪动态陷波
+ */
+void AttitudeManager::setDynamicNotch(DynamicNotch* notch)
+{
+    _dynamicNotch = notch;
+}
\ No newline at end of file
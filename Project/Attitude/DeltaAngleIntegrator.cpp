@@ -0,0 +1,123 @@
+/**
+ * @file DeltaAngleIntegrator.cpp
+ * @brief 带圆锥补偿的角增量积分器实现
+ */
+
+#include "DeltaAngleIntegrator.h"
+
+/**
+ * @brief 构造函数
+ */
+DeltaAngleIntegrator::DeltaAngleIntegrator(float outputPeriod, float defaultDt)
+    : _outputPeriod(outputPeriod),
+      _defaultDt(defaultDt)
+{
+    reset();
+}
+
+/**
+ * @brief 累加一个IMU样本
+ */
+bool DeltaAngleIntegrator::put(const ImuSample &sample)
+{
+    float dt = (sample.dt > 0.0f) ? sample.dt : _defaultDt;
+
+    // 本样本的角增量
+    float da[3];
+    da[0] = sample.gyro[0] * dt;
+    da[1] = sample.gyro[1] * dt;
+    da[2] = sample.gyro[2] * dt;
+
+    // 圆锥补偿：beta += 0.5 * (alpha + lastDeltaAlpha / 6) x da
+    float ax = _alpha[0] + _lastDeltaAlpha[0] * (1.0f / 6.0f);
+    float ay = _alpha[1] + _lastDeltaAlpha[1] * (1.0f / 6.0f);
+    float az = _alpha[2] + _lastDeltaAlpha[2] * (1.0f / 6.0f);
+
+    _beta[0] += 0.5f * (ay * da[2] - az * da[1]);
+    _beta[1] += 0.5f * (az * da[0] - ax * da[2]);
+    _beta[2] += 0.5f * (ax * da[1] - ay * da[0]);
+
+    _alpha[0] += da[0];
+    _alpha[1] += da[1];
+    _alpha[2] += da[2];
+
+    _lastDeltaAlpha[0] = da[0];
+    _lastDeltaAlpha[1] = da[1];
+    _lastDeltaAlpha[2] = da[2];
+
+    _integralDt += dt;
+    _lastDt = dt;
+
+    if (sample.accelValid)
+    {
+        _accelSum[0] += sample.accel[0];
+        _accelSum[1] += sample.accel[1];
+        _accelSum[2] += sample.accel[2];
+        _accelCount++;
+    }
+
+    return ready();
+}
+
+/**
+ * @brief 取出补偿后的等效样本
+ */
+bool DeltaAngleIntegrator::take(ImuSample &out)
+{
+    if (_integralDt <= 0.0f)
+    {
+        return false;
+    }
+
+    float invDt = 1.0f / _integralDt;
+    for (int i = 0; i < 3; i++)
+    {
+        out.gyro[i] = (_alpha[i] + _beta[i]) * invDt;
+    }
+    out.dt = _integralDt;
+
+    if (_accelCount > 0)
+    {
+        float invCount = 1.0f / (float)_accelCount;
+        out.accel[0] = _accelSum[0] * invCount;
+        out.accel[1] = _accelSum[1] * invCount;
+        out.accel[2] = _accelSum[2] * invCount;
+        out.accelValid = true;
+    }
+    else
+    {
+        out.accel[0] = 0.0f;
+        out.accel[1] = 0.0f;
+        out.accel[2] = 0.0f;
+        out.accelValid = false;
+    }
+
+    // 上一个角增量保留，用于下一区间首个样本的圆锥补偿
+    for (int i = 0; i < 3; i++)
+    {
+        _alpha[i] = 0.0f;
+        _beta[i] = 0.0f;
+        _accelSum[i] = 0.0f;
+    }
+    _accelCount = 0;
+    _integralDt = 0.0f;
+
+    return true;
+}
+
+/**
+ * @brief 清空累加状态
+ */
+void DeltaAngleIntegrator::reset()
+{
+    for (int i = 0; i < 3; i++)
+    {
+        _alpha[i] = 0.0f;
+        _beta[i] = 0.0f;
+        _accelSum[i] = 0.0f;
+        _lastDeltaAlpha[i] = 0.0f;
+    }
+    _accelCount = 0;
+    _integralDt = 0.0f;
+    _lastDt = _defaultDt;
+}
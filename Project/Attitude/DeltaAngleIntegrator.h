@@ -0,0 +1,82 @@
+/**
+ * @file DeltaAngleIntegrator.h
+ * @brief 带圆锥补偿的角增量积分器
+ * @details 以陀螺仪原始速率累加角增量并进行圆锥误差补偿，
+ *          按较低速率向姿态估计器输出等效旋转，使传感器带宽与滤波器计算量解耦
+ */
+
+#ifndef DELTA_ANGLE_INTEGRATOR_H
+#define DELTA_ANGLE_INTEGRATOR_H
+
+#include "Attitude.h"
+
+/**
+ * @brief 角增量积分器类
+ * @details 圆锥补偿采用 Savage 两子样递推形式：
+ *          beta += 0.5 * (alpha + dTheta_prev / 6) x dTheta
+ *          输出旋转矢量 phi = alpha + beta
+ */
+class DeltaAngleIntegrator
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param outputPeriod 输出周期，单位：s，累计时长达到该值后可取出一次结果
+     * @param defaultDt 样本未携带时间间隔时使用的默认间隔，单位：s
+     */
+    DeltaAngleIntegrator(float outputPeriod = 0.002f, float defaultDt = 0.0005f);
+
+    /**
+     * @brief 累加一个IMU样本
+     * @param sample IMU样本
+     * @return 累计时长是否已达到输出周期
+     */
+    bool put(const ImuSample &sample);
+
+    /**
+     * @brief 检查是否可以取出结果
+     * @details 累计时长为浮点累加，与输出周期留半个样本间隔的余量，
+     *          避免舍入误差使个别区间多等一个样本
+     */
+    bool ready() const { return _integralDt > 0.0f && _integralDt >= _outputPeriod - 0.5f * _lastDt; }
+
+    /**
+     * @brief 取出补偿后的等效样本并清空累加量
+     * @details 输出样本的 gyro = phi / T，dt = T，估计器按单样本积分即可得到补偿后的旋转；
+     *          accel 为区间内有效加速度的均值
+     * @param out 输出样本
+     * @return 区间内是否有累加数据
+     */
+    bool take(ImuSample &out);
+
+    /**
+     * @brief 清空累加状态
+     */
+    void reset();
+
+    /**
+     * @brief 设置输出周期
+     * @param outputPeriod 输出周期，单位：s
+     */
+    void setOutputPeriod(float outputPeriod) { _outputPeriod = outputPeriod; }
+
+    /**
+     * @brief 获取本区间已累计的时长
+     */
+    float getIntegralDt() const { return _integralDt; }
+
+private:
+    float _outputPeriod;
+    float _defaultDt;
+
+    float _alpha[3];          // 角增量累加和
+    float _beta[3];           // 圆锥补偿项
+    float _lastDeltaAlpha[3]; // 上一个角增量
+    float _integralDt;        // 区间累计时长
+    float _lastDt;            // 上一个样本的时间间隔
+
+    float _accelSum[3];       // 区间内加速度累加和
+    uint32_t _accelCount;     // 区间内有效加速度样本数
+};
+
+#endif // DELTA_ANGLE_INTEGRATOR_H
@@ -0,0 +1,381 @@
+/**
+ * @file DynamicNotch.cpp
+ * @brief 基于FFT的陀螺仪动态陷波实现
+ */
+
+#include "DynamicNotch.h"
+#include "math_const.h"
+#include <math.h>
+
+/**
+ * @brief 构造函数
+ */
+DynamicNotch::DynamicNotch(const DynamicNotchConfig_t &config)
+    : _config(config),
+      _bank(nullptr),
+      _isInitialized(false),
+      _decimCount(0),
+      _ringHead(0),
+      _ringFill(0),
+      _phase(PHASE_WINDOW),
+      _axis(0),
+      _binWidth(0.0f),
+      _minBin(1),
+      _maxBin(BINS - 2),
+      _updateCount(0)
+{
+    for (int i = 0; i < 3; i++) {
+        _decimSum[i] = 0.0f;
+    }
+    for (uint32_t k = 0; k < BINS; k++) {
+        _accum[k] = 0.0f;
+        _spectrum[k] = 0.0f;
+    }
+    for (uint32_t i = 0; i < MAX_NOTCHES; i++) {
+        _center[i] = 0.0f;
+    }
+}
+
+/**
+ * @brief 初始化并绑定陀螺仪滤波器组
+ */
+bool DynamicNotch::init(ImuFilterBank *bank)
+{
+    _isInitialized = false;
+    if (bank == nullptr || _config.sampleFreq <= 0.0f || _config.decimation == 0 ||
+        _config.notchCount == 0 || _config.notchCount > MAX_NOTCHES ||
+        _config.minFreq >= _config.maxFreq || _config.q <= 0.0f) {
+        return false;
+    }
+
+    // 分析带宽须覆盖搜索上限
+    const float analysisFreq = _config.sampleFreq / (float)_config.decimation;
+    if (_config.maxFreq >= analysisFreq / 2.0f) {
+        return false;
+    }
+    _binWidth = analysisFreq / (float)FFT_SIZE;
+    _minBin = (uint32_t)ceilf(_config.minFreq / _binWidth);
+    _maxBin = (uint32_t)floorf(_config.maxFreq / _binWidth);
+    if (_minBin < 1) {
+        _minBin = 1;
+    }
+    if (_maxBin > BINS - 2) {
+        _maxBin = BINS - 2;
+    }
+    if (_minBin >= _maxBin) {
+        return false;
+    }
+
+    // 陷波节先置为直通，检测到峰值后再设置
+    BiquadCoeffs_t passthrough;
+    Biquad_Passthrough(&passthrough);
+    for (uint32_t i = 0; i < _config.notchCount; i++) {
+        if (!bank->setStage(_config.firstStage + i, passthrough)) {
+            return false;
+        }
+        _center[i] = 0.0f;
+    }
+
+    // 汉宁窗
+    for (uint32_t n = 0; n < FFT_SIZE; n++) {
+        _window[n] = 0.5f * (1.0f - cosf(2.0f * M_PI * (float)n / (float)(FFT_SIZE - 1)));
+    }
+
+#if MATH_BIQUAD_USE_CMSIS
+    if (arm_rfft_fast_init_f32(&_fft, FFT_SIZE) != ARM_MATH_SUCCESS) {
+        return false;
+    }
+#endif
+
+    _bank = bank;
+    _decimCount = 0;
+    _ringHead = 0;
+    _ringFill = 0;
+    _phase = PHASE_WINDOW;
+    _axis = 0;
+    _updateCount = 0;
+    _isInitialized = true;
+    return true;
+}
+
+/**
+ * @brief 输入一个陀螺仪样本
+ */
+void DynamicNotch::push(const float gyro[3])
+{
+    if (!_isInitialized) {
+        return;
+    }
+
+    // 均值降采样，兼作简单的抗混叠
+    for (int i = 0; i < 3; i++) {
+        _decimSum[i] += gyro[i];
+    }
+    if (++_decimCount < _config.decimation) {
+        return;
+    }
+
+    const float scale = 1.0f / (float)_config.decimation;
+    for (int i = 0; i < 3; i++) {
+        _ring[i][_ringHead] = _decimSum[i] * scale;
+        _decimSum[i] = 0.0f;
+    }
+    _decimCount = 0;
+    _ringHead = (_ringHead + 1) % FFT_SIZE;
+    if (_ringFill < FFT_SIZE) {
+        _ringFill++;
+    }
+}
+
+/**
+ * @brief 执行一个分析阶段
+ */
+void DynamicNotch::step()
+{
+    if (!_isInitialized || _ringFill < FFT_SIZE) {
+        return;
+    }
+
+    switch (_phase) {
+    case PHASE_WINDOW: {
+        // 从最旧到最新拷贝一轴数据，去均值后加窗
+        const float *src = _ring[_axis];
+        float mean = 0.0f;
+        for (uint32_t n = 0; n < FFT_SIZE; n++) {
+            mean += src[n];
+        }
+        mean /= (float)FFT_SIZE;
+        uint32_t index = _ringHead;
+        for (uint32_t n = 0; n < FFT_SIZE; n++) {
+            _fftIn[n] = (src[index] - mean) * _window[n];
+            index = (index + 1) % FFT_SIZE;
+        }
+        _phase = PHASE_FFT;
+        break;
+    }
+
+    case PHASE_FFT:
+        realFft();
+        _phase = PHASE_MAGNITUDE;
+        break;
+
+    case PHASE_MAGNITUDE:
+        // 三轴幅度谱相加，电机振动频率对各轴相同
+        if (_axis == 0) {
+            for (uint32_t k = 0; k < BINS; k++) {
+                _accum[k] = 0.0f;
+            }
+        }
+        for (uint32_t k = _minBin - 1; k <= _maxBin + 1; k++) {
+            const float re = _fftOut[2 * k];
+            const float im = _fftOut[2 * k + 1];
+            _accum[k] += sqrtf(re * re + im * im);
+        }
+        if (++_axis < 3) {
+            _phase = PHASE_WINDOW;
+        } else {
+            _axis = 0;
+            _phase = PHASE_PEAKS;
+        }
+        break;
+
+    case PHASE_PEAKS:
+        for (uint32_t k = 0; k < BINS; k++) {
+            _spectrum[k] = _accum[k];
+        }
+        findPeaks();
+        _updateCount++;
+        _phase = PHASE_WINDOW;
+        break;
+    }
+}
+
+/**
+ * @brief 实数FFT，输出格式与 arm_rfft_fast_f32 一致：
+ *        [Re(0), Re(N/2), Re(1), Im(1), ..., Re(N/2-1), Im(N/2-1)]
+ */
+void DynamicNotch::realFft()
+{
+#if MATH_BIQUAD_USE_CMSIS
+    // 注意：arm_rfft_fast_f32 会改写输入缓冲区
+    arm_rfft_fast_f32(&_fft, _fftIn, _fftOut, 0);
+#else
+    // 主机上使用基2迭代复数FFT
+    float re[FFT_SIZE];
+    float im[FFT_SIZE];
+    for (uint32_t n = 0; n < FFT_SIZE; n++) {
+        // 位反转重排
+        uint32_t r = 0;
+        for (uint32_t bit = 1, m = n; bit < FFT_SIZE; bit <<= 1, m >>= 1) {
+            r = (r << 1) | (m & 1u);
+        }
+        re[r] = _fftIn[n];
+        im[r] = 0.0f;
+    }
+    for (uint32_t len = 2; len <= FFT_SIZE; len <<= 1) {
+        const float theta = -2.0f * M_PI / (float)len;
+        for (uint32_t start = 0; start < FFT_SIZE; start += len) {
+            for (uint32_t j = 0; j < len / 2; j++) {
+                const float wr = cosf(theta * (float)j);
+                const float wi = sinf(theta * (float)j);
+                const uint32_t a = start + j;
+                const uint32_t b = a + len / 2;
+                const float tr = re[b] * wr - im[b] * wi;
+                const float ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+    _fftOut[0] = re[0];
+    _fftOut[1] = re[FFT_SIZE / 2];
+    for (uint32_t k = 1; k < BINS; k++) {
+        _fftOut[2 * k] = re[k];
+        _fftOut[2 * k + 1] = im[k];
+    }
+#endif
+}
+
+/**
+ * @brief 在合并幅度谱中寻找最强的若干峰值并更新陷波
+ */
+void DynamicNotch::findPeaks()
+{
+    float mean = 0.0f;
+    for (uint32_t k = _minBin; k <= _maxBin; k++) {
+        mean += _spectrum[k];
+    }
+    mean /= (float)(_maxBin - _minBin + 1);
+    const float threshold = mean * _config.threshold;
+
+    // 按幅度保留最强的 notchCount 个局部极大值
+    uint32_t peakBin[MAX_NOTCHES];
+    uint32_t peakCount = 0;
+    for (uint32_t k = _minBin; k <= _maxBin; k++) {
+        const float m = _spectrum[k];
+        if (m <= threshold || m <= _spectrum[k - 1] || m < _spectrum[k + 1]) {
+            continue;
+        }
+        uint32_t pos = peakCount;
+        while (pos > 0 && _spectrum[peakBin[pos - 1]] < m) {
+            pos--;
+        }
+        if (pos >= _config.notchCount) {
+            continue;
+        }
+        uint32_t last = (peakCount < _config.notchCount) ? peakCount : _config.notchCount - 1;
+        for (uint32_t i = last; i > pos; i--) {
+            peakBin[i] = peakBin[i - 1];
+        }
+        peakBin[pos] = k;
+        if (peakCount < _config.notchCount) {
+            peakCount++;
+        }
+    }
+
+    // 抛物线插值得到亚区间频率
+    float peakFreq[MAX_NOTCHES];
+    for (uint32_t i = 0; i < peakCount; i++) {
+        const uint32_t k = peakBin[i];
+        const float y0 = _spectrum[k - 1];
+        const float y1 = _spectrum[k];
+        const float y2 = _spectrum[k + 1];
+        const float denom = y0 - 2.0f * y1 + y2;
+        float delta = (denom != 0.0f) ? 0.5f * (y0 - y2) / denom : 0.0f;
+        if (delta > 0.5f) {
+            delta = 0.5f;
+        } else if (delta < -0.5f) {
+            delta = -0.5f;
+        }
+        peakFreq[i] = ((float)k + delta) * _binWidth;
+    }
+
+    // 已跟踪的陷波依次认领离上一中心频率最近的峰值，峰值顺序变化时各陷波不会互换
+    bool peakUsed[MAX_NOTCHES] = {false};
+    bool stageUsed[MAX_NOTCHES] = {false};
+    while (true) {
+        uint32_t bestStage = MAX_NOTCHES;
+        uint32_t bestPeak = MAX_NOTCHES;
+        float bestDist = 0.0f;
+        for (uint32_t i = 0; i < _config.notchCount; i++) {
+            if (stageUsed[i] || _center[i] <= 0.0f) {
+                continue;
+            }
+            for (uint32_t j = 0; j < peakCount; j++) {
+                const float dist = fabsf(peakFreq[j] - _center[i]);
+                if (!peakUsed[j] && (bestStage == MAX_NOTCHES || dist < bestDist)) {
+                    bestStage = i;
+                    bestPeak = j;
+                    bestDist = dist;
+                }
+            }
+        }
+        if (bestStage == MAX_NOTCHES) {
+            break;
+        }
+        stageUsed[bestStage] = true;
+        peakUsed[bestPeak] = true;
+        applyNotch(bestStage, peakFreq[bestPeak]);
+    }
+
+    // 新出现的峰值交给空闲的陷波，直接以峰值频率起步
+    for (uint32_t j = 0; j < peakCount; j++) {
+        if (peakUsed[j]) {
+            continue;
+        }
+        for (uint32_t i = 0; i < _config.notchCount; i++) {
+            if (!stageUsed[i]) {
+                stageUsed[i] = true;
+                _center[i] = 0.0f;
+                applyNotch(i, peakFreq[j]);
+                break;
+            }
+        }
+    }
+
+    // 峰值少于陷波节数时，多出的陷波恢复直通，避免停留在已消失的频率上
+    for (uint32_t i = 0; i < _config.notchCount; i++) {
+        if (!stageUsed[i]) {
+            clearNotch(i);
+        }
+    }
+}
+
+/**
+ * @brief 平滑中心频率并重设对应的陷波节
+ */
+void DynamicNotch::applyNotch(uint32_t index, float freq)
+{
+    if (freq < _config.minFreq) {
+        freq = _config.minFreq;
+    } else if (freq > _config.maxFreq) {
+        freq = _config.maxFreq;
+    }
+
+    if (_center[index] <= 0.0f) {
+        _center[index] = freq;
+    } else {
+        _center[index] += _config.smoothing * (freq - _center[index]);
+    }
+
+    BiquadCoeffs_t c;
+    Biquad_Notch(&c, _config.sampleFreq, _center[index], _config.q);
+    _bank->setStage(_config.firstStage + index, c);
+}
+
+/**
+ * @brief 将陷波节恢复为直通
+ */
+void DynamicNotch::clearNotch(uint32_t index)
+{
+    if (_center[index] <= 0.0f) {
+        return;
+    }
+    _center[index] = 0.0f;
+
+    BiquadCoeffs_t c;
+    Biquad_Passthrough(&c);
+    _bank->setStage(_config.firstStage + index, c);
+}
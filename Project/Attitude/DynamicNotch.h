@@ -0,0 +1,133 @@
+/**
+ * @file DynamicNotch.h
+ * @brief 基于FFT的陀螺仪动态陷波
+ * @details 将陀螺仪样本降采样后存入环形缓冲区，在后台对三轴分别做加窗实数FFT，
+ *          合并幅度谱后寻找电机振动峰值，并在运行时重设陀螺仪滤波器组中的陷波节
+ */
+
+#ifndef DYNAMIC_NOTCH_H
+#define DYNAMIC_NOTCH_H
+
+#include "Attitude.h"
+
+#if MATH_BIQUAD_USE_CMSIS
+#include "arm_math.h"
+#endif
+
+/**
+ * @brief 动态陷波配置
+ */
+typedef struct {
+    float sampleFreq;    // 陀螺仪采样频率，单位：Hz
+    uint32_t decimation; // 降采样倍数，分析带宽为 sampleFreq / decimation / 2
+    float minFreq;       // 峰值搜索下限，单位：Hz
+    float maxFreq;       // 峰值搜索上限，单位：Hz
+    float q;             // 陷波品质因子
+    uint32_t notchCount; // 陷波节数 (跟踪的峰值数)
+    uint32_t firstStage; // 陷波节在滤波器组中的起始下标
+    float smoothing;     // 中心频率一阶平滑系数 (0~1]
+    float threshold;     // 峰值需超过频带内平均幅度的倍数
+} DynamicNotchConfig_t;
+
+/**
+ * @brief 动态陷波类
+ * @details 每次调用 step() 只完成一个固定工作量的阶段 (单轴加窗、单轴FFT、单轴求幅度、峰值搜索)，
+ *          三轴一轮共 10 个阶段，单次耗时与FFT长度相关而与调用频率无关。
+ *          push()、step() 与滤波器组须在同一线程中调用。
+ */
+class DynamicNotch
+{
+public:
+    static const uint32_t FFT_SIZE = 128;
+    static const uint32_t BINS = FFT_SIZE / 2;
+    static const uint32_t MAX_NOTCHES = 2;
+
+    /**
+     * @brief 构造函数
+     * @param config 配置参数
+     */
+    DynamicNotch(const DynamicNotchConfig_t &config);
+
+    /**
+     * @brief 初始化并绑定陀螺仪滤波器组，陷波节先置为直通
+     * @param bank 陀螺仪滤波器组
+     * @return 配置是否有效
+     */
+    bool init(ImuFilterBank *bank);
+
+    /**
+     * @brief 输入一个陀螺仪样本 (滤波前)
+     * @param gyro 三轴角速度，单位：rad/s
+     */
+    void push(const float gyro[3]);
+
+    /**
+     * @brief 执行一个分析阶段，在一轮结束时更新陷波频率
+     */
+    void step();
+
+    /**
+     * @brief 获取第 index 个陷波的当前中心频率，未检测到峰值时为 0
+     */
+    float getCenterFreq(uint32_t index) const { return index < MAX_NOTCHES ? _center[index] : 0.0f; }
+
+    /**
+     * @brief 获取合并后的幅度谱 (上一轮结果)
+     */
+    const float *getSpectrum() const { return _spectrum; }
+
+    /**
+     * @brief 获取频率分辨率，单位：Hz
+     */
+    float getBinWidth() const { return _binWidth; }
+
+    /**
+     * @brief 获取完成的分析轮数
+     */
+    uint32_t getUpdateCount() const { return _updateCount; }
+
+private:
+    enum Phase : uint8_t {
+        PHASE_WINDOW = 0,
+        PHASE_FFT,
+        PHASE_MAGNITUDE,
+        PHASE_PEAKS
+    };
+
+    DynamicNotchConfig_t _config;
+    ImuFilterBank *_bank;
+    bool _isInitialized;
+
+    // 降采样环形缓冲区
+    float _ring[3][FFT_SIZE];
+    float _decimSum[3];
+    uint32_t _decimCount;
+    uint32_t _ringHead;
+    uint32_t _ringFill;
+
+    // 分析状态
+    Phase _phase;
+    uint8_t _axis;
+    float _window[FFT_SIZE];
+    float _fftIn[FFT_SIZE];
+    float _fftOut[FFT_SIZE];
+    float _accum[BINS];      // 本轮累加的幅度谱
+    float _spectrum[BINS];   // 上一轮完成的幅度谱
+    float _binWidth;
+    uint32_t _minBin;
+    uint32_t _maxBin;
+
+    float _center[MAX_NOTCHES];
+    uint32_t _updateCount;
+
+#if MATH_BIQUAD_USE_CMSIS
+    arm_rfft_fast_instance_f32 _fft;
+#endif
+
+    void realFft();
+    void findPeaks();
+    void applyNotch(uint32_t index, float freq);
+    void clearNotch(uint32_t index);
+};
+
+#endif // DYNAMIC_NOTCH_H
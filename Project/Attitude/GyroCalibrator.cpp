@@ -0,0 +1,161 @@
+/**
+ * @file GyroCalibrator.cpp
+ * @brief 后台陀螺仪零偏校准实现
+ */
+
+#include "GyroCalibrator.h"
+#include "math_utils.h"
+
+/**
+ * @brief 清空统计量
+ */
+void GyroCalibrator::Welford::reset()
+{
+    n = 0;
+    for (int i = 0; i < 3; i++) {
+        mean[i] = 0.0f;
+        m2[i] = 0.0f;
+    }
+}
+
+/**
+ * @brief 加入一个三轴样本
+ */
+void GyroCalibrator::Welford::add(const float x[3])
+{
+    n++;
+    float invN = 1.0f / (float)n;
+    for (int i = 0; i < 3; i++) {
+        float delta = x[i] - mean[i];
+        mean[i] += delta * invN;
+        m2[i] += delta * (x[i] - mean[i]);
+    }
+}
+
+/**
+ * @brief 构造函数
+ */
+GyroCalibrator::GyroCalibrator(const GyroCalibratorConfig_t &config)
+    : _config(config),
+      _calibrated(false),
+      _still(false),
+      _restartCount(0)
+{
+    for (int i = 0; i < 3; i++) {
+        _bias[i] = 0.0f;
+    }
+    restart();
+    _restartCount = 0;
+}
+
+/**
+ * @brief 清空窗口与零偏累计
+ */
+void GyroCalibrator::restart()
+{
+    _gyroWindow.reset();
+    _accelWindow.reset();
+    _windowTime = 0.0f;
+    for (int i = 0; i < 3; i++) {
+        _biasMean[i] = 0.0f;
+    }
+    _biasSamples = 0;
+    _stillCount = 0;
+    _restartCount++;
+}
+
+/**
+ * @brief 输入一批原始IMU样本
+ */
+bool GyroCalibrator::push(const ImuSample *samples, size_t count)
+{
+    bool updated = false;
+    for (size_t n = 0; n < count; n++) {
+        _gyroWindow.add(samples[n].gyro);
+        if (samples[n].accelValid) {
+            _accelWindow.add(samples[n].accel);
+        }
+        _windowTime += (samples[n].dt > 0.0f) ? samples[n].dt : _config.defaultDt;
+
+        if (_windowTime >= _config.window) {
+            updated |= closeWindow();
+            _gyroWindow.reset();
+            _accelWindow.reset();
+            _windowTime = 0.0f;
+        }
+    }
+    return updated;
+}
+
+/**
+ * @brief 以保存的零偏作为初值
+ */
+void GyroCalibrator::seed(const float bias[3])
+{
+    for (int i = 0; i < 3; i++) {
+        _bias[i] = bias[i];
+    }
+    _calibrated = true;
+}
+
+/**
+ * @brief 获取最近一次输出的零偏
+ */
+void GyroCalibrator::getBias(float bias[3]) const
+{
+    for (int i = 0; i < 3; i++) {
+        bias[i] = _bias[i];
+    }
+}
+
+/**
+ * @brief 窗口结束时判定静止并更新零偏累计
+ */
+bool GyroCalibrator::closeWindow()
+{
+    const float gyroVarMax = _config.gyroStdMax * _config.gyroStdMax;
+    const float accelVarMax = _config.accelStdMax * _config.accelStdMax;
+
+    bool still = (_gyroWindow.n > 1) && (_accelWindow.n > 1);
+    for (int i = 0; still && i < 3; i++) {
+        if (_gyroWindow.variance(i) > gyroVarMax ||
+            _accelWindow.variance(i) > accelVarMax ||
+            _gyroWindow.mean[i] > _config.biasMax ||
+            _gyroWindow.mean[i] < -_config.biasMax) {
+            still = false;
+        }
+    }
+    if (still) {
+        // 比力模长应为重力加速度，排除匀加速与自由落体
+        const float *a = _accelWindow.mean;
+        float norm = math_sqrtf(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]);
+        float diff = norm - GRAVITY_CONST;
+        still = (diff <= _config.accelNormTol) && (diff >= -_config.accelNormTol);
+    }
+
+    if (!still) {
+        // 被碰动：已有累计作废，下一段静止重新开始
+        if (_still || _biasSamples > 0) {
+            restart();
+        }
+        _still = false;
+        return false;
+    }
+    _still = true;
+
+    // 按样本数合并窗口均值
+    _biasSamples += _gyroWindow.n;
+    float weight = (float)_gyroWindow.n / (float)_biasSamples;
+    for (int i = 0; i < 3; i++) {
+        _biasMean[i] += (_gyroWindow.mean[i] - _biasMean[i]) * weight;
+    }
+
+    if (++_stillCount < _config.stillWindows) {
+        return false;
+    }
+    for (int i = 0; i < 3; i++) {
+        _bias[i] = _biasMean[i];
+    }
+    _calibrated = true;
+    return true;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file GyroCalibrator.h
+ * @brief 后台陀螺仪零偏校准
+ * @details 在姿态解算循环中逐批接收原始IMU样本，按窗口统计陀螺仪与加速度计的方差判断静止，
+ *          连续静止窗口内的陀螺仪均值即为零偏，无需上电时阻塞采样
+ */
+
+#ifndef GYRO_CALIBRATOR_H
+#define GYRO_CALIBRATOR_H
+
+#include "Attitude.h"
+
+/**
+ * @brief 后台零偏校准配置
+ */
+typedef struct {
+    float window;           // 静止判定窗口时长，单位：s
+    float defaultDt;        // 样本未携带时间间隔时使用的默认间隔，单位：s
+    float gyroStdMax;       // 窗口内陀螺仪各轴标准差上限，单位：rad/s
+    float accelStdMax;      // 窗口内加速度计各轴标准差上限，单位：m/s^2
+    float accelNormTol;     // 窗口内加速度均值模长与重力加速度之差的上限，单位：m/s^2
+    float biasMax;          // 零偏各轴绝对值上限，超出视为匀速转动，单位：rad/s
+    uint32_t stillWindows;  // 连续静止窗口数达到该值后输出零偏
+} GyroCalibratorConfig_t;
+
+/**
+ * @brief 后台陀螺仪零偏校准器
+ * @details 每个窗口用 Welford 在线算法统计陀螺仪与加速度计的均值和方差，
+ *          方差与加速度模长均满足条件时判为静止窗口，其陀螺仪均值按样本数并入零偏累计；
+ *          任一窗口不满足条件 (被碰动) 时清空累计，下一段静止重新开始。
+ *          累计达到 stillWindows 个窗口后输出零偏，之后仍保持静止则每个窗口输出一次更精确的结果。
+ */
+class GyroCalibrator
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param config 校准配置
+     */
+    explicit GyroCalibrator(const GyroCalibratorConfig_t &config);
+
+    /**
+     * @brief 输入一批原始IMU样本 (未扣除零偏)
+     * @param samples 样本数组，按时间先后排列
+     * @param count 样本数量
+     * @return 是否得到新的零偏，为真时可用 getBias() 取出
+     */
+    bool push(const ImuSample *samples, size_t count);
+
+    /**
+     * @brief 获取最近一次输出的零偏
+     * @param bias 陀螺仪零偏，单位：rad/s
+     */
+    void getBias(float bias[3]) const;
+
+    /**
+     * @brief 是否已输出过零偏
+     */
+    bool isCalibrated() const { return _calibrated; }
+
+    /**
+     * @brief 最近一个窗口是否判为静止
+     */
+    bool isStill() const { return _still; }
+
+    /**
+     * @brief 以保存的零偏作为初值，视为已校准，静止后仍按窗口更新
+     * @param bias 陀螺仪零偏，单位：rad/s
+     */
+    void seed(const float bias[3]);
+
+    /**
+     * @brief 清空窗口与零偏累计，已输出的零偏保留
+     */
+    void restart();
+
+    /**
+     * @brief 被碰动而重新开始累计的次数
+     */
+    uint32_t getRestartCount() const { return _restartCount; }
+
+private:
+    // 三轴 Welford 在线均值/方差
+    struct Welford {
+        uint32_t n;
+        float mean[3];
+        float m2[3];
+
+        void reset();
+        void add(const float x[3]);
+        float variance(int axis) const { return (n > 1) ? m2[axis] / (float)(n - 1) : 0.0f; }
+    };
+
+    GyroCalibratorConfig_t _config;
+
+    Welford _gyroWindow;
+    Welford _accelWindow;
+    float _windowTime;        // 当前窗口已累计的时长，单位：s
+
+    float _biasMean[3];       // 连续静止窗口的陀螺仪均值
+    uint32_t _biasSamples;    // 参与累计的样本数
+    uint32_t _stillCount;     // 连续静止窗口数
+
+    float _bias[3];
+    bool _calibrated;
+    bool _still;
+    uint32_t _restartCount;
+
+    // 窗口结束时判定静止并更新零偏累计，返回是否输出新零偏
+    bool closeWindow();
+};
+
+#endif // GYRO_CALIBRATOR_H
@@ -6,14 +6,21 @@
 #include "BMI088.h"
 #include "main.h"
 #include "time_utils.h"
+#include <string.h>
 
 /**
  * @brief 构造函数
  */
 BMI088::BMI088(const BMI088Config_t& config)
     : _config(config), // 使用初始化列表拷贝配置
-      _isCalibrated(false)
+      _isCalibrated(false),
+      _fifoEnabled(config.gyroFifoWatermark > 0),
+      _gyroSamplePeriod(0.001f),
+      _fifoOverrunCount(0)
 {
+    memset(_fifoTxBuf, 0x55, sizeof(_fifoTxBuf));
+    memset(_fifoRxBuf, 0, sizeof(_fifoRxBuf));
+
     // 初始化零偏值为0
     _gyroOffset[0] = 0.0f;
     _gyroOffset[1] = 0.0f;
@@ -69,6 +76,15 @@ BMI088::BMI088(const BMI088Config_t& config)
     _gyroConfig[5][1] = BMI088_GYRO_DRDY_IO_INT3;
     _gyroConfig[5][2] = BMI088_GYRO_INT3_INT4_IO_MAP_ERROR;
 
+    // FIFO模式下陀螺仪提高到2kHz输出，数据就绪中断改为FIFO水位中断
+    if (_fifoEnabled)
+    {
+        _gyroConfig[1][1] = BMI088_GYRO_2000_230_HZ | BMI088_GYRO_BANDWIDTH_MUST_Set;
+        _gyroConfig[3][1] = BMI088_GYRO_FIFO_INT_ON;
+        _gyroConfig[5][1] = BMI088_GYRO_FIFO_IO_INT3;
+        _gyroSamplePeriod = 0.0005f;
+    }
+
     // 设置传感器灵敏度
     setSensitivity();
 }
@@ -137,7 +153,7 @@ bool BMI088::init()
 
     if(accelInitResult && gyroInitResult)
     {
-        calibrateGyro();
+        // 零偏由姿态管理器在后台静止时校准，需要上电阻塞校准时调用 calibrateGyro()
         return true;
     }
 
@@ -237,9 +253,51 @@ bool BMI088::initGyro()
         }
     }
 
+    if (_fifoEnabled)
+    {
+        return initGyroFifo();
+    }
+
     return true;
 }
 
+/**
+ * @brief 初始化陀螺仪FIFO
+ * @details 使用Stream模式，FIFO满后丢弃最旧的数据，保证读出的总是最新样本
+ */
+bool BMI088::initGyroFifo()
+{
+    uint8_t regData = 0;
+    uint8_t watermark = _config.gyroFifoWatermark;
+    if (watermark > BMI088_GYRO_FIFO_DEPTH)
+    {
+        watermark = BMI088_GYRO_FIFO_DEPTH;
+    }
+
+    gyroWriteSingleReg(BMI088_GYRO_FIFO_WM_ENABLE, BMI088_GYRO_FIFO_WM_ON);
+    delay_us(BMI088_COM_WAIT_SENSOR_TIME);
+
+    gyroWriteSingleReg(BMI088_GYRO_FIFO_CONFIG_0, watermark);
+    delay_us(BMI088_COM_WAIT_SENSOR_TIME);
+
+    gyroWriteSingleReg(BMI088_GYRO_FIFO_CONFIG_1, BMI088_GYRO_FIFO_MODE_STREAM);
+    delay_us(BMI088_COM_WAIT_SENSOR_TIME);
+
+    gyroReadSingleReg(BMI088_GYRO_FIFO_CONFIG_1, regData);
+    delay_us(BMI088_COM_WAIT_SENSOR_TIME);
+
+    return (regData & 0xC0) == BMI088_GYRO_FIFO_MODE_STREAM;
+}
+
+/**
+ * @brief 清空陀螺仪FIFO
+ * @details 重新写入FIFO模式寄存器即可清空FIFO和溢出标志
+ */
+void BMI088::flushGyroFifo()
+{
+    gyroWriteSingleReg(BMI088_GYRO_FIFO_CONFIG_1, BMI088_GYRO_FIFO_MODE_STREAM);
+}
+
 /**
  * @brief 读取IMU传感器数据
  */
@@ -291,6 +349,74 @@ void BMI088::read(float gyro[3], float accel[3])
     }
 }
 
+/**
+ * @brief 批量读取IMU样本
+ */
+size_t BMI088::readBatch(ImuSample* samples, size_t maxCount)
+{
+    if (!_fifoEnabled)
+    {
+        return IMU::readBatch(samples, maxCount);
+    }
+
+    if (maxCount == 0)
+    {
+        return 0;
+    }
+
+    // 读取FIFO中的帧数
+    uint8_t status = 0;
+    gyroReadSingleReg(BMI088_GYRO_FIFO_STATUS, status);
+    if (status & BMI088_GYRO_FIFO_OVERRUN)
+    {
+        _fifoOverrunCount++;
+    }
+
+    uint8_t frames = status & BMI088_GYRO_FIFO_FRAME_COUNT_MASK;
+    if (frames == 0)
+    {
+        return 0;
+    }
+    if (frames > GYRO_FIFO_BURST_MAX)
+    {
+        frames = GYRO_FIFO_BURST_MAX;
+    }
+    if (frames > maxCount)
+    {
+        frames = (uint8_t)maxCount;
+    }
+
+    // 一次SPI突发读出所有帧
+    gyroReadFifoBurst(frames);
+
+    const uint8_t *frame = &_fifoRxBuf[1];
+    for (uint8_t n = 0; n < frames; n++)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            int16_t rawData = (int16_t)((frame[2 * i + 1] << 8) | frame[2 * i]);
+            float gyroData = rawData * _gyroSensitivity;
+            samples[n].gyro[i] = _isCalibrated ? (gyroData - _gyroOffset[i]) : gyroData;
+        }
+        samples[n].dt = _gyroSamplePeriod;
+        samples[n].accelValid = false;
+        frame += BMI088_GYRO_FIFO_FRAME_SIZE;
+    }
+
+    // 加速度计每批次只读取一次，附在最新的样本上
+    uint8_t buf[6] = {0};
+    accelReadMultiRegs(BMI088_ACCEL_XOUT_L, buf, 6);
+    ImuSample &last = samples[frames - 1];
+    for (int i = 0; i < 3; i++)
+    {
+        int16_t rawData = (int16_t)((buf[2 * i + 1] << 8) | buf[2 * i]);
+        last.accel[i] = rawData * _accelSensitivity;
+    }
+    last.accelValid = true;
+
+    return frames;
+}
+
 /**
  * @brief 校准陀螺仪零偏
  */
@@ -328,6 +454,12 @@ void BMI088::calibrateGyro(uint32_t sampleCount)
     _gyroOffset[2] /= (float)sampleCount;
 
     _isCalibrated = true;
+
+    // 校准期间FIFO已写满旧数据，清空后再开始批量读取
+    if (_fifoEnabled)
+    {
+        flushGyroFifo();
+    }
 }
 
 /**
@@ -488,4 +620,18 @@ void BMI088::gyroReadMultiRegs(uint8_t reg, uint8_t *data, uint8_t len)
     readMultiRegs(reg, data, len);
     gyroChipSelect(false);
 }
+
+/**
+ * @brief 突发读取陀螺仪FIFO
+ * @details FIFO数据寄存器地址不自增，连续读取即可依次取出各帧，结果存放在_fifoRxBuf[1]起始处
+ */
+void BMI088::gyroReadFifoBurst(uint8_t frames)
+{
+    uint16_t len = 1 + frames * BMI088_GYRO_FIFO_FRAME_SIZE;
+    _fifoTxBuf[0] = BMI088_GYRO_FIFO_DATA | 0x80;
+
+    gyroChipSelect(true);
+    HAL_SPI_TransmitReceive(_config.hspi, _fifoTxBuf, _fifoRxBuf, len, 1000);
+    gyroChipSelect(false);
+}
 #endif // BMI088_USE_SPI
\ No newline at end of file
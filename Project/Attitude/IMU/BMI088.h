@@ -28,6 +28,7 @@ typedef struct
     } ce_acc, ce_gyro; // 片选信号结构体
     uint8_t gyroRange;    // 陀螺仪量程设置
     uint8_t accelRange;   // 加速度计量程设置
+    uint8_t gyroFifoWatermark; // 陀螺仪FIFO水位（帧数），0表示不使用FIFO
 } BMI088Config_t;
 
 
@@ -63,7 +64,29 @@ public:
     virtual void read(float gyro[3], float accel[3]) override;
 
     /**
-     * @brief 校准陀螺仪零偏
+     * @brief 批量读取IMU样本
+     * @details FIFO模式下一次SPI突发读出陀螺仪FIFO中的全部帧，加速度计只读取一次并附在最后一个样本上；
+     *          未使能FIFO时退化为单次read
+     * @param samples 样本缓冲区
+     * @param maxCount 缓冲区最多可容纳的样本数
+     * @return 实际读取的样本数
+     */
+    virtual size_t readBatch(ImuSample* samples, size_t maxCount) override;
+
+    /**
+     * @brief 清空陀螺仪FIFO
+     */
+    void flushGyroFifo();
+
+    /**
+     * @brief 获取FIFO溢出次数
+     */
+    uint32_t getFifoOverrunCount() const { return _fifoOverrunCount; }
+
+    /**
+     * @brief 阻塞校准陀螺仪零偏
+     * @details 以 2ms 间隔丢弃 sampleCount/2 次后平均 sampleCount 次读数，之后的读数扣除该零偏；
+     *          使用后台零偏校准 (GyroCalibrator) 时无需调用
      * @param sampleCount 采样次数，默认为500
      */
     void calibrateGyro(uint32_t sampleCount = 500);
@@ -91,6 +114,17 @@ private:
     // 初始化陀螺仪
     bool initGyro();
 
+    // 初始化陀螺仪FIFO
+    bool initGyroFifo();
+
+    // 陀螺仪FIFO相关
+    static const uint8_t GYRO_FIFO_BURST_MAX = 16; // 单次突发读取的最大帧数
+    bool _fifoEnabled;
+    float _gyroSamplePeriod; // 陀螺仪输出周期，单位：s
+    uint32_t _fifoOverrunCount;
+    uint8_t _fifoTxBuf[1 + GYRO_FIFO_BURST_MAX * BMI088_GYRO_FIFO_FRAME_SIZE];
+    uint8_t _fifoRxBuf[1 + GYRO_FIFO_BURST_MAX * BMI088_GYRO_FIFO_FRAME_SIZE];
+
     // 底层通信函数
     void delay_us(uint16_t us);
     void delay_ms(uint16_t ms);
@@ -111,6 +145,7 @@ private:
     void gyroWriteSingleReg(uint8_t reg, uint8_t data);
     void gyroReadSingleReg(uint8_t reg, uint8_t &data);
     void gyroReadMultiRegs(uint8_t reg, uint8_t *data, uint8_t len);
+    void gyroReadFifoBurst(uint8_t frames);
 #endif
 
     // 设置传感器灵敏度
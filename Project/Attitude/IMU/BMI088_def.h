@@ -108,6 +108,10 @@
 #define BMI088_GYRO_DYDR_SHFITS 0x7
 #define BMI088_GYRO_DYDR (0x1 << BMI088_GYRO_DYDR_SHFITS)
 
+#define BMI088_GYRO_FIFO_STATUS 0x0E // 陀螺仪FIFO状态寄存器
+#define BMI088_GYRO_FIFO_OVERRUN (0x1 << 7)
+#define BMI088_GYRO_FIFO_FRAME_COUNT_MASK 0x7F
+
 #define BMI088_GYRO_RANGE 0x0F // 陀螺仪量程寄存器
 #define BMI088_GYRO_RANGE_SHFITS 0x0
 #define BMI088_GYRO_2000 (0x0 << BMI088_GYRO_RANGE_SHFITS)
@@ -138,6 +142,7 @@
 #define BMI088_GYRO_CTRL 0x15 // 陀螺仪控制寄存器
 #define BMI088_DRDY_OFF 0x00
 #define BMI088_DRDY_ON 0x80
+#define BMI088_GYRO_FIFO_INT_ON 0x40
 
 #define BMI088_GYRO_INT3_INT4_IO_CONF 0x16 // 陀螺仪中断3和中断4 IO配置寄存器
 #define BMI088_GYRO_INT3_GPIO_MODE_SHFITS 0x1
@@ -152,6 +157,21 @@
 #define BMI088_GYRO_DRDY_IO_INT3 0x01
 #define BMI088_GYRO_DRDY_IO_INT4 0x80
 #define BMI088_GYRO_DRDY_IO_BOTH (BMI088_GYRO_DRDY_IO_INT3 | BMI088_GYRO_DRDY_IO_INT4)
+#define BMI088_GYRO_FIFO_IO_INT3 0x04
+#define BMI088_GYRO_FIFO_IO_INT4 0x20
+
+#define BMI088_GYRO_FIFO_WM_ENABLE 0x1E // 陀螺仪FIFO水位中断使能寄存器
+#define BMI088_GYRO_FIFO_WM_ON 0x88
+#define BMI088_GYRO_FIFO_WM_OFF 0x08
+
+#define BMI088_GYRO_FIFO_CONFIG_0 0x3D // 陀螺仪FIFO水位寄存器
+#define BMI088_GYRO_FIFO_CONFIG_1 0x3E // 陀螺仪FIFO模式寄存器
+#define BMI088_GYRO_FIFO_MODE_FIFO 0x40
+#define BMI088_GYRO_FIFO_MODE_STREAM 0x80
+#define BMI088_GYRO_FIFO_DATA 0x3F // 陀螺仪FIFO数据寄存器
+
+#define BMI088_GYRO_FIFO_FRAME_SIZE 6 // 每帧字节数（XYZ各2字节）
+#define BMI088_GYRO_FIFO_DEPTH 100    // FIFO最大帧数
 
 // 公共定义
 #define BMI088_TEMP_FACTOR 0.125f // 温度系数
@@ -0,0 +1,96 @@
+/**
+ * @file VirtualIMU.cpp
+ * @brief 虚拟IMU实现
+ */
+
+#include "VirtualIMU.h"
+#include <math.h>
+
+static const double TWO_PI = 6.283185307179586;
+
+/**
+ * @brief 构造函数
+ */
+VirtualIMU::VirtualIMU(const VirtualIMUConfig_t &config)
+    : _config(config),
+      _dt(1.0 / config.sampleRate),
+      _omega(TWO_PI * config.coneFrequency),
+      _index(0)
+{
+}
+
+/**
+ * @brief 初始化
+ */
+bool VirtualIMU::init()
+{
+    _index = 0;
+    return true;
+}
+
+/**
+ * @brief 获取任意时刻的真值姿态
+ */
+void VirtualIMU::getAttitude(double t, double q[4]) const
+{
+    const double half = 0.5 * _config.coneAngle;
+    const double phase = _omega * t;
+    const double s = sin(half);
+    q[0] = cos(half);
+    q[1] = 0.0;
+    q[2] = s * cos(phase);
+    q[3] = s * sin(phase);
+}
+
+/**
+ * @brief 获取任意时刻的真值机体角速度
+ */
+void VirtualIMU::getRate(double t, double gyro[3]) const
+{
+    const double a = _config.coneAngle;
+    const double phase = _omega * t;
+    const double s = sin(0.5 * a);
+    gyro[0] = -2.0 * _omega * s * s;
+    gyro[1] = -_omega * sin(a) * sin(phase);
+    gyro[2] = _omega * sin(a) * cos(phase);
+}
+
+/**
+ * @brief 输出当前时刻的样本并前进一个采样周期
+ */
+void VirtualIMU::read(float gyro[3], float accel[3])
+{
+    const double t0 = getTime();
+    const double t1 = t0 + _dt;
+    const double a = _config.coneAngle;
+    const double s = sin(0.5 * a);
+
+    // 区间平均角速度：wx 为常值，wy/wz 的正弦按解析积分
+    gyro[0] = (float)(-2.0 * _omega * s * s);
+    gyro[1] = (float)(-sin(a) * (cos(_omega * t0) - cos(_omega * t1)) / _dt);
+    gyro[2] = (float)(sin(a) * (sin(_omega * t1) - sin(_omega * t0)) / _dt);
+
+    // 比力 [0, 0, g] 由导航系转到机体系：a = R(q)^T * [0, 0, g]
+    double q[4];
+    getAttitude(t0, q);
+    const double g = _config.gravity;
+    accel[0] = (float)(2.0 * (q[1] * q[3] - q[0] * q[2]) * g);
+    accel[1] = (float)(2.0 * (q[2] * q[3] + q[0] * q[1]) * g);
+    accel[2] = (float)((q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3]) * g);
+
+    _index++;
+}
+
+/**
+ * @brief 连续输出多个样本
+ */
+size_t VirtualIMU::readBatch(ImuSample* samples, size_t maxCount)
+{
+    for (size_t i = 0; i < maxCount; i++)
+    {
+        read(samples[i].gyro, samples[i].accel);
+        samples[i].dt = (float)_dt;
+        samples[i].accelValid = true;
+    }
+    return maxCount;
+}
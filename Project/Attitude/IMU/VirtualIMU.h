@@ -0,0 +1,86 @@
+/**
+ * @file VirtualIMU.h
+ * @brief 虚拟IMU：按解析运动生成理想陀螺仪与加速度计数据
+ * @details 用于主机上验证姿态前端与估计器，真值姿态有解析解，可与积分结果直接比较
+ */
+
+#ifndef VIRTUAL_IMU_H
+#define VIRTUAL_IMU_H
+
+#include "Attitude.h"
+
+/**
+ * @brief 虚拟IMU配置
+ */
+typedef struct {
+    float sampleRate;       // 采样率，单位：Hz
+    float coneAngle;        // 圆锥半锥角，单位：rad，0 表示静止
+    float coneFrequency;    // 圆锥运动频率，单位：Hz
+    float gravity;          // 重力加速度，单位：m/s^2
+} VirtualIMUConfig_t;
+
+/**
+ * @brief 圆锥运动虚拟IMU
+ * @details 机体姿态 q(t) = [cos(a/2), 0, sin(a/2)cos(wt), sin(a/2)sin(wt)]，
+ *          即转轴在机体 YZ 平面内以角频率 w 旋转、转角恒为半锥角 a 的经典圆锥运动，
+ *          对应的机体角速度为
+ *          wx = -2w sin^2(a/2)，wy = -w sin(a) sin(wt)，wz = w sin(a) cos(wt)。
+ *          各轴角速度均为有界正弦，逐样本直接积分的误差却沿 X 轴单调累积 (圆锥误差)，
+ *          正好用来检验圆锥补偿。
+ *          陀螺仪输出采样区间 [t, t + dt] 内的平均角速度 (解析角增量 / dt)，与积分型陀螺仪一致，
+ *          误差只来自圆锥补偿本身；加速度计输出区间起点的比力 (重力反向) 在机体系中的投影。
+ *          时刻按样本序号乘采样周期以双精度计算，长时间运行不累积时间与相位误差。
+ */
+class VirtualIMU : public IMU
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param config 虚拟IMU配置
+     */
+    explicit VirtualIMU(const VirtualIMUConfig_t &config);
+
+    /**
+     * @brief 初始化 (回到 t = 0)
+     */
+    virtual bool init() override;
+
+    /**
+     * @brief 输出当前时刻的样本并前进一个采样周期
+     */
+    virtual void read(float gyro[3], float accel[3]) override;
+
+    /**
+     * @brief 连续输出 maxCount 个样本，样本携带采样周期
+     */
+    virtual size_t readBatch(ImuSample* samples, size_t maxCount) override;
+
+    /**
+     * @brief 获取任意时刻的真值姿态
+     * @param t 时刻，单位：s
+     * @param q 四元数 [w, x, y, z]
+     */
+    void getAttitude(double t, double q[4]) const;
+
+    /**
+     * @brief 获取任意时刻的真值机体角速度
+     * @param t 时刻，单位：s
+     * @param gyro 角速度，单位：rad/s
+     */
+    void getRate(double t, double gyro[3]) const;
+
+    /**
+     * @brief 下一个样本对应的时刻，单位：s
+     */
+    double getTime() const { return (double)_index * _dt; }
+
+    float getSamplePeriod() const { return (float)_dt; }
+
+private:
+    VirtualIMUConfig_t _config;
+    double _dt;
+    double _omega;    // 圆锥角频率，单位：rad/s
+    uint32_t _index;  // 下一个样本的序号
+};
+
+#endif // VIRTUAL_IMU_H
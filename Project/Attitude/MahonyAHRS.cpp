@@ -12,7 +12,8 @@
 MahonyAHRS::MahonyAHRS(float sampleFreq, float Kp, float Ki)
     : _sampleFreq(sampleFreq),
       _Kp(Kp),
-      _Ki(Ki)
+      _Ki(Ki),
+      _KpHeading(0.0f)
 {
     _invSampleFreq = 1.0f / _sampleFreq;
     reset();
@@ -191,6 +192,9 @@ void MahonyAHRS::update(float gyro[3], float accel[3], float mag[3])
     gy += twoKp * halfey;
     gz += twoKp * halfez;
 
+    // 外部航向修正
+    headingFeedback(q0, q1, q2, q3, _invSampleFreq, gx, gy, gz);
+
 
     // 应用积分反馈 (乘以 2.0f 以匹配旧版本的 twoKi)
     // 注意：旧版本无论是否有磁力计都使用 twoKi
@@ -241,6 +245,115 @@ void MahonyAHRS::update(float gyro[3], float accel[3], float mag[3])
     computeEulerRadians();
 }
 
+/**
+ * @brief 批量更新姿态估计
+ */
+void MahonyAHRS::updateBatch(const ImuSample* samples, size_t count)
+{
+    if (samples == nullptr || count == 0)
+    {
+        return;
+    }
+
+    // 统计批次总时长和平均加速度
+    float batchDt = 0.0f;
+    float ax = 0.0f, ay = 0.0f, az = 0.0f;
+    uint32_t accelCount = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        batchDt += (samples[i].dt > 0.0f) ? samples[i].dt : _invSampleFreq;
+        if (samples[i].accelValid)
+        {
+            ax += samples[i].accel[0];
+            ay += samples[i].accel[1];
+            az += samples[i].accel[2];
+            accelCount++;
+        }
+    }
+
+    float q0 = _q0, q1 = _q1, q2 = _q2, q3 = _q3;
+    float recipNorm;
+
+    // 批次内只做一次加速度计修正，得到恒定的角速度反馈
+    float fbx = 0.0f, fby = 0.0f, fbz = 0.0f;
+    if (accelCount > 0 && ((ax != 0.0f) || (ay != 0.0f) || (az != 0.0f)))
+    {
+        recipNorm = 1.0f / math_sqrtf(ax * ax + ay * ay + az * az);
+        ax *= recipNorm;
+        ay *= recipNorm;
+        az *= recipNorm;
+
+        // 机体坐标系中的重力方向
+        float halfvx = q1 * q3 - q0 * q2;
+        float halfvy = q0 * q1 + q2 * q3;
+        float halfvz = q0 * q0 - 0.5f + q3 * q3;
+
+        float halfex = (ay * halfvz - az * halfvy);
+        float halfey = (az * halfvx - ax * halfvz);
+        float halfez = (ax * halfvy - ay * halfvx);
+
+        float twoKp = 2.0f * _Kp;
+        fbx = twoKp * halfex;
+        fby = twoKp * halfey;
+        fbz = twoKp * halfez;
+
+        if (_Ki > 0.0f)
+        {
+            float twoKi = 2.0f * _Ki;
+            _integralFBx += twoKi * halfex * batchDt;
+            _integralFBy += twoKi * halfey * batchDt;
+            _integralFBz += twoKi * halfez * batchDt;
+        }
+    }
+
+    headingFeedback(q0, q1, q2, q3, batchDt, fbx, fby, fbz);
+
+    if (_Ki > 0.0f)
+    {
+        fbx += _integralFBx;
+        fby += _integralFBy;
+        fbz += _integralFBz;
+    }
+    else
+    {
+        _integralFBx = 0.0f;
+        _integralFBy = 0.0f;
+        _integralFBz = 0.0f;
+    }
+
+    // 陀螺仪逐样本积分
+    for (size_t i = 0; i < count; i++)
+    {
+        float halfDt = 0.5f * ((samples[i].dt > 0.0f) ? samples[i].dt : _invSampleFreq);
+        float gx = (samples[i].gyro[0] + fbx) * halfDt;
+        float gy = (samples[i].gyro[1] + fby) * halfDt;
+        float gz = (samples[i].gyro[2] + fbz) * halfDt;
+
+        float qa = q0;
+        float qb = q1;
+        float qc = q2;
+        float qd = q3;
+
+        q0 = qa + (-qb * gx - qc * gy - qd * gz);
+        q1 = qb + (qa * gx + qc * gz - qd * gy);
+        q2 = qc + (qa * gy - qb * gz + qd * gx);
+        q3 = qd + (qa * gz + qb * gy - qc * gx);
+
+        recipNorm = 1.0f / math_sqrtf(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+        q0 *= recipNorm;
+        q1 *= recipNorm;
+        q2 *= recipNorm;
+        q3 *= recipNorm;
+    }
+
+    _q0 = q0;
+    _q1 = q1;
+    _q2 = q2;
+    _q3 = q3;
+
+    computeEulerRadians();
+}
+
 /**
  * @brief 获取欧拉角
  */
@@ -280,6 +393,8 @@ void MahonyAHRS::reset()
     _integralFBx = 0.0f;
     _integralFBy = 0.0f;
     _integralFBz = 0.0f;
+
+    _headingError = 0.0f;
 }
 
 /**
@@ -307,6 +422,75 @@ void MahonyAHRS::setKi(float Ki)
     _Ki = Ki;
 }
 
+/**
+ * @brief 设置航向修正比例增益
+ */
+void MahonyAHRS::setHeadingKp(float Kp)
+{
+    _KpHeading = Kp;
+}
+
+/**
+ * @brief 设置外部航向误差
+ */
+void MahonyAHRS::setHeadingError(float yawError)
+{
+    _headingError = yawError;
+}
+
+/**
+ * @brief 清除积分反馈中学到的陀螺仪零偏
+ */
+void MahonyAHRS::resetGyroBias()
+{
+    _integralFBx = 0.0f;
+    _integralFBy = 0.0f;
+    _integralFBz = 0.0f;
+}
+
+/**
+ * @brief 航向误差反馈
+ * @details 地面系 Z 轴在机体系中的方向为 2*halfv，绕该轴的误差角速度叠加到反馈上，
+ *          与加速度计修正正交，不影响横滚与俯仰
+ */
+void MahonyAHRS::headingFeedback(float q0, float q1, float q2, float q3, float dt,
+                                 float &fbx, float &fby, float &fbz)
+{
+    float error = _headingError;
+    if (_KpHeading <= 0.0f || error == 0.0f)
+    {
+        return;
+    }
+
+    float zx = 2.0f * (q1 * q3 - q0 * q2);
+    float zy = 2.0f * (q0 * q1 + q2 * q3);
+    float zz = 2.0f * (q0 * q0 - 0.5f + q3 * q3);
+
+    float rate = _KpHeading * error;
+    fbx += rate * zx;
+    fby += rate * zy;
+    fbz += rate * zz;
+
+    if (_Ki > 0.0f)
+    {
+        float twoKi = 2.0f * _Ki;
+        _integralFBx += twoKi * error * zx * dt;
+        _integralFBy += twoKi * error * zy * dt;
+        _integralFBz += twoKi * error * zz * dt;
+    }
+
+    // 扣除本次已修正的角度，超调时直接清零
+    float applied = rate * dt;
+    if ((error > 0.0f && applied >= error) || (error < 0.0f && applied <= error))
+    {
+        _headingError = 0.0f;
+    }
+    else
+    {
+        _headingError = error - applied;
+    }
+}
+
 /**
  * @brief 归一化向量
  */
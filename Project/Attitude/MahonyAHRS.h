@@ -44,6 +44,14 @@ public:
      */
     virtual void update(float gyro[3], float accel[3], float mag[3] = nullptr) override;
 
+    /**
+     * @brief 批量更新姿态估计
+     * @details 先用批次平均加速度计算一次误差反馈，再将反馈叠加到每个陀螺仪样本上逐个积分
+     * @param samples 样本数组，按时间先后排列
+     * @param count 样本数量
+     */
+    virtual void updateBatch(const ImuSample* samples, size_t count) override;
+
     /**
      * @brief 获取欧拉角
      * @param roll 滚转角（绕X轴旋转），单位：rad
@@ -69,6 +77,19 @@ public:
      */
     virtual void setSamplePeriod(float dt) override;
 
+    /**
+     * @brief 设置外部航向误差
+     * @details 误差绕地面系 Z 轴以 KpHeading 反馈，已施加的修正量从剩余误差中扣除，
+     *          外部航向中断时修正自然结束；积分项同时学习 Z 轴陀螺零偏
+     * @param yawError 外部航向减估计偏航，单位：rad
+     */
+    virtual void setHeadingError(float yawError) override;
+
+    /**
+     * @brief 清除积分反馈中学到的陀螺仪零偏
+     */
+    virtual void resetGyroBias() override;
+
     /**
      * @brief 设置比例增益
      * @param Kp 比例增益
@@ -81,6 +102,12 @@ public:
      */
     void setKi(float Ki);
 
+    /**
+     * @brief 设置航向修正比例增益
+     * @param Kp 航向比例增益，单位：1/s，0 表示不使用外部航向
+     */
+    void setHeadingKp(float Kp);
+
 private:
     // 四元数表示的姿态
     float _q0, _q1, _q2, _q3;
@@ -100,11 +127,19 @@ private:
     // 控制参数
     float _Kp;
     float _Ki;
+    float _KpHeading;
+
+    // 尚未消除的外部航向误差
+    float _headingError;
 
     // 加速度重力向量和磁北向量的归一化
     void normalizeVectors(float ax, float ay, float az, float &nx, float &ny, float &nz,
                           float mx, float my, float mz, float &wx, float &wy, float &wz);
 
+    // 将航向误差转为机体系角速度反馈，dt 为本次修正的时长
+    void headingFeedback(float q0, float q1, float q2, float q3, float dt,
+                         float &fbx, float &fby, float &fbz);
+
     // 计算欧拉角（内部方法，仅在update中调用）
     void computeEulerRadians();
 };
@@ -6,6 +6,32 @@
 #include "QuaternionEKF.h"
 #include "math_utils.h"
 
+/**
+ * @brief 对称 3x3 矩阵求逆 (伴随矩阵法)，不申请内存
+ * @return 矩阵非正定 (行列式不为正) 时返回 false
+ */
+static bool invertSymmetric3x3(const utils::math::Matrix &S, utils::math::Matrix &S_inv)
+{
+    const float a = S(0, 0), b = S(0, 1), c = S(0, 2);
+    const float d = S(1, 1), e = S(1, 2), f = S(2, 2);
+    const float c00 = d * f - e * e;
+    const float c01 = c * e - b * f;
+    const float c02 = b * e - c * d;
+    const float det = a * c00 + b * c01 + c * c02;
+    if (det <= 1e-12f)
+    {
+        return false;
+    }
+    const float inv = 1.0f / det;
+    S_inv(0, 0) = c00 * inv;
+    S_inv(0, 1) = S_inv(1, 0) = c01 * inv;
+    S_inv(0, 2) = S_inv(2, 0) = c02 * inv;
+    S_inv(1, 1) = (a * f - c * c) * inv;
+    S_inv(1, 2) = S_inv(2, 1) = (b * c - a * e) * inv;
+    S_inv(2, 2) = (a * d - b * b) * inv;
+    return true;
+}
+
 /**
  * @brief 构造函数
  */
@@ -14,6 +40,13 @@ QuaternionEKF::QuaternionEKF(float sampleFreq)
       _Q(7, 7), // 过程噪声协方差
       _R(3, 3), // 测量噪声协方差
       _dt(1.0f / sampleFreq),
+      _gate_chi2(11.34f), // 3 自由度 99% 分位
+      _gate_reject_limit(250),
+      _gate_rejects(0),
+      _adaptive_gain(1.0f),
+      _accept_count(0),
+      _reject_count(0),
+      _last_innovation(0.0f),
       // 初始化所有预分配的中间矩阵
       _F(7, 7),
       _F_transpose(7, 7),
@@ -26,7 +59,9 @@ QuaternionEKF::QuaternionEKF(float sampleFreq)
       _state_correction(7, 1),
       _I(7, 7),
       _temp_7x7(7, 7),
-      _temp_7x3(7, 3)
+      _temp_7x3(7, 3),
+      _temp_3x7(3, 7),
+      _P_next(7, 7)
 {
     // 初始化
     reset();
@@ -65,6 +100,63 @@ void QuaternionEKF::update(float gyro[3], float accel[3], float mag[3])
     // 注意：当前简化实现不使用磁力计数据
 }
 
+/**
+ * @brief 批量更新姿态估计
+ */
+void QuaternionEKF::updateBatch(const ImuSample* samples, size_t count)
+{
+    if (samples == nullptr || count == 0)
+    {
+        return;
+    }
+
+    float gyro_sum[3] = {0.0f, 0.0f, 0.0f};
+    float accel_sum[3] = {0.0f, 0.0f, 0.0f};
+    float batch_dt = 0.0f;
+    uint32_t accel_count = 0;
+
+    // 四元数逐样本积分，保留高频陀螺仪信息
+    for (size_t i = 0; i < count; i++)
+    {
+        float dt = (samples[i].dt > 0.0f) ? samples[i].dt : _dt;
+        float gyro_corrected[3];
+        for (int k = 0; k < 3; k++)
+        {
+            gyro_corrected[k] = samples[i].gyro[k] - _gyro_bias[k];
+            gyro_sum[k] += gyro_corrected[k] * dt;
+        }
+        propagateQuaternion(gyro_corrected, dt);
+        batch_dt += dt;
+
+        if (samples[i].accelValid)
+        {
+            accel_sum[0] += samples[i].accel[0];
+            accel_sum[1] += samples[i].accel[1];
+            accel_sum[2] += samples[i].accel[2];
+            accel_count++;
+        }
+    }
+
+    // 协方差按批次平均角速度传播一次，过程噪声按样本数累加
+    float gyro_mean[3];
+    for (int k = 0; k < 3; k++)
+    {
+        gyro_mean[k] = gyro_sum[k] / batch_dt;
+    }
+    propagateCovariance(gyro_mean, batch_dt, (float)count);
+
+    // 整个批次只做一次测量更新，自适应噪声需要比力模长，传入均值
+    if (accel_count > 0)
+    {
+        float accel_mean[3];
+        for (int k = 0; k < 3; k++)
+        {
+            accel_mean[k] = accel_sum[k] / (float)accel_count;
+        }
+        measurementUpdate(accel_mean);
+    }
+}
+
 /**
  * @brief 获取欧拉角
  */
@@ -149,6 +241,24 @@ void QuaternionEKF::setMeasurementNoise(const float R[3][3])
     }
 }
 
+/**
+ * @brief 设置加速度计新息门限
+ */
+void QuaternionEKF::setInnovationGate(float chi2, uint32_t reject_limit)
+{
+    _gate_chi2 = chi2;
+    _gate_reject_limit = reject_limit;
+    _gate_rejects = 0;
+}
+
+/**
+ * @brief 设置自适应测量噪声
+ */
+void QuaternionEKF::setAdaptiveNoise(float gain)
+{
+    _adaptive_gain = gain;
+}
+
 /**
  * @brief 状态转移函数
  * @details 使用陀螺仪数据进行状态预测
@@ -161,11 +271,21 @@ void QuaternionEKF::stateTransition(const float gyro[3])
     gyro_corrected[1] = gyro[1] - _gyro_bias[1];
     gyro_corrected[2] = gyro[2] - _gyro_bias[2];
 
+    propagateQuaternion(gyro_corrected, _dt);
+    propagateCovariance(gyro_corrected, _dt, 1.0f);
+}
+
+/**
+ * @brief 四元数积分
+ * @details 假设dt内角速度恒定，按轴角增量更新四元数
+ */
+void QuaternionEKF::propagateQuaternion(const float gyro_corrected[3], float dt)
+{
     // 计算角度变化（假设在短时间内角速度恒定）
     float angle_delta[3];
-    angle_delta[0] = gyro_corrected[0] * _dt;
-    angle_delta[1] = gyro_corrected[1] * _dt;
-    angle_delta[2] = gyro_corrected[2] * _dt;
+    angle_delta[0] = gyro_corrected[0] * dt;
+    angle_delta[1] = gyro_corrected[1] * dt;
+    angle_delta[2] = gyro_corrected[2] * dt;
 
     // 计算角度变化的大小
     float angle_norm = math_sqrtf(angle_delta[0] * angle_delta[0] +
@@ -200,9 +320,16 @@ void QuaternionEKF::stateTransition(const float gyro[3])
 
     // 归一化四元数
     _quat.normalize();
+}
 
+/**
+ * @brief 协方差传播
+ * @param steps 本次传播覆盖的采样步数，过程噪声按步数累加
+ */
+void QuaternionEKF::propagateCovariance(const float gyro_corrected[3], float dt, float steps)
+{
     // 计算状态转移矩阵
-    calculateF(gyro_corrected, _F);
+    calculateF(gyro_corrected, dt, _F);
 
     // 预测状态协方差
     // P = F * P * F^T + Q
@@ -210,12 +337,21 @@ void QuaternionEKF::stateTransition(const float gyro[3])
     _F.transpose(_F_transpose);
     _F.multiply(_P, _temp_7x7); // temp_7x7 = F * P
     _temp_7x7.multiply(_F_transpose, _P); // P = temp_7x7 * F_transpose
-    _P.add(_Q, _P); // P = P + Q
+    if (steps > 1.0f)
+    {
+        _Q.scale(steps, _temp_7x7); // temp_7x7 = steps * Q
+        _P.add(_temp_7x7, _P);
+    }
+    else
+    {
+        _P.add(_Q, _P); // P = P + Q
+    }
 }
 
 /**
  * @brief 测量更新函数
- * @details 使用加速度计数据更新状态估计
+ * @details 使用加速度计数据更新状态估计；新息先经马氏距离门限检验，
+ *          被拒绝的测量不计算增益、不更新协方差
  */
 void QuaternionEKF::measurementUpdate(const float accel[3])
 {
@@ -245,36 +381,76 @@ void QuaternionEKF::measurementUpdate(const float accel[3])
     // 计算测量雅可比矩阵
     calculateH(_H);
 
-    // 计算卡尔曼增益
-    // K = P * H^T * (H * P * H^T + R)^(-1)
-    // 使用预分配矩阵避免创建临时对象
+    // 新息协方差 S = H * P * H^T + R，使用预分配矩阵避免创建临时对象
     _H.transpose(_H_transpose);
-    _H.multiply(_P, _temp_7x3); // temp_7x3 = H * P
-    _temp_7x3.multiply(_H_transpose, _S); // S = temp_7x3 * H_transpose = H * P * H^T
+    _H.multiply(_P, _temp_3x7); // temp_3x7 = H * P
+    _temp_3x7.multiply(_H_transpose, _S); // S = H * P * H^T
     _S.add(_R, _S); // S = S + R
-    
-    // 计算S的逆矩阵
-    _S.inverse(_S_inverse);
-    
-    // 计算卡尔曼增益
+
+    if (!invertSymmetric3x3(_S, _S_inverse))
+    {
+        return;
+    }
+
+    // 新息马氏距离平方，超出门限时跳过增益与协方差更新；
+    // 门限按名义 R 检验，自适应放大的噪声不放宽门限
+    float innovation = 0.0f;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        float row = 0.0f;
+        for (uint32_t j = 0; j < 3; j++)
+        {
+            row += _S_inverse(i, j) * _residual(j, 0);
+        }
+        innovation += _residual(i, 0) * row;
+    }
+    _last_innovation = innovation;
+    if (_gate_chi2 > 0.0f && innovation > _gate_chi2)
+    {
+        if (_gate_reject_limit == 0 || _gate_rejects < _gate_reject_limit)
+        {
+            _gate_rejects++;
+            _reject_count++;
+            return;
+        }
+        // 连续超限达到上限说明估计本身已偏离，此后一律采用，直到新息回到门限内
+    }
+    else
+    {
+        _gate_rejects = 0;
+    }
+    _accept_count++;
+
+    // 比力模长偏离重力加速度时 (机动、振动) 放大测量噪声，降低本次校正的权重
+    float deviation = accel_norm - GRAVITY_CONST;
+    float noise_extra = _adaptive_gain * ((deviation >= 0.0f) ? deviation : -deviation);
+    if (noise_extra > 0.0f)
+    {
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            for (uint32_t j = 0; j < 3; j++)
+            {
+                _S(i, j) += _R(i, j) * noise_extra;
+            }
+        }
+        if (!invertSymmetric3x3(_S, _S_inverse))
+        {
+            return;
+        }
+    }
+
+    // 计算卡尔曼增益 K = P * H^T * S^(-1)
     _P.multiply(_H_transpose, _temp_7x3); // temp_7x3 = P * H^T
     _temp_7x3.multiply(_S_inverse, _K); // K = temp_7x3 * S_inverse = P * H^T * S^(-1)
 
     // 更新状态估计
     _K.multiply(_residual, _state_correction); // state_correction = K * residual
 
-    // 应用四元数校正
-    utils::math::Quaternion q_correction(
-        1.0f,
-        _state_correction(0, 0),
-        _state_correction(1, 0),
-        _state_correction(2, 0));
-
-    // 归一化校正四元数
-    q_correction.normalize();
-
-    // 应用四元数校正
-    _quat = _quat * q_correction;
+    // 应用四元数校正：状态量即四元数四个分量，加性校正后重新归一化
+    _quat.w += _state_correction(0, 0);
+    _quat.x += _state_correction(1, 0);
+    _quat.y += _state_correction(2, 0);
+    _quat.z += _state_correction(3, 0);
     _quat.normalize();
 
     // 更新陀螺仪零偏
@@ -290,54 +466,55 @@ void QuaternionEKF::measurementUpdate(const float accel[3])
             _temp_7x7(i, j) = _I(i, j) - _temp_7x7(i, j); // temp_7x7 = I - K * H
         }
     }
-    _temp_7x7.multiply(_P, _P); // P = temp_7x7 * P = (I - K * H) * P
+    _temp_7x7.multiply(_P, _P_next); // P_next = (I - K * H) * P
+    math_matrix_copy(_P_next.getInternal(), _P.getInternal());
 }
 
 /**
  * @brief 计算状态转移矩阵
  * @details 计算状态转移的雅可比矩阵F
  */
-void QuaternionEKF::calculateF(const float gyro[3], utils::math::Matrix &F)
+void QuaternionEKF::calculateF(const float gyro[3], float dt, utils::math::Matrix &F)
 {
     F.setIdentity();
 
     // 四元数对四元数的雅可比矩阵
     F(0, 0) = 1.0f;
-    F(0, 1) = -0.5f * gyro[0] * _dt;
-    F(0, 2) = -0.5f * gyro[1] * _dt;
-    F(0, 3) = -0.5f * gyro[2] * _dt;
+    F(0, 1) = -0.5f * gyro[0] * dt;
+    F(0, 2) = -0.5f * gyro[1] * dt;
+    F(0, 3) = -0.5f * gyro[2] * dt;
 
-    F(1, 0) = 0.5f * gyro[0] * _dt;
+    F(1, 0) = 0.5f * gyro[0] * dt;
     F(1, 1) = 1.0f;
-    F(1, 2) = 0.5f * gyro[2] * _dt;
-    F(1, 3) = -0.5f * gyro[1] * _dt;
+    F(1, 2) = 0.5f * gyro[2] * dt;
+    F(1, 3) = -0.5f * gyro[1] * dt;
 
-    F(2, 0) = 0.5f * gyro[1] * _dt;
-    F(2, 1) = -0.5f * gyro[2] * _dt;
+    F(2, 0) = 0.5f * gyro[1] * dt;
+    F(2, 1) = -0.5f * gyro[2] * dt;
     F(2, 2) = 1.0f;
-    F(2, 3) = 0.5f * gyro[0] * _dt;
+    F(2, 3) = 0.5f * gyro[0] * dt;
 
-    F(3, 0) = 0.5f * gyro[2] * _dt;
-    F(3, 1) = 0.5f * gyro[1] * _dt;
-    F(3, 2) = -0.5f * gyro[0] * _dt;
+    F(3, 0) = 0.5f * gyro[2] * dt;
+    F(3, 1) = 0.5f * gyro[1] * dt;
+    F(3, 2) = -0.5f * gyro[0] * dt;
     F(3, 3) = 1.0f;
 
     // 四元数对陀螺仪零偏的雅可比矩阵
-    F(0, 4) = 0.5f * _quat.x * _dt;
-    F(0, 5) = 0.5f * _quat.y * _dt;
-    F(0, 6) = 0.5f * _quat.z * _dt;
+    F(0, 4) = 0.5f * _quat.x * dt;
+    F(0, 5) = 0.5f * _quat.y * dt;
+    F(0, 6) = 0.5f * _quat.z * dt;
 
-    F(1, 4) = -0.5f * _quat.w * _dt;
-    F(1, 5) = -0.5f * _quat.z * _dt;
-    F(1, 6) = 0.5f * _quat.y * _dt;
+    F(1, 4) = -0.5f * _quat.w * dt;
+    F(1, 5) = 0.5f * _quat.z * dt;
+    F(1, 6) = -0.5f * _quat.y * dt;
 
-    F(2, 4) = 0.5f * _quat.z * _dt;
-    F(2, 5) = -0.5f * _quat.w * _dt;
-    F(2, 6) = -0.5f * _quat.x * _dt;
+    F(2, 4) = -0.5f * _quat.z * dt;
+    F(2, 5) = -0.5f * _quat.w * dt;
+    F(2, 6) = 0.5f * _quat.x * dt;
 
-    F(3, 4) = -0.5f * _quat.y * _dt;
-    F(3, 5) = 0.5f * _quat.x * _dt;
-    F(3, 6) = -0.5f * _quat.w * _dt;
+    F(3, 4) = 0.5f * _quat.y * dt;
+    F(3, 5) = -0.5f * _quat.x * dt;
+    F(3, 6) = -0.5f * _quat.w * dt;
 }
 
 /**
@@ -362,23 +539,24 @@ void QuaternionEKF::calculateH(utils::math::Matrix &H)
     float qy = _quat.y;
     float qz = _quat.z;
 
+    // 预测值 v = [2(xz - wy), 2(yz + wx), w^2 - x^2 - y^2 + z^2] 对四元数各分量的偏导数
     // dR_dq[0] - 加速度计x轴对四元数各分量的偏导数
-    H(0, 0) = 2 * (qy * qz - qw * qx);
-    H(0, 1) = -2 * qw;
-    H(0, 2) = 2 * qz;
-    H(0, 3) = 2 * qy;
+    H(0, 0) = -2 * qy;
+    H(0, 1) = 2 * qz;
+    H(0, 2) = -2 * qw;
+    H(0, 3) = 2 * qx;
 
     // dR_dq[1] - 加速度计y轴对四元数各分量的偏导数
-    H(1, 0) = 2 * (qw * qy + qx * qz);
-    H(1, 1) = 2 * qz;
-    H(1, 2) = 2 * qw;
-    H(1, 3) = 2 * qx;
+    H(1, 0) = 2 * qx;
+    H(1, 1) = 2 * qw;
+    H(1, 2) = 2 * qz;
+    H(1, 3) = 2 * qy;
 
     // dR_dq[2] - 加速度计z轴对四元数各分量的偏导数
-    H(2, 0) = 2 * (qw * qz - qx * qy);
-    H(2, 1) = -2 * qy;
-    H(2, 2) = -2 * qx;
-    H(2, 3) = 2 * qw;
+    H(2, 0) = 2 * qw;
+    H(2, 1) = -2 * qx;
+    H(2, 2) = -2 * qy;
+    H(2, 3) = 2 * qz;
 }
 
 /**
@@ -387,8 +565,8 @@ void QuaternionEKF::calculateH(utils::math::Matrix &H)
  */
 void QuaternionEKF::predictAccel(float accel_pred[3])
 {
-    // 在世界坐标系中，重力方向为 [0, 0, -1]
-    float gravity_world[3] = {0.0f, 0.0f, -1.0f};
+    // 静止时加速度计测得的比力竖直向上，世界坐标系中为 [0, 0, 1] (与 MahonyAHRS 一致)
+    float gravity_world[3] = {0.0f, 0.0f, 1.0f};
 
     // 使用共轭四元数将世界坐标系中的重力旋转到机体坐标系
     utils::math::Quaternion q_conj = _quat.conjugate();
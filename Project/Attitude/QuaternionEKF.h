@@ -41,6 +41,14 @@ public:
      */
     virtual void update(float gyro[3], float accel[3], float mag[3] = nullptr) override;
 
+    /**
+     * @brief 批量更新姿态估计
+     * @details 四元数逐样本积分，协方差按批次平均角速度传播一次，最后做一次加速度计测量更新
+     * @param samples 样本数组，按时间先后排列
+     * @param count 样本数量
+     */
+    virtual void updateBatch(const ImuSample* samples, size_t count) override;
+
     /**
      * @brief 获取欧拉角
      * @param roll 滚转角（绕X轴旋转），单位：rad
@@ -78,6 +86,27 @@ public:
      */
     void setMeasurementNoise(const float R[3][3]);
 
+    /**
+     * @brief 设置加速度计新息门限
+     * @details 新息的马氏距离平方 r^T * S^-1 * r 超过门限时丢弃本次测量，跳过增益与协方差更新；
+     *          3 自由度卡方分布 99% 分位为 11.34，门限为 0 时不做检验
+     * @param chi2 门限
+     * @param reject_limit 连续丢弃达到该次数后一律采用直到新息回到门限内，避免估计偏离后一直被拒绝，0 表示不强制
+     */
+    void setInnovationGate(float chi2, uint32_t reject_limit);
+
+    /**
+     * @brief 设置自适应测量噪声
+     * @details 测量噪声按比力模长偏离重力加速度的程度放大：R' = R * (1 + gain * ||a| - g|)，
+     *          机动时加速度计的修正随之减弱；门限检验仍使用名义 R，放大的噪声不放宽门限
+     * @param gain 放大系数，单位：1/(m/s^2)，0 表示固定噪声
+     */
+    void setAdaptiveNoise(float gain);
+
+    uint32_t getAcceptCount() const { return _accept_count; }
+    uint32_t getRejectCount() const { return _reject_count; }
+    float getLastInnovation() const { return _last_innovation; } // 最近一次新息马氏距离平方
+
 private:
     // 状态变量
     utils::math::Quaternion _quat; // 四元数姿态
@@ -94,6 +123,15 @@ private:
 
     // 采样时间
     float _dt;
+
+    // 新息门限与自适应测量噪声
+    float _gate_chi2;
+    uint32_t _gate_reject_limit;
+    uint32_t _gate_rejects;      // 连续丢弃次数
+    float _adaptive_gain;
+    uint32_t _accept_count;
+    uint32_t _reject_count;
+    float _last_innovation;
     
     // 预先分配的中间矩阵，避免频繁申请和释放内存
     utils::math::Matrix _F;            // 状态转移矩阵 (7x7)
@@ -108,15 +146,23 @@ private:
     utils::math::Matrix _I;            // 单位矩阵 (7x7)
     utils::math::Matrix _temp_7x7;     // 临时矩阵，用于存储计算中间结果 (7x7)
     utils::math::Matrix _temp_7x3;     // 临时矩阵，用于存储计算中间结果 (7x3)
+    utils::math::Matrix _temp_3x7;     // 临时矩阵，用于存储计算中间结果 (3x7)
+    utils::math::Matrix _P_next;       // 更新后的协方差 (7x7)，避免原地相乘时临时申请内存
 
     // 状态转移函数
     void stateTransition(const float gyro[3]);
 
+    // 四元数积分（输入为已去零偏的角速度）
+    void propagateQuaternion(const float gyro_corrected[3], float dt);
+
+    // 协方差传播 P = F * P * F^T + steps * Q
+    void propagateCovariance(const float gyro_corrected[3], float dt, float steps);
+
     // 测量更新函数
     void measurementUpdate(const float accel[3]);
 
     // 状态矩阵和雅可比矩阵
-    void calculateF(const float gyro[3], utils::math::Matrix &F);
+    void calculateF(const float gyro[3], float dt, utils::math::Matrix &F);
     void calculateH(utils::math::Matrix &H);
 
     // 计算预测的重力方向
@@ -0,0 +1,187 @@
+/**
+ * @file file_flash.cpp
+ * @brief 以文件模拟的扇区式闪存实现
+ */
+
+#include "file_flash.h"
+#include <string.h>
+
+FileFlash::FileFlash(const char* path, uint32_t sectorSize, uint32_t sectorCount, uint32_t programUnit)
+    : file_(fopen(path, "w+b")),
+      sector_size_(sectorSize),
+      sector_count_(sectorCount),
+      unit_(programUnit),
+      torn_(sectorSize / programUnit * sectorCount, false),
+      cut_armed_(false),
+      power_lost_(false),
+      ecc_(false),
+      remaining_(0),
+      rand_(1),
+      overwrite_count_(0)
+{
+    // 出厂状态：全部擦除
+    std::vector<uint8_t> blank(sector_size_, 0xFF);
+    for (uint32_t i = 0; file_ != nullptr && i < sector_count_; i++)
+    {
+        store(i * sector_size_, blank.data(), sector_size_);
+    }
+}
+
+FileFlash::~FileFlash()
+{
+    if (file_ != nullptr)
+    {
+        fclose(file_);
+    }
+}
+
+void FileFlash::cutPowerAfter(uint32_t operations, uint32_t seed, bool ecc)
+{
+    cut_armed_ = true;
+    remaining_ = operations;
+    rand_ = seed * 2654435761u + 1u;
+    ecc_ = ecc;
+}
+
+bool FileFlash::read(uint32_t sector, uint32_t offset, void* data, uint32_t size)
+{
+    if (power_lost_ || !access(sector, offset, size))
+    {
+        return false;
+    }
+    if (ecc_ && size > 0)
+    {
+        const uint32_t first = (sector * sector_size_ + offset) / unit_;
+        const uint32_t last = (sector * sector_size_ + offset + size - 1) / unit_;
+        for (uint32_t u = first; u <= last; u++)
+        {
+            if (torn_[u])
+            {
+                return false;
+            }
+        }
+    }
+    return load(sector * sector_size_ + offset, static_cast<uint8_t*>(data), size);
+}
+
+bool FileFlash::program(uint32_t sector, uint32_t offset, const void* data, uint32_t size)
+{
+    if (power_lost_ || !access(sector, offset, size) || (offset % unit_) != 0 || (size % unit_) != 0)
+    {
+        return false;
+    }
+
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    std::vector<uint8_t> old(unit_);
+    for (uint32_t pos = 0; pos < size; pos += unit_)
+    {
+        const uint32_t addr = sector * sector_size_ + offset + pos;
+        if (!load(addr, old.data(), unit_))
+        {
+            return false;
+        }
+        bool blank = !(ecc_ && torn_[addr / unit_]);
+        for (uint32_t i = 0; i < unit_; i++)
+        {
+            blank = blank && old[i] == 0xFF;
+        }
+        if (!blank)
+        {
+            overwrite_count_++;
+            return false;
+        }
+
+        std::vector<uint8_t> word(src + pos, src + pos + unit_);
+        if (interrupted())
+        {
+            // 只有部分位被编程为 0
+            for (uint32_t i = 0; i < unit_; i++)
+            {
+                word[i] |= random();
+            }
+            torn_[addr / unit_] = true;
+            store(addr, word.data(), unit_);
+            return false;
+        }
+        if (!store(addr, word.data(), unit_))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FileFlash::erase(uint32_t sector)
+{
+    if (power_lost_ || sector >= sector_count_)
+    {
+        return false;
+    }
+
+    const uint32_t units = sector_size_ / unit_;
+    uint32_t done = units;
+    const bool cut = interrupted();
+    if (cut)
+    {
+        done = random() % units;
+    }
+
+    std::vector<uint8_t> word(unit_, 0xFF);
+    for (uint32_t u = 0; u < done; u++)
+    {
+        store(sector * sector_size_ + u * unit_, word.data(), unit_);
+        torn_[sector * units + u] = false;
+    }
+    if (cut)
+    {
+        // 擦除被打断的单元只有部分位恢复为 1
+        const uint32_t addr = sector * sector_size_ + done * unit_;
+        load(addr, word.data(), unit_);
+        for (uint32_t i = 0; i < unit_; i++)
+        {
+            word[i] |= random();
+        }
+        store(addr, word.data(), unit_);
+        torn_[sector * units + done] = true;
+        return false;
+    }
+    return true;
+}
+
+bool FileFlash::access(uint32_t sector, uint32_t offset, uint32_t size) const
+{
+    return file_ != nullptr && sector < sector_count_ && offset + size <= sector_size_;
+}
+
+bool FileFlash::interrupted()
+{
+    if (!cut_armed_)
+    {
+        return false;
+    }
+    if (remaining_ > 0)
+    {
+        remaining_--;
+        return false;
+    }
+    cut_armed_ = false;
+    power_lost_ = true;
+    return true;
+}
+
+uint8_t FileFlash::random()
+{
+    rand_ = rand_ * 1103515245u + 12345u;
+    return (uint8_t)(rand_ >> 16);
+}
+
+bool FileFlash::load(uint32_t pos, uint8_t* data, uint32_t size)
+{
+    return fseek(file_, (long)pos, SEEK_SET) == 0 && fread(data, 1, size, file_) == size;
+}
+
+bool FileFlash::store(uint32_t pos, const uint8_t* data, uint32_t size)
+{
+    return fseek(file_, (long)pos, SEEK_SET) == 0 && fwrite(data, 1, size, file_) == size &&
+           fflush(file_) == 0;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file file_flash.h
+ * @brief 以文件模拟的扇区式闪存，可注入掉电
+ * @details 语义与片内闪存一致：擦除后为 0xFF，编程单元擦除后只能写一次。
+ *          掉电按操作计数注入 (每个编程单元、每次扇区擦除各算一次操作)，
+ *          被打断的编程单元只写入一部分位，被打断的擦除只完成前一部分单元；
+ *          ECC 模式下残缺单元读取失败 (对应 STM32H7 的 ECC 双位错误)，否则读出残缺内容。
+ *          掉电后所有操作失败，直到 powerOn() 模拟重新上电。
+ */
+
+#ifndef FILE_FLASH_H
+#define FILE_FLASH_H
+
+#include "flash_kv.h"
+#include <stdio.h>
+#include <vector>
+
+class FileFlash : public utils::FlashDevice
+{
+public:
+    FileFlash(const char* path, uint32_t sectorSize, uint32_t sectorCount, uint32_t programUnit);
+    ~FileFlash() override;
+
+    bool isOpen() const { return file_ != nullptr; }
+
+    uint32_t sectorSize() const override { return sector_size_; }
+    uint32_t sectorCount() const override { return sector_count_; }
+    uint32_t programUnit() const override { return unit_; }
+
+    bool read(uint32_t sector, uint32_t offset, void* data, uint32_t size) override;
+    bool program(uint32_t sector, uint32_t offset, const void* data, uint32_t size) override;
+    bool erase(uint32_t sector) override;
+
+    /**
+     * @brief 再执行 operations 次操作后掉电，第 operations + 1 次操作被打断
+     * @param seed 残缺内容的随机种子
+     * @param ecc 残缺单元读取是否失败
+     */
+    void cutPowerAfter(uint32_t operations, uint32_t seed, bool ecc);
+
+    void powerOn() { power_lost_ = false; cut_armed_ = false; }
+    bool powerLost() const { return power_lost_; }
+
+    /**
+     * @brief 对未擦除单元编程的次数，正确的使用方式下恒为 0
+     */
+    uint32_t getOverwriteCount() const { return overwrite_count_; }
+
+private:
+    FILE* file_;
+    uint32_t sector_size_;
+    uint32_t sector_count_;
+    uint32_t unit_;
+    std::vector<bool> torn_;   // 每个编程单元是否残缺 (ECC 模式下读取失败)
+
+    bool cut_armed_;
+    bool power_lost_;
+    bool ecc_;
+    uint32_t remaining_;
+    uint32_t rand_;
+    uint32_t overwrite_count_;
+
+    bool access(uint32_t sector, uint32_t offset, uint32_t size) const;
+    bool interrupted();
+    uint8_t random();
+    bool load(uint32_t pos, uint8_t* data, uint32_t size);
+    bool store(uint32_t pos, const uint8_t* data, uint32_t size);
+};
+
+#endif // FILE_FLASH_H
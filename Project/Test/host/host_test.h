@@ -0,0 +1,38 @@
+/**
+ * @file host_test.h
+ * @brief 主机单元测试的最小断言工具
+ * @details 断言失败只打印位置并计数，不中断执行，main 最后以 HOST_TEST_RESULT() 返回失败数
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+#include <math.h>
+
+static int host_test_failures = 0;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);  \
+            host_test_failures++;                                            \
+        }                                                                    \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tol)                                                \
+    do {                                                                     \
+        double _a = (double)(a), _b = (double)(b);                           \
+        if (!(fabs(_a - _b) <= (double)(tol))) {                             \
+            printf("%s:%d: CHECK_NEAR(%s, %s) failed: %g vs %g (tol %g)\n",  \
+                   __FILE__, __LINE__, #a, #b, _a, _b, (double)(tol));       \
+            host_test_failures++;                                            \
+        }                                                                    \
+    } while (0)
+
+#define HOST_TEST_RESULT()                                                   \
+    (printf("%s: %s (%d failures)\n", __FILE__,                              \
+            host_test_failures ? "FAIL" : "OK", host_test_failures),         \
+     host_test_failures ? 1 : 0)
+
+#endif // HOST_TEST_H
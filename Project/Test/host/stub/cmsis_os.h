@@ -0,0 +1,22 @@
+/**
+ * @file cmsis_os.h
+ * @brief 主机测试桩：替代 CMSIS-RTOS2 头文件，只提供被测代码用到的 FreeRTOS 堆接口
+ */
+
+#ifndef CMSIS_OS_H_
+#define CMSIS_OS_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+
+static inline void *pvPortMalloc(size_t size)
+{
+    return malloc(size);
+}
+
+static inline void vPortFree(void *ptr)
+{
+    free(ptr);
+}
+
+#endif /* CMSIS_OS_H_ */
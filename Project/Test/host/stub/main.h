@@ -0,0 +1,17 @@
+/**
+ * @file main.h
+ * @brief 主机测试桩：替代 CubeMX 生成的 main.h，只提供被测代码头文件引用到的 HAL 类型
+ */
+
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct {
+    void *Instance;
+    void *hdma[7];
+} TIM_HandleTypeDef;
+
+#endif /* __MAIN_H */
@@ -0,0 +1,11 @@
+/**
+ * @file tim.h
+ * @brief 主机测试桩：替代 CubeMX 生成的 tim.h
+ */
+
+#ifndef __TIM_H__
+#define __TIM_H__
+
+#include "main.h"
+
+#endif /* __TIM_H__ */
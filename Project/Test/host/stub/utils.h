@@ -0,0 +1,12 @@
+/**
+ * @file utils.h
+ * @brief 主机测试桩：替代 utils/utils.h，只引入数学库与内存分配，不引入依赖 HAL 的时间工具
+ */
+
+#ifndef __UTILS_H__
+#define __UTILS_H__
+
+#include "math_utils.h"
+#include "allocator.h"
+
+#endif // __UTILS_H__
@@ -0,0 +1,151 @@
+/**
+ * @file test_accel_calibrator.cpp
+ * @brief AccelCalibrator 椭球拟合测试
+ * @details 已知比例因子与零偏使理想比力失真 (raw = a / scale + bias)，叠加噪声后在均匀分布的
+ *          多个姿态下静置送入，检查拟合结果还原真值；另检查转动窗口被拒绝，
+ *          以及 resetWindow() 丢弃暂停前未结束的窗口。
+ */
+
+#include "host_test.h"
+#include "AccelCalibrator.h"
+#include "math_const.h"
+#include <random>
+
+static const float TRUE_SCALE[3] = {1.04f, 0.97f, 1.015f};
+static const float TRUE_BIAS[3] = {0.35f, -0.6f, 0.25f};   // m/s^2
+
+static const float SAMPLE_DT = 0.0005f;   // 陀螺仪 2 kHz
+static const int ACCEL_DIV = 4;           // 加速度计 500 Hz
+
+static AccelCalibratorConfig_t makeConfig()
+{
+    AccelCalibratorConfig_t config;
+    config.window = 0.25f;
+    config.defaultDt = SAMPLE_DT;
+    config.gyroMax = 0.05f;
+    config.accelStdMax = 0.15f;
+    config.accelNormTol = 0.15f;
+    config.minAngle = 0.35f;
+    config.minPoints = 20;
+    config.varianceMax = 0.2f;
+    config.scaleMax = 0.1f;
+    config.biasMax = 1.5f;
+    return config;
+}
+
+/**
+ * @brief 以机体系重力方向 dir 生成 duration 秒的样本并送入
+ * @param rate 绕机体 X 轴的角速度，单位：rad/s
+ * @return 是否输出了新结果
+ */
+static bool feed(AccelCalibrator &cal, std::mt19937 &rng, const float dir[3], float rate, float duration)
+{
+    std::normal_distribution<float> accelNoise(0.0f, 0.05f);
+    std::normal_distribution<float> gyroNoise(0.0f, 0.003f);
+    const int count = (int)(duration / SAMPLE_DT + 0.5f);
+    bool updated = false;
+    ImuSample batch[4];
+    for (int n = 0; n < count; n += ACCEL_DIV) {
+        for (int k = 0; k < ACCEL_DIV; k++) {
+            ImuSample &s = batch[k];
+            s.gyro[0] = rate + gyroNoise(rng);
+            s.gyro[1] = gyroNoise(rng);
+            s.gyro[2] = gyroNoise(rng);
+            s.accelValid = (k == 0);
+            for (int i = 0; i < 3; i++) {
+                float a = dir[i] * GRAVITY_CONST;
+                s.accel[i] = a / TRUE_SCALE[i] + TRUE_BIAS[i] + accelNoise(rng);
+            }
+            s.dt = SAMPLE_DT;
+        }
+        updated |= cal.push(batch, ACCEL_DIV);
+    }
+    return updated;
+}
+
+// 斐波那契球面上均匀分布的第 i 个方向 (共 n 个)
+static void sphereDir(int i, int n, float dir[3])
+{
+    const float golden = 2.39996323f;
+    float z = 1.0f - 2.0f * ((float)i + 0.5f) / (float)n;
+    float r = sqrtf(1.0f - z * z);
+    dir[0] = r * cosf(golden * (float)i);
+    dir[1] = r * sinf(golden * (float)i);
+    dir[2] = z;
+}
+
+static void testFit()
+{
+    AccelCalibrator cal(makeConfig());
+    std::mt19937 rng(7);
+    const int POSES = 40;
+
+    bool updated = false;
+    int poses = 0;
+    for (int i = 0; i < POSES; i++) {
+        float dir[3];
+        sphereDir(i, POSES, dir);
+        updated |= feed(cal, rng, dir, 0.0f, 0.5f);
+        poses++;
+        if (updated) {
+            break;
+        }
+    }
+    CHECK(updated);
+    CHECK(cal.isCalibrated());
+    CHECK(cal.getPointCount() >= 20);
+    CHECK(cal.getMaxVariance() <= 0.2f);
+
+    float scale[3], bias[3];
+    cal.getCalibration(scale, bias);
+    printf("after %d poses: scale %.4f %.4f %.4f, bias %.3f %.3f %.3f\n", poses,
+           scale[0], scale[1], scale[2], bias[0], bias[1], bias[2]);
+    for (int i = 0; i < 3; i++) {
+        CHECK_NEAR(scale[i], TRUE_SCALE[i], 0.004);
+        CHECK_NEAR(bias[i], TRUE_BIAS[i], 0.04);
+    }
+
+    // 继续送入更多姿态，结果保持在真值附近
+    for (int i = 0; i < POSES; i++) {
+        float dir[3];
+        sphereDir((i * 7) % POSES, POSES, dir);
+        feed(cal, rng, dir, 0.0f, 0.5f);
+    }
+    cal.getCalibration(scale, bias);
+    for (int i = 0; i < 3; i++) {
+        CHECK_NEAR(scale[i], TRUE_SCALE[i], 0.004);
+        CHECK_NEAR(bias[i], TRUE_BIAS[i], 0.04);
+    }
+}
+
+static void testRejectAndPause()
+{
+    AccelCalibrator cal(makeConfig());
+    std::mt19937 rng(11);
+    const float up[3] = {0.0f, 0.0f, 1.0f};
+    const float side[3] = {1.0f, 0.0f, 0.0f};
+
+    // 转动中的窗口不是拟合点
+    feed(cal, rng, up, 0.5f, 1.0f);
+    CHECK(cal.getPointCount() == 0);
+
+    // 窗口时长按样本间隔累加，多送一点保证窗口结束
+    cal.resetWindow();
+    feed(cal, rng, up, 0.0f, 0.3f);
+    CHECK(cal.getPointCount() == 1);
+
+    // 半个窗口的转动后暂停：丢弃未结束的窗口，恢复后的静止窗口完整有效；
+    // 不丢弃时转动样本混入恢复后的第一个窗口，该窗口被拒绝
+    cal.resetWindow();
+    feed(cal, rng, side, 0.5f, 0.125f);
+    cal.resetWindow();
+    feed(cal, rng, side, 0.0f, 0.3f);
+    CHECK(cal.getPointCount() == 2);
+}
+
+int main()
+{
+    testFit();
+    testRejectAndPause();
+    return HOST_TEST_RESULT();
+}
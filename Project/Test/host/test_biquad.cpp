@@ -0,0 +1,202 @@
+/**
+ * @file test_biquad.cpp
+ * @brief 二阶节系数设计与 BiquadBank 滤波测试
+ * @details 以正弦激励测量稳态增益，与双线性变换巴特沃斯的解析幅频
+ *          |H| = 1 / sqrt(1 + (tan(pi f / fs) / tan(pi fc / fs))^(2N)) 比较；
+ *          检查陷波中心衰减与带外直通、退化参数回到直通，
+ *          以及 BiquadBank 的块处理、单样本处理与逐节 Biquad_Apply 结果一致、各通道互不串扰。
+ */
+
+#include "host_test.h"
+#include "math_biquad.h"
+
+static const double PI = 3.14159265358979323846;
+
+// 以频率 f 的正弦激励滤波器，跳过暂态后在整数个周期上做单频点 DFT，得到输出与输入幅值之比
+template<typename Filter>
+static double measureGain(Filter filter, double fs, double f)
+{
+    const int settle = (int)(fs * 0.5);
+    const int measure = (int)fs; // 1 s，整数频率对应整数个周期
+    double si = 0.0, co = 0.0;
+    for (int n = 0; n < settle + measure; n++)
+    {
+        double phase = 2.0 * PI * f * n / fs;
+        float y = filter((float)sin(phase));
+        if (n >= settle)
+        {
+            si += y * sin(phase);
+            co += y * cos(phase);
+        }
+    }
+    return 2.0 * sqrt(si * si + co * co) / measure;
+}
+
+static double butterworthGain(double fs, double fc, int order, double f)
+{
+    double r = tan(PI * f / fs) / tan(PI * fc / fs);
+    return 1.0 / sqrt(1.0 + pow(r, 2.0 * order));
+}
+
+static void testLowpassResponse()
+{
+    const float fs = 2000.0f, fc = 200.0f;
+    const double freqs[] = {20.0, 100.0, 200.0, 300.0, 500.0, 800.0};
+
+    for (uint32_t stages = 1; stages <= 3; stages++)
+    {
+        for (double f : freqs)
+        {
+            utils::BiquadBank<1, 3> bank;
+            CHECK(bank.setLowpass(fs, fc, stages));
+            CHECK(bank.stages() == stages);
+            double gain = measureGain([&bank](float x) { bank.apply(&x); return x; }, fs, f);
+            CHECK_NEAR(gain, butterworthGain(fs, fc, 2 * stages, f), 2e-3);
+        }
+    }
+
+    // 截止频率处 -3 dB
+    utils::BiquadBank<1, 2> bank;
+    CHECK(bank.setLowpass(fs, fc, 2));
+    double gain = measureGain([&bank](float x) { bank.apply(&x); return x; }, fs, fc);
+    CHECK_NEAR(20.0 * log10(gain), -3.0103, 0.02);
+}
+
+static void testNotch()
+{
+    const float fs = 2000.0f, fc = 250.0f, q = 5.0f;
+    BiquadCoeffs_t c;
+    Biquad_Notch(&c, fs, fc, q);
+
+    float state[2];
+    auto notch = [&c, &state](float x) { return Biquad_Apply(&c, state, x); };
+
+    state[0] = state[1] = 0.0f;
+    CHECK(measureGain(notch, fs, fc) < 1e-3);
+    // 预畸变域内 |W - 1/W| = 1/q 处为 -3 dB，映射回数字频率取整后测量
+    double w_hi = sqrt(1.0 + 1.0 / (4.0 * q * q)) + 1.0 / (2.0 * q);
+    double f_hi = fs / PI * atan(w_hi * tan(PI * fc / fs));
+    double w = tan(PI * round(f_hi) / fs) / tan(PI * fc / fs);
+    double expect = fabs(w - 1.0 / w) / sqrt((w - 1.0 / w) * (w - 1.0 / w) + 1.0 / (q * q));
+    CHECK_NEAR(expect, sqrt(0.5), 0.01);
+    state[0] = state[1] = 0.0f;
+    CHECK_NEAR(measureGain(notch, fs, round(f_hi)), expect, 2e-3);
+    state[0] = state[1] = 0.0f;
+    CHECK_NEAR(measureGain(notch, fs, 20.0), 1.0, 1e-3);
+    state[0] = state[1] = 0.0f;
+    CHECK_NEAR(measureGain(notch, fs, 900.0), 1.0, 2e-3);
+
+    // 带阻以几何中心陷波
+    BiquadCoeffs_t b;
+    Biquad_Bandstop(&b, fs, 200.0f, 300.0f);
+    auto bandstop = [&b, &state](float x) { return Biquad_Apply(&b, state, x); };
+    state[0] = state[1] = 0.0f;
+    CHECK(measureGain(bandstop, fs, sqrt(200.0 * 300.0)) < 1e-3);
+}
+
+static void testDegenerateIsPassthrough()
+{
+    BiquadCoeffs_t c;
+    Biquad_Lowpass(&c, 2000.0f, 1000.0f, 0.7071f);
+    CHECK(c.b0 == 1.0f && c.b1 == 0.0f && c.b2 == 0.0f && c.a1 == 0.0f && c.a2 == 0.0f);
+    Biquad_Notch(&c, 2000.0f, 0.0f, 5.0f);
+    CHECK(c.b0 == 1.0f && c.b1 == 0.0f && c.b2 == 0.0f && c.a1 == 0.0f && c.a2 == 0.0f);
+    Biquad_Bandstop(&c, 2000.0f, 300.0f, 200.0f);
+    CHECK(c.b0 == 1.0f && c.b1 == 0.0f && c.b2 == 0.0f && c.a1 == 0.0f && c.a2 == 0.0f);
+
+    utils::BiquadBank<2, 3> bank;
+    CHECK(!bank.setLowpass(2000.0f, 100.0f, 0));
+    CHECK(!bank.setLowpass(2000.0f, 100.0f, 4));
+    CHECK(!bank.setStage(3, c));
+
+    // 只设置第 2 节时前面的节为直通
+    BiquadCoeffs_t lp;
+    Biquad_Lowpass(&lp, 2000.0f, 100.0f, 0.7071f);
+    CHECK(bank.setStage(2, lp));
+    CHECK(bank.stages() == 3);
+    float single[2] = {0.0f, 0.0f};
+    for (int n = 0; n < 200; n++)
+    {
+        float x = (float)((n * 37) % 17) - 8.0f;
+        float v[2] = {x, -x};
+        bank.apply(v);
+        float ref = Biquad_Apply(&lp, single, x);
+        CHECK_NEAR(v[0], ref, 1e-6);
+        CHECK_NEAR(v[1], -ref, 1e-6);
+    }
+
+    // 清空后为直通
+    bank.clear();
+    float v[2] = {1.5f, -2.5f};
+    bank.apply(v);
+    CHECK(v[0] == 1.5f && v[1] == -2.5f);
+}
+
+static void testBankConsistency()
+{
+    const uint32_t CH = 3, BLOCK = 64, BLOCKS = 8;
+    const float fs = 2000.0f;
+
+    utils::BiquadBank<CH, 2> blockBank;
+    utils::BiquadBank<CH, 2> sampleBank;
+    CHECK(blockBank.setLowpass(fs, 150.0f, 2));
+    CHECK(sampleBank.setLowpass(fs, 150.0f, 2));
+
+    BiquadCoeffs_t c[2];
+    Biquad_Lowpass(&c[0], fs, 150.0f, Biquad_ButterworthQ(2, 0));
+    Biquad_Lowpass(&c[1], fs, 150.0f, Biquad_ButterworthQ(2, 1));
+    float ref_state[CH][2][2] = {};
+
+    float buf[CH][BLOCK];
+    float *data[CH] = {buf[0], buf[1], buf[2]};
+    for (uint32_t blk = 0; blk < BLOCKS; blk++)
+    {
+        for (uint32_t n = 0; n < BLOCK; n++)
+        {
+            double t = (blk * BLOCK + n) / fs;
+            buf[0][n] = (float)sin(2.0 * PI * 30.0 * t);
+            buf[1][n] = (float)(0.5 * sin(2.0 * PI * 400.0 * t) + 0.1);
+            buf[2][n] = (n % 7 == 0) ? 1.0f : 0.0f;
+        }
+
+        float expect[CH][BLOCK];
+        float single[CH][BLOCK];
+        for (uint32_t n = 0; n < BLOCK; n++)
+        {
+            float v[CH];
+            for (uint32_t ch = 0; ch < CH; ch++)
+            {
+                float y = buf[ch][n];
+                y = Biquad_Apply(&c[0], ref_state[ch][0], y);
+                y = Biquad_Apply(&c[1], ref_state[ch][1], y);
+                expect[ch][n] = y;
+                v[ch] = buf[ch][n];
+            }
+            sampleBank.apply(v);
+            for (uint32_t ch = 0; ch < CH; ch++)
+            {
+                single[ch][n] = v[ch];
+            }
+        }
+
+        blockBank.process(data, BLOCK);
+
+        for (uint32_t ch = 0; ch < CH; ch++)
+        {
+            for (uint32_t n = 0; n < BLOCK; n++)
+            {
+                CHECK_NEAR(buf[ch][n], expect[ch][n], 1e-5);
+                CHECK_NEAR(single[ch][n], expect[ch][n], 1e-5);
+            }
+        }
+    }
+}
+
+int main()
+{
+    testLowpassResponse();
+    testNotch();
+    testDegenerateIsPassthrough();
+    testBankConsistency();
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,201 @@
+/**
+ * @file test_delta_angle.cpp
+ * @brief DeltaAngleIntegrator 圆锥补偿精度测试
+ * @details VirtualIMU 以 2 kHz 输出经典圆锥运动，积分器每 4 个样本输出一次等效旋转。
+ *          逐区间把 exp(phi) 与解析真值增量 q(t0)^* x q(t1) 比较，
+ *          并把输出旋转连乘 10 s 后与 q(t_end) 比较；同时以不做补偿的角增量直接求和作对照。
+ *          另检查样本间隔累加有舍入误差的采样率下，每次输出都恰好包含相同数目的样本。
+ */
+
+#include "host_test.h"
+#include "DeltaAngleIntegrator.h"
+#include "VirtualIMU.h"
+
+static void quatMul(const double a[4], const double b[4], double r[4])
+{
+    double w = a[0] * b[0] - a[1] * b[1] - a[2] * b[2] - a[3] * b[3];
+    double x = a[0] * b[1] + a[1] * b[0] + a[2] * b[3] - a[3] * b[2];
+    double y = a[0] * b[2] - a[1] * b[3] + a[2] * b[0] + a[3] * b[1];
+    double z = a[0] * b[3] + a[1] * b[2] - a[2] * b[1] + a[3] * b[0];
+    r[0] = w; r[1] = x; r[2] = y; r[3] = z;
+}
+
+static void quatConj(const double q[4], double r[4])
+{
+    r[0] = q[0]; r[1] = -q[1]; r[2] = -q[2]; r[3] = -q[3];
+}
+
+static void quatFromRotVec(const double phi[3], double q[4])
+{
+    double angle = sqrt(phi[0] * phi[0] + phi[1] * phi[1] + phi[2] * phi[2]);
+    double k = (angle > 1e-12) ? sin(0.5 * angle) / angle : 0.5;
+    q[0] = cos(0.5 * angle);
+    q[1] = phi[0] * k;
+    q[2] = phi[1] * k;
+    q[3] = phi[2] * k;
+}
+
+static void quatNormalize(double q[4])
+{
+    double n = sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    for (int i = 0; i < 4; i++) q[i] /= n;
+}
+
+// 两个姿态之间的旋转角，单位：rad
+static double quatAngleBetween(const double a[4], const double b[4])
+{
+    double ac[4], e[4];
+    quatConj(a, ac);
+    quatMul(ac, b, e);
+    double v = sqrt(e[1] * e[1] + e[2] * e[2] + e[3] * e[3]);
+    return 2.0 * atan2(v, fabs(e[0]));
+}
+
+/**
+ * @brief 以 sampleRate 送入样本，检查每次输出都恰好包含 samplesPerOutput 个样本
+ */
+static void checkSamplesPerOutput(float sampleRate, int samplesPerOutput)
+{
+    const float dt = 1.0f / sampleRate;
+    DeltaAngleIntegrator integrator(samplesPerOutput / sampleRate, dt);
+
+    ImuSample s = {};
+    s.dt = dt;
+    int count = 0;
+    int mismatch = 0;
+    for (int n = 0; n < samplesPerOutput * 1000; n++)
+    {
+        count++;
+        if (!integrator.put(s))
+        {
+            continue;
+        }
+        ImuSample out;
+        integrator.take(out);
+        if (count != samplesPerOutput)
+        {
+            mismatch++;
+        }
+        count = 0;
+    }
+    CHECK(mismatch == 0);
+}
+
+int main()
+{
+    // 1/1600 与 1/3000 累加后略小于输出周期
+    checkSamplesPerOutput(1600.0f, 5);
+    checkSamplesPerOutput(3000.0f, 3);
+    checkSamplesPerOutput(2000.0f, 4);
+
+    const float sampleRate = 2000.0f;
+    const int samplesPerOutput = 4;
+    const double duration = 10.0;
+
+    VirtualIMUConfig_t cfg;
+    cfg.sampleRate = sampleRate;
+    cfg.coneAngle = 5.0f * 3.14159265f / 180.0f;
+    cfg.coneFrequency = 20.0f;
+    cfg.gravity = 9.80665f;
+
+    VirtualIMU imu(cfg);
+    CHECK(imu.init());
+
+    // 真值角速度与姿态自洽：q' = 0.5 q x [0, w]
+    {
+        const double t = 0.0123, h = 1e-6;
+        double q0[4], q1[4], qc[4], dq[4], w[3];
+        imu.getAttitude(t - h, q0);
+        imu.getAttitude(t + h, q1);
+        quatConj(q0, qc);
+        quatMul(qc, q1, dq);
+        imu.getRate(t, w);
+        for (int i = 0; i < 3; i++)
+        {
+            CHECK_NEAR(dq[i + 1] / h, w[i], 1e-4);
+        }
+    }
+
+    DeltaAngleIntegrator integrator(samplesPerOutput / sampleRate, 1.0f / sampleRate);
+
+    double qComp[4], qRaw[4];
+    imu.getAttitude(0.0, qComp);
+    imu.getAttitude(0.0, qRaw);
+
+    double alpha[3] = {0.0, 0.0, 0.0};
+    double maxStepErrComp = 0.0;
+    double maxStepErrRaw = 0.0;
+    int outputs = 0;
+    int samplesInInterval = 0;
+    double t0 = imu.getTime();
+
+    const int totalSamples = (int)(duration * sampleRate);
+    for (int n = 0; n < totalSamples; n++)
+    {
+        ImuSample s;
+        CHECK(imu.readBatch(&s, 1) == 1);
+        CHECK_NEAR(s.accel[0] * s.accel[0] + s.accel[1] * s.accel[1] + s.accel[2] * s.accel[2],
+                   cfg.gravity * cfg.gravity, 1e-3);
+
+        for (int i = 0; i < 3; i++) alpha[i] += (double)s.gyro[i] * s.dt;
+        samplesInInterval++;
+
+        bool ready = integrator.put(s);
+        CHECK(ready == (samplesInInterval == samplesPerOutput));
+        if (!ready)
+        {
+            continue;
+        }
+
+        ImuSample out;
+        CHECK(integrator.take(out));
+        CHECK_NEAR(out.dt, samplesPerOutput / sampleRate, 1e-7);
+        CHECK(out.accelValid);
+
+        double phi[3], dqComp[4], dqRaw[4];
+        for (int i = 0; i < 3; i++) phi[i] = (double)out.gyro[i] * out.dt;
+        quatFromRotVec(phi, dqComp);
+        quatFromRotVec(alpha, dqRaw);
+
+        // 解析真值增量 q(t0)^* x q(t1)
+        double t1 = imu.getTime();
+        double qa[4], qb[4], qac[4], dqTrue[4];
+        imu.getAttitude(t0, qa);
+        imu.getAttitude(t1, qb);
+        quatConj(qa, qac);
+        quatMul(qac, qb, dqTrue);
+
+        double errComp = quatAngleBetween(dqTrue, dqComp);
+        double errRaw = quatAngleBetween(dqTrue, dqRaw);
+        if (errComp > maxStepErrComp) maxStepErrComp = errComp;
+        if (errRaw > maxStepErrRaw) maxStepErrRaw = errRaw;
+
+        quatMul(qComp, dqComp, qComp);
+        quatMul(qRaw, dqRaw, qRaw);
+        quatNormalize(qComp);
+        quatNormalize(qRaw);
+
+        alpha[0] = alpha[1] = alpha[2] = 0.0;
+        samplesInInterval = 0;
+        t0 = t1;
+        outputs++;
+    }
+
+    CHECK(outputs == totalSamples / samplesPerOutput);
+
+    double qEnd[4];
+    imu.getAttitude(imu.getTime(), qEnd);
+    double driftComp = quatAngleBetween(qEnd, qComp);
+    double driftRaw = quatAngleBetween(qEnd, qRaw);
+
+    printf("step error: compensated %.3g rad, uncompensated %.3g rad\n", maxStepErrComp, maxStepErrRaw);
+    printf("drift after %.0f s: compensated %.3g rad, uncompensated %.3g rad\n", duration, driftComp, driftRaw);
+
+    // 未补偿时圆锥误差沿 X 轴单调累积，补偿后应小一个数量级以上
+    CHECK(driftRaw > 1e-2);
+    CHECK(driftComp < 1e-3);
+    CHECK(driftComp * 20.0 < driftRaw);
+    CHECK(maxStepErrComp * 20.0 < maxStepErrRaw);
+
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,188 @@
+/**
+ * @file test_dshot.cpp
+ * @brief DShot 帧编码与 eRPM 回传解码测试
+ * @details 覆盖：校验和与遥测位、双向模式的反相校验和、
+ *          全部 12 位回传值的 GCR 编码往返、非法 GCR 符号与校验错误的拒绝、
+ *          由边沿时间戳还原原始码
+ */
+
+#include "host_test.h"
+#include "dshot.h"
+
+// 4B -> 5B GCR 编码表，与解码表互逆
+static const uint8_t kGcrEncode[16] = {
+    0x19, 0x1B, 0x12, 0x13, 0x1D, 0x15, 0x16, 0x17,
+    0x1A, 0x09, 0x0A, 0x0B, 0x1E, 0x0D, 0x0E, 0x0F,
+};
+
+// 12 位 [exponent:3][mantissa:9] 加校验后按 GCR 展开为 20 位
+static uint32_t gcrFromNibbles(uint32_t data16)
+{
+    uint32_t gcr = 0;
+    for (int i = 3; i >= 0; i--)
+    {
+        gcr = (gcr << 5) | kGcrEncode[(data16 >> (4 * i)) & 0x0Fu];
+    }
+    return gcr;
+}
+
+static uint32_t telemetryData(uint32_t value12)
+{
+    uint32_t csum = value12 ^ (value12 >> 4) ^ (value12 >> 8);
+    csum = ~csum & 0x0Fu;
+    return (value12 << 4) | csum;
+}
+
+// decodeErpm 先做 gcr = raw ^ (raw >> 1)，这里从最高位 (起始位 1) 向下求逆
+static uint32_t rawFromGcr(uint32_t gcr)
+{
+    uint32_t raw = 1u << 20;
+    for (int i = 19; i >= 0; i--)
+    {
+        uint32_t prev = (raw >> (i + 1)) & 1u;
+        raw |= (prev ^ ((gcr >> i) & 1u)) << i;
+    }
+    return raw;
+}
+
+static uint32_t expectedErpm(uint32_t value12)
+{
+    if (value12 == 0x0FFFu)
+    {
+        return 0;
+    }
+    uint32_t period = (value12 & 0x01FFu) << (value12 >> 9);
+    if (period == 0)
+    {
+        return DShotBus::ERPM_INVALID;
+    }
+    return (60000000u + period / 2) / period;
+}
+
+static void testEncodeFrame()
+{
+    // DShot 规范示例：油门 1046，无遥测 -> 1000001011000110
+    CHECK(DShotBus::encodeFrame(1046, false, false) == 0x82C6);
+    // 双向模式校验和取反
+    CHECK(DShotBus::encodeFrame(1046, false, true) == 0x82C9);
+    // 遥测位位于第 4 位，并参与校验
+    CHECK(DShotBus::encodeFrame(1046, true, false) == 0x82D7);
+    CHECK(DShotBus::encodeFrame(0, false, false) == 0x0000);
+    CHECK(DShotBus::encodeFrame(0, false, true) == 0x000F);
+    // 超过 11 位的输入被截断
+    CHECK(DShotBus::encodeFrame(0x0800 | 48, false, false) == DShotBus::encodeFrame(48, false, false));
+
+    for (uint16_t value = 0; value <= DShotBus::THROTTLE_MAX; value++)
+    {
+        for (int telem = 0; telem < 2; telem++)
+        {
+            for (int bidir = 0; bidir < 2; bidir++)
+            {
+                uint16_t frame = DShotBus::encodeFrame(value, telem != 0, bidir != 0);
+                CHECK((frame >> 5) == value);
+                CHECK(((frame >> 4) & 1u) == (uint16_t)telem);
+                uint16_t x = frame ^ (frame >> 4) ^ (frame >> 8) ^ (frame >> 12);
+                CHECK((x & 0x0Fu) == (bidir ? 0x0Fu : 0x00u));
+            }
+        }
+    }
+}
+
+static void testDecodeRoundTrip()
+{
+    for (uint32_t value12 = 0; value12 < 0x1000u; value12++)
+    {
+        uint32_t raw = rawFromGcr(gcrFromNibbles(telemetryData(value12)));
+        CHECK(DShotBus::decodeErpm(raw) == expectedErpm(value12));
+    }
+
+    // 具体数值：周期 1000us -> 60000 eRPM
+    uint32_t raw = rawFromGcr(gcrFromNibbles(telemetryData((1u << 9) | 500u)));
+    CHECK(DShotBus::decodeErpm(raw) == 60000u);
+}
+
+static void testDecodeRejects()
+{
+    static const uint8_t invalid[] = {0x00, 0x01, 0x08, 0x0C, 0x10, 0x11, 0x14, 0x18, 0x1C, 0x1F};
+    const uint32_t data = telemetryData((2u << 9) | 321u);
+
+    for (int group = 0; group < 4; group++)
+    {
+        for (uint8_t code : invalid)
+        {
+            uint32_t gcr = gcrFromNibbles(data);
+            gcr &= ~(0x1Fu << (5 * group));
+            gcr |= (uint32_t)code << (5 * group);
+            CHECK(DShotBus::decodeErpm(rawFromGcr(gcr)) == DShotBus::ERPM_INVALID);
+        }
+    }
+
+    // 合法符号但校验和错误
+    for (int bit = 0; bit < 16; bit++)
+    {
+        uint32_t raw = rawFromGcr(gcrFromNibbles(data ^ (1u << bit)));
+        CHECK(DShotBus::decodeErpm(raw) == DShotBus::ERPM_INVALID);
+    }
+}
+
+// 原始码中每个 1 对应一次电平翻转，按翻转位置生成输入捕获时间戳
+static uint8_t edgesFromRaw(uint32_t raw, uint32_t start, uint32_t ticks_per_bit, uint32_t *edges)
+{
+    uint8_t count = 0;
+    for (int i = 20; i >= 0; i--)
+    {
+        if (raw & (1u << i))
+        {
+            edges[count++] = start + (uint32_t)(20 - i) * ticks_per_bit;
+        }
+    }
+    return count;
+}
+
+static void testEdgesToRaw()
+{
+    const uint32_t tpb = 100;
+    int checked = 0;
+
+    for (uint32_t value12 = 0; value12 < 0x1000u; value12 += 7)
+    {
+        uint32_t raw = rawFromGcr(gcrFromNibbles(telemetryData(value12)));
+        uint32_t edges[21];
+        uint8_t count = edgesFromRaw(raw, 0xFFFFFF00u, tpb, edges); // 覆盖计数器回绕
+
+        // 末尾最多补齐 3 个比特，最后一次翻转更早的帧无法还原
+        uint32_t lowest = 0;
+        while (!(raw & (1u << lowest))) lowest++;
+        if (lowest > 3)
+        {
+            CHECK(DShotBus::edgesToRaw(edges, count, tpb) == 0);
+            continue;
+        }
+        CHECK(DShotBus::edgesToRaw(edges, count, tpb) == raw);
+
+        // 相邻间隔的抖动不超过半个比特时结果不变
+        for (uint8_t i = 1; i < count; i++)
+        {
+            edges[i] += (i & 1) ? tpb / 5 : 0u - tpb / 5;
+        }
+        CHECK(DShotBus::edgesToRaw(edges, count, tpb) == raw);
+        CHECK(DShotBus::decodeErpm(DShotBus::edgesToRaw(edges, count, tpb)) == expectedErpm(value12));
+        checked++;
+    }
+    CHECK(checked > 0);
+
+    uint32_t edges[2] = {0, 100};
+    CHECK(DShotBus::edgesToRaw(nullptr, 2, tpb) == 0);
+    CHECK(DShotBus::edgesToRaw(edges, 1, tpb) == 0);
+    CHECK(DShotBus::edgesToRaw(edges, 2, 0) == 0);
+    CHECK(DShotBus::edgesToRaw(edges, 2, tpb) == 0); // 比特数不足
+}
+
+int main()
+{
+    testEncodeFrame();
+    testDecodeRoundTrip();
+    testDecodeRejects();
+    testEdgesToRaw();
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,187 @@
+/**
+ * @file test_dynamic_notch.cpp
+ * @brief DynamicNotch 合成振动测试
+ * @details 以 2 kHz 输入带噪声的合成电机振动 (两根谱线)，检查：
+ *          两个陷波收敛到振动频率并在滤波器组中实际衰减该频率；
+ *          振动频率缓慢漂移时各陷波继续跟踪原来的谱线；
+ *          一根谱线消失后对应陷波恢复直通；新谱线出现时交给空闲陷波，已跟踪的陷波不被改派。
+ */
+
+#include "host_test.h"
+#include "DynamicNotch.h"
+
+static const double PI = 3.14159265358979323846;
+static const float FS = 2000.0f;
+
+struct Tone
+{
+    double freq;
+    double amp;
+    double phase;
+};
+
+class Vibration
+{
+public:
+    Vibration() : _seed(12345u), _t(0) {}
+
+    Tone tones[2] = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+
+    void next(float gyro[3])
+    {
+        double v = 0.0;
+        for (Tone &tone : tones)
+        {
+            v += tone.amp * sin(tone.phase);
+            tone.phase += 2.0 * PI * tone.freq / FS;
+        }
+        // 三轴振动幅度不同并叠加白噪声
+        gyro[0] = (float)(v + noise());
+        gyro[1] = (float)(0.6 * v + noise());
+        gyro[2] = (float)(0.3 * v + noise());
+        _t++;
+    }
+
+private:
+    uint32_t _seed;
+    uint32_t _t;
+
+    double noise()
+    {
+        _seed = _seed * 1664525u + 1013904223u;
+        return 0.02 * ((double)(_seed >> 8) / (double)(1u << 24) - 0.5);
+    }
+};
+
+static void run(DynamicNotch &notch, Vibration &vib, float seconds)
+{
+    for (int n = 0; n < (int)(seconds * FS); n++)
+    {
+        float gyro[3];
+        vib.next(gyro);
+        notch.push(gyro);
+        notch.step();
+    }
+}
+
+// 对滤波器组的副本输入纯正弦，测量稳态增益
+static double bankGain(const ImuFilterBank &bank, double freq)
+{
+    ImuFilterBank copy = bank;
+    copy.reset();
+    double peak = 0.0;
+    for (int n = 0; n < (int)FS; n++)
+    {
+        float x[3];
+        x[0] = x[1] = x[2] = (float)sin(2.0 * PI * freq * n / FS);
+        copy.apply(x);
+        if (n > (int)FS / 2 && fabs(x[0]) > peak)
+        {
+            peak = fabs(x[0]);
+        }
+    }
+    return peak;
+}
+
+// 返回中心频率距 freq 不超过 tol 的陷波下标，没有时返回 -1
+static int stageAt(const DynamicNotch &notch, double freq, double tol)
+{
+    for (uint32_t i = 0; i < DynamicNotch::MAX_NOTCHES; i++)
+    {
+        if (notch.getCenterFreq(i) > 0.0f && fabs(notch.getCenterFreq(i) - freq) <= tol)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+int main()
+{
+    DynamicNotchConfig_t cfg;
+    cfg.sampleFreq = FS;
+    cfg.decimation = 2;
+    cfg.minFreq = 80.0f;
+    cfg.maxFreq = 450.0f;
+    cfg.q = 3.5f;
+    cfg.notchCount = 2;
+    cfg.firstStage = 0;
+    cfg.smoothing = 0.3f;
+    cfg.threshold = 3.0f;
+
+    ImuFilterBank bank;
+    DynamicNotch notch(cfg);
+    CHECK(notch.init(&bank));
+    CHECK(bank.stages() == 2);
+    CHECK(notch.getCenterFreq(0) == 0.0f && notch.getCenterFreq(1) == 0.0f);
+
+    const double tol = 4.0; // 约半个频率分辨率
+    Vibration vib;
+
+    // 1. 纯噪声：没有超过阈值的峰值，陷波保持直通
+    run(notch, vib, 0.5f);
+    CHECK(notch.getUpdateCount() > 0);
+    CHECK(notch.getCenterFreq(0) == 0.0f && notch.getCenterFreq(1) == 0.0f);
+
+    // 2. 两根谱线，幅度不同
+    vib.tones[0] = {180.0, 0.5, 0.0};
+    vib.tones[1] = {310.0, 0.3, 0.0};
+    run(notch, vib, 1.0f);
+    int s180 = stageAt(notch, 180.0, tol);
+    int s310 = stageAt(notch, 310.0, tol);
+    CHECK(s180 >= 0 && s310 >= 0 && s180 != s310);
+    CHECK(bankGain(bank, 180.0) < 0.1);
+    CHECK(bankGain(bank, 310.0) < 0.1);
+    CHECK(bankGain(bank, 20.0) > 0.95);
+
+    // 3. 幅度对调并让 180 Hz 谱线缓慢漂移到 220 Hz，各陷波仍跟踪原谱线
+    vib.tones[0].amp = 0.2;
+    vib.tones[1].amp = 0.6;
+    for (int i = 1; i <= 40; i++)
+    {
+        vib.tones[0].freq = 180.0 + i;
+        run(notch, vib, 0.05f);
+        CHECK(stageAt(notch, vib.tones[0].freq, 2.0 * tol) == s180);
+        CHECK(stageAt(notch, 310.0, tol) == s310);
+    }
+    run(notch, vib, 0.5f);
+    CHECK(stageAt(notch, 220.0, tol) == s180);
+    CHECK(bankGain(bank, 220.0) < 0.1);
+
+    // 4. 310 Hz 谱线消失：该陷波恢复直通，另一个不受影响
+    vib.tones[1].amp = 0.0;
+    run(notch, vib, 0.5f);
+    CHECK(notch.getCenterFreq(s310) == 0.0f);
+    CHECK(stageAt(notch, 220.0, tol) == s180);
+    CHECK(bankGain(bank, 220.0) < 0.1);
+    {
+        // 滤波器组应只剩一个陷波：与仅含该陷波的参考滤波器组响应相同
+        ImuFilterBank ref;
+        BiquadCoeffs_t c;
+        Biquad_Passthrough(&c);
+        ref.setStage(s310, c);
+        Biquad_Notch(&c, FS, notch.getCenterFreq(s180), cfg.q);
+        ref.setStage(s180, c);
+        CHECK_NEAR(bankGain(bank, 310.0), bankGain(ref, 310.0), 1e-4);
+        CHECK_NEAR(bankGain(bank, 150.0), bankGain(ref, 150.0), 1e-4);
+    }
+
+    // 5. 在已跟踪频率之下出现新谱线：交给空闲陷波，已跟踪的陷波不改派
+    vib.tones[1] = {120.0, 0.8, 0.0};
+    run(notch, vib, 1.0f);
+    CHECK(stageAt(notch, 220.0, tol) == s180);
+    CHECK(stageAt(notch, 120.0, tol) == s310);
+    CHECK(bankGain(bank, 120.0) < 0.1);
+    CHECK(bankGain(bank, 220.0) < 0.1);
+
+    // 6. 振动全部消失，两个陷波都恢复直通
+    vib.tones[0].amp = 0.0;
+    vib.tones[1].amp = 0.0;
+    run(notch, vib, 0.5f);
+    CHECK(notch.getCenterFreq(0) == 0.0f && notch.getCenterFreq(1) == 0.0f);
+    CHECK(bankGain(bank, 220.0) > 0.99 && bankGain(bank, 120.0) > 0.99);
+
+    printf("centers: %.1f Hz, %.1f Hz after %u rounds\n",
+           notch.getCenterFreq(0), notch.getCenterFreq(1), notch.getUpdateCount());
+    return HOST_TEST_RESULT();
+}
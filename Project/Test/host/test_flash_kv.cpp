@@ -0,0 +1,258 @@
+/**
+ * @file test_flash_kv.cpp
+ * @brief utils::FlashKV 在文件模拟闪存上的测试
+ * @details 覆盖读写与版本/长度校验、反复写入触发的扇区整理，以及 set() 与整理过程中
+ *          每一个编程单元/擦除处掉电：重新挂载后各键只能是写入前或写入后的值，
+ *          之后的写入不得对残缺单元再次编程。掉电分别按读出残缺内容与 ECC 读取失败两种方式模拟。
+ */
+
+#include "host_test.h"
+#include "file_flash.h"
+#include "flash_kv.h"
+#include <string.h>
+#include <string>
+
+using utils::FlashKV;
+
+static const uint32_t SECTOR_SIZE = 4096;
+static const uint32_t PROGRAM_UNIT = 32;   // 与 STM32H7 的 256 位闪存字相同
+static const uint16_t VERSION = 3;
+
+static const int KEY_NUM = 5;
+static const uint16_t KEYS[KEY_NUM] = {1, 2, 7, 100, 0x1234};
+static const uint32_t SIZES[KEY_NUM] = {4, 16, 40, 100, FlashKV::MAX_VALUE};
+
+static std::string g_path;
+
+// 第 generation 次写入 key 的内容
+static void makeValue(uint16_t key, uint32_t generation, uint8_t* data, uint32_t size)
+{
+    uint32_t x = key * 40503u + generation * 2654435761u + 1u;
+    for (uint32_t i = 0; i < size; i++)
+    {
+        x = x * 1103515245u + 12345u;
+        data[i] = (uint8_t)(x >> 16);
+    }
+}
+
+static bool hasValue(const FlashKV& kv, int k, uint32_t generation)
+{
+    uint8_t expected[FlashKV::MAX_VALUE];
+    uint8_t actual[FlashKV::MAX_VALUE];
+    makeValue(KEYS[k], generation, expected, SIZES[k]);
+    return kv.get(KEYS[k], actual, SIZES[k], VERSION) && memcmp(expected, actual, SIZES[k]) == 0;
+}
+
+static bool setValue(FlashKV& kv, int k, uint32_t generation)
+{
+    uint8_t data[FlashKV::MAX_VALUE];
+    makeValue(KEYS[k], generation, data, SIZES[k]);
+    return kv.set(KEYS[k], data, SIZES[k], VERSION);
+}
+
+static bool allValues(const FlashKV& kv, const uint32_t generation[KEY_NUM])
+{
+    bool ok = true;
+    for (int k = 0; k < KEY_NUM; k++)
+    {
+        ok = ok && hasValue(kv, k, generation[k]);
+    }
+    return ok;
+}
+
+static void testBasic()
+{
+    FileFlash flash(g_path.c_str(), SECTOR_SIZE, 2, PROGRAM_UNIT);
+    CHECK(flash.isOpen());
+
+    FlashKV kv(&flash);
+    CHECK(kv.mount());              // 空白闪存自动格式化
+    CHECK(kv.getKeyCount() == 0);
+
+    uint8_t data[FlashKV::MAX_VALUE + 1];
+    CHECK(!kv.get(KEYS[0], data, SIZES[0], VERSION));
+
+    CHECK(setValue(kv, 0, 1));
+    CHECK(hasValue(kv, 0, 1));
+    CHECK(!kv.get(KEYS[0], data, SIZES[0] + 1, VERSION));   // 长度不符
+    CHECK(!kv.get(KEYS[0], data, SIZES[0], VERSION + 1));   // 版本不符
+
+    // 内容相同不写入
+    const uint32_t used = kv.getUsedBytes();
+    CHECK(setValue(kv, 0, 1));
+    CHECK(kv.getUsedBytes() == used);
+
+    CHECK(!kv.set(0xFFFF, data, 4, VERSION));
+    CHECK(!kv.set(KEYS[1], data, FlashKV::MAX_VALUE + 1, VERSION));
+
+    // 重新挂载后内容保持
+    uint32_t generation[KEY_NUM];
+    for (int k = 0; k < KEY_NUM; k++)
+    {
+        generation[k] = 10 + k;
+        CHECK(setValue(kv, k, generation[k]));
+    }
+    FlashKV again(&flash);
+    CHECK(again.mount());
+    CHECK(again.getKeyCount() == KEY_NUM);
+    CHECK(allValues(again, generation));
+
+    // 键数上限
+    CHECK(again.format());
+    for (uint32_t i = 0; i < FlashKV::MAX_KEYS; i++)
+    {
+        CHECK(again.set((uint16_t)i, &i, sizeof(i), VERSION));
+    }
+    uint32_t extra = 0;
+    CHECK(!again.set((uint16_t)FlashKV::MAX_KEYS, &extra, sizeof(extra), VERSION));
+    CHECK(again.getCorruptCount() == 0);
+    CHECK(flash.getOverwriteCount() == 0);
+}
+
+static void testCompaction()
+{
+    FileFlash flash(g_path.c_str(), SECTOR_SIZE, 2, PROGRAM_UNIT);
+    FlashKV kv(&flash);
+    CHECK(kv.mount());
+
+    uint32_t generation[KEY_NUM] = {0};
+    for (int k = 0; k < KEY_NUM; k++)
+    {
+        CHECK(setValue(kv, k, 0));
+    }
+
+    bool ok = true;
+    for (uint32_t n = 1; n <= 2000; n++)
+    {
+        const int k = (int)(n % KEY_NUM);
+        generation[k] = n;
+        ok = ok && setValue(kv, k, n);
+        ok = ok && allValues(kv, generation);
+        if (n % 97 == 0)
+        {
+            FlashKV remount(&flash);
+            ok = ok && remount.mount() && allValues(remount, generation) &&
+                 remount.getSequence() == kv.getSequence();
+        }
+    }
+    CHECK(ok);
+    CHECK(kv.getSequence() > 20);   // 经过多次整理，两个扇区轮流使用
+    CHECK(kv.getCorruptCount() == 0);
+    CHECK(flash.getOverwriteCount() == 0);
+}
+
+/**
+ * @brief 从格式化开始构造确定的初始状态
+ * @param full 为 true 时写到下一次写入 KEYS[TARGET] 会触发整理为止
+ */
+static const int TARGET = 3;
+
+static bool prepare(FlashKV& kv, uint32_t generation[KEY_NUM], bool full)
+{
+    if (!kv.format())
+    {
+        return false;
+    }
+    for (int k = 0; k < KEY_NUM; k++)
+    {
+        generation[k] = 0;
+        if (!setValue(kv, k, 0))
+        {
+            return false;
+        }
+    }
+    const uint32_t length = (12 + SIZES[TARGET] + PROGRAM_UNIT - 1) / PROGRAM_UNIT * PROGRAM_UNIT;
+    for (uint32_t n = 1; full && kv.getUsedBytes() + length <= SECTOR_SIZE; n++)
+    {
+        // 只用较短的键填充，保证停在目标记录放不下的位置
+        const int k = (int)(n % 2);
+        generation[k] = n;
+        if (!setValue(kv, k, n))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 写入 KEYS[TARGET] 的过程中在每个操作处掉电，重新上电后检查
+ */
+static void testPowerLoss(bool full, bool ecc)
+{
+    FileFlash flash(g_path.c_str(), SECTOR_SIZE, 2, PROGRAM_UNIT);
+    uint32_t cuts = 0;
+    bool completed = false;
+
+    for (uint32_t cut = 0; cut < 64 && !completed; cut++)
+    {
+        flash.powerOn();
+        FlashKV kv(&flash);
+        uint32_t generation[KEY_NUM];
+        CHECK(kv.mount());
+        CHECK(prepare(kv, generation, full));
+        const uint32_t sequence = kv.getSequence();
+
+        flash.cutPowerAfter(cut, cut + 1, ecc);
+        const bool ok = setValue(kv, TARGET, 1000);
+        if (!flash.powerLost())
+        {
+            // 没有被打断：写入完成，整理场景下扇区已切换
+            CHECK(ok);
+            CHECK(kv.getSequence() == (full ? sequence + 1 : sequence));
+            completed = true;
+            continue;
+        }
+        cuts++;
+        CHECK(!ok);
+
+        // 重新上电
+        flash.powerOn();
+        FlashKV reboot(&flash);
+        CHECK(reboot.mount());
+        for (int k = 0; k < KEY_NUM; k++)
+        {
+            if (k == TARGET)
+            {
+                CHECK(hasValue(reboot, k, generation[k]) || hasValue(reboot, k, 1000));
+            }
+            else
+            {
+                CHECK(hasValue(reboot, k, generation[k]));
+            }
+        }
+
+        // 掉电后继续使用：写入成功，残缺单元不被再次编程，再次挂载内容一致
+        generation[TARGET] = 2000;
+        generation[0] = 2001;
+        CHECK(setValue(reboot, TARGET, 2000));
+        CHECK(setValue(reboot, 0, 2001));
+        CHECK(allValues(reboot, generation));
+        FlashKV remount(&flash);
+        CHECK(remount.mount());
+        CHECK(allValues(remount, generation));
+        CHECK(flash.getOverwriteCount() == 0);
+    }
+
+    CHECK(completed);
+    // 目标记录 4 个编程单元；整理另有 1 次擦除、搬移与扇区头
+    CHECK(cuts >= (full ? 10u : 4u));
+    printf("power loss during %s (%s): %u cut points\n", full ? "compact" : "set",
+           ecc ? "ECC error" : "torn data", cuts);
+}
+
+int main(int argc, char** argv)
+{
+    g_path = std::string(argv[0]) + ".bin";
+    (void)argc;
+
+    testBasic();
+    testCompaction();
+    testPowerLoss(false, false);
+    testPowerLoss(false, true);
+    testPowerLoss(true, false);
+    testPowerLoss(true, true);
+
+    remove(g_path.c_str());
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,117 @@
+/**
+ * @file test_quaternion_ekf.cpp
+ * @brief QuaternionEKF 加速度计新息门限测试
+ * @details 机体水平静止，陀螺仪与加速度计带噪声。名义测量应全部通过门限；
+ *          注入单个与成串的侧向比力异常值应被拒绝且姿态不受影响，关闭门限时同样的异常值拉偏姿态；
+ *          异常结束后测量重新被采用；陀螺仪未察觉的真实倾斜持续超限达到上限后被强制采用并收敛。
+ */
+
+#include "host_test.h"
+#include "QuaternionEKF.h"
+#include "math_const.h"
+#include <random>
+
+static const float GATE_CHI2 = 11.34f;
+static const uint32_t REJECT_LIMIT = 250;
+
+static void configure(QuaternionEKF &ekf, float chi2)
+{
+    float R[3][3] = {{0.01f, 0.0f, 0.0f}, {0.0f, 0.01f, 0.0f}, {0.0f, 0.0f, 0.01f}};
+    float Q[7][7] = {};
+    for (int i = 0; i < 4; i++) {
+        Q[i][i] = 1e-7f;
+    }
+    for (int i = 4; i < 7; i++) {
+        Q[i][i] = 1e-10f;
+    }
+    ekf.setMeasurementNoise(R);
+    ekf.setProcessNoise(Q);
+    ekf.setInnovationGate(chi2, REJECT_LIMIT);
+    ekf.setAdaptiveNoise(0.0f);
+}
+
+/**
+ * @brief 送入 count 个样本
+ * @param pitch 真实俯仰角 (陀螺仪不可见)，单位：rad
+ * @param extra 叠加在加速度计上的异常比力，单位：m/s^2
+ */
+static void run(QuaternionEKF &ekf, std::mt19937 &rng, int count, float pitch, const float extra[3])
+{
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    for (int k = 0; k < count; k++) {
+        float gyro[3] = {0.002f * noise(rng), 0.002f * noise(rng), 0.002f * noise(rng)};
+        float accel[3] = {
+            -GRAVITY_CONST * sinf(pitch) + 0.05f * noise(rng) + extra[0],
+            0.05f * noise(rng) + extra[1],
+            GRAVITY_CONST * cosf(pitch) + 0.05f * noise(rng) + extra[2],
+        };
+        ekf.update(gyro, accel);
+    }
+}
+
+static float tiltDeg(QuaternionEKF &ekf)
+{
+    float roll, pitch, yaw;
+    ekf.getEulerRadians(roll, pitch, yaw);
+    return fmaxf(fabsf(roll), fabsf(pitch)) * RAD_TO_DEG;
+}
+
+int main()
+{
+    const float none[3] = {0.0f, 0.0f, 0.0f};
+    const float lateral[3] = {0.0f, 6.0f, 0.0f};   // 约 31° 的侧向比力
+
+    QuaternionEKF ekf(500.0f);
+    configure(ekf, GATE_CHI2);
+    std::mt19937 rng(3);
+
+    // 名义测量全部通过
+    run(ekf, rng, 1000, 0.0f, none);
+    CHECK(ekf.getAcceptCount() == 1000);
+    CHECK(ekf.getRejectCount() == 0);
+    CHECK(ekf.getLastInnovation() < GATE_CHI2);
+    CHECK(tiltDeg(ekf) < 0.2f);
+
+    // 单个异常值被拒绝
+    const float before = tiltDeg(ekf);
+    run(ekf, rng, 1, 0.0f, lateral);
+    CHECK(ekf.getRejectCount() == 1);
+    CHECK(ekf.getLastInnovation() > GATE_CHI2);
+    CHECK_NEAR(tiltDeg(ekf), before, 0.01);
+
+    // 成串异常值 (0.2 s，少于强制采用的次数) 全部被拒绝，姿态不受影响
+    run(ekf, rng, 100, 0.0f, lateral);
+    CHECK(ekf.getRejectCount() == 101);
+    CHECK(ekf.getAcceptCount() == 1000);
+    const float gatedTilt = tiltDeg(ekf);
+    CHECK(gatedTilt < 0.2f);
+
+    // 异常结束后名义测量重新被采用
+    run(ekf, rng, 500, 0.0f, none);
+    CHECK(ekf.getAcceptCount() == 1500);
+    CHECK(ekf.getRejectCount() == 101);
+    CHECK(tiltDeg(ekf) < 0.2f);
+
+    // 对照：关闭门限时同样的异常值拉偏姿态
+    QuaternionEKF open(500.0f);
+    configure(open, 0.0f);
+    std::mt19937 rng2(3);
+    run(open, rng2, 1000, 0.0f, none);
+    run(open, rng2, 101, 0.0f, lateral);
+    const float openTilt = tiltDeg(open);
+    CHECK(open.getRejectCount() == 0);
+    CHECK(openTilt > 2.0f);
+    printf("after 101 outliers: tilt %.3f deg gated, %.2f deg without gate\n", gatedTilt, openTilt);
+
+    // 陀螺仪未察觉的真实倾斜：连续超限达到上限后强制采用，收敛到新的姿态
+    const float tilt = 30.0f * DEG_TO_RAD;
+    const uint32_t rejects = ekf.getRejectCount();
+    run(ekf, rng, (int)REJECT_LIMIT, tilt, none);
+    CHECK(ekf.getRejectCount() == rejects + REJECT_LIMIT);
+    run(ekf, rng, 2500, tilt, none);
+    CHECK(ekf.getRejectCount() == rejects + REJECT_LIMIT);
+    CHECK_NEAR(tiltDeg(ekf), 30.0, 1.5);
+    CHECK(ekf.getLastInnovation() < GATE_CHI2);
+
+    return HOST_TEST_RESULT();
+}
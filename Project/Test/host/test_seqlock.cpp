@@ -0,0 +1,148 @@
+/**
+ * @file test_seqlock.cpp
+ * @brief utils::SeqLock 多线程压力测试
+ * @details 一个写者连续发布快照，多个读者并发读取。快照内每个字段都由同一个计数值导出，
+ *          并带有校验字段，读者逐次验证：校验正确、字段与计数一致 (无撕裂读)、
+ *          计数与返回序号对应 (counter == seq / 2)，且序号单调不减。
+ */
+
+#include "host_test.h"
+#include "seqlock.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+static const int FIELD_NUM = 30;
+
+// 多个缓存行，拷贝无法由单条指令完成，撕裂读有机会暴露
+struct Payload
+{
+    uint32_t counter;
+    uint32_t field[FIELD_NUM];
+    uint32_t checksum;
+};
+
+static void fill(Payload &p, uint32_t counter)
+{
+    p.counter = counter;
+    p.checksum = counter;
+    for (int i = 0; i < FIELD_NUM; i++)
+    {
+        p.field[i] = counter * (uint32_t)(2 * i + 1);
+        p.checksum ^= p.field[i];
+    }
+}
+
+static bool consistent(const Payload &p)
+{
+    uint32_t checksum = p.counter;
+    for (int i = 0; i < FIELD_NUM; i++)
+    {
+        if (p.field[i] != p.counter * (uint32_t)(2 * i + 1))
+        {
+            return false;
+        }
+        checksum ^= p.field[i];
+    }
+    return checksum == p.checksum;
+}
+
+struct ReaderResult
+{
+    uint64_t reads;
+    uint64_t torn;
+    uint64_t mismatched;
+    uint64_t regressions;
+    uint32_t distinct;
+};
+
+int main()
+{
+    const int READERS = 3;
+    const auto DURATION = std::chrono::milliseconds(500);
+
+    utils::SeqLock<Payload> lock;
+    std::atomic<bool> done(false);
+    std::atomic<int> started(0);
+    std::vector<ReaderResult> results(READERS);
+    std::vector<std::thread> readers;
+
+    for (int r = 0; r < READERS; r++)
+    {
+        readers.emplace_back([&lock, &done, &started, &results, r]() {
+            ReaderResult res = {0, 0, 0, 0, 0};
+            started.fetch_add(1);
+            uint32_t last_seq = 0;
+            uint32_t last_counter = 0xFFFFFFFFu;
+            Payload p;
+            while (!done.load(std::memory_order_acquire))
+            {
+                uint32_t seq = lock.read(p);
+                res.reads++;
+                if (!consistent(p))
+                {
+                    res.torn++;
+                }
+                if (p.counter != seq / 2)
+                {
+                    res.mismatched++;
+                }
+                if (seq < last_seq)
+                {
+                    res.regressions++;
+                }
+                if (p.counter != last_counter)
+                {
+                    res.distinct++;
+                    last_counter = p.counter;
+                }
+                last_seq = seq;
+            }
+            results[r] = res;
+        });
+    }
+
+    // 所有读者就绪后再开始写，按固定时长持续发布
+    while (started.load() < READERS)
+    {
+        std::this_thread::yield();
+    }
+    Payload p;
+    uint32_t writes = 0;
+    const auto deadline = std::chrono::steady_clock::now() + DURATION;
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        for (int i = 0; i < 1000; i++)
+        {
+            fill(p, ++writes);
+            lock.write(p);
+        }
+    }
+    done.store(true, std::memory_order_release);
+    for (auto &t : readers)
+    {
+        t.join();
+    }
+
+    for (int r = 0; r < READERS; r++)
+    {
+        printf("reader %d: %llu reads, %u distinct snapshots of %u\n", r,
+               (unsigned long long)results[r].reads, results[r].distinct, writes);
+        CHECK(results[r].reads > 0);
+        CHECK(results[r].torn == 0);
+        CHECK(results[r].mismatched == 0);
+        CHECK(results[r].regressions == 0);
+        // 读者须与写者真正并发，否则测试没有意义
+        CHECK(results[r].distinct > 1);
+    }
+
+    // 写者结束后读到的是最后一次发布
+    Payload last;
+    CHECK(lock.read(last) == 2 * writes);
+    CHECK(last.counter == writes);
+    CHECK(consistent(last));
+    CHECK(lock.sequence() == 2 * writes);
+
+    return HOST_TEST_RESULT();
+}
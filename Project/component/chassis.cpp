@@ -3,6 +3,7 @@
 #include <algorithm> // for std::max, std::min
 #include <cstring>   // for memcpy
 #include "utils.h"
+#include "trace.h"
 
 // Chassis 类的构造函数实现
 Chassis::Chassis(const ChassisDependencies& deps) :
@@ -81,6 +82,7 @@ void Chassis::setThrottleMode(ThrottleMode mode) {
 // setBaseThrottle, setTargetAltitude, updateCurrentAltitude, setAltitudeControlActive 方法已移除
 
 void Chassis::update() {
+    TRACE_SCOPE(TRACE_ID_CHASSIS_UPDATE);
     if (!status_.isInitialized || !config_.attitudeMgr) {
         // 必要组件未初始化，则不执行更新
         return;
@@ -88,8 +90,15 @@ void Chassis::update() {
 
     // 1. 读取当前姿态和角速度
     // 从AttitudeManager获取的是IMU直接输出的角度和角速度
-    config_.attitudeMgr->getAttitude(status_.imuRoll, status_.imuPitch, status_.imuYaw);
-    config_.attitudeMgr->getGyro(status_.imuGyro);
+    // 通过快照一次性读取，保证角度与角速度来自同一次估计器更新
+    StateSnapshot snapshot;
+    config_.attitudeMgr->getSnapshot(snapshot);
+    status_.imuRoll = snapshot.roll;
+    status_.imuPitch = snapshot.pitch;
+    status_.imuYaw = snapshot.yaw;
+    for (int i = 0; i < 3; ++i) {
+        status_.imuGyro[i] = snapshot.gyro[i];
+    }
 
     // 根据chassis.md的定义，将IMU角度转换为机体坐标系角度
     // phi_body (roll) = +IMU.roll
@@ -153,6 +162,9 @@ void Chassis::update() {
             config_.motors[i]->setThrottle(status_.motorOutputs[i]);
         }
     }
+    // 记录本次输出对应的采样时刻与写入完成时刻
+    status_.sampleCycle = snapshot.sample_cycle;
+    status_.outputCycle = DWT->CYCCNT;
 }
 
 void Chassis::disarm() {
@@ -97,6 +97,10 @@ public:
         // 最终输出
         float motorOutputs[4] = {0.0f, 0.0f, 0.0f, 0.0f}; // 存储计算出的电机输出值 (-100.0 to 100.0)
 
+        // 端到端延迟统计
+        uint32_t sampleCycle = 0;     // 本次输出所用IMU样本的数据就绪时刻 (DWT 周期计数)
+        uint32_t outputCycle = 0;     // 本次电机写入完成时刻 (DWT 周期计数)
+
         // 其他状态
         bool isInitialized = false;   // 初始化标志
     };
@@ -171,6 +175,12 @@ public:
      */
     virtual void disarm();
 
+    /**
+     * @brief 获取最近一次输出所用样本的数据就绪时刻与电机写入完成时刻 (DWT 周期计数)
+     */
+    uint32_t getOutputSampleCycle() const { return status_.sampleCycle; }
+    uint32_t getOutputCycle() const { return status_.outputCycle; }
+
 protected:
     Config config_; // 存储配置参数
     Target target_; // 存储目标值
@@ -1,5 +1,7 @@
 #include "move.h"
 #include "chassis.h"  // 添加chassis头文件
+#include "position_estimator.h"
+#include "altitude_estimator.h"
 #include <math.h>
 #include <algorithm>
 #include <cstring>
@@ -16,6 +18,8 @@ Move::Move(const MoveDependencies& deps) :
     // 从外部依赖项拷贝指针到内部 config_ 结构体
     config_.lidar = deps.lidar;
     config_.chassis = deps.chassis;  // 添加chassis指针赋值
+    config_.estimator = deps.estimator;
+    config_.altitude = deps.altitude;
     memcpy(config_.positionPIDs, deps.positionPIDs, sizeof(config_.positionPIDs));
     memcpy(config_.velocityPIDs, deps.velocityPIDs, sizeof(config_.velocityPIDs));
 }
@@ -80,10 +84,30 @@ void Move::setPositionControlMode(bool use_position_control) {
 }
 
 void Move::getCurrentPosition(float& x, float& y, float& z) const {
-    LidarPoseData pose_data = config_.lidar->getPoseData();
-    x = pose_data.x - status_.offsetX; // 使用偏移量调整位置
-    y = pose_data.y - status_.offsetY;
-    z = pose_data.z - status_.offsetZ;
+    bool from_estimator = false;
+    if (config_.estimator) {
+        PositionEstimate estimate;
+        config_.estimator->getEstimate(estimate);
+        if (estimate.valid) {
+            x = estimate.pos[0] - status_.offsetX;
+            y = estimate.pos[1] - status_.offsetY;
+            z = estimate.pos[2] - status_.offsetZ;
+            from_estimator = true;
+        }
+    }
+    if (!from_estimator) {
+        LidarPoseData pose_data = config_.lidar->getPoseData();
+        x = pose_data.x - status_.offsetX; // 使用偏移量调整位置
+        y = pose_data.y - status_.offsetY;
+        z = pose_data.z - status_.offsetZ;
+    }
+    if (config_.altitude) {
+        AltitudeEstimate altitude;
+        config_.altitude->getEstimate(altitude);
+        if (altitude.valid) {
+            z = altitude.z - status_.offsetZ;
+        }
+    }
 }
 
 void Move::getCurrentVelocity(float& vx, float& vy, float& vz) const {
@@ -209,6 +233,9 @@ void Move::setOffset(float offset_x, float offset_y, float offset_z, float offse
     status_.offsetY = offset_y;
     status_.offsetZ = offset_z;
     status_.offsetYaw = normalizeAngle(offset_yaw);
+    if (config_.estimator) {
+        config_.estimator->setYawOffset(status_.offsetYaw);
+    }
 }
 
 void Move::getOffset(float& offset_x, float& offset_y, float& offset_z, float& offset_yaw) const {
@@ -233,6 +260,9 @@ void Move::setCurrentAsOrigin() {
         status_.offsetZ = pose_data.z;
         // 使用chassis的当前偏航角设置偏移量
         status_.offsetYaw = normalizeAngle(config_.chassis->getCurrentYaw());
+        if (config_.estimator) {
+            config_.estimator->setYawOffset(status_.offsetYaw);
+        }
     }
 }
 
@@ -241,23 +271,70 @@ void Move::updateSensorData() {
         return;
     }
 
-    // 获取位置数据 (地面坐标系) - 原始传感器数据
-    LidarPoseData pose_data = config_.lidar->getPoseData();
-    if (pose_data.valid) {
-        // 应用偏移量：计算坐标 = 原始坐标 - 偏移量
-        status_.currentX_ground = pose_data.x - status_.offsetX;
-        status_.currentY_ground = pose_data.y - status_.offsetY;
-        status_.currentZ_ground = pose_data.z - status_.offsetZ;
+    uint32_t cycles_per_us = SystemCoreClock / 1000000u;
+
+    // 优先使用位置估计器的高频输出，无效时退回雷达位姿与差分速度
+    bool from_estimator = false;
+    if (config_.estimator) {
+        PositionEstimate estimate;
+        config_.estimator->getEstimate(estimate);
+        if (estimate.valid) {
+            if (cycles_per_us != 0) {
+                status_.poseAgeUs = (DWT->CYCCNT - estimate.cycle) / cycles_per_us;
+            }
+            status_.currentX_ground = estimate.pos[0] - status_.offsetX;
+            status_.currentY_ground = estimate.pos[1] - status_.offsetY;
+            status_.currentZ_ground = estimate.pos[2] - status_.offsetZ;
+            status_.currentVx_ground = estimate.vel[0];
+            status_.currentVy_ground = estimate.vel[1];
+            status_.currentVz_ground = estimate.vel[2];
+            from_estimator = true;
+        }
     }
 
-    // 获取速度数据 (地面坐标系)
-    LidarVelocityData velocity_data = config_.lidar->getVelocityData();
-    if (velocity_data.valid) {
-        status_.currentVx_ground = velocity_data.vx_filtered;
-        status_.currentVy_ground = velocity_data.vy_filtered;
-        status_.currentVz_ground = velocity_data.vz_filtered;
+    if (!from_estimator) {
+        // 获取位置数据 (地面坐标系) - 原始传感器数据
+        LidarPoseData pose_data = config_.lidar->getPoseData();
+        if (cycles_per_us != 0) {
+            status_.poseAgeUs = (DWT->CYCCNT - config_.lidar->getPoseRxCycle()) / cycles_per_us;
+        }
+        if (pose_data.valid) {
+            // 应用偏移量：计算坐标 = 原始坐标 - 偏移量
+            status_.currentX_ground = pose_data.x - status_.offsetX;
+            status_.currentY_ground = pose_data.y - status_.offsetY;
+            status_.currentZ_ground = pose_data.z - status_.offsetZ;
+        }
+
+        // 获取速度数据 (地面坐标系)
+        LidarVelocityData velocity_data = config_.lidar->getVelocityData();
+        if (velocity_data.valid) {
+            status_.currentVx_ground = velocity_data.vx_filtered;
+            status_.currentVy_ground = velocity_data.vy_filtered;
+            status_.currentVz_ground = velocity_data.vz_filtered;
+        }
     }
 
+    // Z 方向优先使用高度估计器，雷达掉线时仍由气压计与惯导维持
+    updateAltitude();
+
+    updateBodyVelocity();
+}
+
+bool Move::updateAltitude() {
+    if (!config_.altitude) {
+        return false;
+    }
+    AltitudeEstimate altitude;
+    config_.altitude->getEstimate(altitude);
+    if (!altitude.valid) {
+        return false;
+    }
+    status_.currentZ_ground = altitude.z - status_.offsetZ;
+    status_.currentVz_ground = altitude.vz;
+    return true;
+}
+
+void Move::updateBodyVelocity() {
     // 使用chassis的当前偏航角而不是雷达的偏航角
     // 应用偏移量并归一化：计算角度 = 原始角度 - 偏移角度
     status_.currentYaw = normalizeAngle(config_.chassis->getCurrentYaw() - status_.offsetYaw);
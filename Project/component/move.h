@@ -7,6 +7,8 @@
 
 // 前向声明
 class Chassis;
+class PositionEstimator;
+class AltitudeEstimator;
 
 // 定义PID索引
 #define PID_X_POSITION  0
@@ -25,6 +27,8 @@ struct MoveDependencies {
     Chassis* chassis = nullptr;  // 添加chassis指针用于获取当前偏航角
     PidController* positionPIDs[3] = {nullptr, nullptr, nullptr}; // X, Y, Z Position (外环)
     PidController* velocityPIDs[3] = {nullptr, nullptr, nullptr}; // X, Y, Z Velocity (内环)
+    PositionEstimator* estimator = nullptr; // 可选，有效时替代雷达的位置与差分速度
+    AltitudeEstimator* altitude = nullptr;  // 可选，有效时替代 Z 方向的位置与速度 (雷达掉线时由气压计维持)
 };
 
 /**
@@ -41,6 +45,8 @@ public:
         Chassis* chassis = nullptr;  // 添加chassis指针
         PidController* positionPIDs[3] = {nullptr, nullptr, nullptr}; // 外环: X, Y, Z Position
         PidController* velocityPIDs[3] = {nullptr, nullptr, nullptr}; // 内环: X, Y, Z Velocity
+        PositionEstimator* estimator = nullptr; // 位置估计器 (可选)
+        AltitudeEstimator* altitude = nullptr;  // 高度估计器 (可选)
     };
 
     /**
@@ -107,6 +113,9 @@ public:
         float throttleCmd_prev = 0.0f;        // 前一帧的油门指令 (相对值)
         float throttleCmd_far = 0.0f;        // 前两帧的油门指令 (相对值)
 
+        // 本次更新所用位置数据的时龄 (us)：雷达位姿自接收以来，或估计器输出自IMU采样以来
+        uint32_t poseAgeUs = 0;
+
         // 数据有效性
         bool isInitialized = false;      // 初始化标志
     };
@@ -233,6 +242,17 @@ protected:
      */
     virtual void updateSensorData();
 
+    /**
+     * @brief 更新当前偏航角并将地面坐标系速度转换到机身坐标系
+     */
+    virtual void updateBodyVelocity();
+
+    /**
+     * @brief 用高度估计器覆盖 Z 方向的位置与速度
+     * @return 高度估计是否有效
+     */
+    virtual bool updateAltitude();
+
     /**
      * @brief 坐标系转换：从地面坐标系到机身坐标系
      * @details 使用与odometer模块相同的坐标变换公式
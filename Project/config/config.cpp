@@ -8,7 +8,13 @@
 // Attitude
 BMI088 bmi088(CONFIG_BMI088_SET);
 MahonyAHRS mahony_estimator(500.0f, 0.55f, 0.002f);
+DeltaAngleIntegrator delta_angle_integrator(0.002f, 0.0005f);
 AttitudeManager attitude_manager(&bmi088, &mahony_estimator);
+GyroCalibrator gyro_calibrator(CONFIG_GYRO_CALIBRATOR_SET);
+AccelCalibrator accel_calibrator(CONFIG_ACCEL_CALIBRATOR_SET);
+ImuFilterBank gyro_filter;
+ImuFilterBank accel_filter;
+DynamicNotch gyro_dynamic_notch(CONFIG_GYRO_DYN_NOTCH_SET);
 
 
 // NRF
@@ -18,10 +24,18 @@ Nrf nrf(CONFIG_NRF_SET);
 UPT20X upt201(&huart8);
 
 // 四旋翼电机
+#if CONFIG_MOTOR_USE_DSHOT
+DShotBus dshot_bus(&htim1, CONFIG_DSHOT_SPEED, CONFIG_DSHOT_BIDIRECTIONAL);
+DShotMotor motor_1(&dshot_bus, 0, false);
+DShotMotor motor_2(&dshot_bus, 1, false);
+DShotMotor motor_3(&dshot_bus, 2, false);
+DShotMotor motor_4(&dshot_bus, 3, false);
+#else
 SdcDualMotor motor_1(&htim1, TIM_CHANNEL_1, false);
 SdcDualMotor motor_2(&htim1, TIM_CHANNEL_2, false);
 SdcDualMotor motor_3(&htim1, TIM_CHANNEL_3, false);
 SdcDualMotor motor_4(&htim1, TIM_CHANNEL_4, false);
+#endif
 
 PidController pid_roll_rad(CONFIG_PID_ROLL_RAD_SET);
 PidController pid_pitch_rad(CONFIG_PID_PITCH_RAD_SET);
@@ -36,7 +50,18 @@ PidController pid_yaw_spd(CONFIG_PID_YAW_SPD_SET);
 // 飞控底盘
 Chassis chassis(CONFIG_CHASSIS_SET);
 
+// 控制流水线
+ControlPipeline control_pipeline(CONFIG_CONTROL_PIPELINE_SET, &attitude_manager, &chassis);
+
 Lidar lidar(&huart1);
+PositionEstimator position_estimator(CONFIG_POSITION_ESTIMATOR_SET, &lidar,
+                                     CONFIG_OPTICAL_FLOW_ENABLE ? &upt201 : nullptr);
+AltitudeEstimator altitude_estimator(CONFIG_ALTITUDE_ESTIMATOR_SET, &lidar);
+SPL06 spl06(CONFIG_SPL06_SET);
+
+// 参数存储
+InternalFlash param_flash(CONFIG_PARAMS_FIRST_SECTOR, CONFIG_PARAMS_SECTOR_COUNT);
+utils::FlashKV param_store(&param_flash);
 
 PidController pid_x_vel(CONFIG_PID_X_VEL_SET);
 PidController pid_y_vel(CONFIG_PID_Y_VEL_SET);
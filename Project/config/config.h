@@ -7,9 +7,14 @@
 #include "Attitude.h"
 #include "BMI088.h"
 #include "MahonyAHRS.h"
+#include "DeltaAngleIntegrator.h"
+#include "DynamicNotch.h"
+#include "GyroCalibrator.h"
+#include "AccelCalibrator.h"
 // motor
 #include "motor.h"
 #include "sdc_dual.h"
+#include "dshot.h"
 // module
 #include "scheduler.h"
 #include "pid.h"
@@ -22,6 +27,7 @@
 #include "ws2812.h"
 #include "lidar.h"
 #include "hc12.h"
+#include "internal_flash.h"
 
 #include "point.h"
 #include "path.h"
@@ -30,6 +36,7 @@
 // component
 #include "chassis.h"
 #include "move.h"
+#include "control_pipeline.h"
 // debug
 #include "vofa.h"
 //
@@ -43,12 +50,88 @@
         .ce_acc = {.port = GPIOC, .pin = GPIO_PIN_0},  \
         .ce_gyro = {.port = GPIOC, .pin = GPIO_PIN_3}, \
         .gyroRange = BMI088_GYRO_2000,                 \
-        .accelRange = BMI088_ACC_RANGE_3G              \
+        .accelRange = BMI088_ACC_RANGE_3G,             \
+        .gyroFifoWatermark = 4                         \
     }
 extern BMI088 bmi088;
 extern MahonyAHRS mahony_estimator;
+extern DeltaAngleIntegrator delta_angle_integrator;
 extern AttitudeManager attitude_manager;
 
+// 后台陀螺仪零偏校准：停机时窗口方差判定静止，连续静止 stillWindows 个窗口后即可解锁，
+// 被碰动后自动重新累计；关闭时上电阻塞校准约 1.5s
+#define CONFIG_GYRO_CALIBRATOR_ENABLE 1
+#define CONFIG_GYRO_CALIBRATOR_SET                     \
+    (GyroCalibratorConfig_t)                           \
+    {                                                  \
+        .window = 0.25f,                               \
+        .defaultDt = 0.0005f,                          \
+        .gyroStdMax = 0.02f,                           \
+        .accelStdMax = 0.15f,                          \
+        .accelNormTol = 0.5f,                          \
+        .biasMax = 0.1f,                               \
+        .stillWindows = 3                              \
+    }
+extern GyroCalibrator gyro_calibrator;
+
+// 在线加速度计校准：停机时各准静止姿态的加速度均值做椭球拟合，得到三轴比例因子与零偏；
+// 需要在足够多的不同姿态 (含侧放与倒置) 下静置，协方差收敛后才输出，结果保存在参数存储中
+#define CONFIG_ACCEL_CALIBRATOR_ENABLE 1
+#define CONFIG_ACCEL_CALIBRATOR_SET                    \
+    (AccelCalibratorConfig_t)                          \
+    {                                                  \
+        .window = 0.25f,                               \
+        .defaultDt = 0.0005f,                          \
+        .gyroMax = 0.05f,                              \
+        .accelStdMax = 0.15f,                          \
+        .accelNormTol = 0.15f,                         \
+        .minAngle = 0.35f,                             \
+        .minPoints = 20,                               \
+        .varianceMax = 0.2f,                           \
+        .scaleMax = 0.1f,                              \
+        .biasMax = 1.5f                                \
+    }
+extern AccelCalibrator accel_calibrator;
+
+// IMU 数字滤波，截止频率为 0 时直通
+#define CONFIG_GYRO_SAMPLE_RATE_HZ 2000.0f // 陀螺仪 FIFO 输出频率
+#define CONFIG_GYRO_LPF_HZ 200.0f
+#define CONFIG_GYRO_LPF_STAGES 1           // 巴特沃斯阶数 = 2 * 节数
+#define CONFIG_ACCEL_SAMPLE_RATE_HZ 500.0f // 加速度计每批次读取一次
+#define CONFIG_ACCEL_LPF_HZ 30.0f
+#define CONFIG_ACCEL_LPF_STAGES 2
+extern ImuFilterBank gyro_filter;
+extern ImuFilterBank accel_filter;
+
+// 陀螺仪动态陷波：1kHz 降采样后 128 点FFT (7.8Hz 分辨率)，陷波节接在低通节之后
+#define CONFIG_GYRO_DYN_NOTCH_ENABLE 1
+#define CONFIG_GYRO_DYN_NOTCH_SET                      \
+    (DynamicNotchConfig_t)                             \
+    {                                                  \
+        .sampleFreq = CONFIG_GYRO_SAMPLE_RATE_HZ,      \
+        .decimation = 2,                               \
+        .minFreq = 80.0f,                              \
+        .maxFreq = 450.0f,                             \
+        .q = 3.5f,                                     \
+        .notchCount = 2,                               \
+        .firstStage = CONFIG_GYRO_LPF_STAGES,          \
+        .smoothing = 0.3f,                             \
+        .threshold = 3.0f                              \
+    }
+extern DynamicNotch gyro_dynamic_notch;
+
+// 雷达 IMU 航向修正 Mahony 偏航漂移：按测量时刻与偏航历史比较，首次观测对准两者的固定偏差
+#define CONFIG_HEADING_FUSION_ENABLE 1
+#define CONFIG_HEADING_KP 0.5f // 航向误差反馈增益，单位：1/s
+#define CONFIG_HEADING_FUSION_SET                      \
+    (HeadingFusionConfig_t)                            \
+    {                                                  \
+        .delay_ms = 20.0f,                             \
+        .sign = 1.0f,                                  \
+        .gate = 0.35f,                                 \
+        .realign_count = 50                            \
+    }
+
 // NRF 配置
 
 #define CONFIG_NRF_SET                                 \
@@ -72,16 +155,29 @@ extern AttitudeManager attitude_manager;
     }
 
 extern Nrf nrf;
-extern ground_station_rx_data_t ground_station_rx_data;
 
-// UPT201 配置
+// UPT201 配置 (光流 + 测距)，使能后其速度作为观测融合进位置估计
+#define CONFIG_OPTICAL_FLOW_ENABLE 1
 extern UPT20X upt201;
 
 // 四旋翼电机
+// 1: 使用 DShot 数字协议驱动电调 (TIM1 CH1~CH4 一次 DMA 突发)，0: 使用 PWM 驱动 SdcDual 电调
+#define CONFIG_MOTOR_USE_DSHOT 0
+#define CONFIG_DSHOT_SPEED DShotSpeed::DSHOT600
+#define CONFIG_DSHOT_BIDIRECTIONAL false
+
+#if CONFIG_MOTOR_USE_DSHOT
+extern DShotBus dshot_bus;
+extern DShotMotor motor_1;
+extern DShotMotor motor_2;
+extern DShotMotor motor_3;
+extern DShotMotor motor_4;
+#else
 extern SdcDualMotor motor_1;
 extern SdcDualMotor motor_2;
 extern SdcDualMotor motor_3;
 extern SdcDualMotor motor_4;
+#endif
 
 // 三轴角度pid(外环)
 
@@ -164,6 +260,84 @@ extern Lidar lidar;
     }
 extern Chassis chassis;
 
+// 控制流水线
+// BMI088 INT3 (陀螺仪FIFO水位中断) 接入的 EXTI 引脚，0 表示未接线，此时使用 TIM6 按 500Hz 触发
+#define CONFIG_BMI088_INT_GYRO_PIN 0
+
+#define CONFIG_CONTROL_PIPELINE_SET                    \
+    (ControlPipelineConfig_t)                          \
+    {                                                  \
+        .trigger_pin = CONFIG_BMI088_INT_GYRO_PIN,     \
+        .htim_trigger = &htim6,                        \
+        .trigger_rate_hz = 500.0f,                     \
+        .timeout_ms = 10                               \
+    }
+extern ControlPipeline control_pipeline;
+
+// 位置估计：IMU 速率预测 + 雷达位姿/光流速度延迟融合，关闭时 Move 直接使用雷达位姿与差分速度
+#define CONFIG_POSITION_ESTIMATOR_ENABLE 1
+#define CONFIG_POSITION_ESTIMATOR_SET                  \
+    (PositionEstimatorConfig_t)                        \
+    {                                                  \
+        .accel_noise = 0.5f,                           \
+        .bias_noise = 0.02f,                           \
+        .pos_noise = 0.03f,                            \
+        .lidar_delay_ms = 20.0f,                       \
+        .lidar_yaw = 0.0f,                             \
+        .timeout_ms = 200,                             \
+        .flow_noise = 0.08f,                           \
+        .flow_delay_ms = 5.0f,                         \
+        .flow_yaw = 0.0f,                              \
+        .flow_min_confidence = 30,                     \
+        .flow_min_distance = 80,                       \
+        .flow_max_distance = 4000                      \
+    }
+extern PositionEstimator position_estimator;
+
+// 气压计 SPL06 (SPI3，片选 PA15)，关闭时高度估计只使用雷达
+#define CONFIG_BARO_ENABLE 1
+#define CONFIG_SPL06_SET                                                             \
+    (SPL06Config_t)                                                                  \
+    {                                                                                \
+        .hspi = &hspi3,                                                              \
+        .csPin = {.port = PA15_SPI3_NSS_GPIO_Port, .pin = PA15_SPI3_NSS_Pin}         \
+    }
+extern SPL06 spl06;
+
+// 高度估计：IMU 速率三阶互补滤波，雷达在线时以雷达高度为参考，掉线后改用气压高度
+#define CONFIG_ALTITUDE_ESTIMATOR_ENABLE 1
+#define CONFIG_ALTITUDE_ESTIMATOR_SET                  \
+    (AltitudeEstimatorConfig_t)                        \
+    {                                                  \
+        .lidar_tau = 0.5f,                             \
+        .baro_tau = 2.0f,                              \
+        .baro_offset_tau = 5.0f,                       \
+        .lidar_delay_ms = 20.0f,                       \
+        .baro_delay_ms = 150.0f,                       \
+        .lidar_timeout_ms = 200,                       \
+        .baro_timeout_ms = 500                         \
+    }
+extern AltitudeEstimator altitude_estimator;
+// 自动模式下雷达掉线后按高度估计缓降的速度，单位：m/s
+#define CONFIG_LIDAR_LOSS_DESCEND_RATE 0.3f
+
+// 参数存储：片内闪存扇区 6、7 (0x080C0000 起 256KB，已从链接器 IROM 中划出)，
+// 上电恢复陀螺仪零偏、加速度计校准、地面气压、垂直加速度零偏与 PID 参数，停机时写回变化超过阈值的项
+#define CONFIG_PARAMS_ENABLE 1
+#define CONFIG_PARAMS_FIRST_SECTOR 6
+#define CONFIG_PARAMS_SECTOR_COUNT 2
+#define CONFIG_PARAMS_GYRO_BIAS_TOL 0.002f    // 陀螺仪零偏变化阈值，单位：rad/s
+#define CONFIG_PARAMS_BARO_GROUND_TOL 20.0f   // 地面气压变化阈值，单位：Pa
+#define CONFIG_PARAMS_ALTITUDE_BIAS_TOL 0.05f // 垂直加速度零偏变化阈值，单位：m/s^2
+#define CONFIG_PARAMS_ACCEL_SCALE_TOL 0.002f  // 加速度计比例因子变化阈值
+#define CONFIG_PARAMS_ACCEL_BIAS_TOL 0.02f    // 加速度计零偏变化阈值，单位：m/s^2
+extern InternalFlash param_flash;
+extern utils::FlashKV param_store;
+
+// 事件追踪
+// 按下手柄该功能键后冻结追踪缓冲区并经 HC12 导出 (9600 波特率下约 20s)
+#define CONFIG_TRACE_DUMP_FKEY 1
+
 // 运动控制
 
 #define CONFIG_PID_X_VEL_SET                                        \
@@ -236,7 +410,13 @@ extern PidController pid_z_pos;
         .positionPIDs = {&pid_x_pos, &pid_y_pos, &pid_z_pos}, \
         .velocityPIDs = { &pid_x_vel,                         \
                           &pid_y_vel,                         \
-                          &pid_z_vel }                        \
+                          &pid_z_vel },                       \
+        .estimator = CONFIG_POSITION_ESTIMATOR_ENABLE         \
+                         ? &position_estimator                \
+                         : nullptr,                           \
+        .altitude = CONFIG_ALTITUDE_ESTIMATOR_ENABLE          \
+                        ? &altitude_estimator                 \
+                        : nullptr                             \
     }
 
 extern Move move;
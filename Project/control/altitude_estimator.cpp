@@ -0,0 +1,242 @@
+#include "altitude_estimator.h"
+#include "math_const.h"
+#include <string.h>
+
+// 两次积分的最大间隔，超过时视为流水线中断，只推进时间不积分
+static constexpr float MAX_PREDICT_DT = 0.02f;
+// 气压偏差跟踪的单次最大步长，避免长时间无数据后一次跳变
+static constexpr float MAX_BARO_DT = 0.5f;
+
+AltitudeEstimator::AltitudeEstimator(const AltitudeEstimatorConfig_t &config, Lidar *lidar)
+    : config_(config), lidar_(lidar), reset_pending_(false),
+      initialized_(false), z_base_(0.0f), z_correction_(0.0f), vz_(0.0f),
+      accel_correction_(0.0f), accel_bias_seed_(0.0f), error_(0.0f), baro_offset_(0.0f), baro_offset_valid_(false),
+      reference_(AltitudeReference::NONE), last_cycle_(0),
+      lidar_seq_(0), lidar_rx_cycle_(0), lidar_seen_(false),
+      baro_seq_(0), baro_rx_cycle_(0), baro_seen_(false),
+      history_head_(0), history_count_(0)
+{
+    memset(history_, 0, sizeof(history_));
+}
+
+void AltitudeEstimator::setBaroAltitude(float altitude)
+{
+    BaroSample sample;
+    sample.altitude = altitude;
+    sample.rx_cycle = DWT->CYCCNT;
+    baro_sample_.write(sample);
+}
+
+void AltitudeEstimator::update(const StateSnapshot &snapshot)
+{
+    if (reset_pending_)
+    {
+        initialized_ = false;
+        history_count_ = 0;
+        reset_pending_ = false;
+    }
+
+    const uint32_t cycle = snapshot.sample_cycle;
+    const uint32_t now = DWT->CYCCNT;
+    const uint32_t cycles_per_ms = SystemCoreClock / 1000u;
+
+    // 1. 取新到达的观测
+    LidarPoseSample lidar_sample;
+    bool has_lidar = false;
+    if (lidar_ != nullptr)
+    {
+        const uint32_t seq = lidar_->getPoseSample(lidar_sample);
+        has_lidar = (seq != lidar_seq_) && (seq != 0);
+        lidar_seq_ = seq;
+    }
+    BaroSample baro_sample;
+    const uint32_t baro_seq = baro_sample_.read(baro_sample);
+    const bool has_baro = (baro_seq != baro_seq_) && (baro_seq != 0);
+    baro_seq_ = baro_seq;
+
+    const uint32_t prev_baro_rx = baro_rx_cycle_;
+    const bool prev_baro_seen = baro_seen_;
+    if (has_lidar)
+    {
+        lidar_rx_cycle_ = lidar_sample.rx_cycle;
+        lidar_seen_ = true;
+    }
+    if (has_baro)
+    {
+        baro_rx_cycle_ = baro_sample.rx_cycle;
+        baro_seen_ = true;
+    }
+
+    // 2. 选择参考源：雷达优先，掉线后使用对齐过的气压高度
+    const bool lidar_ok = lidar_seen_ && (now - lidar_rx_cycle_) <= config_.lidar_timeout_ms * cycles_per_ms;
+    const bool baro_ok = baro_seen_ && (now - baro_rx_cycle_) <= config_.baro_timeout_ms * cycles_per_ms;
+
+    if (!initialized_)
+    {
+        if (has_lidar)
+        {
+            initialize(lidar_sample.z, cycle);
+        }
+        else if (has_baro && !lidar_ok)
+        {
+            initialize(baro_sample.altitude, cycle);
+            baro_offset_ = 0.0f;
+            baro_offset_valid_ = true;
+        }
+        publish(cycle, initialized_);
+        return;
+    }
+
+    AltitudeReference reference = AltitudeReference::NONE;
+    if (lidar_ok)
+    {
+        reference = AltitudeReference::LIDAR;
+    }
+    else if (baro_ok && baro_offset_valid_)
+    {
+        reference = AltitudeReference::BARO;
+    }
+    if (reference != reference_)
+    {
+        // 切换参考源时丢弃旧误差，由新参考的下一次观测重新计算
+        error_ = 0.0f;
+        reference_ = reference;
+    }
+
+    // 3. 三阶互补滤波积分
+    float dt = (float)(cycle - last_cycle_) / (float)SystemCoreClock;
+    last_cycle_ = cycle;
+    if (dt > 0.0f && dt <= MAX_PREDICT_DT)
+    {
+        const float tau = (reference_ == AltitudeReference::BARO) ? config_.baro_tau : config_.lidar_tau;
+        if (reference_ != AltitudeReference::NONE && tau > 0.0f)
+        {
+            const float k1 = 3.0f / tau;
+            const float k2 = 3.0f / (tau * tau);
+            const float k3 = 1.0f / (tau * tau * tau);
+            accel_correction_ += error_ * k3 * dt;
+            vz_ += error_ * k2 * dt;
+            z_correction_ += error_ * k1 * dt;
+        }
+        const float dv = (verticalAccel(snapshot) + accel_correction_) * dt;
+        z_base_ += (vz_ + 0.5f * dv) * dt;
+        vz_ += dv;
+    }
+
+    // 4. 保存历史点供延迟观测比较
+    HistoryEntry &entry = history_[history_head_];
+    entry.cycle = cycle;
+    entry.z = z_base_;
+    history_head_ = (history_head_ + 1) % HISTORY_SIZE;
+    if (history_count_ < HISTORY_SIZE)
+    {
+        history_count_++;
+    }
+
+    // 5. 用测量时刻的估计高度计算误差
+    if (has_lidar && reference_ == AltitudeReference::LIDAR)
+    {
+        const uint32_t delay_cycles = (uint32_t)(config_.lidar_delay_ms * (float)cycles_per_ms);
+        correct(lidar_sample.z, lidar_sample.rx_cycle - delay_cycles);
+    }
+    if (has_baro)
+    {
+        const uint32_t delay_cycles = (uint32_t)(config_.baro_delay_ms * (float)cycles_per_ms);
+        const uint32_t meas_cycle = baro_sample.rx_cycle - delay_cycles;
+        float z_meas = z_base_;
+        historyAt(meas_cycle, z_meas);
+        const float offset = baro_sample.altitude - (z_meas + z_correction_);
+
+        if (!baro_offset_valid_)
+        {
+            baro_offset_ = offset;
+            baro_offset_valid_ = true;
+        }
+        else if (reference_ == AltitudeReference::LIDAR && prev_baro_seen && config_.baro_offset_tau > 0.0f)
+        {
+            // 雷达在线：低通跟踪气压漂移与雷达/气压坐标差
+            float baro_dt = (float)(baro_sample.rx_cycle - prev_baro_rx) / (float)SystemCoreClock;
+            if (baro_dt > MAX_BARO_DT)
+            {
+                baro_dt = MAX_BARO_DT;
+            }
+            baro_offset_ += (offset - baro_offset_) * baro_dt / (config_.baro_offset_tau + baro_dt);
+        }
+        else if (reference_ == AltitudeReference::BARO)
+        {
+            correct(baro_sample.altitude - baro_offset_, meas_cycle);
+        }
+    }
+
+    publish(cycle, reference_ != AltitudeReference::NONE);
+}
+
+void AltitudeEstimator::getEstimate(AltitudeEstimate &estimate) const
+{
+    estimate_.read(estimate);
+    // 流水线停止时估计不再更新，视为无效
+    const uint32_t timeout_cycles = (SystemCoreClock / 1000u) * config_.lidar_timeout_ms;
+    if (estimate.valid && (DWT->CYCCNT - estimate.cycle) > timeout_cycles)
+    {
+        estimate.valid = false;
+    }
+}
+
+float AltitudeEstimator::verticalAccel(const StateSnapshot &snapshot) const
+{
+    // 机体系比力经四元数旋转后的 Z 分量 (Z 轴向上)，再减去重力
+    const float q0 = snapshot.q[0], q1 = snapshot.q[1], q2 = snapshot.q[2], q3 = snapshot.q[3];
+    const float ax = snapshot.accel[0], ay = snapshot.accel[1], az = snapshot.accel[2];
+    const float ez = 2.0f * (q1 * q3 - q0 * q2) * ax + 2.0f * (q2 * q3 + q0 * q1) * ay + (1.0f - 2.0f * (q1 * q1 + q2 * q2)) * az;
+    return ez - GRAVITY_CONST;
+}
+
+bool AltitudeEstimator::historyAt(uint32_t cycle, float &z) const
+{
+    // 从最新向最旧查找测量时刻所在的历史点
+    for (uint32_t back = 0; back < history_count_; back++)
+    {
+        const HistoryEntry &entry = history_[(history_head_ + HISTORY_SIZE - 1 - back) % HISTORY_SIZE];
+        if ((int32_t)(cycle - entry.cycle) >= 0)
+        {
+            z = entry.z;
+            return true;
+        }
+    }
+    return false;
+}
+
+void AltitudeEstimator::correct(float reference, uint32_t meas_cycle)
+{
+    // 测量早于全部历史时退化为与当前估计比较
+    float z_meas = z_base_;
+    historyAt(meas_cycle, z_meas);
+    error_ = reference - (z_meas + z_correction_);
+}
+
+void AltitudeEstimator::initialize(float z, uint32_t cycle)
+{
+    z_base_ = z;
+    z_correction_ = 0.0f;
+    vz_ = 0.0f;
+    accel_correction_ = -accel_bias_seed_;
+    error_ = 0.0f;
+    reference_ = AltitudeReference::NONE;
+    history_head_ = 0;
+    history_count_ = 0;
+    last_cycle_ = cycle;
+    initialized_ = true;
+}
+
+void AltitudeEstimator::publish(uint32_t cycle, bool valid)
+{
+    AltitudeEstimate estimate;
+    estimate.z = z_base_ + z_correction_;
+    estimate.vz = vz_;
+    estimate.accel_bias = -accel_correction_;
+    estimate.baro_offset = baro_offset_;
+    estimate.cycle = cycle;
+    estimate.reference = reference_;
+    estimate.valid = valid;
+    estimate_.write(estimate);
+}
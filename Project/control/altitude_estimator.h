@@ -0,0 +1,143 @@
+#ifndef __ALTITUDE_ESTIMATOR_H__
+#define __ALTITUDE_ESTIMATOR_H__
+
+#include "main.h"
+#include "Attitude.h"
+#include "lidar.h"
+#include "seqlock.h"
+
+/**
+ * @brief 高度估计器配置
+ */
+typedef struct
+{
+    float lidar_tau;          // 以雷达高度为参考时的滤波时间常数，单位：s
+    float baro_tau;           // 以气压高度为参考时的滤波时间常数，单位：s
+    float baro_offset_tau;    // 雷达在线时气压计偏差的跟踪时间常数，单位：s
+    float lidar_delay_ms;     // 雷达位姿的测量时刻早于接收时刻的时间，单位：ms
+    float baro_delay_ms;      // 气压高度 (含中值滤波) 的测量时刻早于接收时刻的时间，单位：ms
+    uint32_t lidar_timeout_ms; // 超过该时间未收到雷达位姿则切换到气压参考
+    uint32_t baro_timeout_ms;  // 超过该时间未收到气压数据则视为气压计失效
+} AltitudeEstimatorConfig_t;
+
+/**
+ * @brief 高度参考源
+ */
+enum class AltitudeReference : uint8_t
+{
+    NONE = 0, // 无参考，仅惯导外推
+    LIDAR,    // 雷达高度
+    BARO,     // 气压高度 (已对齐到雷达坐标系)
+};
+
+/**
+ * @brief 高度估计结果 (雷达 Z 坐标系，未减去 Move 的原点偏移)
+ */
+struct AltitudeEstimate
+{
+    float z;                     // 高度，单位：m
+    float vz;                    // 垂直速度，单位：m/s
+    float accel_bias;            // 垂直加速度零偏，单位：m/s^2
+    float baro_offset;           // 气压高度减雷达高度的偏差，单位：m
+    uint32_t cycle;              // 估计对应的 IMU 数据就绪时刻 (DWT 周期计数)
+    AltitudeReference reference; // 当前参考源
+    bool valid;                  // 已初始化且存在未超时的参考源
+};
+
+/**
+ * @brief 气压/雷达 + 惯导三阶互补高度估计
+ * @details 状态为高度、垂直速度与加速度零偏，以 IMU 速率积分姿态旋转后的垂直加速度，
+ *          参考高度与测量时刻的历史高度之差按时间常数 tau 反馈：
+ *          k1 = 3/tau 修正高度，k2 = 3/tau^2 修正速度，k3 = 1/tau^3 修正零偏，
+ *          对加速度零偏为三阶无静差。
+ *          雷达在线时以雷达高度为参考，同时低通跟踪气压高度与估计高度之差；
+ *          雷达掉线后改用扣除该偏差的气压高度并放慢时间常数，高度与速度连续过渡。
+ *          update() 只能在单个线程 (控制流水线) 中调用，setBaroAltitude() 与 getEstimate() 可在任意任务中调用。
+ */
+class AltitudeEstimator
+{
+public:
+    static const uint32_t HISTORY_SIZE = 128; // 500Hz 下约 256ms，覆盖气压中值滤波延迟
+
+    AltitudeEstimator(const AltitudeEstimatorConfig_t &config, Lidar *lidar);
+
+    /**
+     * @brief 以最新姿态快照积分一步，并融合新到达的雷达/气压高度
+     * @param snapshot 姿态快照 (四元数、机体系加速度、数据就绪时刻)
+     */
+    void update(const StateSnapshot &snapshot);
+
+    /**
+     * @brief 写入一次新的气压相对高度 (气压计作业中调用)
+     * @param altitude 相对上电地面的气压高度，单位：m
+     */
+    void setBaroAltitude(float altitude);
+
+    /**
+     * @brief 获取一致的估计结果
+     */
+    void getEstimate(AltitudeEstimate &estimate) const;
+
+    /**
+     * @brief 请求重置，下一次参考高度到达时重新初始化
+     */
+    void reset() { reset_pending_ = true; }
+
+    /**
+     * @brief 设置垂直加速度零偏初值 (如上次保存的值)，在下一次初始化时生效
+     * @param bias 垂直加速度零偏，单位：m/s^2
+     */
+    void setAccelBias(float bias) { accel_bias_seed_ = bias; }
+
+private:
+    struct BaroSample
+    {
+        float altitude;
+        uint32_t rx_cycle;
+    };
+
+    // 历史点：未叠加高度修正量的积分高度
+    struct HistoryEntry
+    {
+        uint32_t cycle;
+        float z;
+    };
+
+    AltitudeEstimatorConfig_t config_;
+    Lidar *lidar_;
+    volatile bool reset_pending_;
+
+    bool initialized_;
+    float z_base_;       // 加速度积分得到的高度
+    float z_correction_; // 累积的高度修正量，输出高度 = z_base_ + z_correction_
+    float vz_;
+    float accel_correction_;
+    float accel_bias_seed_;
+    float error_;        // 最近一次参考高度与估计高度之差，在下一次观测前持续反馈
+    float baro_offset_;
+    bool baro_offset_valid_;
+    AltitudeReference reference_;
+
+    uint32_t last_cycle_;
+    uint32_t lidar_seq_;
+    uint32_t lidar_rx_cycle_;
+    bool lidar_seen_;
+    uint32_t baro_seq_;
+    uint32_t baro_rx_cycle_;
+    bool baro_seen_;
+
+    HistoryEntry history_[HISTORY_SIZE];
+    uint32_t history_head_; // 下一个写入位置
+    uint32_t history_count_;
+
+    utils::SeqLock<BaroSample> baro_sample_;
+    utils::SeqLock<AltitudeEstimate> estimate_;
+
+    float verticalAccel(const StateSnapshot &snapshot) const;
+    bool historyAt(uint32_t cycle, float &z) const;
+    void correct(float reference, uint32_t meas_cycle);
+    void initialize(float z, uint32_t cycle);
+    void publish(uint32_t cycle, bool valid);
+};
+
+#endif // __ALTITUDE_ESTIMATOR_H__
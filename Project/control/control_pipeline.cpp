@@ -0,0 +1,157 @@
+#include "control_pipeline.h"
+#include "tim_drv.h"
+#include "time_utils.h"
+
+ControlPipeline::ControlPipeline(const ControlPipelineConfig_t &config, AttitudeManager *attitude, Chassis *chassis)
+    : config_(config), attitude_(attitude), chassis_(chassis), position_(nullptr), altitude_(nullptr),
+      heading_source_(nullptr), heading_seq_(0), task_(nullptr),
+      control_enabled_(false), timer_mode_(false), cycles_per_us_(1), trigger_cycle_(0)
+{
+    resetStats();
+}
+
+bool ControlPipeline::start()
+{
+    if (attitude_ == nullptr)
+    {
+        return false;
+    }
+
+    // 使用 DWT 周期计数器打时间戳：中断中可安全读取，且不受系统节拍更新时机影响
+    utils::time::enableCycleCounter();
+    cycles_per_us_ = SystemCoreClock / 1000000u;
+    if (cycles_per_us_ == 0)
+    {
+        cycles_per_us_ = 1;
+    }
+
+    task_ = osThreadGetId();
+
+    if (config_.trigger_pin != 0)
+    {
+        // 由 IMU 数据就绪中断触发，EXTI 引脚由 CubeMX 配置
+        timer_mode_ = false;
+        return true;
+    }
+
+    // 数据就绪中断未接线时，退化为定时器周期触发
+    if (config_.htim_trigger == nullptr)
+    {
+        return false;
+    }
+    uint32_t psc, arr;
+    if (TimDrv_CalcPscAndAtr(config_.htim_trigger, config_.trigger_rate_hz, &psc, &arr) != 0)
+    {
+        return false;
+    }
+    __HAL_TIM_SET_PRESCALER(config_.htim_trigger, psc);
+    __HAL_TIM_SET_AUTORELOAD(config_.htim_trigger, arr);
+    config_.htim_trigger->Instance->EGR = TIM_EGR_UG;
+    __HAL_TIM_CLEAR_FLAG(config_.htim_trigger, TIM_FLAG_UPDATE);
+    timer_mode_ = true;
+    return HAL_TIM_Base_Start_IT(config_.htim_trigger) == HAL_OK;
+}
+
+void ControlPipeline::spinOnce()
+{
+    uint32_t notified = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(config_.timeout_ms));
+    uint32_t start_cycle = DWT->CYCCNT;
+    uint32_t trigger_cycle = trigger_cycle_;
+
+    if (notified == 0)
+    {
+        // 触发源丢失，按轮询方式继续执行，保证姿态与控制不中断
+        stats_.timeout_count++;
+    }
+    else if (notified > 1)
+    {
+        stats_.missed_count += notified - 1;
+    }
+
+    // 1. 姿态估计，采样时刻随姿态快照传到电机输出
+    attitude_->update(notified != 0 ? trigger_cycle : start_cycle);
+
+    // 2. 角度环 -> 角速度环 -> 混控 -> 电机输出
+    if (control_enabled_ && chassis_ != nullptr)
+    {
+        chassis_->update();
+        latency_.recordOutput(chassis_->getOutputSampleCycle(), chassis_->getOutputCycle());
+    }
+
+    // 3. 外部航向为低速延迟观测，同样放在电机输出之后，修正从下一次姿态估计开始生效
+    if (heading_source_ != nullptr)
+    {
+        LidarImuSample sample;
+        const uint32_t seq = heading_source_->getImuSample(sample);
+        if (seq != heading_seq_ && seq != 0)
+        {
+            attitude_->fuseHeading(sample.yaw, sample.rx_cycle);
+        }
+        heading_seq_ = seq;
+    }
+
+    // 4. 位置/高度估计以 IMU 速率预测，放在电机输出之后不增加姿态控制延迟
+    if (position_ != nullptr || altitude_ != nullptr)
+    {
+        StateSnapshot snapshot;
+        attitude_->getSnapshot(snapshot);
+        if (position_ != nullptr)
+        {
+            position_->update(snapshot);
+        }
+        if (altitude_ != nullptr)
+        {
+            altitude_->update(snapshot);
+        }
+    }
+
+    // 延迟由 latency_ 截止于电机写入时刻统计，其后的航向融合与位置估计只计入执行时间
+    updateStats(start_cycle, DWT->CYCCNT);
+}
+
+void ControlPipeline::triggerFromISR()
+{
+    trigger_cycle_ = DWT->CYCCNT;
+
+    TaskHandle_t task = (TaskHandle_t)task_;
+    if (task == nullptr)
+    {
+        return;
+    }
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(task, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+void ControlPipeline::handleEXTI(uint16_t GPIO_Pin)
+{
+    if (!timer_mode_ && config_.trigger_pin != 0 && GPIO_Pin == config_.trigger_pin)
+    {
+        triggerFromISR();
+    }
+}
+
+void ControlPipeline::handleTimer(TIM_HandleTypeDef *htim)
+{
+    if (timer_mode_ && htim == config_.htim_trigger)
+    {
+        triggerFromISR();
+    }
+}
+
+void ControlPipeline::resetStats()
+{
+    stats_.exec_max_us = 0.0f;
+    stats_.missed_count = 0;
+    stats_.timeout_count = 0;
+}
+
+void ControlPipeline::updateStats(uint32_t start_cycle, uint32_t end_cycle)
+{
+    // 无符号差值可正确处理 CYCCNT 回绕
+    float exec_us = (float)(end_cycle - start_cycle) / (float)cycles_per_us_;
+    if (exec_us > stats_.exec_max_us)
+    {
+        stats_.exec_max_us = exec_us;
+    }
+}
@@ -0,0 +1,135 @@
+#ifndef __CONTROL_PIPELINE_H__
+#define __CONTROL_PIPELINE_H__
+
+#include "main.h"
+#include "cmsis_os.h"
+#include "Attitude.h"
+#include "chassis.h"
+#include "latency_monitor.h"
+#include "position_estimator.h"
+#include "altitude_estimator.h"
+
+/**
+ * @brief 控制流水线配置
+ * @details 触发源二选一：trigger_pin 非 0 时使用 IMU 数据就绪中断 (EXTI)，
+ *          否则使用 htim_trigger 按 trigger_rate_hz 周期触发
+ */
+typedef struct
+{
+    uint16_t trigger_pin;            // IMU 数据就绪中断引脚 (EXTI)，0 表示未接线
+    TIM_HandleTypeDef *htim_trigger; // 备用触发定时器
+    float trigger_rate_hz;           // 备用触发频率，单位：Hz
+    uint32_t timeout_ms;             // 等待触发超时，超时后按轮询方式执行一次
+} ControlPipelineConfig_t;
+
+/**
+ * @brief 流水线运行统计
+ * @details 采样到电机输出的延迟只由 LatencyMonitor 统计，见 getLatency()
+ */
+typedef struct
+{
+    float exec_max_us;      // 单次流水线最大执行时间，单位：us
+    uint32_t missed_count;  // 上一周期未处理完时到达的触发次数
+    uint32_t timeout_count; // 等待触发超时次数
+} ControlPipelineStats_t;
+
+/**
+ * @brief 中断驱动的控制流水线
+ * @details IMU 数据就绪 -> 姿态估计 -> 角度/角速度环 -> 混控 -> 电机输出，
+ *          由中断通过任务通知唤醒，在同一个高优先级任务中顺序执行，
+ *          消除姿态任务与控制任务各自 osDelay 带来的等待与相位漂移。
+ */
+class ControlPipeline
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param config 流水线配置
+     * @param attitude 姿态管理器
+     * @param chassis 底盘控制器 (包含角度/角速度环与混控)
+     */
+    ControlPipeline(const ControlPipelineConfig_t &config, AttitudeManager *attitude, Chassis *chassis);
+
+    /**
+     * @brief 绑定当前任务并启动触发源，需在流水线任务中调用
+     * @return 触发源是否启动成功
+     */
+    bool start();
+
+    /**
+     * @brief 等待下一次触发并执行一次完整流水线
+     */
+    void spinOnce();
+
+    /**
+     * @brief 使能/关闭控制输出，关闭时只执行姿态估计
+     * @param enable 是否使能
+     */
+    void enableControl(bool enable) { control_enabled_ = enable; }
+    bool isControlEnabled() const { return control_enabled_; }
+
+    /**
+     * @brief 设置位置估计器，姿态估计后以同一快照预测一步，传入nullptr则停止
+     * @param estimator 位置估计器
+     */
+    void setPositionEstimator(PositionEstimator *estimator) { position_ = estimator; }
+
+    /**
+     * @brief 设置高度估计器，与位置估计器使用同一快照，传入nullptr则停止
+     * @param estimator 高度估计器
+     */
+    void setAltitudeEstimator(AltitudeEstimator *estimator) { altitude_ = estimator; }
+
+    /**
+     * @brief 设置外部航向来源，雷达 IMU 航向按接收时刻融合到姿态估计，传入nullptr则停止
+     * @param lidar 雷达
+     */
+    void setHeadingSource(Lidar *lidar) { heading_source_ = lidar; }
+
+    /**
+     * @brief 中断触发入口，记录采样时间戳并唤醒流水线任务
+     */
+    void triggerFromISR();
+
+    /**
+     * @brief EXTI 回调入口，引脚匹配时触发
+     * @param GPIO_Pin 触发中断的引脚
+     */
+    void handleEXTI(uint16_t GPIO_Pin);
+
+    /**
+     * @brief 定时器回调入口，定时器匹配时触发
+     * @param htim 触发中断的定时器
+     */
+    void handleTimer(TIM_HandleTypeDef *htim);
+
+    const ControlPipelineStats_t &getStats() const { return stats_; }
+    void resetStats();
+
+    /**
+     * @brief 端到端延迟直方图 (数据就绪 -> 电机写入)
+     */
+    LatencyMonitor &getLatency() { return latency_; }
+
+private:
+    ControlPipelineConfig_t config_;
+    AttitudeManager *attitude_;
+    Chassis *chassis_;
+    PositionEstimator *position_;
+    AltitudeEstimator *altitude_;
+    Lidar *heading_source_;
+    uint32_t heading_seq_;
+
+    volatile osThreadId_t task_;
+    volatile bool control_enabled_;
+    bool timer_mode_;
+    uint32_t cycles_per_us_;
+
+    volatile uint32_t trigger_cycle_; // 最近一次触发时的 DWT 周期计数
+    ControlPipelineStats_t stats_;
+    LatencyMonitor latency_;
+
+    void updateStats(uint32_t start_cycle, uint32_t end_cycle);
+};
+
+#endif // __CONTROL_PIPELINE_H__
@@ -0,0 +1,134 @@
+#include "latency_monitor.h"
+#include "cmsis_os.h"
+#include <stdio.h>
+
+// 直方图区间宽度
+static constexpr float LATENCY_BIN_US = 50.0f; // 0 ~ 1.6ms
+static constexpr float JITTER_BIN_US = 10.0f;  // 0 ~ 320us
+static constexpr float POSE_AGE_BIN_MS = 5.0f; // 0 ~ 160ms
+
+LatencyMonitor::LatencyMonitor()
+    : latency_us_(LATENCY_BIN_US), jitter_us_(JITTER_BIN_US), pose_age_ms_(POSE_AGE_BIN_MS),
+      last_sample_cycle_(0), last_output_cycle_(0), has_last_(false),
+      reset_output_pending_(false), reset_pose_pending_(false),
+      dumping_(false), dump_index_(0)
+{
+}
+
+void LatencyMonitor::recordOutput(uint32_t sample_cycle, uint32_t output_cycle)
+{
+    if (reset_output_pending_)
+    {
+        latency_us_.reset();
+        jitter_us_.reset();
+        has_last_ = false;
+        reset_output_pending_ = false;
+    }
+
+    // 在使用时读取主频，静态构造时时钟尚未配置
+    uint32_t cycles_per_us = SystemCoreClock / 1000000u;
+    if (cycles_per_us == 0)
+    {
+        return;
+    }
+
+    // 无符号差值可正确处理 CYCCNT 回绕
+    latency_us_.record((float)(output_cycle - sample_cycle) / (float)cycles_per_us);
+
+    if (has_last_)
+    {
+        int32_t output_interval = (int32_t)(output_cycle - last_output_cycle_);
+        int32_t sample_interval = (int32_t)(sample_cycle - last_sample_cycle_);
+        int32_t jitter = output_interval - sample_interval;
+        if (jitter < 0)
+        {
+            jitter = -jitter;
+        }
+        jitter_us_.record((float)jitter / (float)cycles_per_us);
+    }
+    last_sample_cycle_ = sample_cycle;
+    last_output_cycle_ = output_cycle;
+    has_last_ = true;
+}
+
+void LatencyMonitor::recordPoseAge(uint32_t age_us)
+{
+    if (reset_pose_pending_)
+    {
+        pose_age_ms_.reset();
+        reset_pose_pending_ = false;
+    }
+    pose_age_ms_.record((float)age_us * 0.001f);
+}
+
+static void fillSummary(LatencySummary_t *summary, const utils::Histogram<LatencyMonitor::BINS> &histogram)
+{
+    summary->count = histogram.count();
+    summary->mean = histogram.mean();
+    summary->p50 = histogram.percentile(0.50f);
+    summary->p99 = histogram.percentile(0.99f);
+    summary->max = histogram.max();
+}
+
+void LatencyMonitor::getReport(LatencyReport_t *report) const
+{
+    if (report == nullptr)
+    {
+        return;
+    }
+    report->timestamp_ms = osKernelGetTickCount();
+    fillSummary(&report->latency_us, latency_us_);
+    fillSummary(&report->jitter_us, jitter_us_);
+    fillSummary(&report->pose_age_ms, pose_age_ms_);
+}
+
+void LatencyMonitor::dumpStart()
+{
+    dump_index_ = 0;
+    dumping_ = true;
+}
+
+bool LatencyMonitor::dumpStep(LatencyWriteFunc_t write)
+{
+    if (!dumping_)
+    {
+        return true;
+    }
+
+    static const char *const names[] = {"latency_us", "jitter_us", "pose_age_ms"};
+    const utils::Histogram<BINS> *histograms[] = {&latency_us_, &jitter_us_, &pose_age_ms_};
+
+    if (dump_index_ >= 3)
+    {
+        // 导出完成，清零开始新一轮统计
+        reset_output_pending_ = true;
+        reset_pose_pending_ = true;
+        dumping_ = false;
+        return true;
+    }
+
+    // 每行：名称 统计值 区间宽度 各区间计数 溢出计数
+    const utils::Histogram<BINS> &h = *histograms[dump_index_];
+    char line[320];
+    int len = snprintf(line, sizeof(line), "%s n=%lu mean=%.1f sd=%.1f p50=%.1f p99=%.1f max=%.1f w=%.0f bins=",
+                       names[dump_index_], (unsigned long)h.count(), h.mean(), h.stddev(),
+                       h.percentile(0.50f), h.percentile(0.99f), h.max(), h.binWidth());
+    for (uint32_t i = 0; i < BINS && len > 0 && len < (int)sizeof(line); i++)
+    {
+        len += snprintf(line + len, sizeof(line) - len, "%lu,", (unsigned long)h.bin(i));
+    }
+    if (len > 0 && len < (int)sizeof(line))
+    {
+        len += snprintf(line + len, sizeof(line) - len, "%lu\r\n", (unsigned long)h.overflow());
+    }
+    if (len <= 0 || len >= (int)sizeof(line))
+    {
+        len = (int)sizeof(line) - 1;
+    }
+
+    if (write((const uint8_t *)line, (uint16_t)len))
+    {
+        dump_index_++;
+    }
+    return false;
+}
@@ -0,0 +1,93 @@
+#ifndef __LATENCY_MONITOR_H__
+#define __LATENCY_MONITOR_H__
+
+#include "main.h"
+#include "histogram.h"
+
+// 单个直方图的摘要
+typedef struct __attribute__((packed))
+{
+    uint32_t count; // 样本数
+    float mean;     // 均值
+    float p50;      // 中位数 (区间上沿)
+    float p99;      // 99% 分位 (区间上沿)
+    float max;      // 最大值
+} LatencySummary_t;
+
+// 延迟统计记录
+typedef struct __attribute__((packed))
+{
+    uint32_t timestamp_ms;
+    LatencySummary_t latency_us;  // IMU 数据就绪 -> 电机写入，单位：us
+    LatencySummary_t jitter_us;   // 输出间隔相对采样间隔的偏差，单位：us
+    LatencySummary_t pose_age_ms; // 位置环使用的雷达位姿的时龄，单位：ms
+} LatencyReport_t;
+
+// 导出数据写入函数，整块写入成功返回 true，否则稍后以同一数据重试
+typedef bool (*LatencyWriteFunc_t)(const uint8_t *data, uint16_t size);
+
+/**
+ * @brief 端到端延迟直方图
+ * @details 以 IMU 数据就绪中断的 DWT 时间戳为起点，经姿态快照传到底盘电机写入，
+ *          统计采样到输出的延迟、输出抖动，以及位置环所用雷达位姿的时龄。
+ *          输出统计由控制流水线线程写入，位姿时龄由位置环线程写入，各自单写者。
+ */
+class LatencyMonitor
+{
+public:
+    static const uint32_t BINS = 32;
+
+    LatencyMonitor();
+
+    /**
+     * @brief 记录一次电机输出
+     * @param sample_cycle 输出所用样本的数据就绪时刻 (DWT 周期计数)
+     * @param output_cycle 电机写入完成时刻 (DWT 周期计数)
+     */
+    void recordOutput(uint32_t sample_cycle, uint32_t output_cycle);
+
+    /**
+     * @brief 记录一次位置环使用的雷达位姿时龄
+     * @param age_us 时龄，单位：us
+     */
+    void recordPoseAge(uint32_t age_us);
+
+    /**
+     * @brief 生成摘要记录
+     */
+    void getReport(LatencyReport_t *report) const;
+
+    /**
+     * @brief 开始以文本形式导出全部直方图，导出完成后清零
+     */
+    void dumpStart();
+
+    /**
+     * @brief 导出一个直方图，需周期调用直至返回 true
+     * @param write 写入函数
+     * @return 导出是否完成 (未在导出时也返回 true)
+     */
+    bool dumpStep(LatencyWriteFunc_t write);
+
+    const utils::Histogram<BINS> &getLatency() const { return latency_us_; }
+    const utils::Histogram<BINS> &getJitter() const { return jitter_us_; }
+    const utils::Histogram<BINS> &getPoseAge() const { return pose_age_ms_; }
+
+private:
+    utils::Histogram<BINS> latency_us_;
+    utils::Histogram<BINS> jitter_us_;
+    utils::Histogram<BINS> pose_age_ms_;
+
+    uint32_t last_sample_cycle_;
+    uint32_t last_output_cycle_;
+    bool has_last_;
+
+    // 清零请求由各自的写者线程执行，避免与写入并发
+    volatile bool reset_output_pending_;
+    volatile bool reset_pose_pending_;
+
+    volatile bool dumping_;
+    uint8_t dump_index_;
+};
+
+#endif // __LATENCY_MONITOR_H__
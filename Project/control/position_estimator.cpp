@@ -0,0 +1,376 @@
+#include "position_estimator.h"
+#include "math_const.h"
+#include <math.h>
+#include <string.h>
+
+// 两次预测的最大间隔，超过时视为流水线中断，只推进时间不积分
+static constexpr float MAX_PREDICT_DT = 0.02f;
+// 初始速度与零偏的不确定度
+static constexpr float INIT_VEL_STD = 0.5f;
+static constexpr float INIT_BIAS_STD = 0.3f;
+
+PositionEstimator::PositionEstimator(const PositionEstimatorConfig_t &config, Lidar *lidar, UPT20X *flow)
+    : config_(config), lidar_(lidar), flow_(flow), yaw_offset_(0.0f), reset_pending_(false),
+      initialized_(false), last_cycle_(0), last_fuse_cycle_(0), lidar_seq_(0), flow_seq_(0),
+      history_head_(0), history_count_(0),
+      fuse_count_(0), replay_count_(0), drop_count_(0),
+      flow_fuse_count_(0), flow_reject_count_(0)
+{
+    memset(axes_, 0, sizeof(axes_));
+}
+
+void PositionEstimator::update(const StateSnapshot &snapshot)
+{
+    if (lidar_ == nullptr)
+    {
+        return;
+    }
+    if (reset_pending_)
+    {
+        initialized_ = false;
+        history_count_ = 0;
+        reset_pending_ = false;
+    }
+
+    const uint32_t cycle = snapshot.sample_cycle;
+    LidarPoseSample sample;
+    const uint32_t seq = lidar_->getPoseSample(sample);
+    const bool has_pose = (seq != lidar_seq_) && (seq != 0);
+    lidar_seq_ = seq;
+
+    OpticalFlowData flow;
+    bool has_flow = false;
+    if (flow_ != nullptr)
+    {
+        const uint32_t flow_seq = flow_->getSample(flow);
+        has_flow = (flow_seq != flow_seq_) && (flow_seq != 0);
+        flow_seq_ = flow_seq;
+    }
+
+    if (!initialized_)
+    {
+        if (has_pose)
+        {
+            initialize(sample, cycle);
+            publish(cycle);
+        }
+        return;
+    }
+
+    // 1. 预测：IMU 速率积分旋转到地面坐标系的加速度
+    float dt = (float)(cycle - last_cycle_) / (float)SystemCoreClock;
+    last_cycle_ = cycle;
+    float accel[3] = {0.0f, 0.0f, 0.0f};
+    float gyro_delta[3] = {0.0f, 0.0f, 0.0f};
+    if (dt > 0.0f && dt <= MAX_PREDICT_DT)
+    {
+        // 机体系比力旋转到地面坐标系 (Z 轴向上)，再减去重力
+        rotateToGround(snapshot, snapshot.accel, accel);
+        accel[2] -= GRAVITY_CONST;
+        for (int i = 0; i < 3; i++)
+        {
+            predictAxis(axes_[i], accel[i], dt);
+            gyro_delta[i] = snapshot.gyro[i] * dt;
+        }
+    }
+    else
+    {
+        dt = 0.0f;
+    }
+
+    // 2. 保存历史点供延迟观测回放
+    HistoryEntry &entry = history_[history_head_];
+    entry.cycle = cycle;
+    entry.dt = dt;
+    for (int i = 0; i < 3; i++)
+    {
+        entry.accel[i] = accel[i];
+        entry.gyro_delta[i] = gyro_delta[i];
+        entry.axes[i] = axes_[i];
+    }
+    history_head_ = (history_head_ + 1) % HISTORY_SIZE;
+    if (history_count_ < HISTORY_SIZE)
+    {
+        history_count_++;
+    }
+
+    // 3. 延迟融合雷达位姿与光流速度
+    if (has_pose)
+    {
+        fusePose(sample);
+    }
+    if (has_flow)
+    {
+        fuseFlow(snapshot, flow);
+    }
+
+    publish(cycle);
+}
+
+void PositionEstimator::getEstimate(PositionEstimate &estimate) const
+{
+    estimate_.read(estimate);
+    const uint32_t timeout_cycles = (SystemCoreClock / 1000u) * config_.timeout_ms;
+    if (estimate.valid && (DWT->CYCCNT - estimate.fuse_cycle) > timeout_cycles)
+    {
+        estimate.valid = false;
+    }
+}
+
+void PositionEstimator::rotateToGround(const StateSnapshot &snapshot, const float body[3], float ground[3]) const
+{
+    // 机体系向量经四元数旋转到 IMU 参考系 (Z 轴向上)
+    const float q0 = snapshot.q[0], q1 = snapshot.q[1], q2 = snapshot.q[2], q3 = snapshot.q[3];
+    const float ax = body[0], ay = body[1], az = body[2];
+    const float ex = (1.0f - 2.0f * (q2 * q2 + q3 * q3)) * ax + 2.0f * (q1 * q2 - q0 * q3) * ay + 2.0f * (q1 * q3 + q0 * q2) * az;
+    const float ey = 2.0f * (q1 * q2 + q0 * q3) * ax + (1.0f - 2.0f * (q1 * q1 + q3 * q3)) * ay + 2.0f * (q2 * q3 - q0 * q1) * az;
+    const float ez = 2.0f * (q1 * q3 - q0 * q2) * ax + 2.0f * (q2 * q3 + q0 * q1) * ay + (1.0f - 2.0f * (q1 * q1 + q2 * q2)) * az;
+
+    // 绕 Z 轴转到地面坐标系
+    const float yaw = yaw_offset_ + config_.lidar_yaw;
+    const float c = cosf(yaw);
+    const float s = sinf(yaw);
+    ground[0] = c * ex + s * ey;
+    ground[1] = -s * ex + c * ey;
+    ground[2] = ez;
+}
+
+void PositionEstimator::predictAxis(AxisState &axis, float accel, float dt) const
+{
+    // x = [p, v, b]，p' = v，v' = a - b，b' = 0
+    const float a = accel - axis.x[2];
+    const float dt2 = 0.5f * dt * dt;
+    axis.x[0] += axis.x[1] * dt + a * dt2;
+    axis.x[1] += a * dt;
+
+    // P = F P F' + Q，F = [1 dt -dt^2/2; 0 1 -dt; 0 0 1]
+    float (&P)[3][3] = axis.P;
+    float FP[3][3];
+    for (int j = 0; j < 3; j++)
+    {
+        FP[0][j] = P[0][j] + dt * P[1][j] - dt2 * P[2][j];
+        FP[1][j] = P[1][j] - dt * P[2][j];
+        FP[2][j] = P[2][j];
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        P[i][0] = FP[i][0] + dt * FP[i][1] - dt2 * FP[i][2];
+        P[i][1] = FP[i][1] - dt * FP[i][2];
+        P[i][2] = FP[i][2];
+    }
+
+    // 加速度噪声经 G = [dt^2/2, dt, 0] 进入位置与速度，零偏为随机游走
+    const float qa = config_.accel_noise * config_.accel_noise;
+    P[0][0] += qa * dt2 * dt2;
+    P[0][1] += qa * dt2 * dt;
+    P[1][0] += qa * dt2 * dt;
+    P[1][1] += qa * dt * dt;
+    P[2][2] += config_.bias_noise * config_.bias_noise * dt;
+}
+
+void PositionEstimator::fuseAxis(AxisState &axis, uint32_t index, float z, float noise_var) const
+{
+    // H 为第 index 个状态的单位行向量 (0: 位置，1: 速度)
+    float (&P)[3][3] = axis.P;
+    const float S = P[index][index] + noise_var;
+    if (S <= 0.0f)
+    {
+        return;
+    }
+    float K[3];
+    for (int i = 0; i < 3; i++)
+    {
+        K[i] = P[i][index] / S;
+    }
+    const float innovation = z - axis.x[index];
+    for (int i = 0; i < 3; i++)
+    {
+        axis.x[i] += K[i] * innovation;
+    }
+    // P = (I - K H) P
+    float row[3] = {P[index][0], P[index][1], P[index][2]};
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            P[i][j] -= K[i] * row[j];
+        }
+    }
+}
+
+bool PositionEstimator::fuseDelayed(uint32_t meas_cycle, const float *z, uint32_t axis_count, uint32_t state_index, float noise_var)
+{
+    // 从最新向最旧查找测量时刻所在的历史点
+    uint32_t back = 0;
+    uint32_t index = 0;
+    bool found = false;
+    for (; back < history_count_; back++)
+    {
+        index = (history_head_ + HISTORY_SIZE - 1 - back) % HISTORY_SIZE;
+        if ((int32_t)(meas_cycle - history_[index].cycle) >= 0)
+        {
+            found = true;
+            break;
+        }
+    }
+    if (!found)
+    {
+        // 测量早于全部历史，无法回放
+        drop_count_++;
+        return false;
+    }
+
+    // 在测量时刻的状态上更新，再用保存的输入预测回当前时刻
+    AxisState state[3];
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        state[i] = history_[index].axes[i];
+        if (i < axis_count)
+        {
+            fuseAxis(state[i], state_index, z[i], noise_var);
+        }
+        history_[index].axes[i] = state[i];
+    }
+    for (uint32_t k = back; k > 0; k--)
+    {
+        HistoryEntry &entry = history_[(history_head_ + HISTORY_SIZE - k) % HISTORY_SIZE];
+        for (int i = 0; i < 3; i++)
+        {
+            if (entry.dt > 0.0f)
+            {
+                predictAxis(state[i], entry.accel[i], entry.dt);
+            }
+            entry.axes[i] = state[i];
+        }
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        axes_[i] = state[i];
+    }
+
+    if (back > 0)
+    {
+        replay_count_++;
+    }
+    return true;
+}
+
+void PositionEstimator::fusePose(const LidarPoseSample &sample)
+{
+    const float z[3] = {sample.x, sample.y, sample.z};
+    const uint32_t delay_cycles = (uint32_t)(config_.lidar_delay_ms * (float)(SystemCoreClock / 1000u));
+    if (fuseDelayed(sample.rx_cycle - delay_cycles, z, 3, 0, config_.pos_noise * config_.pos_noise))
+    {
+        fuse_count_++;
+        last_fuse_cycle_ = DWT->CYCCNT;
+    }
+}
+
+void PositionEstimator::fuseFlow(const StateSnapshot &snapshot, const OpticalFlowData &flow)
+{
+    if (!flow.valid || flow.integration_time == 0 || flow.confidence == 0 ||
+        flow.confidence < config_.flow_min_confidence ||
+        flow.distance < config_.flow_min_distance || flow.distance > config_.flow_max_distance)
+    {
+        flow_reject_count_++;
+        return;
+    }
+
+    // 积分区间 [start, end]，由接收时刻减去传输延迟得到
+    const uint32_t delay_cycles = (uint32_t)(config_.flow_delay_ms * (float)(SystemCoreClock / 1000u));
+    const uint32_t span_cycles = flow.integration_time * (SystemCoreClock / 1000000u);
+    const uint32_t end_cycle = flow.rx_cycle - delay_cycles;
+    const uint32_t start_cycle = end_cycle - span_cycles;
+
+    // 同一区间内的机体旋转，转到传感器坐标系
+    float angle[3];
+    if (!gyroIntegral(start_cycle, end_cycle, angle))
+    {
+        drop_count_++;
+        return;
+    }
+    const float c = cosf(config_.flow_yaw);
+    const float s = sinf(config_.flow_yaw);
+    const float gx = c * angle[0] + s * angle[1];
+    const float gy = -s * angle[0] + c * angle[1];
+
+    // 光流为绕传感器 X/Y 轴的右手转角，去除旋转分量后乘以测距得到传感器坐标系速度
+    const float span = (float)flow.integration_time * 1e-6f;
+    const float range = (float)flow.distance * 0.001f;
+    const float rate_x = (flow.flow_x - gx) / span;
+    const float rate_y = (flow.flow_y - gy) / span;
+    const float vx = -rate_y * range;
+    const float vy = rate_x * range;
+
+    // 传感器 -> 机体 -> 地面坐标系，垂直速度由雷达位姿约束，这里按 0 处理
+    const float body[3] = {c * vx - s * vy, s * vx + c * vy, 0.0f};
+    float ground[3];
+    rotateToGround(snapshot, body, ground);
+
+    // 置信度越低测量噪声越大，速度取区间中点时刻
+    const float noise_var = config_.flow_noise * config_.flow_noise * 100.0f / (float)flow.confidence;
+    if (fuseDelayed(end_cycle - span_cycles / 2, ground, 2, 1, noise_var))
+    {
+        flow_fuse_count_++;
+    }
+}
+
+bool PositionEstimator::gyroIntegral(uint32_t start_cycle, uint32_t end_cycle, float angle[3]) const
+{
+    for (int i = 0; i < 3; i++)
+    {
+        angle[i] = 0.0f;
+    }
+    // 累加 (start, end] 内各预测步的陀螺仪积分，区间须完整落在历史中
+    for (uint32_t back = 0; back < history_count_; back++)
+    {
+        const HistoryEntry &entry = history_[(history_head_ + HISTORY_SIZE - 1 - back) % HISTORY_SIZE];
+        if ((int32_t)(entry.cycle - end_cycle) > 0)
+        {
+            continue;
+        }
+        if ((int32_t)(entry.cycle - start_cycle) <= 0)
+        {
+            return true;
+        }
+        for (int i = 0; i < 3; i++)
+        {
+            angle[i] += entry.gyro_delta[i];
+        }
+    }
+    return false;
+}
+
+void PositionEstimator::initialize(const LidarPoseSample &sample, uint32_t cycle)
+{
+    const float z[3] = {sample.x, sample.y, sample.z};
+    for (int i = 0; i < 3; i++)
+    {
+        AxisState &axis = axes_[i];
+        memset(&axis, 0, sizeof(axis));
+        axis.x[0] = z[i];
+        axis.P[0][0] = config_.pos_noise * config_.pos_noise;
+        axis.P[1][1] = INIT_VEL_STD * INIT_VEL_STD;
+        axis.P[2][2] = INIT_BIAS_STD * INIT_BIAS_STD;
+    }
+    history_head_ = 0;
+    history_count_ = 0;
+    last_cycle_ = cycle;
+    last_fuse_cycle_ = DWT->CYCCNT;
+    initialized_ = true;
+}
+
+void PositionEstimator::publish(uint32_t cycle)
+{
+    PositionEstimate estimate;
+    for (int i = 0; i < 3; i++)
+    {
+        estimate.pos[i] = axes_[i].x[0];
+        estimate.vel[i] = axes_[i].x[1];
+        estimate.accel_bias[i] = axes_[i].x[2];
+    }
+    estimate.cycle = cycle;
+    estimate.fuse_cycle = last_fuse_cycle_;
+    estimate.valid = initialized_;
+    estimate_.write(estimate);
+}
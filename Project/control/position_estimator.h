@@ -0,0 +1,142 @@
+#ifndef __POSITION_ESTIMATOR_H__
+#define __POSITION_ESTIMATOR_H__
+
+#include "main.h"
+#include "Attitude.h"
+#include "lidar.h"
+#include "upt20x.h"
+#include "seqlock.h"
+
+/**
+ * @brief 位置估计器配置
+ */
+typedef struct
+{
+    float accel_noise;    // 加速度测量噪声标准差，单位：m/s^2
+    float bias_noise;     // 加速度零偏随机游走，单位：m/s^2/sqrt(s)
+    float pos_noise;      // 雷达位置测量噪声标准差，单位：m
+    float lidar_delay_ms; // 雷达位姿的测量时刻早于接收时刻的时间，单位：ms
+    float lidar_yaw;      // 雷达坐标系相对偏航原点的安装偏角，单位：rad
+    uint32_t timeout_ms;  // 超过该时间未融合雷达数据则估计无效
+
+    float flow_noise;            // 光流速度测量噪声标准差 (置信度 100% 时)，单位：m/s
+    float flow_delay_ms;         // 光流积分区间结束时刻早于接收时刻的时间，单位：ms
+    float flow_yaw;              // 光流传感器相对机体的安装偏角，单位：rad
+    uint8_t flow_min_confidence; // 低于该置信度的光流数据不融合，百分比
+    uint16_t flow_min_distance;  // 光流测距有效下限，单位：mm
+    uint16_t flow_max_distance;  // 光流测距有效上限，单位：mm
+} PositionEstimatorConfig_t;
+
+/**
+ * @brief 位置估计结果 (地面坐标系，未减去 Move 的原点偏移)
+ */
+struct PositionEstimate
+{
+    float pos[3];        // 位置，单位：m
+    float vel[3];        // 速度，单位：m/s
+    float accel_bias[3]; // 加速度零偏，单位：m/s^2
+    uint32_t cycle;      // 估计对应的 IMU 数据就绪时刻 (DWT 周期计数)
+    uint32_t fuse_cycle; // 最近一次融合雷达位姿的时刻 (DWT 周期计数)
+    bool valid;          // 已初始化且雷达数据未超时
+};
+
+/**
+ * @brief 位置/速度/加速度零偏 9 状态卡尔曼滤波
+ * @details 以 IMU 速率用姿态旋转后的加速度做预测，雷达位姿与光流速度作为延迟观测融合：
+ *          每次预测后保存状态、协方差与输入，观测到达时回退到测量时刻所在的历史点更新，
+ *          再用保存的输入重新预测到当前时刻，得到高频、低延迟的位置与速度。
+ *          光流按积分区间内的陀螺仪积分去除旋转分量，乘以测距得到机体系水平速度，
+ *          再旋转到地面坐标系，测量噪声按置信度加权。
+ *          零偏建模在地面坐标系，过程噪声与观测均按轴独立，故协方差按轴分块 (3 个 3x3)，
+ *          与完整 9x9 协方差等价。
+ *          update() 只能在单个线程 (控制流水线) 中调用，getEstimate() 可在任意任务中调用。
+ */
+class PositionEstimator
+{
+public:
+    static const uint32_t HISTORY_SIZE = 64; // 500Hz 下约 128ms
+
+    PositionEstimator(const PositionEstimatorConfig_t &config, Lidar *lidar, UPT20X *flow = nullptr);
+
+    /**
+     * @brief 以最新姿态快照预测一步，并融合新到达的雷达位姿
+     * @param snapshot 姿态快照 (四元数、机体系加速度、数据就绪时刻)
+     */
+    void update(const StateSnapshot &snapshot);
+
+    /**
+     * @brief 获取一致的估计结果
+     */
+    void getEstimate(PositionEstimate &estimate) const;
+
+    /**
+     * @brief 设置地面坐标系相对 IMU 航向的偏航原点，单位：rad
+     */
+    void setYawOffset(float yaw) { yaw_offset_ = yaw; }
+
+    /**
+     * @brief 请求重置，下一次雷达观测到达时重新初始化
+     */
+    void reset() { reset_pending_ = true; }
+
+    uint32_t getFuseCount() const { return fuse_count_; }
+    uint32_t getReplayCount() const { return replay_count_; }
+    uint32_t getDropCount() const { return drop_count_; }
+    uint32_t getFlowFuseCount() const { return flow_fuse_count_; }
+    uint32_t getFlowRejectCount() const { return flow_reject_count_; }
+
+private:
+    // 单轴状态 [位置, 速度, 零偏] 与协方差
+    struct AxisState
+    {
+        float x[3];
+        float P[3][3];
+    };
+
+    // 历史点：预测到 cycle 时刻后的状态及得到它所用的输入
+    struct HistoryEntry
+    {
+        uint32_t cycle;
+        float accel[3];
+        float gyro_delta[3]; // 本步机体系陀螺仪积分，单位：rad
+        float dt;
+        AxisState axes[3];
+    };
+
+    PositionEstimatorConfig_t config_;
+    Lidar *lidar_;
+    UPT20X *flow_;
+    volatile float yaw_offset_;
+    volatile bool reset_pending_;
+
+    bool initialized_;
+    AxisState axes_[3];
+    uint32_t last_cycle_;
+    uint32_t last_fuse_cycle_;
+    uint32_t lidar_seq_;
+    uint32_t flow_seq_;
+
+    HistoryEntry history_[HISTORY_SIZE];
+    uint32_t history_head_;  // 下一个写入位置
+    uint32_t history_count_;
+
+    utils::SeqLock<PositionEstimate> estimate_;
+
+    uint32_t fuse_count_;
+    uint32_t replay_count_;
+    uint32_t drop_count_;
+    uint32_t flow_fuse_count_;
+    uint32_t flow_reject_count_;
+
+    void rotateToGround(const StateSnapshot &snapshot, const float body[3], float ground[3]) const;
+    void predictAxis(AxisState &axis, float accel, float dt) const;
+    void fuseAxis(AxisState &axis, uint32_t index, float z, float noise_var) const;
+    bool fuseDelayed(uint32_t meas_cycle, const float *z, uint32_t axis_count, uint32_t state_index, float noise_var);
+    void fusePose(const LidarPoseSample &sample);
+    void fuseFlow(const StateSnapshot &snapshot, const OpticalFlowData &flow);
+    bool gyroIntegral(uint32_t start_cycle, uint32_t end_cycle, float angle[3]) const;
+    void initialize(const LidarPoseSample &sample, uint32_t cycle);
+    void publish(uint32_t cycle);
+};
+
+#endif // __POSITION_ESTIMATOR_H__
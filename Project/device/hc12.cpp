@@ -1,6 +1,7 @@
 #include "hc12.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include "cmsis_os.h"
 
 /**
@@ -14,7 +15,20 @@ HC12::HC12(UART_HandleTypeDef *huart, GPIO_TypeDef *set_port, uint16_t set_pin)
     , set_port(set_port)
     , set_pin(set_pin)
     , is_in_at_mode(false)
-    , rx_index(0)
+    , initialized(false)
+    , timer(nullptr)
+    , cmd_head(0)
+    , cmd_tail(0)
+    , state(STATE_IDLE)
+    , state_tick(0)
+    , response_len(0)
+    , response_lines(0)
+    , tx_head(0)
+    , tx_tail(0)
+    , tx_chunk(0)
+    , tx_busy(false)
+    , tx_cmd_active(false)
+    , rx_read_pos(0)
 {
     // 设置默认配置
     config.mode = HC12_MODE_FU3;
@@ -24,8 +38,9 @@ HC12::HC12(UART_HandleTypeDef *huart, GPIO_TypeDef *set_port, uint16_t set_pin)
     config.format.data_bits = 8;
     config.format.parity = 'N';
     config.format.stop_bits = 1;
-    
-    // 清空接收缓冲区
+
+    // 清空缓冲区
+    memset(response, 0, sizeof(response));
     memset(rx_buffer, 0, sizeof(rx_buffer));
 }
 
@@ -43,284 +58,437 @@ HC12::~HC12()
  */
 HAL_StatusTypeDef HC12::init()
 {
-    if (!huart || !set_port) {
+    if (!huart || !set_port || !huart->hdmatx || !huart->hdmarx) {
         return HAL_ERROR;
     }
-    
+    if (initialized) {
+        return HAL_OK;
+    }
+
     // SET引脚置高电平，退出AT模式
     HAL_GPIO_WritePin(set_port, set_pin, GPIO_PIN_SET);
-    //osDelay(RESET_DELAY);
-    
+
+    startReceive();
+
+    // 创建后台状态机定时器
+    osTimerAttr_t timer_attr = {
+        "HC12Timer", // 名称
+        0,           // 属性
+        NULL,        // 内存区块
+        0            // 大小
+    };
+    timer = osTimerNew(timerCallback, osTimerPeriodic, this, &timer_attr);
+    if (!timer || osTimerStart((osTimerId_t)timer, PROCESS_PERIOD) != osOK) {
+        return HAL_ERROR;
+    }
+
+    initialized = true;
     return HAL_OK;
 }
 
 /**
- * @brief 进入AT指令模式
- * @retval HAL状态
+ * @brief 定时器回调，驱动后台状态机
+ * @param argument: HC12实例指针
+ */
+void HC12::timerCallback(void *argument)
+{
+    static_cast<HC12 *>(argument)->process();
+}
+
+/**
+ * @brief 启动DMA循环接收
+ */
+void HC12::startReceive()
+{
+    rx_read_pos = 0;
+    HAL_UART_Receive_DMA(huart, rx_buffer, RX_BUFFER_SIZE);
+}
+
+/**
+ * @brief 获取DMA当前写入位置
+ * @retval 写入位置
+ */
+uint16_t HC12::rxWritePos() const
+{
+    uint16_t pos = RX_BUFFER_SIZE - __HAL_DMA_GET_COUNTER(huart->hdmarx);
+    return (pos >= RX_BUFFER_SIZE) ? 0 : pos;
+}
+
+/**
+ * @brief 将AT指令加入队列(私有函数)
+ * @param cmd: AT指令字符串
+ * @param expect: 期望的响应前缀，nullptr表示任意响应
+ * @param lines: 响应行数
+ * @param apply: 成功后更新的配置项
+ * @param value: 配置项的值
+ * @param output: APPLY_PARAMS时输出配置的位置
+ * @param callback: 完成回调
+ * @param context: 回调参数
+ * @retval HAL_OK已入队, HAL_BUSY队列已满, HAL_ERROR参数错误
  */
-HAL_StatusTypeDef HC12::enterATMode()
+HAL_StatusTypeDef HC12::submitCommand(const char *cmd, const char *expect, uint8_t lines,
+                                      ApplyType apply, int32_t value, HC12_Config_t *output,
+                                      HC12_CommandCallback callback, void *context)
 {
-    if (!huart) {
+    if (!cmd || !initialized || strlen(cmd) >= sizeof(cmd_queue[0].cmd)) {
         return HAL_ERROR;
     }
-    
-    // SET引脚置低电平
-    HAL_GPIO_WritePin(set_port, set_pin, GPIO_PIN_RESET);
-    osDelay(SET_DELAY);
-    
-    is_in_at_mode = true;
+
+    taskENTER_CRITICAL();
+    uint16_t next = (cmd_head + 1) % CMD_QUEUE_SIZE;
+    if (next == cmd_tail) {
+        taskEXIT_CRITICAL();
+        return HAL_BUSY;
+    }
+    Command &command = cmd_queue[cmd_head];
+    strcpy(command.cmd, cmd);
+    command.expect = expect;
+    command.lines = (lines > 0) ? lines : 1;
+    command.timeout = AT_TIMEOUT;
+    command.apply = apply;
+    command.value = value;
+    command.output = output;
+    command.callback = callback;
+    command.context = context;
+    cmd_head = next;
+    taskEXIT_CRITICAL();
+
     return HAL_OK;
 }
 
 /**
- * @brief 退出AT指令模式
- * @retval HAL状态
+ * @brief 结束队首指令并通知调用者(私有函数)
+ * @param status: 执行结果
  */
-HAL_StatusTypeDef HC12::exitATMode()
+void HC12::completeCommand(HAL_StatusTypeDef status)
 {
-    if (!huart) {
-        return HAL_ERROR;
+    const Command &command = cmd_queue[cmd_tail];
+
+    if (status == HAL_OK && command.expect &&
+        strncmp(response, command.expect, strlen(command.expect)) != 0) {
+        status = HAL_ERROR;
     }
-    
-    // SET引脚置高电平
-    HAL_GPIO_WritePin(set_port, set_pin, GPIO_PIN_SET);
-    osDelay(EXIT_DELAY);
-    
-    is_in_at_mode = false;
-    return HAL_OK;
+    if (status == HAL_OK) {
+        applyCommand(command);
+    }
+    if (command.callback) {
+        command.callback(status, response, command.context);
+    }
+
+    cmd_tail = (cmd_tail + 1) % CMD_QUEUE_SIZE;
+    state = STATE_SEND;
 }
 
 /**
- * @brief 发送AT指令并接收响应(私有函数)
- * @param cmd: AT指令字符串
- * @param response: 响应缓冲区
- * @param timeout: 超时时间(ms)
- * @retval HAL状态
+ * @brief 指令执行成功后更新本地配置(私有函数)
+ * @param command: 已完成的指令
  */
-HAL_StatusTypeDef HC12::sendATCommand(const char *cmd, char *response, uint16_t timeout)
+void HC12::applyCommand(const Command &command)
 {
-    if (!cmd || !is_in_at_mode) {
-        return HAL_ERROR;
+    switch (command.apply) {
+    case APPLY_MODE:
+        config.mode = (HC12_Mode_t)command.value;
+        break;
+    case APPLY_BAUD:
+        config.baud_rate = (HC12_Baud_t)command.value;
+        reinitUart(config.baud_rate);
+        break;
+    case APPLY_CHANNEL:
+        config.channel = (uint8_t)command.value;
+        break;
+    case APPLY_POWER:
+        config.power = (HC12_Power_t)command.value;
+        break;
+    case APPLY_FORMAT:
+        config.format.data_bits = (uint8_t)(command.value & 0xFF);
+        config.format.parity = (char)((command.value >> 8) & 0xFF);
+        config.format.stop_bits = (uint8_t)((command.value >> 16) & 0xFF);
+        break;
+    case APPLY_DEFAULT:
+        // 恢复默认配置
+        config.mode = HC12_MODE_FU3;
+        config.baud_rate = HC12_BAUD_9600;
+        config.channel = 1;
+        config.power = HC12_POWER_8;
+        if (huart->Init.BaudRate != (uint32_t)HC12_BAUD_9600) {
+            reinitUart(HC12_BAUD_9600);
+        }
+        break;
+    case APPLY_PARAMS:
+        parseParams(command.output);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief 以新波特率重新初始化UART(私有函数)
+ * @param baud: 波特率
+ * @note 模块应答后即以新波特率通信，本端须同步切换；
+ *       DeInit/Init会经MspDeInit/MspInit重新配置DMA，之后重启循环接收
+ */
+void HC12::reinitUart(uint32_t baud)
+{
+    HAL_UART_Abort(huart);
+
+    taskENTER_CRITICAL();
+    tx_chunk = 0;
+    tx_cmd_active = false;
+    tx_busy = false;
+    taskEXIT_CRITICAL();
+
+    HAL_UART_DeInit(huart);
+    huart->Init.BaudRate = baud;
+    HAL_UART_Init(huart);
+    startReceive();
+}
+
+/**
+ * @brief 解析AT+RX的响应(私有函数)
+ * @param out: 输出配置，可为nullptr
+ * @note 响应格式: OK+B9600 / OK+RC001 / OK+RP:+20dBm / OK+FU3
+ */
+void HC12::parseParams(HC12_Config_t *out)
+{
+    static const int8_t power_dbm[8] = {-1, 2, 5, 8, 11, 14, 17, 20};
+    const char *line = response;
+
+    while (line && *line) {
+        if (strncmp(line, "OK+B", 4) == 0) {
+            config.baud_rate = (HC12_Baud_t)atoi(line + 4);
+        } else if (strncmp(line, "OK+RC", 5) == 0) {
+            config.channel = (uint8_t)atoi(line + 5);
+        } else if (strncmp(line, "OK+RP:", 6) == 0) {
+            int dbm = atoi(line + 6);
+            for (uint8_t i = 0; i < 8; i++) {
+                if (power_dbm[i] == dbm) {
+                    config.power = (HC12_Power_t)(i + 1);
+                }
+            }
+        } else if (strncmp(line, "OK+FU", 5) == 0) {
+            config.mode = (HC12_Mode_t)atoi(line + 5);
+        }
+        line = strchr(line, '\n');
+        if (line) {
+            line++;
+        }
     }
-    
-    // 发送AT指令
-    HAL_StatusTypeDef status = HAL_UART_Transmit(huart, (uint8_t*)cmd, 
-                                                strlen(cmd), AT_TIMEOUT);
-    if (status != HAL_OK) {
-        return status;
+
+    if (out) {
+        *out = config;
     }
-    
-    // 接收响应
-    if (response) {
-        uint8_t rx_byte;
-        uint16_t rx_count = 0;
-        uint32_t start_tick = HAL_GetTick();
-        
-        while ((HAL_GetTick() - start_tick) < timeout) {
-            if (HAL_UART_Receive(huart, &rx_byte, 1, 1) == HAL_OK) {
-                response[rx_count++] = rx_byte;
-                if (rx_byte == '\n' || rx_count >= 63) {
-                    response[rx_count] = '\0';
-                    break;
+}
+
+/**
+ * @brief 后台状态机
+ * @note 由定时器每PROCESS_PERIOD毫秒调用一次
+ */
+void HC12::process()
+{
+    if (!initialized) {
+        return;
+    }
+
+    // 接收因错误停止时重新启动
+    if (huart->RxState == HAL_UART_STATE_READY) {
+        startReceive();
+    }
+
+    uint32_t now = HAL_GetTick();
+
+    switch (state) {
+    case STATE_IDLE:
+        if (cmd_head != cmd_tail) {
+            // 等待正在发送的透传数据发完后再拉低SET，避免数据被当作指令
+            taskENTER_CRITICAL();
+            if (!tx_busy) {
+                is_in_at_mode = true;
+                HAL_GPIO_WritePin(set_port, set_pin, GPIO_PIN_RESET);
+                state_tick = now;
+                state = STATE_ENTER_AT;
+            }
+            taskEXIT_CRITICAL();
+        }
+        break;
+
+    case STATE_ENTER_AT:
+        if (now - state_tick >= SET_DELAY) {
+            rx_read_pos = rxWritePos(); // 丢弃进入AT模式前收到的数据
+            state = STATE_SEND;
+        }
+        break;
+
+    case STATE_SEND:
+        if (cmd_head == cmd_tail) {
+            // 队列已空，退出AT模式
+            HAL_GPIO_WritePin(set_port, set_pin, GPIO_PIN_SET);
+            state_tick = now;
+            state = STATE_EXIT_AT;
+            break;
+        }
+        taskENTER_CRITICAL();
+        if (!tx_busy) {
+            uint16_t len = strlen(cmd_queue[cmd_tail].cmd);
+            memcpy(cmd_tx_buffer, cmd_queue[cmd_tail].cmd, len);
+            if (HAL_UART_Transmit_DMA(huart, cmd_tx_buffer, len) == HAL_OK) {
+                tx_cmd_active = true;
+                tx_busy = true;
+                response_len = 0;
+                response_lines = 0;
+                response[0] = '\0';
+                state_tick = now;
+                state = STATE_WAIT_RESPONSE;
+            }
+        }
+        taskEXIT_CRITICAL();
+        break;
+
+    case STATE_WAIT_RESPONSE:
+    {
+        uint16_t write_pos = rxWritePos();
+        while (rx_read_pos != write_pos && response_lines < cmd_queue[cmd_tail].lines) {
+            char c = (char)rx_buffer[rx_read_pos];
+            rx_read_pos = (rx_read_pos + 1) % RX_BUFFER_SIZE;
+            if (c == '\r') {
+                continue;
+            }
+            if (c == '\n') {
+                if (response_len == 0) {
+                    continue; // 跳过空行
                 }
+                response_lines++;
+            }
+            if (response_len < RESPONSE_SIZE - 1) {
+                response[response_len++] = c;
+                response[response_len] = '\0';
             }
         }
-        
-        if (rx_count == 0) {
-            return HAL_TIMEOUT;
+
+        if (response_lines >= cmd_queue[cmd_tail].lines) {
+            completeCommand(HAL_OK);
+        } else if (now - state_tick >= cmd_queue[cmd_tail].timeout) {
+            completeCommand(response_len > 0 ? HAL_ERROR : HAL_TIMEOUT);
         }
+        break;
+    }
+
+    case STATE_EXIT_AT:
+        if (now - state_tick >= EXIT_DELAY) {
+            taskENTER_CRITICAL();
+            is_in_at_mode = false;
+            state = STATE_IDLE;
+            rx_read_pos = rxWritePos();
+            // 继续发送AT模式期间积压的透传数据
+            if (!tx_busy && tx_head != tx_tail) {
+                startTransmitLocked();
+            }
+            taskEXIT_CRITICAL();
+        }
+        break;
     }
-    
-    return HAL_OK;
 }
 
 /**
  * @brief 设置工作模式
  * @param mode: 工作模式
+ * @param callback: 完成回调，可为nullptr
+ * @param context: 回调参数
  * @retval HAL状态
  */
-HAL_StatusTypeDef HC12::setMode(HC12_Mode_t mode)
+HAL_StatusTypeDef HC12::setMode(HC12_Mode_t mode, HC12_CommandCallback callback, void *context)
 {
     char cmd[16];
-    char response[64];
-    
-    // 进入AT模式
-    enterATMode();
-    
-    // 发送设置模式指令
     snprintf(cmd, sizeof(cmd), "AT+FU%d", mode);
-    HAL_StatusTypeDef status = sendATCommand(cmd, response, AT_TIMEOUT);
-    
-    if (status == HAL_OK) {
-        config.mode = mode;
-    }
-    
-    // 退出AT模式
-    exitATMode();
-    
-    return status;
+    return submitCommand(cmd, "OK", 1, APPLY_MODE, mode, nullptr, callback, context);
 }
 
 /**
  * @brief 设置波特率
  * @param baud: 波特率
+ * @param callback: 完成回调，可为nullptr
+ * @param context: 回调参数
  * @retval HAL状态
  */
-HAL_StatusTypeDef HC12::setBaudRate(HC12_Baud_t baud)
+HAL_StatusTypeDef HC12::setBaudRate(HC12_Baud_t baud, HC12_CommandCallback callback, void *context)
 {
     char cmd[16];
-    char response[64];
-    
-    // 进入AT模式
-    enterATMode();
-    
-    // 发送设置波特率指令
     snprintf(cmd, sizeof(cmd), "AT+B%d", baud);
-    HAL_StatusTypeDef status = sendATCommand(cmd, response, AT_TIMEOUT);
-    
-    if (status == HAL_OK) {
-        config.baud_rate = baud;
-    }
-    
-    // 退出AT模式
-    exitATMode();
-    
-    return status;
+    return submitCommand(cmd, "OK", 1, APPLY_BAUD, baud, nullptr, callback, context);
 }
 
 /**
  * @brief 设置通信频道
  * @param channel: 频道号(1-127)
+ * @param callback: 完成回调，可为nullptr
+ * @param context: 回调参数
  * @retval HAL状态
  */
-HAL_StatusTypeDef HC12::setChannel(uint8_t channel)
+HAL_StatusTypeDef HC12::setChannel(uint8_t channel, HC12_CommandCallback callback, void *context)
 {
     if (channel < 1 || channel > 127) {
         return HAL_ERROR;
     }
-    
+
     char cmd[16];
-    char response[64];
-    
-    // 进入AT模式
-    enterATMode();
-    
-    // 发送设置频道指令
     snprintf(cmd, sizeof(cmd), "AT+C%03d", channel);
-    HAL_StatusTypeDef status = sendATCommand(cmd, response, AT_TIMEOUT);
-    
-    if (status == HAL_OK) {
-        config.channel = channel;
-    }
-    
-    // 退出AT模式
-    exitATMode();
-    
-    return status;
+    return submitCommand(cmd, "OK", 1, APPLY_CHANNEL, channel, nullptr, callback, context);
 }
 
 /**
  * @brief 设置发射功率
  * @param power: 功率等级
+ * @param callback: 完成回调，可为nullptr
+ * @param context: 回调参数
  * @retval HAL状态
  */
-HAL_StatusTypeDef HC12::setPower(HC12_Power_t power)
+HAL_StatusTypeDef HC12::setPower(HC12_Power_t power, HC12_CommandCallback callback, void *context)
 {
     char cmd[16];
-    char response[64];
-    
-    // 进入AT模式
-    enterATMode();
-    
-    // 发送设置功率指令
     snprintf(cmd, sizeof(cmd), "AT+P%d", power);
-    HAL_StatusTypeDef status = sendATCommand(cmd, response, AT_TIMEOUT);
-    
-    if (status == HAL_OK) {
-        config.power = power;
-    }
-    
-    // 退出AT模式
-    exitATMode();
-    
-    return status;
+    return submitCommand(cmd, "OK", 1, APPLY_POWER, power, nullptr, callback, context);
 }
 
 /**
  * @brief 设置串口格式
  * @param format: 串口格式
+ * @param callback: 完成回调，可为nullptr
+ * @param context: 回调参数
  * @retval HAL状态
  */
-HAL_StatusTypeDef HC12::setUartFormat(const HC12_UartFormat_t &format)
+HAL_StatusTypeDef HC12::setUartFormat(const HC12_UartFormat_t &format, HC12_CommandCallback callback, void *context)
 {
     char cmd[16];
-    char response[64];
-    
-    // 进入AT模式
-    enterATMode();
-    
-    // 发送设置串口格式指令
     snprintf(cmd, sizeof(cmd), "AT+U%d%c%d", format.data_bits, format.parity, format.stop_bits);
-    HAL_StatusTypeDef status = sendATCommand(cmd, response, AT_TIMEOUT);
-    
-    if (status == HAL_OK) {
-        config.format = format;
-    }
-    
-    // 退出AT模式
-    exitATMode();
-    
-    return status;
+    int32_t value = format.data_bits | ((int32_t)(uint8_t)format.parity << 8) | ((int32_t)format.stop_bits << 16);
+    return submitCommand(cmd, "OK", 1, APPLY_FORMAT, value, nullptr, callback, context);
 }
 
 /**
  * @brief 获取固件版本
- * @param version: 版本字符串缓冲区
+ * @param callback: 完成回调，版本字符串通过response返回
+ * @param context: 回调参数
  * @retval HAL状态
  */
-HAL_StatusTypeDef HC12::getVersion(char *version)
+HAL_StatusTypeDef HC12::getVersion(HC12_CommandCallback callback, void *context)
 {
-    if (!version) {
+    if (!callback) {
         return HAL_ERROR;
     }
-    
-    // 进入AT模式
-    enterATMode();
-    
-    HAL_StatusTypeDef status = sendATCommand("AT+V", version, AT_TIMEOUT);
-    
-    // 退出AT模式
-    exitATMode();
-    
-    return status;
+
+    return submitCommand("AT+V", nullptr, 1, APPLY_NONE, 0, nullptr, callback, context);
 }
 
 /**
  * @brief 获取所有参数
- * @param config: 配置结构体指针
+ * @param config: 完成后写入配置的位置，可为nullptr，须在指令完成前保持有效
+ * @param callback: 完成回调，可为nullptr
+ * @param context: 回调参数
  * @retval HAL状态
  */
-HAL_StatusTypeDef HC12::getAllParams(HC12_Config_t *config)
+HAL_StatusTypeDef HC12::getAllParams(HC12_Config_t *config, HC12_CommandCallback callback, void *context)
 {
-    if (!config) {
-        return HAL_ERROR;
-    }
-    
-    char response[256];
-    
-    // 进入AT模式
-    enterATMode();
-    
-    HAL_StatusTypeDef status = sendATCommand("AT+RX", response, AT_TIMEOUT);
-    
-    if (status == HAL_OK) {
-        *config = this->config;
-    }
-    
-    // 退出AT模式
-    exitATMode();
-    
-    return status;
+    return submitCommand("AT+RX", "OK", 4, APPLY_PARAMS, 0, config, callback, context);
 }
 
 /**
@@ -334,105 +502,178 @@ const HC12_Config_t& HC12::getCurrentConfig() const
 
 /**
  * @brief 恢复出厂默认设置
+ * @param callback: 完成回调，可为nullptr
+ * @param context: 回调参数
  * @retval HAL状态
  */
-HAL_StatusTypeDef HC12::restoreDefault()
+HAL_StatusTypeDef HC12::restoreDefault(HC12_CommandCallback callback, void *context)
 {
-    char response[64];
-    
-    // 进入AT模式
-    enterATMode();
-    
-    HAL_StatusTypeDef status = sendATCommand("AT+DEFAULT", response, AT_TIMEOUT);
-    
-    if (status == HAL_OK) {
-        // 恢复默认配置
-        config.mode = HC12_MODE_FU3;
-        config.baud_rate = HC12_BAUD_9600;
-        config.channel = 1;
-        config.power = HC12_POWER_8;
-    }
-    
-    // 退出AT模式
-    exitATMode();
-    
-    return status;
+    return submitCommand("AT+DEFAULT", "OK", 1, APPLY_DEFAULT, 0, nullptr, callback, context);
 }
 
 /**
  * @brief 进入睡眠模式
+ * @param callback: 完成回调，可为nullptr
+ * @param context: 回调参数
+ * @retval HAL状态
+ */
+HAL_StatusTypeDef HC12::sleep(HC12_CommandCallback callback, void *context)
+{
+    return submitCommand("AT+SLEEP", "OK", 1, APPLY_NONE, 0, nullptr, callback, context);
+}
+
+/**
+ * @brief 发送任意AT指令
+ * @param cmd: AT指令字符串(不超过15字节)
+ * @param expect: 期望的响应前缀，nullptr表示任意响应
+ * @param lines: 响应行数
+ * @param callback: 完成回调，可为nullptr
+ * @param context: 回调参数
  * @retval HAL状态
  */
-HAL_StatusTypeDef HC12::sleep()
+HAL_StatusTypeDef HC12::sendCommand(const char *cmd, const char *expect, uint8_t lines,
+                                    HC12_CommandCallback callback, void *context)
 {
-    char response[64];
-    
-    // 进入AT模式
-    enterATMode();
-    
-    HAL_StatusTypeDef status = sendATCommand("AT+SLEEP", response, AT_TIMEOUT);
-    
-    // 退出AT模式
-    exitATMode();
-    
-    return status;
+    return submitCommand(cmd, expect, lines, APPLY_NONE, 0, nullptr, callback, context);
+}
+
+/**
+ * @brief 启动一段连续数据的DMA发送(私有函数)
+ * @note 调用者须处于临界区或发送完成中断中
+ */
+void HC12::startTransmitLocked()
+{
+    uint16_t end = (tx_head >= tx_tail) ? tx_head : TX_BUFFER_SIZE;
+    uint16_t len = end - tx_tail;
+    if (len == 0) {
+        return;
+    }
+    if (HAL_UART_Transmit_DMA(huart, &tx_buffer[tx_tail], len) == HAL_OK) {
+        tx_chunk = len;
+        tx_busy = true;
+    }
 }
 
 /**
  * @brief 发送数据(透传模式)
  * @param data: 发送数据
  * @param size: 数据长度
- * @retval HAL状态
+ * @retval HAL_OK已写入发送缓冲区, HAL_BUSY缓冲区空间不足
+ * @note AT模式期间数据暂存在缓冲区中，退出AT模式后自动发出
  */
 HAL_StatusTypeDef HC12::transmitData(const uint8_t *data, uint16_t size)
 {
-    if (!data || size == 0 || is_in_at_mode) {
+    if (!data || size == 0 || !initialized) {
         return HAL_ERROR;
     }
-    
-    return HAL_UART_Transmit(huart, (uint8_t*)data, size, 100);
+
+    taskENTER_CRITICAL();
+    uint16_t used = (tx_head + TX_BUFFER_SIZE - tx_tail) % TX_BUFFER_SIZE;
+    if (size > TX_BUFFER_SIZE - 1 - used) {
+        taskEXIT_CRITICAL();
+        return HAL_BUSY;
+    }
+
+    uint16_t first = TX_BUFFER_SIZE - tx_head;
+    if (first > size) {
+        first = size;
+    }
+    memcpy(&tx_buffer[tx_head], data, first);
+    memcpy(tx_buffer, data + first, size - first);
+    tx_head = (tx_head + size) % TX_BUFFER_SIZE;
+
+    // 有AT指令排队时不再启动新的数据段，让状态机尽快进入AT模式
+    if (!tx_busy && state == STATE_IDLE && cmd_head == cmd_tail) {
+        startTransmitLocked();
+    }
+    taskEXIT_CRITICAL();
+
+    return HAL_OK;
 }
 
 /**
  * @brief 接收数据(透传模式)
- * @param data: 接收缓冲区
+ * @param data: 接收缓冲区(至少255字节)
  * @param size: 接收到的数据长度
- * @param timeout: 超时时间
+ * @param timeout: 无数据时的最长等待时间
  * @retval HAL状态
  */
 HAL_StatusTypeDef HC12::receiveData(uint8_t *data, uint16_t *size, uint32_t timeout)
 {
-    if (!data || !size || is_in_at_mode) {
+    if (!data || !size || !initialized) {
         return HAL_ERROR;
     }
-    
+
     *size = 0;
     uint32_t start_tick = HAL_GetTick();
-    
-    while ((HAL_GetTick() - start_tick) < timeout) {
-        uint8_t rx_byte;
-        if (HAL_UART_Receive(huart, &rx_byte, 1, 1) == HAL_OK) {
-            data[(*size)++] = rx_byte;
-            if (*size >= 255) break;  // 防止缓冲区溢出
+
+    while (true) {
+        if (state != STATE_IDLE) {
+            return HAL_BUSY; // AT模式期间接收数据由状态机处理
+        }
+
+        taskENTER_CRITICAL();
+        uint16_t write_pos = rxWritePos();
+        while (rx_read_pos != write_pos && *size < 255) {
+            data[(*size)++] = rx_buffer[rx_read_pos];
+            rx_read_pos = (rx_read_pos + 1) % RX_BUFFER_SIZE;
+        }
+        taskEXIT_CRITICAL();
+
+        if (*size > 0 || (HAL_GetTick() - start_tick) >= timeout) {
+            break;
         }
+        osDelay(1);
     }
-    
+
     return (*size > 0) ? HAL_OK : HAL_TIMEOUT;
 }
 
 /**
- * @brief UART中断处理函数
- * @retval 无
+ * @brief UART发送完成回调
+ * @param huart: 触发回调的UART句柄
+ */
+void HC12::txCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart != this->huart || !tx_busy) {
+        return;
+    }
+
+    if (tx_cmd_active) {
+        tx_cmd_active = false;
+        tx_busy = false;
+        return;
+    }
+
+    tx_tail = (tx_tail + tx_chunk) % TX_BUFFER_SIZE;
+    tx_chunk = 0;
+    tx_busy = false;
+
+    // 仅在透传模式下继续发送，进入AT模式前须等待发送完成；
+    // 有AT指令排队时优先执行指令，积压数据在退出AT模式后继续发出，避免连续遥测饿死指令
+    if (state == STATE_IDLE && cmd_head == cmd_tail && tx_head != tx_tail) {
+        startTransmitLocked();
+    }
+}
+
+/**
+ * @brief UART错误回调
+ * @param huart: 触发回调的UART句柄
+ * @note 接收由process()重新启动；若发送被中止则丢弃当前数据段
  */
-void HC12::irqHandler()
+void HC12::errorCallback(UART_HandleTypeDef *huart)
 {
-    // 在这里可以处理UART接收中断
-    // 将接收到的数据存储到环形缓冲区中
-    uint8_t rx_data;
-    if (HAL_UART_Receive(huart, &rx_data, 1, 0) == HAL_OK) {
-        if (rx_index < sizeof(rx_buffer)) {
-            rx_buffer[rx_index++] = rx_data;
+    if (huart != this->huart) {
+        return;
+    }
+
+    if (tx_busy && huart->gState == HAL_UART_STATE_READY) {
+        if (!tx_cmd_active) {
+            tx_tail = (tx_tail + tx_chunk) % TX_BUFFER_SIZE;
         }
+        tx_chunk = 0;
+        tx_cmd_active = false;
+        tx_busy = false;
     }
 }
 
@@ -451,5 +692,31 @@ bool HC12::isInATMode() const
  */
 bool HC12::isInitialized() const
 {
-    return (huart != nullptr && set_port != nullptr);
+    return initialized;
+}
+
+/**
+ * @brief 检查是否有AT指令未执行完
+ * @retval true: 队列非空或仍处于AT模式
+ */
+bool HC12::isBusy() const
+{
+    return state != STATE_IDLE || cmd_head != cmd_tail;
+}
+
+/**
+ * @brief 等待所有AT指令执行完毕并回到透传模式
+ * @param timeout: 超时时间(ms)
+ * @retval HAL_OK: 已空闲, HAL_TIMEOUT: 超时
+ */
+HAL_StatusTypeDef HC12::waitIdle(uint32_t timeout)
+{
+    uint32_t start_tick = HAL_GetTick();
+    while (isBusy()) {
+        if ((HAL_GetTick() - start_tick) >= timeout) {
+            return HAL_TIMEOUT;
+        }
+        osDelay(PROCESS_PERIOD);
+    }
+    return HAL_OK;
 }
@@ -53,64 +53,157 @@ typedef struct {
     HC12_UartFormat_t format;   // 串口格式
 } HC12_Config_t;
 
+/**
+ * @brief AT指令完成回调函数类型
+ * @param status: HAL_OK响应匹配, HAL_ERROR响应不匹配, HAL_TIMEOUT超时
+ * @param response: 收到的响应文本(多行以'\n'分隔)
+ * @param context: 提交指令时传入的用户参数
+ * @note 在软件定时器任务中调用，应尽快返回，不可阻塞
+ */
+typedef void (*HC12_CommandCallback)(HAL_StatusTypeDef status, const char *response, void *context);
+
 /**
  * @brief HC-12无线串口通信模块类
+ * @details AT指令进入队列后由后台状态机依次执行：拉低SET、等待、DMA发送指令、
+ *          从环形接收缓冲区匹配响应、全部完成后拉高SET。透传数据同样经DMA发送，
+ *          AT模式期间暂存在发送缓冲区中，退出AT模式后继续发出，调用者均不会阻塞。
  */
 class HC12 {
+public:
+    // 静态常量定义
+    static const uint16_t AT_TIMEOUT = 1000;
+    static const uint16_t SET_DELAY = 40;
+    static const uint16_t EXIT_DELAY = 80;
+    static const uint16_t RESET_DELAY = 200;
+    static const uint16_t PROCESS_PERIOD = 5;      // 后台状态机运行周期(ms)
+    static const uint16_t CMD_QUEUE_SIZE = 8;      // AT指令队列深度
+    static const uint16_t TX_BUFFER_SIZE = 512;    // 透传发送环形缓冲区大小
+    static const uint16_t RX_BUFFER_SIZE = 256;    // DMA循环接收缓冲区大小
+    static const uint16_t RESPONSE_SIZE = 128;     // AT响应缓冲区大小
+
 private:
+    /* 指令成功后需要更新的配置项 */
+    enum ApplyType {
+        APPLY_NONE,
+        APPLY_MODE,
+        APPLY_BAUD,
+        APPLY_CHANNEL,
+        APPLY_POWER,
+        APPLY_FORMAT,
+        APPLY_DEFAULT,
+        APPLY_PARAMS
+    };
+
+    /* 排队中的AT指令 */
+    struct Command {
+        char cmd[16];                   // 指令文本
+        const char *expect;             // 期望的响应前缀，nullptr表示任意响应
+        uint8_t lines;                  // 需要接收的响应行数
+        uint16_t timeout;               // 响应超时(ms)
+        ApplyType apply;                // 成功后更新的配置项
+        int32_t value;                  // 配置项的值
+        HC12_Config_t *output;          // APPLY_PARAMS时输出配置的位置
+        HC12_CommandCallback callback;  // 完成回调
+        void *context;                  // 回调参数
+    };
+
+    /* 后台状态机状态 */
+    enum State {
+        STATE_IDLE,             // 透传模式
+        STATE_ENTER_AT,         // SET已拉低，等待SET_DELAY
+        STATE_SEND,             // 发送队首指令
+        STATE_WAIT_RESPONSE,    // 等待响应
+        STATE_EXIT_AT           // SET已拉高，等待EXIT_DELAY
+    };
+
     UART_HandleTypeDef *huart;      // UART句柄
     GPIO_TypeDef *set_port;         // SET引脚端口
     uint16_t set_pin;               // SET引脚号
     HC12_Config_t config;           // 当前配置
-    bool is_in_at_mode;             // 是否处于AT模式
-    uint8_t rx_buffer[256];         // 接收缓冲区
-    uint16_t rx_index;              // 接收索引
-    
+    volatile bool is_in_at_mode;    // 是否处于AT模式
+    bool initialized;               // 是否已初始化
+    void *timer;                    // 后台状态机定时器(osTimerId_t)
+
+    // AT指令队列
+    Command cmd_queue[CMD_QUEUE_SIZE];
+    volatile uint16_t cmd_head;
+    volatile uint16_t cmd_tail;
+    volatile State state;
+    uint32_t state_tick;            // 进入当前状态的时刻
+    char response[RESPONSE_SIZE];   // 当前指令的响应
+    uint16_t response_len;
+    uint8_t response_lines;
+
+    // 发送：透传数据环形缓冲区与AT指令缓冲区共用一路DMA
+    uint8_t tx_buffer[TX_BUFFER_SIZE];
+    volatile uint16_t tx_head;
+    volatile uint16_t tx_tail;
+    volatile uint16_t tx_chunk;     // 正在发送的数据长度
+    volatile bool tx_busy;          // DMA发送进行中
+    volatile bool tx_cmd_active;    // 当前DMA发送的是AT指令
+    uint8_t cmd_tx_buffer[16];
+
+    // 接收：DMA循环写入，读指针由软件维护
+    uint8_t rx_buffer[RX_BUFFER_SIZE];
+    volatile uint16_t rx_read_pos;
+
     // 私有成员函数
-    HAL_StatusTypeDef sendATCommand(const char *cmd, char *response, uint16_t timeout);
-    
+    HAL_StatusTypeDef submitCommand(const char *cmd, const char *expect, uint8_t lines,
+                                    ApplyType apply, int32_t value, HC12_Config_t *output,
+                                    HC12_CommandCallback callback, void *context);
+    void completeCommand(HAL_StatusTypeDef status);
+    void applyCommand(const Command &command);
+    void parseParams(HC12_Config_t *out);
+    void reinitUart(uint32_t baud);
+    void startTransmitLocked();
+    void startReceive();
+    uint16_t rxWritePos() const;
+    static void timerCallback(void *argument);
+
 public:
     // 构造函数和析构函数
     HC12(UART_HandleTypeDef *huart, GPIO_TypeDef *set_port, uint16_t set_pin);
     ~HC12();
     
-    // 初始化和基本操作
+    // 初始化：启动DMA接收与后台状态机，需在RTOS内核启动后调用
     HAL_StatusTypeDef init();
-    HAL_StatusTypeDef enterATMode();
-    HAL_StatusTypeDef exitATMode();
     
-    // 参数设置函数
-    HAL_StatusTypeDef setMode(HC12_Mode_t mode);
-    HAL_StatusTypeDef setBaudRate(HC12_Baud_t baud);
-    HAL_StatusTypeDef setChannel(uint8_t channel);
-    HAL_StatusTypeDef setPower(HC12_Power_t power);
-    HAL_StatusTypeDef setUartFormat(const HC12_UartFormat_t &format);
+    // 参数设置函数：仅将指令加入队列，返回HAL_BUSY表示队列已满
+    HAL_StatusTypeDef setMode(HC12_Mode_t mode, HC12_CommandCallback callback = nullptr, void *context = nullptr);
+    HAL_StatusTypeDef setBaudRate(HC12_Baud_t baud, HC12_CommandCallback callback = nullptr, void *context = nullptr);
+    HAL_StatusTypeDef setChannel(uint8_t channel, HC12_CommandCallback callback = nullptr, void *context = nullptr);
+    HAL_StatusTypeDef setPower(HC12_Power_t power, HC12_CommandCallback callback = nullptr, void *context = nullptr);
+    HAL_StatusTypeDef setUartFormat(const HC12_UartFormat_t &format, HC12_CommandCallback callback = nullptr, void *context = nullptr);
     
     // 参数查询函数
-    HAL_StatusTypeDef getVersion(char *version);
-    HAL_StatusTypeDef getAllParams(HC12_Config_t *config);
+    HAL_StatusTypeDef getVersion(HC12_CommandCallback callback, void *context = nullptr);
+    HAL_StatusTypeDef getAllParams(HC12_Config_t *config = nullptr, HC12_CommandCallback callback = nullptr, void *context = nullptr);
     const HC12_Config_t& getCurrentConfig() const;
     
     // 系统控制函数
-    HAL_StatusTypeDef restoreDefault();
-    HAL_StatusTypeDef sleep();
+    HAL_StatusTypeDef restoreDefault(HC12_CommandCallback callback = nullptr, void *context = nullptr);
+    HAL_StatusTypeDef sleep(HC12_CommandCallback callback = nullptr, void *context = nullptr);
+    
+    // 发送任意AT指令
+    HAL_StatusTypeDef sendCommand(const char *cmd, const char *expect, uint8_t lines,
+                                  HC12_CommandCallback callback = nullptr, void *context = nullptr);
     
     // 数据传输函数
     HAL_StatusTypeDef transmitData(const uint8_t *data, uint16_t size);
     HAL_StatusTypeDef receiveData(uint8_t *data, uint16_t *size, uint32_t timeout);
     
-    // 中断处理
-    void irqHandler();
+    // 后台处理，由定时器周期调用，也可手动调用
+    void process();
+    
+    // 中断回调
+    void txCpltCallback(UART_HandleTypeDef *huart);
+    void errorCallback(UART_HandleTypeDef *huart);
     
     // 状态查询
     bool isInATMode() const;
     bool isInitialized() const;
-    
-    // 静态常量定义
-    static const uint16_t AT_TIMEOUT = 1000;
-    static const uint16_t SET_DELAY = 40;
-    static const uint16_t EXIT_DELAY = 80;
-    static const uint16_t RESET_DELAY = 200;
+    bool isBusy() const;
+    HAL_StatusTypeDef waitIdle(uint32_t timeout);
 };
 
 #endif /* __HC12_H */
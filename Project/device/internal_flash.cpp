@@ -0,0 +1,85 @@
+#include "internal_flash.h"
+#include <string.h>
+
+InternalFlash::InternalFlash(uint32_t firstSector, uint32_t sectorCount)
+    : first_sector_(firstSector), sector_count_(sectorCount)
+{
+}
+
+bool InternalFlash::read(uint32_t sector, uint32_t offset, void* data, uint32_t size)
+{
+    if (sector >= sector_count_ || offset + size > FLASH_SECTOR_SIZE)
+    {
+        return false;
+    }
+
+    // 编程中途掉电的闪存字 ECC 校验失败，读取时置位 DBECCERR 并产生总线错误。
+    // 读取期间置 FAULTMASK 并设置 BFHFNMIGN 忽略该总线错误，改由标志位判断，
+    // 返回 false 后由上层按记录损坏处理
+    const uint32_t faultmask = __get_FAULTMASK();
+    __set_FAULTMASK(1);
+    SCB->CCR |= SCB_CCR_BFHFNMIGN_Msk;
+    __DSB();
+    __ISB();
+    __HAL_FLASH_CLEAR_FLAG_BANK1(FLASH_FLAG_DBECCERR_BANK1);
+
+    memcpy(data, (const void*)address(sector, offset), size);
+    __DSB();
+    const bool ecc_error = __HAL_FLASH_GET_FLAG_BANK1(FLASH_FLAG_DBECCERR_BANK1);
+    if (ecc_error)
+    {
+        __HAL_FLASH_CLEAR_FLAG_BANK1(FLASH_FLAG_DBECCERR_BANK1);
+    }
+
+    SCB->CCR &= ~SCB_CCR_BFHFNMIGN_Msk;
+    __DSB();
+    __ISB();
+    __set_FAULTMASK(faultmask);
+    return !ecc_error;
+}
+
+bool InternalFlash::program(uint32_t sector, uint32_t offset, const void* data, uint32_t size)
+{
+    const uint32_t unit = programUnit();
+    if (sector >= sector_count_ || offset + size > FLASH_SECTOR_SIZE || (offset % unit) != 0 || (size % unit) != 0)
+    {
+        return false;
+    }
+
+    // HAL 按 32 位字读取源数据，逐个闪存字拷贝到对齐的缓冲区
+    uint32_t word[FLASH_NB_32BITWORD_IN_FLASHWORD];
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    bool ok = true;
+
+    HAL_FLASH_Unlock();
+    for (uint32_t pos = 0; pos < size && ok; pos += unit)
+    {
+        memcpy(word, src + pos, unit);
+        ok = HAL_FLASH_Program(FLASH_TYPEPROGRAM_FLASHWORD, address(sector, offset + pos), (uint32_t)word) == HAL_OK;
+    }
+    HAL_FLASH_Lock();
+
+    // 回读确认
+    return ok && memcmp((const void*)address(sector, offset), data, size) == 0;
+}
+
+bool InternalFlash::erase(uint32_t sector)
+{
+    if (sector >= sector_count_)
+    {
+        return false;
+    }
+
+    FLASH_EraseInitTypeDef erase = {0};
+    erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+    erase.Banks = FLASH_BANK_1;
+    erase.Sector = first_sector_ + sector;
+    erase.NbSectors = 1;
+    erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+
+    uint32_t error = 0;
+    HAL_FLASH_Unlock();
+    HAL_StatusTypeDef status = HAL_FLASHEx_Erase(&erase, &error);
+    HAL_FLASH_Lock();
+    return status == HAL_OK;
+}
@@ -0,0 +1,40 @@
+#ifndef __INTERNAL_FLASH_H__
+#define __INTERNAL_FLASH_H__
+
+#include "main.h"
+#include "flash_kv.h"
+
+/**
+ * @brief 片内闪存的扇区访问 (STM32H723，单存储体，128KB 扇区，256 位闪存字)
+ * @details 扇区编号相对 firstSector，读取直接访问存储器映射地址，遇到 ECC 双位错误 (编程中途掉电) 时返回 false；
+ *          擦除/编程期间同一存储体的取指会停顿，调用者须保证此时没有实时任务依赖 CPU
+ */
+class InternalFlash : public utils::FlashDevice
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param firstSector 第一个可用扇区号，须位于链接器 IROM 区域之外
+     * @param sectorCount 可用扇区数
+     */
+    InternalFlash(uint32_t firstSector, uint32_t sectorCount);
+
+    uint32_t sectorSize() const override { return FLASH_SECTOR_SIZE; }
+    uint32_t sectorCount() const override { return sector_count_; }
+    uint32_t programUnit() const override { return FLASH_NB_32BITWORD_IN_FLASHWORD * 4; }
+
+    bool read(uint32_t sector, uint32_t offset, void* data, uint32_t size) override;
+    bool program(uint32_t sector, uint32_t offset, const void* data, uint32_t size) override;
+    bool erase(uint32_t sector) override;
+
+private:
+    uint32_t first_sector_;
+    uint32_t sector_count_;
+
+    uint32_t address(uint32_t sector, uint32_t offset) const
+    {
+        return FLASH_BANK1_BASE + (first_sector_ + sector) * FLASH_SECTOR_SIZE + offset;
+    }
+};
+
+#endif // __INTERNAL_FLASH_H__
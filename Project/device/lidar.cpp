@@ -7,6 +7,7 @@ Lidar::Lidar(UART_HandleTypeDef* huart, float pose_frequency_hz)
     : huart_(huart),
       running_(false),
       pose_frequency_hz_(pose_frequency_hz),
+      pose_rx_cycle_(0),
       pose_packet_count_(0),
       imu_packet_count_(0),
       error_count_(0),
@@ -316,6 +317,8 @@ bool Lidar::parsePosePacket() {
     
     // 更新当前位置数据（使用原始位置）
     pose_data_ = new_pose;
+    pose_rx_cycle_ = DWT->CYCCNT;
+    pose_sample_.write(LidarPoseSample{new_pose.x, new_pose.y, new_pose.z, pose_rx_cycle_});
     pose_packet_count_++;
 
     if (!velocity_initialized_) {
@@ -388,6 +391,7 @@ bool Lidar::parseImuPacket() {
     imu_data_.pitch = bytesToFloat(&payload_[4]);
     imu_data_.yaw = bytesToFloat(&payload_[8]);
     imu_data_.valid = true;
+    imu_sample_.write(LidarImuSample{imu_data_.roll, imu_data_.pitch, imu_data_.yaw, DWT->CYCCNT});
     
     imu_packet_count_++;
 
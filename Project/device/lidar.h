@@ -49,6 +49,22 @@ struct LidarImuData {
     bool valid;    // 数据有效性标志
 };
 
+// 带接收时刻的原始位姿样本，用于状态估计
+struct LidarPoseSample {
+    float x;           // X坐标 (地面坐标系)
+    float y;           // Y坐标 (地面坐标系)
+    float z;           // Z坐标 (地面坐标系)
+    uint32_t rx_cycle; // 接收时刻 (DWT 周期计数)
+};
+
+// 带接收时刻的原始IMU姿态样本，用于航向融合
+struct LidarImuSample {
+    float roll;        // Roll角
+    float pitch;       // Pitch角
+    float yaw;         // Yaw角
+    uint32_t rx_cycle; // 接收时刻 (DWT 周期计数)
+};
+
 // Lidar数据接收回调函数类型定义
 typedef void (*lidar_pose_rx_callback_t)(const struct LidarPoseData* pose_data);
 typedef void (*lidar_imu_rx_callback_t)(const struct LidarImuData* imu_data);
@@ -59,6 +75,8 @@ typedef void (*lidar_imu_rx_callback_t)(const struct LidarImuData* imu_data);
 
 #ifdef __cplusplus
 
+#include "seqlock.h"
+
 class Lidar {
 public:
     Lidar(UART_HandleTypeDef* huart, float pose_frequency_hz = 50.0f);
@@ -75,8 +93,14 @@ public:
     float getPoseFrequency() const { return pose_frequency_hz_; }
 
     LidarPoseData getPoseData() const;
+    // 最近一次位姿数据的接收时刻 (DWT 周期计数)
+    uint32_t getPoseRxCycle() const { return pose_rx_cycle_; }
+    // 无锁读取最近一次位姿样本，返回值每收到一帧位姿递增，可用于判断是否有新数据
+    uint32_t getPoseSample(LidarPoseSample& sample) const { return pose_sample_.read(sample); }
     LidarVelocityData getVelocityData() const;
     LidarImuData getImuData() const;
+    // 无锁读取最近一次IMU姿态样本，返回值每收到一帧IMU数据递增
+    uint32_t getImuSample(LidarImuSample& sample) const { return imu_sample_.read(sample); }
 
     bool isRunning() const { return running_; }
 
@@ -109,8 +133,11 @@ private:
     uint8_t dma_rx_buffer_[LIDAR_DMA_BUFFER_SIZE];
 
     LidarPoseData pose_data_;
+    volatile uint32_t pose_rx_cycle_;
+    utils::SeqLock<LidarPoseSample> pose_sample_;
     LidarVelocityData velocity_data_;
     LidarImuData imu_data_;
+    utils::SeqLock<LidarImuSample> imu_sample_;
 
     // 速度计算相关
     LidarPoseData last_pose_;
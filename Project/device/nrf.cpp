@@ -67,107 +67,63 @@ GPIO_PinState _Nrf_IRQ_Read(Nrf_t *nrf) // 读取IRQ引脚的电平
 {
     return HAL_GPIO_ReadPin(nrf->irq.port, nrf->irq.pin);
 }
-uint8_t _Nrf_SPI_ByteExchange(Nrf_t *nrf, uint8_t data) // SPI字节交换函数
+uint8_t _Nrf_SPI_Exchange(Nrf_t *nrf, uint8_t len) // 阻塞式SPI事务：片选期间一次性收发spi_tx/spi_rx中的len字节，返回STATUS
 {
-    uint8_t rx_data;
-    HAL_SPI_TransmitReceive(nrf->hspi, &data, &rx_data, 1, 100);
-    return rx_data;
-}
-/*-----------------------SPI接口的命令设置-------------------------*/
-uint8_t _Nrf_Write_Register(Nrf_t *nrf, uint8_t reg_offset, uint8_t data) // 写寄存器
-{
-    uint8_t status;
     _Nrf_CS_Low(nrf);
-    status = _Nrf_SPI_ByteExchange(nrf, NRF_CMD_WRITE_REG | reg_offset);
-    _Nrf_SPI_ByteExchange(nrf, data);
+    if (HAL_SPI_TransmitReceive(nrf->hspi, nrf->spi_tx, nrf->spi_rx, len, 100) != HAL_OK)
+        nrf->spi_rx[0] = 0;
     _Nrf_CS_High(nrf);
-    return status;
+    return nrf->spi_rx[0];
 }
-uint8_t _Nrf_Read_Register(Nrf_t *nrf, uint8_t reg_offset) // 读寄存器
+/*-----------------------SPI接口的命令设置-------------------------*/
+//* 以下阻塞接口仅在初始化阶段（中断未使能前）使用，运行期间的收发全部由异步状态机完成
+uint8_t _Nrf_Command(Nrf_t *nrf, uint8_t cmd) // 单字节命令
 {
-    uint8_t reg_val;
-    _Nrf_CS_Low(nrf);
-    _Nrf_SPI_ByteExchange(nrf, NRF_CMD_READ_REG | reg_offset);
-    reg_val = _Nrf_SPI_ByteExchange(nrf, NRF_CMD_NOP);
-    _Nrf_CS_High(nrf);
-    return reg_val;
+    nrf->spi_tx[0] = cmd;
+    return _Nrf_SPI_Exchange(nrf, 1);
 }
-uint8_t _Nrf_Write_TX_Payload(Nrf_t *nrf, uint8_t *pBuf, uint8_t len) // 写TX Payload
+uint8_t _Nrf_Write_Register(Nrf_t *nrf, uint8_t reg_offset, uint8_t data) // 写寄存器
 {
-    uint8_t status;
-    _Nrf_CS_Low(nrf);
-    status = _Nrf_SPI_ByteExchange(nrf, NRF_CMD_WRITE_TX_PAYLOAD); // SPI发送写TX_PAYLOAD的命令
-    while (len--)
-    {
-        _Nrf_SPI_ByteExchange(nrf, *pBuf++); // SPI发送数据，依次写入到E01C的TX FIFO
-    }
-    _Nrf_CS_High(nrf);
-    return status;
+    nrf->spi_tx[0] = NRF_CMD_WRITE_REG | reg_offset;
+    nrf->spi_tx[1] = data;
+    return _Nrf_SPI_Exchange(nrf, 2);
 }
-uint8_t _Nrf_Read_RX_Payload(Nrf_t *nrf, uint8_t *pBuf, uint8_t len) // 读RX Payload
+uint8_t _Nrf_Read_Register(Nrf_t *nrf, uint8_t reg_offset) // 读寄存器
 {
-    uint8_t status;
-    _Nrf_CS_Low(nrf);
-    status = _Nrf_SPI_ByteExchange(nrf, NRF_CMD_READ_RX_PAYLOAD); // SPI发送读RX_PAYLOAD的命令
-    while (len--)
-    {
-        *pBuf++ = _Nrf_SPI_ByteExchange(nrf, NRF_CMD_NOP); // SPI读取数据，依次读出E01C的RX FIFO
-    }
-    _Nrf_CS_High(nrf);
-    return status;
+    nrf->spi_tx[0] = NRF_CMD_READ_REG | reg_offset;
+    nrf->spi_tx[1] = NRF_CMD_NOP;
+    _Nrf_SPI_Exchange(nrf, 2);
+    return nrf->spi_rx[1];
 }
 uint8_t _Nrf_Flush_TX(Nrf_t *nrf) // 清空TX FIFO
 {
-    uint8_t status;
-    _Nrf_CS_Low(nrf);
-    status = _Nrf_SPI_ByteExchange(nrf, NRF_CMD_FLUSH_TX); // SPI发送清空TX FIFO的命令
-    _Nrf_CS_High(nrf);
-    return status;
+    return _Nrf_Command(nrf, NRF_CMD_FLUSH_TX);
 }
 uint8_t _Nrf_Flush_RX(Nrf_t *nrf) // 清空RX FIFO
 {
-    uint8_t status;
-    _Nrf_CS_Low(nrf);
-    status = _Nrf_SPI_ByteExchange(nrf, NRF_CMD_FLUSH_RX); // SPI发送清空RX FIFO的命令
-    _Nrf_CS_High(nrf);
-    return status;
-}
-uint8_t _Nrf_Reuse_TX_Payload(Nrf_t *nrf) // 重复使用上一包数据
-{
-    uint8_t status;
-    _Nrf_CS_Low(nrf);
-    status = _Nrf_SPI_ByteExchange(nrf, NRF_CMD_REUSE_TX_PAYLOAD); // SPI发送重复使用上一包数据的命令
-    _Nrf_CS_High(nrf);
-    return status;
+    return _Nrf_Command(nrf, NRF_CMD_FLUSH_RX);
 }
 uint8_t _Nrf_Nop(Nrf_t *nrf)
 {
-    _Nrf_CS_Low(nrf);
-    uint8_t status = _Nrf_SPI_ByteExchange(nrf, NRF_CMD_NOP); // SPI发送重复使用上一包数据的命令
-    _Nrf_CS_High(nrf);
-    return status;
+    return _Nrf_Command(nrf, NRF_CMD_NOP);
 }
 uint8_t _Nrf_Read_Buffer(Nrf_t *nrf, uint8_t reg, uint8_t *pBuf, uint8_t len)
 {
-    _Nrf_CS_Low(nrf);                                                    // 使能SPI传输
-    uint8_t status = _Nrf_SPI_ByteExchange(nrf, NRF_CMD_READ_REG | reg); // 发送寄存器值(位置),并读取状态值
-    while (len--)                                                        // 读取数据
-    {
-        *pBuf++ = _Nrf_SPI_ByteExchange(nrf, NRF_CMD_NOP); // 读出数据
-    }
-    _Nrf_CS_High(nrf); // 关闭SPI传输
+    if (len > NRF_WID_RX_PLOAD)
+        len = NRF_WID_RX_PLOAD;
+    nrf->spi_tx[0] = NRF_CMD_READ_REG | reg;
+    memset(&nrf->spi_tx[1], NRF_CMD_NOP, len);
+    uint8_t status = _Nrf_SPI_Exchange(nrf, len + 1);
+    memcpy(pBuf, &nrf->spi_rx[1], len);
     return status;
 }
 uint8_t _Nrf_Write_Buffer(Nrf_t *nrf, uint8_t reg, uint8_t *pBuf, uint8_t len)
 {
-    _Nrf_CS_Low(nrf);                                                     // 使能SPI传输
-    uint8_t status = _Nrf_SPI_ByteExchange(nrf, NRF_CMD_WRITE_REG | reg); // 发送寄存器值(位置),并读取状态值
-    while (len--)                                                         // 读取数据
-    {
-        _Nrf_SPI_ByteExchange(nrf, *pBuf++); // 读出数据
-    }
-    _Nrf_CS_High(nrf); // 关闭SPI传输
-    return status;
+    if (len > NRF_WID_RX_PLOAD)
+        len = NRF_WID_RX_PLOAD;
+    nrf->spi_tx[0] = NRF_CMD_WRITE_REG | reg;
+    memcpy(&nrf->spi_tx[1], pBuf, len);
+    return _Nrf_SPI_Exchange(nrf, len + 1);
 }
 /*----------------------------------寄存器----------------------------------*/
 // 配置寄存器CONFIG
@@ -444,6 +400,7 @@ void _Nrf_Set_Config(Nrf_t *nrf) // 配置寄存器
     // Start in RX mode, Power Up, 2-byte CRC, CRC enabled
     _NRF_REG_CONFIG config = {.prim_rx = 1, .pwr_up = 1, .crc0 = 1, .en_crc = 1, .mask_max_rt = 0, .mask_tx_ds = 0, .mask_rx_dr = 0};
     _Nrf_Write_RegStruct_8bits(nrf, &config, NRF_REG_CONFIG);
+    memcpy(&nrf->config_reg, &config, 1); // 缓存CONFIG，运行期切换收发模式时无需先读寄存器
 
     // Initialize signal quality buffer
     memset(nrf->signal_quality.check_buf, 0x00, sizeof(nrf->signal_quality.check_buf)); // Initialize to all success (1s)
@@ -485,16 +442,43 @@ uint8_t _Nrf_CheckConnectivity(Nrf_t *nrf)
         return 1;
     }
 }
-void Nrf_Init(Nrf_t *nrf)
+void _Nrf_AsyncReset(Nrf_t *nrf) // 复位异步状态机与发送队列
+{
+    nrf->tx_queue.head = 0;
+    nrf->tx_queue.tail = 0;
+    nrf->tx_queue.dropped = 0;
+    nrf->async_state = Nrf_t::Nrf_Async_Idle;
+    nrf->spi_busy = 0;
+    nrf->irq_pending = 0;
+    nrf->tx_in_flight = 0;
+    nrf->addr_dirty = 1;
+    nrf->status = 0;
+    nrf->rx_pipe = 0;
+    nrf->spi_error_count = 0;
+}
+uint8_t Nrf_Probe(Nrf_t *nrf) // 单次连通性检测，模块响应则完成配置，不等待
 {
-    while (_Nrf_CheckConnectivity(nrf) == 0);
-	_Nrf_CheckConnectivity(nrf);
+    _Nrf_AsyncReset(nrf);
+    if (_Nrf_CheckConnectivity(nrf) == 0)
+        return 0;
     _Nrf_Set_Config(nrf);
     _NRF_REG_STATUS status;
     _Nrf_Read_RegStruct_8bits(nrf, &status, NRF_REG_STATUS);  // 读取配置寄存器
     _Nrf_Write_RegStruct_8bits(nrf, &status, NRF_REG_STATUS); // 中断触发时status对应位置1，向对应的标志位写1清除中断标志
     // Use scope resolution for enum value
     _Nrf_ModeSwitch(nrf, Nrf_t::Nrf_Mode_Receive);
+    return 1;
+}
+uint8_t Nrf_Init(Nrf_t *nrf)
+{
+    uint32_t retry = 0;
+    while (Nrf_Probe(nrf) == 0)
+    {
+        if (++retry >= NRF_INIT_RETRY_TIMES)
+            return 0; // 模块无响应，由调用者决定是否稍后以 Nrf_Probe 重试
+        HAL_Delay(1);
+    }
+    return 1;
 }
 void _Nrf_CalculateNrfSignalQuality(Nrf_t *nrf)
 {
@@ -535,61 +519,261 @@ void _Nrf_TransmitSuccess(Nrf_t *nrf)
     nrf->signal_quality.check_index = (nrf->signal_quality.check_index + 1) % 128;
     _Nrf_CalculateNrfSignalQuality(nrf);
 }
-void Nrf_EXTI_Callback(Nrf_t *nrf, uint16_t gpio_pin)
+/*----------------------------------异步状态机----------------------------------*/
+// 每个SPI事务完成后由Nrf_SPI_TxRxCpltCallback推进到下一步，中断中不再等待SPI
+#define NRF_STATUS_RX_DR 0x40
+#define NRF_STATUS_TX_DS 0x20
+#define NRF_STATUS_MAX_RT 0x10
+#define NRF_CONFIG_PRIM_RX 0x01
+
+void _Nrf_AsyncKick(Nrf_t *nrf);
+
+uint8_t _Nrf_AsyncTransfer(Nrf_t *nrf, Nrf_t::Nrf_AsyncState_t state, uint8_t len) // 启动一次非阻塞SPI事务
 {
-    if (gpio_pin != nrf->irq.pin)
-        return;
-    _NRF_REG_STATUS status;
-    _Nrf_Read_RegStruct_8bits(nrf, &status, NRF_REG_STATUS);  // 读取配置寄存器
-    _Nrf_Write_RegStruct_8bits(nrf, &status, NRF_REG_STATUS); // 中断触发时status对应位置1，向对应的标志位写1清除中断标志
-    // Use scope resolution for enum value
-    _Nrf_ModeSwitch(nrf, Nrf_t::Nrf_Mode_Receive);                   // 切换到接收模式
-    if (status.rx_dr && status.rx_p_no != 7)                  // 如果成功接收到了数据
+    HAL_StatusTypeDef ret;
+    nrf->async_state = state;
+    _Nrf_CS_Low(nrf);
+    if (nrf->hspi->hdmatx != NULL && nrf->hspi->hdmarx != NULL)
+        ret = HAL_SPI_TransmitReceive_DMA(nrf->hspi, nrf->spi_tx, nrf->spi_rx, len);
+    else
+        ret = HAL_SPI_TransmitReceive_IT(nrf->hspi, nrf->spi_tx, nrf->spi_rx, len);
+    if (ret != HAL_OK)
     {
-        nrf->rx_data[status.rx_p_no].len = _Nrf_Read_Register(nrf, NRF_CMD_READ_RX_PAYLOAD_WID); // 读取接收到的数据包长度
-        if (nrf->rx_data[status.rx_p_no].len > 0 && nrf->rx_data[status.rx_p_no].len <= NRF_WID_RX_PLOAD) // Check length validity
-        {
-            _Nrf_Read_Buffer(nrf, NRF_CMD_READ_RX_PAYLOAD, nrf->rx_data[status.rx_p_no].buf, nrf->rx_data[status.rx_p_no].len); // 读取接收到的数据包
-            if (nrf->nrf_rx_callback)                                                                                           // 如果接收回调函数不为空，则调用回调函数
-                // Fix cast from void* to uint8_t*
-                nrf->nrf_rx_callback(status.rx_p_no, (uint8_t *)nrf->rx_data[status.rx_p_no].buf, nrf->rx_data[status.rx_p_no].len);
-            // Consider flushing RX FIFO only after successful processing or if callback is null?
-            // _Nrf_Flush_RX(nrf); // Flushing here might lose data if callback processing is slow
-        }
-        // Always flush RX FIFO if data was present (even if invalid length or no callback)
-        // or if an error occurred (len > 32, indicated by len being 0 after read from WID register)
-        _Nrf_Flush_RX(nrf);
+        _Nrf_CS_High(nrf);
+        return 0;
     }
-    else if (status.tx_ds) // 发送成功
+    return 1;
+}
+void _Nrf_AsyncAbort(Nrf_t *nrf) // SPI事务失败，释放总线并在下一次触发时重新读取STATUS
+{
+    _Nrf_CS_High(nrf);
+    nrf->spi_error_count++;
+    nrf->tx_in_flight = 0;
+    nrf->irq_pending = 1; // 下一次kick从读取STATUS开始，重新回到接收模式
+    nrf->async_state = Nrf_t::Nrf_Async_Idle;
+    nrf->spi_busy = 0;
+    _Nrf_CE_High(nrf);
+}
+void _Nrf_AsyncFinish(Nrf_t *nrf) // 当前事务链结束，检查是否有待处理的中断或发送
+{
+    nrf->async_state = Nrf_t::Nrf_Async_Idle;
+    nrf->spi_busy = 0;
+    _Nrf_AsyncKick(nrf);
+}
+void _Nrf_AsyncNext(Nrf_t *nrf, Nrf_t::Nrf_AsyncState_t state, uint8_t len)
+{
+    if (!_Nrf_AsyncTransfer(nrf, state, len))
+        _Nrf_AsyncAbort(nrf);
+}
+void _Nrf_AsyncEnterTx(Nrf_t *nrf) // 拉低CE并切换到发射模式
+{
+    _Nrf_CE_Low(nrf);
+    nrf->spi_tx[0] = NRF_CMD_WRITE_REG | NRF_REG_CONFIG;
+    nrf->spi_tx[1] = nrf->config_reg & ~NRF_CONFIG_PRIM_RX;
+    _Nrf_AsyncNext(nrf, Nrf_t::Nrf_Async_EnterTx, 2);
+}
+void _Nrf_AsyncEnterRx(Nrf_t *nrf) // 切换到接收模式，CE在事务完成后拉高
+{
+    _Nrf_CE_Low(nrf);
+    nrf->spi_tx[0] = NRF_CMD_WRITE_REG | NRF_REG_CONFIG;
+    nrf->spi_tx[1] = nrf->config_reg | NRF_CONFIG_PRIM_RX;
+    _Nrf_AsyncNext(nrf, Nrf_t::Nrf_Async_EnterRx, 2);
+}
+void _Nrf_AsyncWritePayload(Nrf_t *nrf) // 将队首数据包一次性写入TX FIFO
+{
+    uint8_t index = nrf->tx_queue.tail;
+    uint8_t len = nrf->tx_queue.len[index];
+    nrf->spi_tx[0] = NRF_CMD_WRITE_TX_PAYLOAD;
+    memcpy(&nrf->spi_tx[1], nrf->tx_queue.buf[index], len);
+    _Nrf_AsyncNext(nrf, Nrf_t::Nrf_Async_WritePayload, len + 1);
+}
+void _Nrf_AsyncWriteAddr(Nrf_t *nrf, uint8_t reg, Nrf_t::Nrf_AsyncState_t state)
+{
+    nrf->spi_tx[0] = NRF_CMD_WRITE_REG | reg;
+    memcpy(&nrf->spi_tx[1], nrf->address_transmit, NRF_WID_TX_ADR);
+    _Nrf_AsyncNext(nrf, state, NRF_WID_TX_ADR + 1);
+}
+void _Nrf_AsyncHandleTxResult(Nrf_t *nrf) // 处理STATUS中的发送结果
+{
+    if (nrf->status & NRF_STATUS_TX_DS) // 发送成功（ACK负载会同时置位RX_DR，已在此之前读出）
     {
         _Nrf_TransmitSuccess(nrf);
-        // Use scope resolution for enum value
         nrf->tx_state = Nrf_t::Nrf_Transmit_Success;
-        _Nrf_Flush_TX(nrf); // 清空发送缓冲区
     }
-    else if (status.max_rt) // 达到最大重发次数
+    else if (nrf->status & NRF_STATUS_MAX_RT) // 达到最大重发次数
     {
         _Nrf_TransmitFailed(nrf);
-        // Use scope resolution for enum value
         nrf->tx_state = Nrf_t::Nrf_Transmit_Failed;
-        _Nrf_Flush_TX(nrf); // 清空发送缓冲区
     }
-    // It's possible other flags in status are set, handle if necessary
+    else
+    {
+        if (nrf->tx_in_flight)
+            _Nrf_AsyncFinish(nrf); // 仍在等待发送结果
+        else
+            _Nrf_AsyncEnterRx(nrf);
+        return;
+    }
+    nrf->tx_in_flight = 0;
+    nrf->spi_tx[0] = NRF_CMD_FLUSH_TX; // 清空发送缓冲区
+    _Nrf_AsyncNext(nrf, Nrf_t::Nrf_Async_FlushTx, 1);
+}
+void _Nrf_AsyncKick(Nrf_t *nrf) // 总线空闲时启动新的事务链，IRQ优先于发送
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (nrf->spi_busy)
+    {
+        __set_PRIMASK(primask);
+        return;
+    }
+    uint8_t start_irq = nrf->irq_pending;
+    uint8_t start_tx = !start_irq && !nrf->tx_in_flight && nrf->tx_queue.head != nrf->tx_queue.tail;
+    if (!start_irq && !start_tx)
+    {
+        __set_PRIMASK(primask);
+        return;
+    }
+    nrf->spi_busy = 1;
+    nrf->irq_pending = 0;
+    __set_PRIMASK(primask);
+
+    if (start_irq)
+    {
+        nrf->spi_tx[0] = NRF_CMD_WRITE_REG | NRF_REG_STATUS; // 写1清除全部中断标志，同时读回STATUS
+        nrf->spi_tx[1] = NRF_STATUS_RX_DR | NRF_STATUS_TX_DS | NRF_STATUS_MAX_RT;
+        _Nrf_AsyncNext(nrf, Nrf_t::Nrf_Async_ClearStatus, 2);
+    }
+    else
+    {
+        _Nrf_AsyncEnterTx(nrf);
+    }
 }
-void Nrf_Transmit(Nrf_t *nrf, uint8_t *data, uint8_t len)
+void Nrf_SPI_TxRxCpltCallback(Nrf_t *nrf, SPI_HandleTypeDef *hspi)
 {
+    if (hspi != nrf->hspi || !nrf->spi_busy)
+        return;
+    _Nrf_CS_High(nrf);
+    switch (nrf->async_state)
+    {
+    case Nrf_t::Nrf_Async_ClearStatus:
+        nrf->status = nrf->spi_rx[0];
+        nrf->rx_pipe = (nrf->status >> 1) & 0x07;
+        if ((nrf->status & NRF_STATUS_RX_DR) && nrf->rx_pipe < 6) // 如果成功接收到了数据
+        {
+            nrf->spi_tx[0] = NRF_CMD_READ_RX_PAYLOAD_WID; // 读取接收到的数据包长度
+            nrf->spi_tx[1] = NRF_CMD_NOP;
+            _Nrf_AsyncNext(nrf, Nrf_t::Nrf_Async_ReadWidth, 2);
+        }
+        else
+        {
+            _Nrf_AsyncHandleTxResult(nrf);
+        }
+        break;
+    case Nrf_t::Nrf_Async_ReadWidth:
+    {
+        uint8_t len = nrf->spi_rx[1];
+        if (len > 0 && len <= NRF_WID_RX_PLOAD)
+        {
+            nrf->rx_data[nrf->rx_pipe].len = len;
+            nrf->spi_tx[0] = NRF_CMD_READ_RX_PAYLOAD; // 单次事务读出整个数据包
+            memset(&nrf->spi_tx[1], NRF_CMD_NOP, len);
+            _Nrf_AsyncNext(nrf, Nrf_t::Nrf_Async_ReadPayload, len + 1);
+        }
+        else // 长度非法，直接清空RX FIFO
+        {
+            nrf->spi_tx[0] = NRF_CMD_FLUSH_RX;
+            _Nrf_AsyncNext(nrf, Nrf_t::Nrf_Async_FlushRx, 1);
+        }
+        break;
+    }
+    case Nrf_t::Nrf_Async_ReadPayload:
+    {
+        uint8_t pipe = nrf->rx_pipe;
+        memcpy(nrf->rx_data[pipe].buf, &nrf->spi_rx[1], nrf->rx_data[pipe].len);
+        if (nrf->nrf_rx_callback) // 如果接收回调函数不为空，则调用回调函数
+            nrf->nrf_rx_callback(pipe, (uint8_t *)nrf->rx_data[pipe].buf, nrf->rx_data[pipe].len);
+        nrf->spi_tx[0] = NRF_CMD_FLUSH_RX;
+        _Nrf_AsyncNext(nrf, Nrf_t::Nrf_Async_FlushRx, 1);
+        break;
+    }
+    case Nrf_t::Nrf_Async_FlushRx:
+        _Nrf_AsyncHandleTxResult(nrf);
+        break;
+    case Nrf_t::Nrf_Async_FlushTx:
+        if (nrf->tx_queue.head != nrf->tx_queue.tail)
+            _Nrf_AsyncEnterTx(nrf); // 队列中还有数据，直接发送下一包
+        else
+            _Nrf_AsyncEnterRx(nrf);
+        break;
+    case Nrf_t::Nrf_Async_EnterRx:
+        _Nrf_CE_High(nrf);
+        _Nrf_AsyncFinish(nrf);
+        break;
+    case Nrf_t::Nrf_Async_EnterTx:
+        if (nrf->addr_dirty)
+            _Nrf_AsyncWriteAddr(nrf, NRF_REG_TX_ADDR, Nrf_t::Nrf_Async_WriteTxAddr); // 写入发送地址
+        else
+            _Nrf_AsyncWritePayload(nrf);
+        break;
+    case Nrf_t::Nrf_Async_WriteTxAddr:
+        _Nrf_AsyncWriteAddr(nrf, NRF_REG_RX_ADDR_P0, Nrf_t::Nrf_Async_WriteP0Addr); // P0通道接收地址与发送地址相同，用于接收接收机回传的ACK
+        break;
+    case Nrf_t::Nrf_Async_WriteP0Addr:
+        nrf->addr_dirty = 0;
+        _Nrf_AsyncWritePayload(nrf);
+        break;
+    case Nrf_t::Nrf_Async_WritePayload:
+        nrf->tx_queue.tail = (nrf->tx_queue.tail + 1) & (NRF_TX_QUEUE_SIZE - 1);
+        nrf->tx_in_flight = 1;
+        _Nrf_CE_High(nrf); // 启动发射
+        _Nrf_AsyncFinish(nrf);
+        break;
+    default:
+        _Nrf_AsyncFinish(nrf);
+        break;
+    }
+}
+void Nrf_SPI_ErrorCallback(Nrf_t *nrf, SPI_HandleTypeDef *hspi)
+{
+    if (hspi != nrf->hspi || !nrf->spi_busy)
+        return;
+    _Nrf_AsyncAbort(nrf);
+}
+void Nrf_EXTI_Callback(Nrf_t *nrf, uint16_t gpio_pin)
+{
+    if (gpio_pin != nrf->irq.pin)
+        return;
+    nrf->irq_pending = 1; // 若SPI正忙，当前事务链结束后会处理
+    _Nrf_AsyncKick(nrf);
+}
+uint8_t Nrf_Transmit(Nrf_t *nrf, uint8_t *data, uint8_t len)
+{
+    if (len == 0 || len > NRF_WID_RX_PLOAD)
+        return 0;
+    // 多个任务可能同时发送，入队时短暂关中断；出队只在状态机中进行，无需加锁
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint8_t head = nrf->tx_queue.head;
+    uint8_t next = (head + 1) & (NRF_TX_QUEUE_SIZE - 1);
+    if (next == nrf->tx_queue.tail)
+    {
+        nrf->tx_queue.dropped++;
+        __set_PRIMASK(primask);
+        return 0;
+    }
+    memcpy(nrf->tx_queue.buf[head], data, len);
+    nrf->tx_queue.len[head] = len;
+    __DMB();
+    nrf->tx_queue.head = next;
     // Use scope resolution for enum value
     nrf->tx_state = Nrf_t::Nrf_Transmit_Ongoing;
-    // Use scope resolution for enum value
-    _Nrf_ModeSwitch(nrf, Nrf_t::Nrf_Mode_Transmit); // 切换到发射模式
-    _Nrf_CE_Low(nrf);
-    _Nrf_Write_Buffer(nrf, NRF_REG_TX_ADDR, nrf->address_transmit, NRF_WID_TX_ADR);    // 写入发送地址
-    _Nrf_Write_Buffer(nrf, NRF_REG_RX_ADDR_P0, nrf->address_transmit, NRF_WID_RX_ADR); // P0通道接收地址与发送地址相同，用于接收接收机回传的ACK
-    _Nrf_Write_Buffer(nrf, NRF_CMD_WRITE_TX_PAYLOAD, data, len);                       // 写入发送数据包
-    _Nrf_CE_High(nrf);
+    __set_PRIMASK(primask);
+    _Nrf_AsyncKick(nrf);
+    return 1;
 }
 void Nrf_SetTransmitAddress(Nrf_t *nrf, uint8_t *transmit_addr)
 {
     for (uint32_t i = 0; i < 5; i++)
         nrf->address_transmit[i] = transmit_addr[i];
+    nrf->addr_dirty = 1; // 下一次发送时写入TX_ADDR与RX_ADDR_P0
 }
@@ -3,6 +3,8 @@
 #include "spi.h"
 #include <cstring> // Include for memcpy and memset
 
+#define NRF_TX_QUEUE_SIZE 4       // 发送队列深度（必须为2的幂）
+#define NRF_INIT_RETRY_TIMES 10   // 初始化时连通性检测的最大尝试次数
 
 
 typedef struct 
@@ -53,14 +55,53 @@ typedef struct
         float quality;                  //信号质量
     } signal_quality;       //信号质量
 
-    void (*nrf_rx_callback)(uint8_t channel, uint8_t* data, uint8_t len); //接收回调函数
+    void (*nrf_rx_callback)(uint8_t channel, uint8_t* data, uint8_t len); //接收回调函数（在中断上下文中调用，须快速返回）
+
+    //* 以下为异步状态机使用的成员，由Nrf_Init初始化
+    struct
+    {
+        uint8_t buf[NRF_TX_QUEUE_SIZE][32];
+        uint8_t len[NRF_TX_QUEUE_SIZE];
+        volatile uint8_t head;      // 写入位置，仅由发送方修改
+        volatile uint8_t tail;      // 读取位置，仅由状态机修改
+        uint32_t dropped;           // 队列满时丢弃的包数
+    } tx_queue;                     // 无锁发送队列（单生产者单消费者）
+
+    enum Nrf_AsyncState_t
+    {
+        Nrf_Async_Idle,
+        Nrf_Async_ClearStatus,      // 写STATUS清中断，同时读回STATUS
+        Nrf_Async_ReadWidth,        // 读取接收包长度
+        Nrf_Async_ReadPayload,      // 读取接收包
+        Nrf_Async_FlushRx,
+        Nrf_Async_FlushTx,
+        Nrf_Async_EnterRx,          // 写CONFIG切换到接收模式
+        Nrf_Async_EnterTx,          // 写CONFIG切换到发射模式
+        Nrf_Async_WriteTxAddr,
+        Nrf_Async_WriteP0Addr,
+        Nrf_Async_WritePayload,
+    } async_state;                  // 异步状态机当前事务
+
+    volatile uint8_t spi_busy;      // SPI事务进行中
+    volatile uint8_t irq_pending;   // IRQ到来时SPI正忙，待当前事务完成后处理
+    volatile uint8_t tx_in_flight;  // 负载已写入，等待TX_DS/MAX_RT
+    uint8_t addr_dirty;             // 发送地址需要重新写入
+    uint8_t config_reg;             // CONFIG寄存器缓存（接收模式）
+    uint8_t status;                 // 最近一次读取到的STATUS
+    uint8_t rx_pipe;                // 当前接收包的通道号
+    uint32_t spi_error_count;       // SPI事务错误次数
+    uint8_t spi_tx[33];             // SPI DMA发送缓冲区（命令字节 + 32字节负载）
+    uint8_t spi_rx[33];             // SPI DMA接收缓冲区
 } Nrf_t;
 
 
-void Nrf_Init(Nrf_t* nrf);
+uint8_t Nrf_Init(Nrf_t* nrf);
+uint8_t Nrf_Probe(Nrf_t* nrf);
 void Nrf_EXTI_Callback(Nrf_t* nrf,uint16_t gpio_pin);
-void Nrf_Transmit(Nrf_t* nrf, uint8_t* data, uint8_t len);
+uint8_t Nrf_Transmit(Nrf_t* nrf, uint8_t* data, uint8_t len);
 void Nrf_SetTransmitAddress(Nrf_t* nrf, uint8_t* address);
+void Nrf_SPI_TxRxCpltCallback(Nrf_t* nrf, SPI_HandleTypeDef* hspi);
+void Nrf_SPI_ErrorCallback(Nrf_t* nrf, SPI_HandleTypeDef* hspi);
 
 // C++ Wrapper Class
 #ifdef __cplusplus
@@ -111,16 +152,32 @@ public:
         // Copy constructor
     }
 
-    // Initialize the NRF module
-    void init() {
-        Nrf_Init(&nrf_handle);
-        initialized = true;
+    // Initialize the NRF module with retries (blocking), returns false if the module does not respond
+    bool init() {
+        initialized = (Nrf_Init(&nrf_handle) != 0);
+        return initialized;
+    }
+
+    // Single connectivity check without delays, configures the module if it responds
+    bool probe() {
+        initialized = (Nrf_Probe(&nrf_handle) != 0);
+        return initialized;
+    }
+
+    // Check whether the module has been initialized successfully
+    bool isInitialized() const {
+        return initialized;
     }
 
-    // Transmit data
-    void transmit(uint8_t* data, uint8_t len) {
-        if (!initialized) return; // Or handle error
-        Nrf_Transmit(&nrf_handle, data, len);
+    // Queue data for transmission, returns false if the TX queue is full
+    bool transmit(uint8_t* data, uint8_t len) {
+        if (!initialized) return false;
+        return Nrf_Transmit(&nrf_handle, data, len) != 0;
+    }
+
+    // Number of packets dropped because the TX queue was full
+    uint32_t getDroppedCount() const {
+        return nrf_handle.tx_queue.dropped;
     }
 
     // Set the transmit address
@@ -153,6 +210,18 @@ public:
         }
     }
 
+    // Handle SPI transfer complete (intended to be called from HAL_SPI_TxRxCpltCallback)
+    void handleSpiTxRxCplt(SPI_HandleTypeDef* hspi) {
+        if (!initialized) return;
+        Nrf_SPI_TxRxCpltCallback(&nrf_handle, hspi);
+    }
+
+    // Handle SPI error (intended to be called from HAL_SPI_ErrorCallback)
+    void handleSpiError(SPI_HandleTypeDef* hspi) {
+        if (!initialized) return;
+        Nrf_SPI_ErrorCallback(&nrf_handle, hspi);
+    }
+
     // Provide access to the underlying C struct if needed for external C functions
     Nrf_t* getHandle() {
         return &nrf_handle;
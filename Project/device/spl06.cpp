@@ -144,12 +144,35 @@ SPL06::SPL06(const SPL06Config_t& config) : _config(config) {
 }
 
 bool SPL06::init() {
-   info_.Status.InitOK = 0; // 假设初始化失败，直到成功
+   reset();
+   // 复位后内部初始化 (读取校准系数) 最长约 40ms，轮询就绪标志代替固定等待
+   uint32_t waited = 0;
+   while (!isResetDone()) {
+       if (waited >= RESET_TIMEOUT_MS) {
+           return false;
+       }
+       delayMs(1);
+       waited++;
+   }
+   return configure();
+}
 
+void SPL06::reset() {
+   info_.Status.InitOK = 0; // 假设初始化失败，直到成功
    chipSelect(false); // 取消片选
-   delayMs(2); // 等待传感器启动
    softReset();
-   delayMs(100); // 复位后等待，传感器内部初始化
+}
+
+bool SPL06::isResetDone() {
+   if (spiReadReg(SPL06_DEV_ID) != 0x10) {
+       return false; // 复位期间接口无响应或器件ID不正确
+   }
+   uint8_t meas_cfg = spiReadReg(SPL06_MEAS_CFG);
+   return (meas_cfg & MEAS_COEF_RDY) && (meas_cfg & MEAS_SENSOR_RDY);
+}
+
+bool SPL06::configure() {
+   info_.Status.InitOK = 0;
 
    uint8_t id = spiReadReg(SPL06_DEV_ID);
 
@@ -257,25 +280,25 @@ bool SPL06::init() {
        return false; 
    }
 
-   // 等待第一次读数稳定
-   delayMs(150); 
-
+   // 不等待首次读数：update() 只在测量就绪标志置位时读取，地面校准本身等待读数稳定
    info_.Status.InitOK = 1; // 标记初始化成功
    return true;
 }
 
-void SPL06::update() {
+bool SPL06::update() {
    if (!info_.Status.InitOK) {
-       return; // 如果未初始化成功，则不执行更新
+       return false; // 如果未初始化成功，则不执行更新
    }
 
    uint8_t meas_status = spiReadReg(SPL06_MEAS_CFG);
    bool new_data_read = false;
+   bool new_pressure = false;
 
    // 检查气压数据是否就绪
    if (meas_status & MEAS_PRS_RDY) {
        info_.RawPressure = readRawPressure();
        new_data_read = true;
+       new_pressure = true;
    }
 
    // 检查温度数据是否就绪
@@ -284,6 +307,10 @@ void SPL06::update() {
        new_data_read = true;
    }
 
+   if (!new_pressure && info_.RawPressure == 0) {
+       return false; // 配置后首次气压测量尚未完成
+   }
+
    // 如果在本次调用中没有读取到任何新数据（例如，标志位均未置位），
    // 并且原始值仍为初始的0，则后续计算无意义，可能导致输出持续为0。
    // 这种情况下，可以考虑提前返回，或至少意识到数据是陈旧的。
@@ -322,6 +349,7 @@ void SPL06::update() {
        // 计算相对于校准后地面的高度
        info_.Altitude = pressureToAltitude(info_.Pressure) - baroGndAltitude_;
    }
+   return new_pressure;
 }
 
 // --- 私有辅助方法实现 ---
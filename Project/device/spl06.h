@@ -68,15 +68,33 @@ public:
    SPL06(const SPL06Config_t& config);
 
    /**
-    * @brief 初始化SPL06传感器
+    * @brief 初始化SPL06传感器 (阻塞，依次调用 reset()、等待 isResetDone()、configure())
     * @return 初始化是否成功
     */
    bool init();
 
+   /**
+    * @brief 发出软复位，立即返回，之后轮询 isResetDone()
+    */
+   void reset();
+
+   /**
+    * @brief 复位后的内部初始化是否完成 (器件ID正确且传感器与校准系数就绪)
+    */
+   bool isResetDone();
+
+   /**
+    * @brief 读取校准系数、配置过采样并启动连续测量，须在 isResetDone() 为真后调用
+    * @details 不等待首次测量，update() 在测量就绪标志置位后才读取数据
+    * @return 配置是否成功
+    */
+   bool configure();
+
    /**
     * @brief 更新传感器读数和计算值
+    * @return 本次是否读到新的气压数据
     */
-   void update();
+   bool update();
 
    // --- Getters ---
    /**
@@ -119,6 +137,16 @@ public:
     * @return true 如果读数稳定
     */
    bool isStable() const { return info_.Status.IsStable; }
+   /**
+    * @brief 获取地面气压参考值
+    * @return 地面气压 (Pa)
+    */
+   float getGroundPressure() const { return baroGndPressure_; }
+   /**
+    * @brief 设置地面气压参考初值 (如上次保存的值)，须在 init() 之后调用，仍需稳定后才置位 isStable
+    * @param pressure 地面气压 (Pa)
+    */
+   void setGroundPressure(float pressure) { baroGndPressure_ = pressure; }
    /**
     * @brief 获取校准参数
     * @return 校准参数结构体
@@ -137,6 +165,8 @@ private:
    float baroGndAltitude_ = 0.0f;      // 地面气压对应的高度 (m)
    uint32_t baroCaliTimeout_ = 0;      // 用于校准稳定性的时间戳
 
+   static constexpr uint32_t RESET_TIMEOUT_MS = 100; // 复位后等待就绪的上限，原固定等待时长
+
    // 中值滤波状态
    static constexpr int MEDIAN_FILTER_LEN = 3; // 滤波器长度
    int32_t filterBuff_[MEDIAN_FILTER_LEN] = {0}; // 滤波缓冲区
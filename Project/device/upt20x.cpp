@@ -204,6 +204,8 @@ bool UPT20X::parsePacket() {
     flow_data_.distance = laser_distance;
     flow_data_.valid = (valid == UPT20X_VALID_FLAG);
     flow_data_.confidence = confidence;
+    flow_data_.rx_cycle = DWT->CYCCNT;
+    flow_sample_.write(flow_data_);
     
     // 如果数据有效，喂狗
     if (flow_data_.valid && watchdog_ && watchdog_->isActive()) {
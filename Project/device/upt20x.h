@@ -3,6 +3,7 @@
 #include "main.h"
 #include <stdint.h>
 #include "watchdog.h"
+#include "seqlock.h"
 #include <functional>
 
 // 数据包格式常量
@@ -21,6 +22,7 @@ struct OpticalFlowData {
     uint16_t distance;         // 距离，单位：毫米
     bool valid;                // 数据有效性标志
     uint8_t confidence;        // 置信度，百分比
+    uint32_t rx_cycle;         // 接收时刻 (DWT 周期计数)
     
     // 计算实际位移（需要乘以高度）
     float getDisplacementX(float height_mm) const {
@@ -49,6 +51,9 @@ public:
     
     // 获取最新的光流数据
     OpticalFlowData getData() const;
+
+    // 获取一致的最新光流数据，返回序号 (每包加 2，0 表示尚未收到)，可在任意任务中调用
+    uint32_t getSample(OpticalFlowData& sample) const { return flow_sample_.read(sample); }
     
     // 检查模块是否运行中
     bool isRunning() const { return running_; }
@@ -79,6 +84,7 @@ private:
     
     // 数据缓存和处理
     OpticalFlowData flow_data_;
+    utils::SeqLock<OpticalFlowData> flow_sample_;
     
     // 统计数据
     uint32_t packet_count_;
@@ -1,7 +1,55 @@
 #include "fdcan_drv.h"
+#include <string.h>
 #define FDCAN_TRANSMIT_ID_TYPE                  0x1
 #define FDCAN_TRANSMIT_FRAME_TYPE               0x2
 #define FDCAN_TRANSMIT_CAN_TYPE                 0x4
+
+// 消息RAM中接收/发送元素的字段掩码
+#define FDCAN_DRV_ELEMENT_MASK_XTD              0x40000000U
+#define FDCAN_DRV_ELEMENT_MASK_FIDX             0x7F000000U
+#define FDCAN_DRV_ELEMENT_MASK_ANMF             0x80000000U
+
+static const uint8_t _FdcanDrv_DLCtoBytes[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+
+typedef struct
+{
+    FdcanDrvSubscriber_t *std[FDCAN_DRV_STD_FILTER_NBR];   // 以过滤器序号索引的订阅者
+    FdcanDrvSubscriber_t *ext[FDCAN_DRV_EXT_FILTER_NBR];
+    uint32_t std_count;
+    uint32_t ext_count;
+    FdcanDrvFrame_t discard;                                // 无订阅者或ring已满时的丢弃缓冲区
+} _FdcanDrv_Context_t;
+
+static _FdcanDrv_Context_t _fdcan_drv_context[3];
+
+static uint32_t _FdcanDrv_InstanceIndex(FDCAN_HandleTypeDef *hfdcan)
+{
+    if (hfdcan->Instance == FDCAN1) return 0;
+    if (hfdcan->Instance == FDCAN2) return 1;
+    return 2;
+}
+/*
+*   按FDCAN_DRV_xxx划分消息RAM并重新初始化外设
+*   CubeMX生成的配置中过滤器和FIFO数量均为0，且各外设的RAM偏移相同，需在此重新分配
+*/
+static HAL_StatusTypeDef _FdcanDrv_ConfigMessageRam(FDCAN_HandleTypeDef *hfdcan)
+{
+    if (hfdcan->State == HAL_FDCAN_STATE_BUSY) HAL_FDCAN_Stop(hfdcan);
+    hfdcan->Init.MessageRAMOffset = _FdcanDrv_InstanceIndex(hfdcan) * FDCAN_DRV_RAM_WORDS;
+    hfdcan->Init.StdFiltersNbr = FDCAN_DRV_STD_FILTER_NBR;
+    hfdcan->Init.ExtFiltersNbr = FDCAN_DRV_EXT_FILTER_NBR;
+    hfdcan->Init.RxFifo0ElmtsNbr = (hfdcan->Instance == FDCAN1) ? FDCAN_DRV_RX_FIFO_NBR : 0;
+    hfdcan->Init.RxFifo0ElmtSize = FDCAN_DATA_BYTES_64;
+    hfdcan->Init.RxFifo1ElmtsNbr = (hfdcan->Instance == FDCAN1) ? 0 : FDCAN_DRV_RX_FIFO_NBR;
+    hfdcan->Init.RxFifo1ElmtSize = FDCAN_DATA_BYTES_64;
+    hfdcan->Init.RxBuffersNbr = 0;
+    hfdcan->Init.TxEventsNbr = 0;
+    hfdcan->Init.TxBuffersNbr = 0;
+    hfdcan->Init.TxFifoQueueElmtsNbr = FDCAN_DRV_TX_FIFO_NBR;
+    hfdcan->Init.TxFifoQueueMode = FDCAN_TX_FIFO_OPERATION;
+    hfdcan->Init.TxElmtSize = FDCAN_DATA_BYTES_64;
+    return HAL_FDCAN_Init(hfdcan);
+}
 /*
 *   初始化对应FDCAN外设的标准帧接收过滤器
 *   其中FDCAN1和FDCAN3使用FILTER_RANGE模式进行过滤，FilterID1和FilterID2表示通过的标识符范围
@@ -43,6 +91,7 @@ void _FdcanDrv_InitExtendedFrame(FDCAN_HandleTypeDef *hfdcan)
 void FdcanDrv_Init_Default(FDCAN_HandleTypeDef *hfdcan)
 {
 	if(hfdcan == NULL) Error_Handler();
+    if(HAL_OK != _FdcanDrv_ConfigMessageRam(hfdcan)) Error_Handler();
     _FdcanDrv_InitStandardFrame(hfdcan);
     _FdcanDrv_InitExtendedFrame(hfdcan);
     if (HAL_FDCAN_ConfigGlobalFilter(hfdcan, FDCAN_REJECT, FDCAN_REJECT, FDCAN_FILTER_REMOTE, FDCAN_FILTER_REMOTE) ||
@@ -102,12 +151,204 @@ HAL_StatusTypeDef FdcanDrv_Transmit_FD_ExtRemote(FDCAN_HandleTypeDef *hfdcan, ui
     return FdcanDrv_Transmit(hfdcan, FDCAN_TRANSMIT_ID_EXT | FDCAN_TRANSMIT_FRAME_REMOTE | FDCAN_TRANSMIT_CAN_FD, id, pData, dlcField);
 }
 
-FdcanBspReceive_t FdcanDrv_DequeueRxPackage(FDCAN_HandleTypeDef *hfdcan)
+HAL_StatusTypeDef FdcanDrv_DequeueRxPackage(FDCAN_HandleTypeDef *hfdcan, FdcanBspReceive_t *rxmsg)
+{
+    if(hfdcan == NULL || rxmsg == NULL) return HAL_ERROR;
+    rxmsg->hfdcan = hfdcan;
+    rxmsg->RxFIFO = (hfdcan->Instance == FDCAN1) ? FDCAN_RX_FIFO0 : FDCAN_RX_FIFO1;
+    return HAL_FDCAN_GetRxMessage(hfdcan, rxmsg->RxFIFO, &rxmsg->RxMessage, rxmsg->RxData);
+}
+
+/*----------------------------------订阅方式接收----------------------------------*/
+HAL_StatusTypeDef FdcanDrv_Init(FDCAN_HandleTypeDef *hfdcan)
+{
+    if(hfdcan == NULL) return HAL_ERROR;
+    _FdcanDrv_Context_t *ctx = &_fdcan_drv_context[_FdcanDrv_InstanceIndex(hfdcan)];
+    memset(ctx, 0, sizeof(_FdcanDrv_Context_t));
+    uint32_t it = (hfdcan->Instance == FDCAN1) ? FDCAN_IT_RX_FIFO0_NEW_MESSAGE : FDCAN_IT_RX_FIFO1_NEW_MESSAGE;
+    if (_FdcanDrv_ConfigMessageRam(hfdcan) ||
+        HAL_FDCAN_ConfigGlobalFilter(hfdcan, FDCAN_REJECT, FDCAN_REJECT, FDCAN_REJECT_REMOTE, FDCAN_REJECT_REMOTE) ||
+        HAL_FDCAN_ActivateNotification(hfdcan, it, 0) ||
+        HAL_FDCAN_ActivateNotification(hfdcan, FDCAN_IT_BUS_OFF, 0)
+    ) return HAL_ERROR;
+    if(hfdcan->Instance == FDCAN1)
+    {
+        HAL_FDCAN_ConfigTxDelayCompensation(hfdcan, hfdcan->Init.DataPrescaler * hfdcan->Init.DataTimeSeg1, 0);
+        HAL_FDCAN_EnableTxDelayCompensation(hfdcan);
+    }
+    return HAL_FDCAN_Start(hfdcan);
+}
+HAL_StatusTypeDef FdcanDrv_Subscribe(FDCAN_HandleTypeDef *hfdcan, FdcanDrvSubscriber_t *sub, uint32_t IdType,
+                                     uint32_t id, uint32_t mask, FdcanDrvNotify_t notify, void *context)
+{
+    if(hfdcan == NULL || sub == NULL) return HAL_ERROR;
+    _FdcanDrv_Context_t *ctx = &_fdcan_drv_context[_FdcanDrv_InstanceIndex(hfdcan)];
+    uint32_t index;
+    if(IdType == FDCAN_STANDARD_ID)
+    {
+        if(ctx->std_count >= FDCAN_DRV_STD_FILTER_NBR) return HAL_ERROR;
+        index = ctx->std_count;
+    }
+    else
+    {
+        if(ctx->ext_count >= FDCAN_DRV_EXT_FILTER_NBR) return HAL_ERROR;
+        index = ctx->ext_count;
+    }
+
+    sub->hfdcan = hfdcan;
+    sub->IdType = IdType;
+    sub->id = id;
+    sub->mask = mask;
+    sub->head = 0;
+    sub->tail = 0;
+    sub->overflow = 0;
+    sub->notify = notify;
+    sub->context = context;
+
+    // 先登记订阅者再写过滤器，保证中断看到过滤器序号时订阅者已就绪
+    if(IdType == FDCAN_STANDARD_ID) ctx->std[index] = sub;
+    else ctx->ext[index] = sub;
+    __DMB();
+
+    FDCAN_FilterTypeDef filter = {0};
+    filter.IdType = IdType;
+    filter.FilterIndex = index;
+    filter.FilterType = FDCAN_FILTER_MASK;
+    filter.FilterConfig = (hfdcan->Instance == FDCAN1) ? FDCAN_FILTER_TO_RXFIFO0 : FDCAN_FILTER_TO_RXFIFO1;
+    filter.FilterID1 = id;
+    filter.FilterID2 = mask;
+    if(HAL_OK != HAL_FDCAN_ConfigFilter(hfdcan, &filter))
+    {
+        if(IdType == FDCAN_STANDARD_ID) ctx->std[index] = NULL;
+        else ctx->ext[index] = NULL;
+        return HAL_ERROR;
+    }
+
+    if(IdType == FDCAN_STANDARD_ID) ctx->std_count++;
+    else ctx->ext_count++;
+    return HAL_OK;
+}
+const FdcanDrvFrame_t *FdcanDrv_Peek(const FdcanDrvSubscriber_t *sub)
+{
+    if(sub->tail == sub->head) return NULL;
+    __DMB();
+    return &sub->ring[sub->tail & (FDCAN_DRV_RING_SIZE - 1)];
+}
+void FdcanDrv_Release(FdcanDrvSubscriber_t *sub)
+{
+    if(sub->tail == sub->head) return;
+    __DMB();
+    sub->tail++;
+}
+uint32_t FdcanDrv_Available(const FdcanDrvSubscriber_t *sub)
+{
+    return sub->head - sub->tail;
+}
+/*
+*   读取FIFO队首元素的过滤器序号，在取出之前确定目标订阅者，使帧可以直接写入订阅者的槽
+*/
+static FdcanDrvSubscriber_t *_FdcanDrv_PeekSubscriber(_FdcanDrv_Context_t *ctx, FDCAN_HandleTypeDef *hfdcan, uint32_t RxFifo)
+{
+    uint32_t *element;
+    if(RxFifo == FDCAN_RX_FIFO0)
+    {
+        uint32_t index = (hfdcan->Instance->RXF0S & FDCAN_RXF0S_F0GI) >> FDCAN_RXF0S_F0GI_Pos;
+        element = (uint32_t *)(hfdcan->msgRam.RxFIFO0SA + index * hfdcan->Init.RxFifo0ElmtSize * 4U);
+    }
+    else
+    {
+        uint32_t index = (hfdcan->Instance->RXF1S & FDCAN_RXF1S_F1GI) >> FDCAN_RXF1S_F1GI_Pos;
+        element = (uint32_t *)(hfdcan->msgRam.RxFIFO1SA + index * hfdcan->Init.RxFifo1ElmtSize * 4U);
+    }
+    if(element[1] & FDCAN_DRV_ELEMENT_MASK_ANMF) return NULL;
+    uint32_t filter = (element[1] & FDCAN_DRV_ELEMENT_MASK_FIDX) >> 24U;
+    if(element[0] & FDCAN_DRV_ELEMENT_MASK_XTD)
+        return (filter < FDCAN_DRV_EXT_FILTER_NBR) ? ctx->ext[filter] : NULL;
+    return (filter < FDCAN_DRV_STD_FILTER_NBR) ? ctx->std[filter] : NULL;
+}
+void FdcanDrv_RxFifoCallback(FDCAN_HandleTypeDef *hfdcan, uint32_t RxFifo)
+{
+    _FdcanDrv_Context_t *ctx = &_fdcan_drv_context[_FdcanDrv_InstanceIndex(hfdcan)];
+    FdcanDrvSubscriber_t *touched[FDCAN_DRV_STD_FILTER_NBR + FDCAN_DRV_EXT_FILTER_NBR];
+    uint32_t touched_count = 0;
+
+    while(HAL_FDCAN_GetRxFifoFillLevel(hfdcan, RxFifo) > 0)
+    {
+        FdcanDrvSubscriber_t *sub = _FdcanDrv_PeekSubscriber(ctx, hfdcan, RxFifo);
+        if(sub != NULL && sub->head - sub->tail < FDCAN_DRV_RING_SIZE)
+        {
+            FdcanDrvFrame_t *slot = &sub->ring[sub->head & (FDCAN_DRV_RING_SIZE - 1)];
+            if(HAL_OK != HAL_FDCAN_GetRxMessage(hfdcan, RxFifo, &slot->RxMessage, slot->RxData)) break;
+            __DMB();
+            sub->head++;
+            if(sub->notify != NULL)
+            {
+                uint32_t i;
+                for(i = 0; i < touched_count && touched[i] != sub; i++);
+                if(i == touched_count) touched[touched_count++] = sub;
+            }
+        }
+        else
+        {
+            // 无对应订阅者或ring已满，仍需取出以释放FIFO
+            if(HAL_OK != HAL_FDCAN_GetRxMessage(hfdcan, RxFifo, &ctx->discard.RxMessage, ctx->discard.RxData)) break;
+            if(sub != NULL) sub->overflow++;
+        }
+    }
+
+    for(uint32_t i = 0; i < touched_count; i++)
+        touched[i]->notify(touched[i], touched[i]->context);
+}
+/*
+*   将一帧写入发送FIFO的指定元素，格式与HAL_FDCAN_AddMessageToTxFifoQ相同
+*/
+static void _FdcanDrv_WriteTxElement(FDCAN_HandleTypeDef *hfdcan, const FdcanDrvTxFrame_t *frame, uint32_t index)
+{
+    uint32_t *address = (uint32_t *)(hfdcan->msgRam.TxBufferSA + index * hfdcan->Init.TxElmtSize * 4U);
+    uint32_t remote = (frame->transmit_Para & FDCAN_TRANSMIT_FRAME_TYPE) ? FDCAN_REMOTE_FRAME : FDCAN_DATA_FRAME;
+    uint32_t fd = (frame->transmit_Para & FDCAN_TRANSMIT_CAN_TYPE) ? (FDCAN_FD_CAN | FDCAN_BRS_ON) : FDCAN_CLASSIC_CAN;
+    uint32_t dlc = frame->dlcField & 0xFU;
+
+    if(frame->transmit_Para & FDCAN_TRANSMIT_ID_TYPE)
+        address[0] = FDCAN_ESI_ACTIVE | FDCAN_EXTENDED_ID | remote | (frame->id & 0x1FFFFFFFU);
+    else
+        address[0] = FDCAN_ESI_ACTIVE | FDCAN_STANDARD_ID | remote | ((frame->id & 0x7FFU) << 18U);
+    address[1] = FDCAN_NO_TX_EVENTS | fd | (dlc << 16U);
+
+    const uint8_t *data = (const uint8_t *)frame->pData;
+    uint32_t length = (data != NULL) ? _FdcanDrv_DLCtoBytes[dlc] : 0;
+    for(uint32_t i = 0; i < length; i += 4U)
+    {
+        uint32_t word = 0;
+        for(uint32_t j = 0; j < 4U && i + j < length; j++)
+            word |= (uint32_t)data[i + j] << (8U * j);
+        address[2U + i / 4U] = word;
+    }
+}
+uint32_t FdcanDrv_TransmitBatch(FDCAN_HandleTypeDef *hfdcan, const FdcanDrvTxFrame_t *frames, uint32_t count)
 {
-    FdcanBspReceive_t rxmsg = {0};
-    if(hfdcan == NULL) return rxmsg;
-    rxmsg.hfdcan = hfdcan;
-    rxmsg.RxFIFO = (hfdcan->Instance == FDCAN1) ? FDCAN_RX_FIFO0 : FDCAN_RX_FIFO1;
-    HAL_FDCAN_GetRxMessage(hfdcan, rxmsg.RxFIFO, &rxmsg.RxMessage, rxmsg.RxData);
-    return rxmsg;
+    if(hfdcan == NULL || frames == NULL || hfdcan->State != HAL_FDCAN_STATE_BUSY) return 0;
+    uint32_t fifo_size = hfdcan->Init.TxFifoQueueElmtsNbr;
+    if(fifo_size == 0) return 0;
+
+    uint32_t status = hfdcan->Instance->TXFQS;
+    uint32_t free_level = (status & FDCAN_TXFQS_TFFL) >> FDCAN_TXFQS_TFFL_Pos;
+    uint32_t put_index = (status & FDCAN_TXFQS_TFQPI) >> FDCAN_TXFQS_TFQPI_Pos;
+    uint32_t base = hfdcan->Init.TxBuffersNbr;
+    if(count > free_level) count = free_level;
+
+    uint32_t request = 0;
+    uint32_t index = put_index;
+    for(uint32_t i = 0; i < count; i++)
+    {
+        index = base + (put_index - base + i) % fifo_size;
+        _FdcanDrv_WriteTxElement(hfdcan, &frames[i], index);
+        request |= 1U << index;
+    }
+    if(request != 0)
+    {
+        hfdcan->Instance->TXBAR = request; // 一次提交全部发送请求
+        hfdcan->LatestTxFifoQRequest = 1U << index;
+    }
+    return count;
 }
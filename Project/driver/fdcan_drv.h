@@ -47,11 +47,99 @@ typedef struct
     uint32_t RxFIFO;
 } FdcanBspReceive_t;
 /*
-* @brief  FDCAN接收数据
+* @brief  FDCAN接收数据（轮询方式，用于FdcanDrv_Init_Default）
 * @param  hfdcan: FDCAN句柄
-* @retval FdcanBspReceive_t 包含接收到的数据和数据帧信息
+* @param  rxmsg: 接收到的数据和数据帧信息
+* @retval HAL_OK表示取到一帧，FIFO为空时返回HAL_ERROR
 */
-FdcanBspReceive_t FdcanDrv_DequeueRxPackage(FDCAN_HandleTypeDef *hfdcan);
+HAL_StatusTypeDef FdcanDrv_DequeueRxPackage(FDCAN_HandleTypeDef *hfdcan, FdcanBspReceive_t *rxmsg);
+
+/*----------------------------------订阅方式接收----------------------------------*/
+// 每个FDCAN外设的消息RAM划分（FDCAN1~3共享10KB消息RAM，每个外设占用FDCAN_DRV_RAM_WORDS字）
+#define FDCAN_DRV_STD_FILTER_NBR                16      // 标准帧过滤器数量，即标准帧订阅者上限
+#define FDCAN_DRV_EXT_FILTER_NBR                8       // 扩展帧过滤器数量，即扩展帧订阅者上限
+#define FDCAN_DRV_RX_FIFO_NBR                   24      // 硬件接收FIFO深度
+#define FDCAN_DRV_TX_FIFO_NBR                   16      // 硬件发送FIFO深度
+#define FDCAN_DRV_RAM_WORDS                     848
+// 每个订阅者的接收环形缓冲区深度（必须为2的幂）
+#define FDCAN_DRV_RING_SIZE                     8
+
+typedef struct
+{
+    FDCAN_RxHeaderTypeDef RxMessage;
+    uint8_t RxData[64];
+} FdcanDrvFrame_t;
+
+typedef struct FdcanDrvSubscriber FdcanDrvSubscriber_t;
+typedef void (*FdcanDrvNotify_t)(FdcanDrvSubscriber_t *sub, void *context);
+
+/*
+*   订阅者：由硬件过滤器筛选出的帧在中断中直接写入ring的空槽，
+*   中断只修改head，订阅者只修改tail，无需加锁
+*/
+struct FdcanDrvSubscriber
+{
+    FDCAN_HandleTypeDef *hfdcan;
+    uint32_t IdType;                        // FDCAN_STANDARD_ID或FDCAN_EXTENDED_ID
+    uint32_t id;                            // 过滤ID
+    uint32_t mask;                          // 过滤掩码，1表示该位需要匹配
+    FdcanDrvFrame_t ring[FDCAN_DRV_RING_SIZE];
+    volatile uint32_t head;                 // 写入计数，仅由中断修改
+    volatile uint32_t tail;                 // 读取计数，仅由订阅者修改
+    volatile uint32_t overflow;             // ring已满时丢弃的帧数
+    FdcanDrvNotify_t notify;                // 中断中收到新帧后调用，可为NULL
+    void *context;
+};
+
+typedef struct
+{
+    uint32_t id;
+    uint8_t transmit_Para;                  // 与FdcanDrv_Transmit相同的FDCAN_TRANSMIT_xxx组合
+    uint32_t dlcField;                      // FDCAN_DLC_BYTES_xxx
+    const void *pData;
+} FdcanDrvTxFrame_t;
+
+/*
+*   初始化FDCAN外设用于订阅方式接收：
+*       配置消息RAM，拒绝未匹配任何过滤器的帧，使能接收FIFO新消息中断并启动外设
+*       FDCAN1使用FIFO0缓冲区，其余使用FIFO1缓冲区
+*/
+HAL_StatusTypeDef FdcanDrv_Init(FDCAN_HandleTypeDef *hfdcan);
+/*
+* @brief  注册订阅者并为其配置一个硬件过滤器
+* @param  hfdcan: FDCAN句柄
+* @param  sub: 订阅者，需保持有效（通常为全局变量）
+* @param  IdType: FDCAN_STANDARD_ID或FDCAN_EXTENDED_ID
+* @param  id: 过滤ID
+* @param  mask: 过滤掩码，0x7FF/0x1FFFFFFF表示精确匹配
+* @param  notify: 收到新帧的中断回调，可为NULL
+* @param  context: 回调参数
+* @retval HAL_ERROR表示过滤器已用完
+*/
+HAL_StatusTypeDef FdcanDrv_Subscribe(FDCAN_HandleTypeDef *hfdcan, FdcanDrvSubscriber_t *sub, uint32_t IdType,
+                                     uint32_t id, uint32_t mask, FdcanDrvNotify_t notify, void *context);
+/*
+* @brief  获取订阅者最早的一帧（零拷贝，直接指向ring中的槽）
+* @retval 无数据时返回NULL；使用完毕后调用FdcanDrv_Release释放该槽
+*/
+const FdcanDrvFrame_t *FdcanDrv_Peek(const FdcanDrvSubscriber_t *sub);
+void FdcanDrv_Release(FdcanDrvSubscriber_t *sub);
+uint32_t FdcanDrv_Available(const FdcanDrvSubscriber_t *sub);
+/*
+* @brief  接收FIFO中断处理：一次取出FIFO中的全部帧并分发到订阅者
+* @param  hfdcan: FDCAN句柄
+* @param  RxFifo: FDCAN_RX_FIFO0或FDCAN_RX_FIFO1
+*/
+void FdcanDrv_RxFifoCallback(FDCAN_HandleTypeDef *hfdcan, uint32_t RxFifo);
+/*
+* @brief  批量发送：将多帧写入发送FIFO后一次性提交发送请求
+* @param  hfdcan: FDCAN句柄
+* @param  frames: 帧数组
+* @param  count: 帧数
+* @retval 实际写入的帧数（受发送FIFO剩余空间限制）
+* @note   不可重入，多个任务发送时需由调用者保证互斥
+*/
+uint32_t FdcanDrv_TransmitBatch(FDCAN_HandleTypeDef *hfdcan, const FdcanDrvTxFrame_t *frames, uint32_t count);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,165 @@
+#include "boot_sequencer.h"
+#include "cmsis_os.h"
+#include "time_utils.h"
+
+extern uint32_t SystemCoreClock;
+
+static uint32_t boot_cycles_to_us(uint64_t cycles)
+{
+    return (uint32_t)(cycles / (SystemCoreClock / 1000000u));
+}
+
+BootSequencer::BootSequencer(const BootStageConfig_t* stages, uint8_t count)
+    : stages_(stages), count_(count > BOOT_MAX_STAGES ? BOOT_MAX_STAGES : count), total_us_(0), stats_{}
+{
+}
+
+bool BootSequencer::validate() const
+{
+    if (stages_ == nullptr)
+    {
+        return false;
+    }
+
+    // 与执行器相同的拓扑检查：每轮排入一个依赖已全部排入的阶段，排不完即成环
+    uint32_t placed = 0;
+    uint32_t valid_mask = (count_ >= 32) ? 0xFFFFFFFFu : ((1u << count_) - 1u);
+    for (uint8_t n = 0; n < count_; n++)
+    {
+        int next = -1;
+        for (uint8_t i = 0; i < count_; i++)
+        {
+            if (stages_[i].depends & ~valid_mask)
+            {
+                return false; // 依赖了不存在的阶段
+            }
+            if (!(placed & (1u << i)) && (stages_[i].depends & ~placed) == 0)
+            {
+                next = i;
+                break;
+            }
+        }
+        if (next < 0)
+        {
+            return false; // 依赖成环
+        }
+        placed |= (1u << next);
+    }
+    return true;
+}
+
+bool BootSequencer::run(uint32_t poll_ms)
+{
+    if (!validate())
+    {
+        return false;
+    }
+
+    uint64_t begin = utils::time::getGlobalTick();
+    for (uint8_t i = 0; i < count_; i++)
+    {
+        stats_[i] = BootStageStats_t{};
+        stats_[i].state = BOOT_STAGE_PENDING;
+    }
+
+    uint32_t ready_mask = 0;
+    uint32_t failed_mask = 0;
+    uint8_t remaining = count_;
+    while (remaining > 0)
+    {
+        bool progressed = false;
+        for (uint8_t i = 0; i < count_; i++)
+        {
+            BootStageStats_t& stats = stats_[i];
+            const BootStageConfig_t& stage = stages_[i];
+
+            if (stats.state == BOOT_STAGE_PENDING)
+            {
+                if (stage.depends & failed_mask)
+                {
+                    // 依赖失败，本阶段及依赖本阶段的阶段均不启动
+                    stats.state = BOOT_STAGE_SKIPPED;
+                    failed_mask |= (1u << i);
+                    remaining--;
+                    progressed = true;
+                    continue;
+                }
+                if ((stage.depends & ~ready_mask) != 0)
+                {
+                    continue; // 依赖尚未就绪
+                }
+                start(i, begin);
+                progressed = true;
+            }
+
+            if (stats.state == BOOT_STAGE_WAITING)
+            {
+                uint64_t now = utils::time::getGlobalTick();
+                uint32_t elapsed_us = boot_cycles_to_us(now - begin) - stats.start_us;
+                if (stage.ready == nullptr || stage.ready())
+                {
+                    finish(i, begin, BOOT_STAGE_READY);
+                }
+                else if (stage.timeout_ms != 0 && elapsed_us >= stage.timeout_ms * 1000u)
+                {
+                    finish(i, begin, BOOT_STAGE_FAILED);
+                }
+                else
+                {
+                    continue;
+                }
+                progressed = true;
+            }
+
+            if (stats.state == BOOT_STAGE_READY || stats.state == BOOT_STAGE_FAILED)
+            {
+                uint32_t bit = 1u << i;
+                if (!((ready_mask | failed_mask) & bit))
+                {
+                    if (stats.state == BOOT_STAGE_READY)
+                    {
+                        ready_mask |= bit;
+                    }
+                    else
+                    {
+                        failed_mask |= bit;
+                    }
+                    remaining--;
+                }
+            }
+        }
+
+        // 本轮有阶段启动或结束时立即再扫描一轮，新解除依赖的阶段不必等待轮询间隔
+        if (!progressed && remaining > 0)
+        {
+            osDelay(poll_ms);
+        }
+    }
+
+    total_us_ = boot_cycles_to_us(utils::time::getGlobalTick() - begin);
+    return failed_mask == 0;
+}
+
+void BootSequencer::start(uint8_t index, uint64_t begin)
+{
+    BootStageStats_t& stats = stats_[index];
+    const BootStageConfig_t& stage = stages_[index];
+
+    uint64_t now = utils::time::getGlobalTick();
+    stats.start_us = boot_cycles_to_us(now - begin);
+    stats.state = BOOT_STAGE_WAITING;
+
+    bool ok = (stage.start == nullptr) || stage.start();
+    stats.exec_us = boot_cycles_to_us(utils::time::getGlobalTick() - now);
+    if (!ok)
+    {
+        finish(index, begin, BOOT_STAGE_FAILED);
+    }
+}
+
+void BootSequencer::finish(uint8_t index, uint64_t begin, BootStageState_t state)
+{
+    BootStageStats_t& stats = stats_[index];
+    stats.ready_us = boot_cycles_to_us(utils::time::getGlobalTick() - begin) - stats.start_us;
+    stats.state = (uint8_t)state;
+}
@@ -0,0 +1,95 @@
+#ifndef BOOT_SEQUENCER_H
+#define BOOT_SEQUENCER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BOOT_MAX_STAGES 16 // 依赖位掩码为 32 位，不能超过 32
+
+// 启动步骤与就绪判定函数类型
+typedef bool (*BootStageFunc_t)(void);
+
+// 启动阶段声明
+typedef struct {
+    const char* name;       // 阶段名称
+    BootStageFunc_t start;  // 启动步骤，返回是否成功，不得长时间阻塞；为空表示无需启动
+    BootStageFunc_t ready;  // 就绪判定，为空表示启动步骤返回即就绪
+    uint32_t depends;       // 依赖的阶段 (按声明下标的位掩码)，依赖全部就绪后才启动
+    uint32_t timeout_ms;    // 启动后等待就绪的超时，0 表示不超时
+} BootStageConfig_t;
+
+// 阶段状态
+typedef enum {
+    BOOT_STAGE_PENDING = 0, // 等待依赖
+    BOOT_STAGE_WAITING,     // 已启动，等待就绪
+    BOOT_STAGE_READY,       // 已就绪
+    BOOT_STAGE_FAILED,      // 启动步骤失败或等待就绪超时
+    BOOT_STAGE_SKIPPED,     // 依赖失败，未启动
+} BootStageState_t;
+
+// 阶段耗时记录，时刻均相对启动序列开始
+typedef struct {
+    uint8_t state;          // BootStageState_t
+    uint32_t start_us;      // 开始启动的时刻
+    uint32_t exec_us;       // 启动步骤本身的执行时间
+    uint32_t ready_us;      // 开始启动到就绪 (或失败) 的时间
+} BootStageStats_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+
+/**
+ * @brief 依赖图启动序列
+ * @details 各设备声明启动步骤、依赖与就绪判定，代替串行初始化与估计的等待延时。
+ *          启动步骤只发出命令 (如软复位)，不等待硬件；等待中的阶段在每轮轮询中检查就绪判定，
+ *          依赖全部就绪的阶段立即启动，互不依赖的设备等待硬件的时间相互重叠。
+ *          阶段失败时依赖它的阶段被跳过，其余阶段照常完成。
+ *          每个阶段的开始时刻、启动耗时与就绪耗时记录在统计表中 (DWT 计时)，
+ *          可在调试器中查看，据此找出启动的关键路径。
+ */
+class BootSequencer {
+public:
+    /**
+     * @brief 构造函数
+     * @param stages 阶段声明表 (需在启动序列生命周期内有效)
+     * @param count 阶段数量，不超过 BOOT_MAX_STAGES
+     */
+    BootSequencer(const BootStageConfig_t* stages, uint8_t count);
+
+    /**
+     * @brief 在当前线程中运行启动序列，所有阶段就绪、失败或跳过后返回
+     * @param poll_ms 没有阶段可推进时的轮询间隔，单位：ms
+     * @return 是否所有阶段均就绪；依赖越界或成环时不运行任何阶段并返回 false
+     */
+    bool run(uint32_t poll_ms = 1);
+
+    uint8_t getStageCount() const { return count_; }
+    const BootStageConfig_t& getStage(uint8_t index) const { return stages_[index]; }
+    const BootStageStats_t& getStats(uint8_t index) const { return stats_[index]; }
+
+    /**
+     * @brief 启动序列总耗时，单位：us
+     */
+    uint32_t getTotalUs() const { return total_us_; }
+
+private:
+    const BootStageConfig_t* stages_;
+    uint8_t count_;
+    uint32_t total_us_;
+    BootStageStats_t stats_[BOOT_MAX_STAGES];
+
+    bool validate() const;
+    void start(uint8_t index, uint64_t begin);
+    void finish(uint8_t index, uint64_t begin, BootStageState_t state);
+};
+
+#endif // __cplusplus
+
+#endif // BOOT_SEQUENCER_H
@@ -0,0 +1,148 @@
+#include "executor.h"
+#include "cmsis_os.h"
+#include "time_utils.h"
+
+extern uint32_t SystemCoreClock;
+
+Executor::Executor(const ExecutorJobConfig_t* jobs, uint8_t count)
+    : jobs_(jobs), count_(count > EXECUTOR_MAX_JOBS ? EXECUTOR_MAX_JOBS : count), initialized_(false),
+      order_{0}, next_release_{0}, finished_{false}, stats_{}
+{
+}
+
+bool Executor::init()
+{
+    if (jobs_ == nullptr)
+    {
+        return false;
+    }
+
+    // 依赖拓扑排序：每轮从依赖已全部排入的作业中选出优先级最高者
+    uint32_t placed = 0;
+    uint32_t valid_mask = (count_ >= 32) ? 0xFFFFFFFFu : ((1u << count_) - 1u);
+    for (uint8_t n = 0; n < count_; n++)
+    {
+        int best = -1;
+        for (uint8_t i = 0; i < count_; i++)
+        {
+            if (placed & (1u << i))
+            {
+                continue;
+            }
+            if (jobs_[i].depends & ~valid_mask)
+            {
+                return false; // 依赖了不存在的作业
+            }
+            if ((jobs_[i].depends & ~placed) != 0)
+            {
+                continue; // 依赖尚未排入
+            }
+            if (best < 0 || jobs_[i].priority < jobs_[best].priority)
+            {
+                best = i;
+            }
+        }
+        if (best < 0)
+        {
+            return false; // 依赖成环
+        }
+        order_[n] = (uint8_t)best;
+        placed |= (1u << best);
+    }
+
+    initialized_ = true;
+    return true;
+}
+
+void Executor::run()
+{
+    if (!initialized_ && !init())
+    {
+        // 作业声明有误，保持线程存活以便调试
+        while (1)
+        {
+            osDelay(1000);
+        }
+    }
+
+    uint32_t start = osKernelGetTickCount();
+    for (uint8_t i = 0; i < count_; i++)
+    {
+        next_release_[i] = start + jobs_[i].start_ms;
+        finished_[i] = false;
+    }
+
+    while (1)
+    {
+        uint32_t now = osKernelGetTickCount();
+
+        // 按拓扑序执行所有已到释放时刻的作业
+        for (uint8_t n = 0; n < count_; n++)
+        {
+            uint8_t i = order_[n];
+            if (finished_[i] || (int32_t)(now - next_release_[i]) < 0)
+            {
+                continue;
+            }
+
+            execute(i);
+
+            if (jobs_[i].period_ms == 0)
+            {
+                finished_[i] = true;
+                continue;
+            }
+            // 绝对时间累加，执行耗时不影响下次释放时刻
+            next_release_[i] += jobs_[i].period_ms;
+            if ((int32_t)(now - next_release_[i]) >= 0)
+            {
+                // 已错过整个周期，跳到下一个未来时刻，避免连续补跑
+                uint32_t missed = (now - next_release_[i]) / jobs_[i].period_ms + 1;
+                next_release_[i] += missed * jobs_[i].period_ms;
+                stats_[i].skip_count += missed;
+            }
+        }
+
+        // 睡眠到最近的释放时刻
+        bool any = false;
+        uint32_t wake = 0;
+        for (uint8_t i = 0; i < count_; i++)
+        {
+            if (finished_[i])
+            {
+                continue;
+            }
+            if (!any || (int32_t)(next_release_[i] - wake) < 0)
+            {
+                wake = next_release_[i];
+                any = true;
+            }
+        }
+        if (!any)
+        {
+            // 没有周期作业，线程空转
+            osDelay(1000);
+            continue;
+        }
+        if ((int32_t)(wake - osKernelGetTickCount()) > 0)
+        {
+            osDelayUntil(wake);
+        }
+    }
+}
+
+void Executor::execute(uint8_t index)
+{
+    uint64_t begin = utils::time::getGlobalTick();
+    jobs_[index].func();
+    uint64_t cycles = utils::time::getGlobalTick() - begin;
+
+    uint32_t exec_us = (uint32_t)(cycles / (SystemCoreClock / 1000000u));
+    ExecutorJobStats_t& stats = stats_[index];
+    stats.run_count++;
+    stats.last_exec_us = exec_us;
+    if (exec_us > stats.max_exec_us)
+    {
+        stats.max_exec_us = exec_us;
+    }
+}
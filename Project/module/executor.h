@@ -0,0 +1,84 @@
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EXECUTOR_MAX_JOBS 24 // 依赖位掩码为 32 位，不能超过 32
+
+// 作业函数类型
+typedef void (*ExecutorFunc_t)(void);
+
+// 作业声明
+typedef struct {
+    const char* name;       // 作业名称
+    ExecutorFunc_t func;    // 作业函数，不得阻塞
+    uint32_t period_ms;     // 执行周期，0 表示只在 start_ms 时执行一次
+    uint32_t start_ms;      // 首次释放时刻，相对执行器启动
+    uint8_t priority;       // 同一时刻释放的作业中数值越小越先执行
+    uint32_t depends;       // 依赖的作业 (按声明下标的位掩码)，同一时刻释放时被依赖者先执行
+} ExecutorJobConfig_t;
+
+// 作业运行统计
+typedef struct {
+    uint32_t run_count;     // 执行次数
+    uint32_t skip_count;    // 因错过整个周期而跳过的释放次数
+    uint32_t last_exec_us;  // 最近一次执行时间
+    uint32_t max_exec_us;   // 最大执行时间
+} ExecutorJobStats_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+
+/**
+ * @brief 多速率作业执行器
+ * @details 在单个线程中按声明的周期、优先级与数据依赖调度多个周期作业。
+ *          释放时刻按绝对时间累加 (osDelayUntil)，执行耗时不会带来周期漂移；
+ *          线程只在最近的释放时刻唤醒，同一时刻释放的作业按依赖拓扑序与优先级依次执行。
+ */
+class Executor {
+public:
+    /**
+     * @brief 构造函数
+     * @param jobs 作业声明表 (需在执行器生命周期内有效)
+     * @param count 作业数量，不超过 EXECUTOR_MAX_JOBS
+     */
+    Executor(const ExecutorJobConfig_t* jobs, uint8_t count);
+
+    /**
+     * @brief 根据依赖与优先级计算执行顺序
+     * @return 依赖中存在环或越界时返回 false
+     */
+    bool init();
+
+    /**
+     * @brief 在当前线程中运行执行器，不返回
+     */
+    void run();
+
+    uint8_t getJobCount() const { return count_; }
+    const ExecutorJobConfig_t& getJob(uint8_t index) const { return jobs_[index]; }
+    const ExecutorJobStats_t& getStats(uint8_t index) const { return stats_[index]; }
+
+private:
+    const ExecutorJobConfig_t* jobs_;
+    uint8_t count_;
+    bool initialized_;
+
+    uint8_t order_[EXECUTOR_MAX_JOBS];       // 执行顺序 (作业下标)
+    uint32_t next_release_[EXECUTOR_MAX_JOBS]; // 下次释放时刻 (内核节拍)
+    bool finished_[EXECUTOR_MAX_JOBS];       // 单次作业是否已执行
+    ExecutorJobStats_t stats_[EXECUTOR_MAX_JOBS];
+
+    void execute(uint8_t index);
+};
+
+#endif // __cplusplus
+
+#endif // EXECUTOR_H
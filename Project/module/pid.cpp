@@ -1,49 +1,15 @@
 #include "pid.h"
 #include <math.h>
 
-#ifndef PI
-#define PI 3.14159265358979323846f
-#endif
-
 // 计算滤波器系数
 void PID_UpdateDifferentialFilterCoefficients(PidController_t *pid) {
     if (pid == NULL) return;
     
-    float samplingFreq = pid->config.diffFilterSamplingFreq;
-    float cutoffFreq = pid->config.diffFilterCutoffFreq;
-    float q = pid->config.diffFilterQ;
-    
-    // 检查是否低于奈奎斯特频率
-    if (cutoffFreq < (samplingFreq / 2.0f)) {
-        // 设置变量
-        const float omega = 2.0f * PI * cutoffFreq / samplingFreq;
-        const float sn = sinf(omega);
-        const float cs = cosf(omega);
-        const float alpha = sn / (2.0f * q);
-
-        // 低通滤波器系数
-        float b0 = (1.0f - cs) / 2.0f;
-        float b1 = 1.0f - cs;
-        float b2 = (1.0f - cs) / 2.0f;
-        
-        const float a0 = 1.0f + alpha;
-        const float a1 = -2.0f * cs;
-        const float a2 = 1.0f - alpha;
-
-        // 预计算系数
-        pid->status.diffFilterB0 = b0 / a0;
-        pid->status.diffFilterB1 = b1 / a0;
-        pid->status.diffFilterB2 = b2 / a0;
-        pid->status.diffFilterA1 = a1 / a0;
-        pid->status.diffFilterA2 = a2 / a0;
-    } else {
-        // 截止频率高于奈奎斯特频率 - 无滤波直接通过
-        pid->status.diffFilterB0 = 1.0f;
-        pid->status.diffFilterB1 = 0.0f;
-        pid->status.diffFilterB2 = 0.0f;
-        pid->status.diffFilterA1 = 0.0f;
-        pid->status.diffFilterA2 = 0.0f;
-    }
+    // 截止频率高于奈奎斯特频率时退化为直通
+    Biquad_Lowpass(&pid->status.diffFilter,
+                   pid->config.diffFilterSamplingFreq,
+                   pid->config.diffFilterCutoffFreq,
+                   pid->config.diffFilterQ);
 }
 
 // C接口实现 - 初始化函数现在只接受预先配置好的控制器
@@ -61,19 +27,15 @@ void PID_Init(PidController_t *pid) {
     pid->status.output = 0.0f;
     
     // 初始化滤波器状态
-    pid->status.diffFilterD1 = 0.0f;
-    pid->status.diffFilterD2 = 0.0f;
+    pid->status.diffFilterState[0] = 0.0f;
+    pid->status.diffFilterState[1] = 0.0f;
     
     // 如果启用了微分滤波，计算滤波器系数
     if (pid->config.diffFilterEnabled) {
         PID_UpdateDifferentialFilterCoefficients(pid);
     } else {
         // 未启用时设置为直通
-        pid->status.diffFilterB0 = 1.0f;
-        pid->status.diffFilterB1 = 0.0f;
-        pid->status.diffFilterB2 = 0.0f;
-        pid->status.diffFilterA1 = 0.0f;
-        pid->status.diffFilterA2 = 0.0f;
+        Biquad_Passthrough(&pid->status.diffFilter);
     }
 }
 
@@ -82,17 +44,6 @@ void PID_SetTarget(PidController_t *pid, float target) {
     pid->status.target = target;
 }
 
-// 二阶低通滤波器实现
-float PID_BiquadLPFilter(PidController_t *pid, float input) {
-    if (pid == NULL) return input;
-    
-    const float result = pid->status.diffFilterB0 * input + pid->status.diffFilterD1;
-    pid->status.diffFilterD1 = pid->status.diffFilterB1 * input - pid->status.diffFilterA1 * result + pid->status.diffFilterD2;
-    pid->status.diffFilterD2 = pid->status.diffFilterB2 * input - pid->status.diffFilterA2 * result;
-    
-    return result;
-}
-
 // 核心更新函数，提供全部参数
 float PID_Update(PidController_t *pid, float actual, PidMode_e mode, PidType_e type) {
     if (pid == NULL) return 0.0f;
@@ -133,7 +84,7 @@ float PID_Update(PidController_t *pid, float actual, PidMode_e mode, PidType_e t
         
         // 微分滤波 - 使用二阶低通滤波器
         if (pid->config.diffFilterEnabled && pid->config.kd != 0.0f) {
-            pid->status.differential = PID_BiquadLPFilter(pid, pid->status.differential);
+            pid->status.differential = Biquad_Apply(&pid->status.diffFilter, pid->status.diffFilterState, pid->status.differential);
         }
     } else {
         pid->status.differential = 0.0f;
@@ -201,8 +152,8 @@ void PID_Reset(PidController_t *pid) {
     pid->status.integral = 0.0f;
     pid->status.differential = 0.0f;
     pid->status.output = 0.0f;
-    pid->status.diffFilterD1 = 0.0f;
-    pid->status.diffFilterD2 = 0.0f;
+    pid->status.diffFilterState[0] = 0.0f;
+    pid->status.diffFilterState[1] = 0.0f;
 }
 
 void PID_ClearIntegral(PidController_t *pid) {
@@ -245,8 +196,8 @@ void PID_InitDifferentialFilter(PidController_t *pid, float samplingFreq, float
     PID_UpdateDifferentialFilterCoefficients(pid);
     
     // 重置滤波器状态
-    pid->status.diffFilterD1 = 0.0f;
-    pid->status.diffFilterD2 = 0.0f;
+    pid->status.diffFilterState[0] = 0.0f;
+    pid->status.diffFilterState[1] = 0.0f;
     
     // 启用滤波器
     pid->config.diffFilterEnabled = 1;
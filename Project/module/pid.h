@@ -2,6 +2,7 @@
 #define PID_H
 
 #include <stdint.h>
+#include "math_biquad.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -60,16 +61,9 @@ typedef struct {
     float differential;                // 微分项
     float output;                      // 输出值
     
-    // 二阶低通滤波器参数 - 计算得到的系数
-    float diffFilterB0;                // 滤波器系数b0
-    float diffFilterB1;                // 滤波器系数b1 
-    float diffFilterB2;                // 滤波器系数b2
-    float diffFilterA1;                // 滤波器系数a1
-    float diffFilterA2;                // 滤波器系数a2
-    
-    // 滤波器状态变量
-    float diffFilterD1;                // 滤波器状态变量d1
-    float diffFilterD2;                // 滤波器状态变量d2
+    // 微分项二阶低通滤波器
+    BiquadCoeffs_t diffFilter;         // 计算得到的系数
+    float diffFilterState[2];          // 滤波器状态变量d1, d2
 } PidStatus_t;
 
 // PID控制器结构体
@@ -0,0 +1,103 @@
+#include "runtime_monitor.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "time_utils.h"
+#include <string.h>
+
+volatile uint32_t runtime_isr_cycles = 0;
+volatile uint32_t runtime_isr_depth = 0;
+volatile uint32_t runtime_isr_start = 0;
+
+extern "C" void configureTimerForRunTimeStats(void)
+{
+    // 调度器启动时调用，确保 DWT 周期计数器已开启
+    utils::time::enableCycleCounter();
+}
+
+extern "C" unsigned long getRunTimeCounterValue(void)
+{
+    return DWT->CYCCNT;
+}
+
+// 采样缓冲区较大，放在静态区以免占用调用线程的栈
+static TaskStatus_t runtime_task_status[RUNTIME_MONITOR_MAX_TASKS];
+
+RuntimeMonitor::RuntimeMonitor()
+    : last_isr_(0), last_count_(0), last_number_{0}, last_runtime_{0}
+{
+}
+
+uint32_t RuntimeMonitor::previousRuntime(uint32_t number) const
+{
+    for (uint8_t i = 0; i < last_count_; i++)
+    {
+        if (last_number_[i] == number)
+        {
+            return last_runtime_[i];
+        }
+    }
+    return 0; // 新创建的任务
+}
+
+static uint16_t toPermille(uint32_t part, uint32_t total)
+{
+    if (total == 0)
+    {
+        return 0;
+    }
+    uint64_t permille = (uint64_t)part * 1000u / total;
+    return (uint16_t)(permille > 1000u ? 1000u : permille);
+}
+
+bool RuntimeMonitor::sample(RuntimeStatsRecord_t* record)
+{
+    if (record == nullptr)
+    {
+        return false;
+    }
+
+    UBaseType_t count = uxTaskGetSystemState(runtime_task_status, RUNTIME_MONITOR_MAX_TASKS, nullptr);
+    if (count == 0)
+    {
+        return false; // 缓冲区不足以容纳全部任务
+    }
+    uint32_t isr = runtime_isr_cycles;
+
+    // 各任务运行计数增量之和即为统计周期长度 (中断耗时计入被打断的任务)
+    uint32_t delta[RUNTIME_MONITOR_MAX_TASKS];
+    uint32_t total = 0;
+    uint32_t idle = 0;
+    for (UBaseType_t i = 0; i < count; i++)
+    {
+        delta[i] = runtime_task_status[i].ulRunTimeCounter - previousRuntime(runtime_task_status[i].xTaskNumber);
+        total += delta[i];
+        if (strcmp(runtime_task_status[i].pcTaskName, "IDLE") == 0) // configIDLE_TASK_NAME 默认值
+        {
+            idle += delta[i];
+        }
+    }
+
+    record->timestamp_ms = xTaskGetTickCount();
+    record->cpu_load_permille = (uint16_t)(1000u - toPermille(idle, total));
+    record->isr_load_permille = toPermille(isr - last_isr_, total);
+    record->heap_free_bytes = (uint32_t)xPortGetFreeHeapSize();
+    record->heap_min_free_bytes = (uint32_t)xPortGetMinimumEverFreeHeapSize();
+    record->task_count = (uint8_t)count;
+    for (UBaseType_t i = 0; i < count; i++)
+    {
+        RuntimeTaskRecord_t& task = record->tasks[i];
+        strncpy(task.name, runtime_task_status[i].pcTaskName, RUNTIME_MONITOR_NAME_LEN);
+        task.cpu_permille = toPermille(delta[i], total);
+        uint32_t stack_free = runtime_task_status[i].usStackHighWaterMark * sizeof(StackType_t);
+        task.stack_free_bytes = (uint16_t)(stack_free > 0xFFFFu ? 0xFFFFu : stack_free);
+    }
+
+    for (UBaseType_t i = 0; i < count; i++)
+    {
+        last_number_[i] = runtime_task_status[i].xTaskNumber;
+        last_runtime_[i] = runtime_task_status[i].ulRunTimeCounter;
+    }
+    last_count_ = (uint8_t)count;
+    last_isr_ = isr;
+    return true;
+}
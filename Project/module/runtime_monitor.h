@@ -0,0 +1,110 @@
+#ifndef RUNTIME_MONITOR_H
+#define RUNTIME_MONITOR_H
+
+#include <stdint.h>
+#include "main.h"
+
+// 最多统计的任务数，须不少于系统中同时存在的任务数 (含空闲与定时器任务)
+#define RUNTIME_MONITOR_MAX_TASKS 12
+// 记录中保留的任务名长度
+#define RUNTIME_MONITOR_NAME_LEN 8
+
+// 单个任务的运行统计
+typedef struct __attribute__((packed)) {
+    char name[RUNTIME_MONITOR_NAME_LEN]; // 任务名 (截断，不保证以 '\0' 结尾)
+    uint16_t cpu_permille;               // 统计周期内的CPU占用，单位：‰
+    uint16_t stack_free_bytes;           // 栈历史最小剩余，单位：字节
+} RuntimeTaskRecord_t;
+
+// 系统运行统计记录
+typedef struct __attribute__((packed)) {
+    uint32_t timestamp_ms;                // 采样时刻
+    uint16_t cpu_load_permille;           // 非空闲CPU占用 (含中断)，单位：‰
+    uint16_t isr_load_permille;           // 已插桩中断占用，单位：‰
+    uint32_t heap_free_bytes;             // 当前空闲堆
+    uint32_t heap_min_free_bytes;         // 历史最小空闲堆
+    uint8_t task_count;                   // 有效任务条目数
+    RuntimeTaskRecord_t tasks[RUNTIME_MONITOR_MAX_TASKS];
+} RuntimeStatsRecord_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 已插桩中断累计占用的 DWT 周期数
+extern volatile uint32_t runtime_isr_cycles;
+// 当前嵌套的插桩中断层数与最外层进入时刻，仅供插桩函数使用
+extern volatile uint32_t runtime_isr_depth;
+extern volatile uint32_t runtime_isr_start;
+
+// FreeRTOS 运行时统计计数源 (DWT 周期计数器)
+void configureTimerForRunTimeStats(void);
+unsigned long getRunTimeCounterValue(void);
+
+/**
+ * @brief 中断耗时插桩，成对放在中断服务函数的开头与结尾
+ * @note 插桩中断的优先级并不相同：TIM7 (HAL 时基) 为 TICK_INT_PRIORITY (15)，其余为 5，
+ *       优先级 5 的中断可以抢占 TIM7。按嵌套层数只在最外层退出时累计一次，
+ *       内层耗时已包含在外层区间内，不会重复计入；层数与累计值的读-改-写
+ *       在短暂关中断下完成，不会被更高优先级的插桩中断打断而丢失更新。
+ */
+static inline void runtime_isr_enter(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (runtime_isr_depth++ == 0)
+    {
+        runtime_isr_start = DWT->CYCCNT;
+    }
+    __set_PRIMASK(primask);
+}
+
+static inline void runtime_isr_exit(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (--runtime_isr_depth == 0)
+    {
+        runtime_isr_cycles += DWT->CYCCNT - runtime_isr_start;
+    }
+    __set_PRIMASK(primask);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#define RUNTIME_ISR_ENTER() runtime_isr_enter()
+#define RUNTIME_ISR_EXIT()  runtime_isr_exit()
+
+#ifdef __cplusplus
+
+/**
+ * @brief 运行时统计监视器
+ * @details 周期性采样各任务CPU占用、栈历史最小剩余、堆余量与中断占用。
+ *          CPU占用按两次采样间各任务运行时间计数 (DWT 周期) 的增量计算，
+ *          计数为 32 位，采样周期须小于计数器回绕时间 (550MHz 下约 7.8s)。
+ */
+class RuntimeMonitor {
+public:
+    RuntimeMonitor();
+
+    /**
+     * @brief 采样一次并生成统计记录，首次调用时占用率为自调度器启动以来的平均值
+     * @param record 输出记录
+     * @return 任务数超过 RUNTIME_MONITOR_MAX_TASKS 时返回 false
+     */
+    bool sample(RuntimeStatsRecord_t* record);
+
+private:
+    uint32_t last_isr_;       // 上次采样的中断累计周期
+    uint8_t last_count_;
+    uint32_t last_number_[RUNTIME_MONITOR_MAX_TASKS];  // 上次采样的任务编号
+    uint32_t last_runtime_[RUNTIME_MONITOR_MAX_TASKS]; // 上次采样的任务运行计数
+
+    uint32_t previousRuntime(uint32_t number) const;
+};
+
+#endif // __cplusplus
+
+#endif // RUNTIME_MONITOR_H
@@ -1,5 +1,6 @@
 #include "scheduler.h"
 #include "tim_drv.h"
+#include "trace.h"
 #include <functional>
 #include <new> 
 #include <atomic>
@@ -247,6 +248,7 @@ void Scheduler::timerCallback(TIM_HandleTypeDef* htim) {
     if (!initialized || !htim || htim->Instance != this->htim->Instance) {
         return;
     }
+    TRACE_SCOPE(TRACE_ID_SCHEDULER_TIMER);
     
     // 根据模式执行任务 (遍历当前链表)
     if (mode == SchedulerMode::Obstructed) {
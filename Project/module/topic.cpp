@@ -0,0 +1,48 @@
+#include "topic.h"
+
+TopicBase* TopicBase::head_ = nullptr;
+
+TopicBase::TopicBase(const char* name)
+    : seq_(0), begin_(0), name_(name), next_(nullptr),
+      notify_threads_{nullptr}, notify_flags_{0}, notify_count_(0),
+      rate_last_count_(0), rate_(0.0f)
+{
+    // 话题均为静态对象，在调度器启动前完成注册，无需加锁
+    next_ = head_;
+    head_ = this;
+}
+
+bool TopicBase::addNotify(osThreadId_t thread, uint32_t flags)
+{
+    if (thread == nullptr || flags == 0 || notify_count_ >= TOPIC_MAX_NOTIFY)
+    {
+        return false;
+    }
+    notify_threads_[notify_count_] = thread;
+    notify_flags_[notify_count_] = flags;
+    notify_count_++; // 先写入条目再增加计数，发布者不会看到未写完的条目
+    return true;
+}
+
+void TopicBase::notify()
+{
+    uint8_t count = notify_count_;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        osThreadFlagsSet(notify_threads_[i], notify_flags_[i]); // 可在中断中调用
+    }
+}
+
+void TopicBase::updateRates(uint32_t period_ms)
+{
+    if (period_ms == 0)
+    {
+        return;
+    }
+    for (TopicBase* topic = head_; topic != nullptr; topic = topic->next_)
+    {
+        uint32_t count = topic->getPublishCount();
+        topic->rate_ = (float)(count - topic->rate_last_count_) * 1000.0f / (float)period_ms;
+        topic->rate_last_count_ = count;
+    }
+}
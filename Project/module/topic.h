@@ -0,0 +1,243 @@
+#ifndef TOPIC_H
+#define TOPIC_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+
+#include <atomic>
+#include "cmsis_os.h"
+
+// 每个话题最多可登记的通知线程数
+#define TOPIC_MAX_NOTIFY 4
+
+/**
+ * @brief 话题基类
+ * @details 负责静态注册、发布计数、更新通知与频率统计，与数据类型无关。
+ *          所有话题在构造时挂入全局链表，可遍历统计各话题发布频率。
+ */
+class TopicBase {
+public:
+    explicit TopicBase(const char* name);
+
+    const char* getName() const { return name_; }
+
+    /**
+     * @brief 获取已完成的发布次数，同时也是最新数据的序号 (0 表示尚未发布)
+     */
+    uint32_t getPublishCount() const { return seq_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 获取最近一个统计周期内的发布频率，单位：Hz
+     */
+    float getRate() const { return rate_; }
+
+    /**
+     * @brief 登记更新通知，每次发布后对该线程置位线程标志
+     * @param thread 被通知的线程
+     * @param flags 置位的线程标志
+     * @return 是否登记成功
+     */
+    bool addNotify(osThreadId_t thread, uint32_t flags);
+
+    /**
+     * @brief 判断序号为 seq 的数据所在槽位是否仍未被覆盖
+     * @param seq 数据序号
+     * @param depth 槽位数
+     */
+    bool isIntact(uint32_t seq, uint32_t depth) const
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return (begin_.load(std::memory_order_relaxed) - seq) < depth;
+    }
+
+    static TopicBase* first() { return head_; }
+    TopicBase* next() const { return next_; }
+
+    /**
+     * @brief 统计所有话题的发布频率，需以固定周期调用
+     * @param period_ms 调用周期，单位：ms
+     */
+    static void updateRates(uint32_t period_ms);
+
+protected:
+    std::atomic<uint32_t> seq_;   // 已完成发布的序号
+    std::atomic<uint32_t> begin_; // 正在写入的序号
+
+    void notify();
+
+private:
+    const char* name_;
+    TopicBase* next_;
+    static TopicBase* head_;
+
+    osThreadId_t notify_threads_[TOPIC_MAX_NOTIFY];
+    uint32_t notify_flags_[TOPIC_MAX_NOTIFY];
+    uint8_t notify_count_;
+
+    uint32_t rate_last_count_;
+    float rate_;
+};
+
+/**
+ * @brief 类型化话题
+ * @details 单写者多读者的环形槽位，发布即一次拷贝到下一个槽位 (或通过 claim/commit
+ *          直接在槽位中构造)，读者直接在槽位中读取。写者先登记正在写入的序号再写槽位，
+ *          读者读完后检查该槽位是否已被新一轮发布覆盖，全程无锁、不关中断。
+ *          发布可在任务或中断中进行，但同一话题只能有一个写者。
+ * @tparam T 数据类型，须可平凡拷贝
+ * @tparam Depth 槽位数，读者在槽位被覆盖前 (Depth - 1 次发布内) 完成读取即可保证一致
+ */
+template<typename T, uint32_t Depth = 4>
+class Topic : public TopicBase {
+    static_assert(Depth >= 2, "Topic depth must be at least 2");
+
+public:
+    explicit Topic(const char* name) : TopicBase(name), slots_{} {}
+
+    /**
+     * @brief 发布一份数据
+     * @param value 数据
+     */
+    void publish(const T& value)
+    {
+        *claim() = value;
+        commit();
+    }
+
+    /**
+     * @brief 取得下一个待写槽位，写入完成后必须调用 commit()
+     * @return 槽位指针
+     */
+    T* claim()
+    {
+        uint32_t seq = seq_.load(std::memory_order_relaxed) + 1;
+        begin_.store(seq, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        return &slots_[seq % Depth];
+    }
+
+    /**
+     * @brief 提交 claim() 取得的槽位并通知订阅者
+     */
+    void commit()
+    {
+        seq_.store(begin_.load(std::memory_order_relaxed), std::memory_order_release);
+        notify();
+    }
+
+    /**
+     * @brief 原地访问最新数据，未发布过时为零初始化的数据
+     */
+    const T& latest() const { return slots_[getPublishCount() % Depth]; }
+
+    /**
+     * @brief 原地访问指定序号的数据，读取后应调用 isIntact() 确认未被覆盖
+     */
+    const T& slot(uint32_t seq) const { return slots_[seq % Depth]; }
+
+    static constexpr uint32_t depth() { return Depth; }
+
+private:
+    T slots_[Depth];
+};
+
+/**
+ * @brief 话题订阅者
+ * @details 每个订阅者独立记录已读序号，可判断是否有更新并统计被跳过的数据条数
+ */
+template<typename T, uint32_t Depth = 4>
+class Subscriber {
+public:
+    explicit Subscriber(const Topic<T, Depth>& topic)
+        : topic_(topic), last_seq_(0), peek_seq_(0), lost_count_(0)
+    {
+    }
+
+    /**
+     * @brief 是否有未读的新数据
+     */
+    bool updated() const { return topic_.getPublishCount() != last_seq_; }
+
+    /**
+     * @brief 将最新数据标记为已读，不读取内容
+     * @return 调用前是否有未读的新数据
+     */
+    bool consume()
+    {
+        uint32_t seq = topic_.getPublishCount();
+        if (seq == last_seq_)
+        {
+            return false;
+        }
+        mark(seq);
+        return true;
+    }
+
+    /**
+     * @brief 原地读取最新数据并标记为已读
+     * @details 使用完返回的数据后调用 intact() 确认读取期间槽位未被覆盖
+     * @return 数据指针，尚未发布过时返回 nullptr
+     */
+    const T* peek()
+    {
+        uint32_t seq = topic_.getPublishCount();
+        if (seq == 0)
+        {
+            return nullptr;
+        }
+        mark(seq);
+        peek_seq_ = seq;
+        return &topic_.slot(seq);
+    }
+
+    /**
+     * @brief 确认上一次 peek() 得到的数据未被覆盖
+     */
+    bool intact() const { return topic_.isIntact(peek_seq_, Depth); }
+
+    /**
+     * @brief 拷贝一份一致的最新数据并标记为已读
+     * @param out 输出数据
+     * @return 尚未发布过时返回 false
+     */
+    bool copy(T& out)
+    {
+        while (true)
+        {
+            uint32_t seq = topic_.getPublishCount();
+            if (seq == 0)
+            {
+                return false;
+            }
+            out = topic_.slot(seq);
+            if (topic_.isIntact(seq, Depth))
+            {
+                mark(seq);
+                return true;
+            }
+        }
+    }
+
+    uint32_t getSequence() const { return last_seq_; }
+    uint32_t getLostCount() const { return lost_count_; }
+
+private:
+    const Topic<T, Depth>& topic_;
+    uint32_t last_seq_;
+    uint32_t peek_seq_;
+    uint32_t lost_count_;
+
+    void mark(uint32_t seq)
+    {
+        if (last_seq_ != 0 && seq - last_seq_ > 1)
+        {
+            lost_count_ += seq - last_seq_ - 1;
+        }
+        last_seq_ = seq;
+    }
+};
+
+#endif // __cplusplus
+
+#endif // TOPIC_H
@@ -0,0 +1,199 @@
+#include "trace.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "time_utils.h"
+#include <string.h>
+
+extern uint32_t SystemCoreClock;
+
+TraceEvent_t trace_ring[TRACE_RING_SIZE];
+volatile uint32_t trace_head = 0;
+volatile uint8_t trace_recording = 0;
+
+// 任务表：切换事件只记录下标，任务名在首次切入时保存 (任务删除后仍可导出)
+static void* trace_tasks[TRACE_MAX_TASKS];
+static char trace_task_names[TRACE_MAX_TASKS][TRACE_TASK_NAME_LEN];
+static uint8_t trace_task_count = 0;
+
+// 导出数据头
+typedef struct __attribute__((packed)) {
+    uint32_t magic;         // "TRC1"
+    uint32_t clock_hz;      // DWT 计数频率
+    uint32_t event_count;   // 事件数
+    uint32_t first_index;   // 第一个事件的序号
+    uint16_t task_count;    // 任务表条目数
+    uint16_t name_len;      // 任务名长度
+} TraceDumpHeader_t;
+
+static const uint32_t TRACE_DUMP_MAGIC = 0x31435254u;     // "TRC1"
+static const uint32_t TRACE_DUMP_END_MAGIC = 0x444E4554u; // "TEND"
+
+static bool trace_dump_active = false;
+static uint32_t trace_dump_offset = 0;
+static uint16_t trace_dump_failures = 0;   // 连续写入失败次数
+static TraceDumpHeader_t trace_dump_header;
+
+static_assert((TRACE_RING_SIZE & (TRACE_RING_SIZE - 1)) == 0, "TRACE_RING_SIZE must be a power of 2");
+static_assert(sizeof(TraceEvent_t) == 8, "TraceEvent_t must be 8 bytes");
+
+extern "C" {
+
+void trace_init(void)
+{
+    utils::time::enableCycleCounter();
+    trace_recording = TRACE_ENABLE;
+}
+
+void trace_task_switched_in(void* task)
+{
+#if TRACE_ENABLE
+    if (!trace_recording)
+    {
+        return;
+    }
+    // 在 PendSV 中调用，此时调度器不会重入，任务表无需加锁
+    uint8_t index = 0;
+    while (index < trace_task_count && trace_tasks[index] != task)
+    {
+        index++;
+    }
+    if (index == trace_task_count)
+    {
+        if (trace_task_count >= TRACE_MAX_TASKS)
+        {
+            trace_record(TRACE_TYPE_SWITCH, 0xFFFFu); // 任务表已满
+            return;
+        }
+        trace_tasks[index] = task;
+        strncpy(trace_task_names[index], pcTaskGetName((TaskHandle_t)task), TRACE_TASK_NAME_LEN);
+        trace_task_count++;
+    }
+    trace_record(TRACE_TYPE_SWITCH, index);
+#else
+    (void)task;
+#endif
+}
+
+void trace_dump_start(void)
+{
+    trace_recording = 0;
+
+    uint32_t head = trace_head;
+    uint32_t count = head < TRACE_RING_SIZE ? head : TRACE_RING_SIZE;
+    trace_dump_header.magic = TRACE_DUMP_MAGIC;
+    trace_dump_header.clock_hz = SystemCoreClock;
+    trace_dump_header.event_count = count;
+    trace_dump_header.first_index = head - count;
+    trace_dump_header.task_count = trace_task_count;
+    trace_dump_header.name_len = TRACE_TASK_NAME_LEN;
+
+    trace_dump_offset = 0;
+    trace_dump_failures = 0;
+    trace_dump_active = true;
+}
+
+bool trace_dumping(void)
+{
+    return trace_dump_active;
+}
+
+/**
+ * @brief 从导出数据流 (头 | 任务名表 | 事件 | 结束标记) 的指定偏移处拷贝数据
+ * @return 实际拷贝的字节数，0 表示已到末尾
+ */
+static uint16_t trace_dump_read(uint32_t offset, uint8_t* out, uint16_t size)
+{
+    const uint32_t names_size = (uint32_t)trace_dump_header.task_count * TRACE_TASK_NAME_LEN;
+    const uint32_t events_size = trace_dump_header.event_count * sizeof(TraceEvent_t);
+    uint16_t copied = 0;
+
+    while (copied < size)
+    {
+        uint32_t pos = offset + copied;
+        const uint8_t* src;
+        uint32_t avail;
+
+        if (pos < sizeof(TraceDumpHeader_t))
+        {
+            src = (const uint8_t*)&trace_dump_header + pos;
+            avail = sizeof(TraceDumpHeader_t) - pos;
+        }
+        else if ((pos -= sizeof(TraceDumpHeader_t)) < names_size)
+        {
+            src = (const uint8_t*)&trace_task_names[0][0] + pos;
+            avail = names_size - pos;
+        }
+        else if ((pos -= names_size) < events_size)
+        {
+            // 按序号从旧到新输出，环形缓冲区回绕处分段拷贝
+            uint32_t slot = (trace_dump_header.first_index + pos / sizeof(TraceEvent_t)) & (TRACE_RING_SIZE - 1u);
+            uint32_t in_event = pos % sizeof(TraceEvent_t);
+            src = (const uint8_t*)&trace_ring[slot] + in_event;
+            avail = (TRACE_RING_SIZE - slot) * sizeof(TraceEvent_t) - in_event;
+            if (avail > events_size - pos)
+            {
+                avail = events_size - pos;
+            }
+        }
+        else if ((pos -= events_size) < sizeof(TRACE_DUMP_END_MAGIC))
+        {
+            src = (const uint8_t*)&TRACE_DUMP_END_MAGIC + pos;
+            avail = sizeof(TRACE_DUMP_END_MAGIC) - pos;
+        }
+        else
+        {
+            break;
+        }
+
+        uint16_t n = (uint16_t)((size - copied) < avail ? (size - copied) : avail);
+        memcpy(out + copied, src, n);
+        copied += n;
+    }
+    return copied;
+}
+
+/**
+ * @brief 结束导出，清空缓冲区并恢复记录
+ */
+static void trace_dump_finish(void)
+{
+    trace_dump_active = false;
+    trace_head = 0;
+    trace_recording = TRACE_ENABLE;
+}
+
+bool trace_dump_step(TraceWriteFunc_t write, uint16_t chunk)
+{
+    if (!trace_dump_active)
+    {
+        return true;
+    }
+
+    uint8_t buffer[64];
+    if (chunk == 0 || chunk > sizeof(buffer))
+    {
+        chunk = sizeof(buffer);
+    }
+
+    uint16_t n = trace_dump_read(trace_dump_offset, buffer, chunk);
+    if (n == 0)
+    {
+        // 导出完成，清空缓冲区重新记录
+        trace_dump_finish();
+        return true;
+    }
+    if (write(buffer, n))
+    {
+        trace_dump_offset += n;
+        trace_dump_failures = 0;
+    }
+    else if (++trace_dump_failures >= TRACE_DUMP_MAX_RETRIES)
+    {
+        // 链路长时间无法写入，放弃本次导出，不再停留在不记录的状态
+        trace_dump_finish();
+        return true;
+    }
+    return false;
+}
+
+} // extern "C"
@@ -0,0 +1,152 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "main.h"
+
+// 是否编译事件追踪，关闭后所有追踪宏为空
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE 1
+#endif
+
+// 环形缓冲区事件数，须为 2 的幂
+#define TRACE_RING_SIZE 2048
+// 可记录名称的任务数
+#define TRACE_MAX_TASKS 16
+// 导出的任务名长度
+#define TRACE_TASK_NAME_LEN 8
+// 导出时连续写入失败的次数上限，超过后放弃导出并恢复记录
+#define TRACE_DUMP_MAX_RETRIES 250
+
+// 事件类型
+typedef enum {
+    TRACE_TYPE_BEGIN = 0,   // 区间开始
+    TRACE_TYPE_END,         // 区间结束
+    TRACE_TYPE_SWITCH,      // 任务切入，id 为任务表下标
+    TRACE_TYPE_INSTANT,     // 瞬时事件
+} TraceType_t;
+
+// 事件编号，新增编号需同步 Tools/trace2chrome.py 中的名称表
+typedef enum {
+    TRACE_ID_SCHEDULER_TIMER = 1,   // Scheduler::timerCallback
+    TRACE_ID_CHASSIS_UPDATE,        // Chassis::update
+    TRACE_ID_ATTITUDE_UPDATE,       // AttitudeManager::update
+    TRACE_ID_LIDAR_RX_ISR,          // 雷达串口接收中断
+    TRACE_ID_NRF_EXTI_ISR,          // NRF IRQ 引脚中断
+    TRACE_ID_NRF_SPI_ISR,           // NRF SPI 传输完成中断
+    TRACE_ID_USER = 0x100,          // 临时调试使用的起始编号
+} TraceId_t;
+
+// 单个事件，8 字节
+typedef struct __attribute__((packed)) {
+    uint32_t cycles;    // DWT 周期计数
+    uint16_t id;        // 事件编号或任务表下标
+    uint8_t type;       // TraceType_t
+    uint8_t irq;        // 记录时的异常号 (IPSR)，0 表示线程模式
+} TraceEvent_t;
+
+// 导出数据写入函数，整块写入成功返回 true，否则稍后以同一数据块重试
+typedef bool (*TraceWriteFunc_t)(const uint8_t* data, uint16_t size);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern TraceEvent_t trace_ring[TRACE_RING_SIZE];
+extern volatile uint32_t trace_head;        // 已分配的事件总数
+extern volatile uint8_t trace_recording;    // 是否记录
+
+/**
+ * @brief 记录一个事件，可在任务、中断与调度器钩子中调用
+ * @details 以 LDREX/STREX 无锁分配槽位，不关中断；环形缓冲区写满后覆盖最旧事件
+ */
+static inline void trace_record(uint8_t type, uint16_t id)
+{
+    if (!trace_recording)
+    {
+        return;
+    }
+    uint32_t index;
+    do
+    {
+        index = __LDREXW((volatile uint32_t*)&trace_head);
+    } while (__STREXW(index + 1u, (volatile uint32_t*)&trace_head));
+
+    TraceEvent_t* event = &trace_ring[index & (TRACE_RING_SIZE - 1u)];
+    event->cycles = DWT->CYCCNT;
+    event->id = id;
+    event->type = type;
+    event->irq = (uint8_t)__get_IPSR();
+}
+
+/**
+ * @brief 调度器切入任务钩子 (traceTASK_SWITCHED_IN)
+ * @param task 切入的任务句柄
+ */
+void trace_task_switched_in(void* task);
+
+/**
+ * @brief 开启 DWT 周期计数器并开始记录
+ */
+void trace_init(void);
+
+/**
+ * @brief 停止记录并从头开始导出当前缓冲区
+ */
+void trace_dump_start(void);
+
+/**
+ * @brief 导出一段数据，需周期调用直至返回 true；导出完成后清空缓冲区并恢复记录
+ * @details 写入连续失败 TRACE_DUMP_MAX_RETRIES 次时放弃本次导出，同样清空缓冲区并恢复记录
+ * @param write 写入函数
+ * @param chunk 每次写入的最大字节数
+ * @return 导出是否完成 (未在导出时也返回 true)
+ */
+bool trace_dump_step(TraceWriteFunc_t write, uint16_t chunk);
+
+/**
+ * @brief 是否正在导出，导出期间其他 HC12 写者应暂停发送，避免数据与导出流交错
+ */
+bool trace_dumping(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#if TRACE_ENABLE
+#define TRACE_BEGIN(id)     trace_record(TRACE_TYPE_BEGIN, (uint16_t)(id))
+#define TRACE_END(id)       trace_record(TRACE_TYPE_END, (uint16_t)(id))
+#define TRACE_INSTANT(id)   trace_record(TRACE_TYPE_INSTANT, (uint16_t)(id))
+#else
+#define TRACE_BEGIN(id)     ((void)0)
+#define TRACE_END(id)       ((void)0)
+#define TRACE_INSTANT(id)   ((void)0)
+#endif
+
+#ifdef __cplusplus
+
+/**
+ * @brief 作用域追踪，构造时记录开始、析构时记录结束，适用于有多个返回点的函数
+ */
+class TraceScope {
+public:
+    explicit TraceScope(uint16_t id) : id_(id) { TRACE_BEGIN(id_); }
+    ~TraceScope() { TRACE_END(id_); }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    uint16_t id_;
+};
+
+#if TRACE_ENABLE
+#define TRACE_SCOPE(id) TraceScope trace_scope_(id)
+#else
+#define TRACE_SCOPE(id) ((void)0)
+#endif
+
+#endif // __cplusplus
+
+#endif // TRACE_H
@@ -0,0 +1,245 @@
+#include "dshot.h"
+#include "tim_drv.h"
+#include <algorithm> // 用于 std::max 和 std::min
+
+// 比特 1 / 比特 0 的高电平占比 (DShot 规范：75% / 37.5%)
+static constexpr uint32_t BIT1_NUM = 6, BIT0_NUM = 3, BIT_DEN = 8;
+
+static const uint32_t kTimChannels[DShotBus::CHANNEL_NUM] = {
+    TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4,
+};
+
+DShotBus::DShotBus(TIM_HandleTypeDef *htim, DShotSpeed speed, bool bidirectional)
+    : htim_(htim), speed_(speed), bidirectional_(bidirectional), initialized_(false), busy_(false),
+      bit1_compare_(0), bit0_compare_(0), attached_mask_(0), pending_mask_(0),
+      frames_{0}, erpm_{0}, frame_count_(0), dropped_count_(0), dma_buffer_{0}
+{
+    for (uint8_t i = 0; i < CHANNEL_NUM; i++)
+    {
+        frames_[i] = encodeFrame(0, false, bidirectional_);
+        erpm_[i] = ERPM_INVALID;
+    }
+}
+
+bool DShotBus::init()
+{
+    if (initialized_)
+    {
+        return true;
+    }
+    if (htim_ == nullptr || htim_->hdma[TIM_DMA_ID_UPDATE] == nullptr)
+    {
+        // 定时器未关联更新事件 DMA，无法突发写入
+        return false;
+    }
+
+    // 预分频为 1，一个计数周期即一个比特时隙
+    uint32_t bit_period = TimDrv_GetPeriphCLKFreq(htim_) / static_cast<uint32_t>(speed_);
+    if (bit_period < BIT_DEN * 2 || bit_period > 0x10000u)
+    {
+        return false;
+    }
+    bit1_compare_ = bit_period * BIT1_NUM / BIT_DEN;
+    bit0_compare_ = bit_period * BIT0_NUM / BIT_DEN;
+
+    __HAL_TIM_SET_PRESCALER(htim_, 0);
+    __HAL_TIM_SET_AUTORELOAD(htim_, bit_period - 1);
+
+    for (uint8_t i = 0; i < CHANNEL_NUM; i++)
+    {
+        __HAL_TIM_SET_COMPARE(htim_, kTimChannels[i], 0);
+        if (bidirectional_)
+        {
+            // 双向 DShot 空闲电平为高，输出极性反相
+            htim_->Instance->CCER |= (TIM_CCER_CC1P << (4u * i));
+        }
+    }
+    // 立即装载新的预分频与比较值
+    htim_->Instance->EGR = TIM_EGR_UG;
+
+    for (uint8_t i = 0; i < CHANNEL_NUM; i++)
+    {
+        if (HAL_TIM_PWM_Start(htim_, kTimChannels[i]) != HAL_OK)
+        {
+            return false;
+        }
+    }
+
+    initialized_ = true;
+    return true;
+}
+
+void DShotBus::attach(uint8_t channel)
+{
+    if (channel < CHANNEL_NUM)
+    {
+        attached_mask_ |= (1u << channel);
+    }
+}
+
+void DShotBus::write(uint8_t channel, uint16_t value, bool telemetry)
+{
+    if (channel >= CHANNEL_NUM)
+    {
+        return;
+    }
+    frames_[channel] = encodeFrame(value, telemetry, bidirectional_);
+    pending_mask_ |= (1u << channel);
+
+    // 所有已注册通道都已更新，本控制周期合并为一次 DMA 突发
+    if (attached_mask_ != 0 && (pending_mask_ & attached_mask_) == attached_mask_)
+    {
+        commit();
+    }
+}
+
+bool DShotBus::commit()
+{
+    if (!initialized_)
+    {
+        return false;
+    }
+    pending_mask_ = 0;
+    if (busy_)
+    {
+        // 上一帧仍在发送，丢弃本帧
+        dropped_count_++;
+        return false;
+    }
+
+    for (uint8_t ch = 0; ch < CHANNEL_NUM; ch++)
+    {
+        uint16_t frame = frames_[ch];
+        uint32_t *slot = &dma_buffer_[ch];
+        for (uint8_t bit = 0; bit < FRAME_BITS; bit++)
+        {
+            *slot = (frame & 0x8000u) ? bit1_compare_ : bit0_compare_;
+            frame <<= 1;
+            slot += CHANNEL_NUM;
+        }
+        // 帧尾零时隙保持为 0，不需要重写
+    }
+
+    busy_ = true;
+    if (HAL_TIM_DMABurst_MultiWriteStart(htim_, TIM_DMABASE_CCR1, TIM_DMA_UPDATE,
+                                         dma_buffer_, TIM_DMABURSTLENGTH_4TRANSFERS,
+                                         SLOT_NUM * CHANNEL_NUM) != HAL_OK)
+    {
+        busy_ = false;
+        dropped_count_++;
+        return false;
+    }
+    frame_count_++;
+    return true;
+}
+
+void DShotBus::handleDmaCplt(TIM_HandleTypeDef *htim)
+{
+    if (htim != htim_ || !busy_)
+    {
+        return;
+    }
+    // 关闭更新事件 DMA 请求，比较值停留在最后的零时隙
+    HAL_TIM_DMABurst_WriteStop(htim_, TIM_DMA_UPDATE);
+    busy_ = false;
+}
+
+bool DShotBus::processTelemetry(uint8_t channel, const uint32_t *edges, uint8_t count, uint32_t ticks_per_bit)
+{
+    if (channel >= CHANNEL_NUM || !bidirectional_)
+    {
+        return false;
+    }
+    uint32_t raw = edgesToRaw(edges, count, ticks_per_bit);
+    if (raw == 0)
+    {
+        return false;
+    }
+    uint32_t erpm = decodeErpm(raw);
+    if (erpm == ERPM_INVALID)
+    {
+        return false;
+    }
+    erpm_[channel] = erpm;
+    return true;
+}
+
+uint32_t DShotBus::getErpm(uint8_t channel) const
+{
+    return (channel < CHANNEL_NUM) ? erpm_[channel] : ERPM_INVALID;
+}
+
+DShotMotor::DShotMotor(DShotBus *bus, uint8_t channel, bool reversed, float throttle_limit)
+    : Motor(reversed), bus_(bus), channel_(channel), throttle_limit_factor_(throttle_limit), current_value_(0)
+{
+}
+
+void DShotMotor::init()
+{
+    if (bus_ == nullptr || !bus_->init())
+    {
+        return;
+    }
+    bus_->attach(channel_);
+    current_value_ = 0;
+    bus_->write(channel_, current_value_);
+}
+
+void DShotMotor::setThrottle(float throttle)
+{
+    if (bus_ == nullptr || !bus_->isInitialized())
+    {
+        return;
+    }
+
+    this->currentThrottle_ = throttle; // 存储用户请求的原始油门值
+
+    float effective_throttle = adjustThrottleForDirection(throttle);
+    effective_throttle = std::min(100.0f * throttle_limit_factor_, effective_throttle);
+
+    // DShot 为单向协议，非正油门输出停转值；正油门线性映射到 [48, 2047]
+    if (effective_throttle <= 0.0f)
+    {
+        current_value_ = 0;
+    }
+    else
+    {
+        float span = static_cast<float>(DShotBus::THROTTLE_MAX - DShotBus::THROTTLE_MIN);
+        current_value_ = static_cast<uint16_t>(DShotBus::THROTTLE_MIN + effective_throttle * (span / 100.0f) + 0.5f);
+        if (current_value_ > DShotBus::THROTTLE_MAX)
+        {
+            current_value_ = DShotBus::THROTTLE_MAX;
+        }
+    }
+
+    bus_->write(channel_, current_value_);
+}
+
+void DShotMotor::sendCommand(uint8_t command)
+{
+    if (bus_ == nullptr || !bus_->isInitialized() || command >= DShotBus::THROTTLE_MIN)
+    {
+        return;
+    }
+    current_value_ = command;
+    bus_->write(channel_, command, true); // 命令帧需置位遥测位
+}
+
+void DShotMotor::setThrottleLimitFactor(float factor)
+{
+    throttle_limit_factor_ = std::max(0.0f, std::min(1.0f, factor));
+}
+
+float DShotMotor::getThrottleLimitFactor() const
+{
+    return throttle_limit_factor_;
+}
+
+uint32_t DShotMotor::getErpm() const
+{
+    if (bus_ == nullptr || !bus_->isBidirectional())
+    {
+        return DShotBus::ERPM_INVALID;
+    }
+    return bus_->getErpm(channel_);
+}
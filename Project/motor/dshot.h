@@ -0,0 +1,188 @@
+#ifndef __DSHOT_H__
+#define __DSHOT_H__
+
+#include "main.h"
+#include "tim.h"
+#include "motor.h"
+
+/**
+ * @brief DShot 速率档位，数值为比特率 (bit/s)
+ */
+enum class DShotSpeed : uint32_t {
+    DSHOT300 = 300000,
+    DSHOT600 = 600000,
+};
+
+/**
+ * @brief DShot 总线
+ * @details 一个高级定时器的 CH1~CH4 共用一段 DMA 缓冲区，每个比特时隙通过
+ *          TIM 更新事件触发一次 DMA 突发写入 CCR1~CCR4，一次 DMA 传输即可同时
+ *          更新四个电机。缓冲区末尾附加若干零时隙，保证帧结束后输出回到空闲电平。
+ *          双向 DShot 模式下输出极性反相，并在帧校验和中取反以请求 eRPM 回传。
+ */
+class DShotBus {
+public:
+    static constexpr uint8_t CHANNEL_NUM = 4;        // 每条总线的通道数 (CH1~CH4)
+    static constexpr uint8_t FRAME_BITS = 16;        // 每帧比特数
+    static constexpr uint8_t RESET_SLOTS = 2;        // 帧尾零时隙数
+    static constexpr uint8_t SLOT_NUM = FRAME_BITS + RESET_SLOTS;
+    static constexpr uint16_t THROTTLE_MIN = 48;     // 最小有效油门值 (0~47 为命令)
+    static constexpr uint16_t THROTTLE_MAX = 2047;   // 最大油门值
+    static constexpr uint32_t ERPM_INVALID = 0xFFFFFFFFu;
+
+    /**
+     * @brief DShotBus 构造函数
+     * @param htim 定时器句柄指针 (需已关联 TIM_DMA_ID_UPDATE 的 DMA)
+     * @param speed DShot 速率档位
+     * @param bidirectional 是否启用双向 DShot (eRPM 回传)
+     */
+    DShotBus(TIM_HandleTypeDef* htim, DShotSpeed speed, bool bidirectional = false);
+
+    /**
+     * @brief 初始化总线：重新配置定时器时基，启动四路 PWM 输出
+     * @details 多个 DShotMotor 共享同一条总线，重复调用直接返回
+     * @return 初始化是否成功
+     */
+    bool init();
+
+    /**
+     * @brief 注册一个通道，注册后的全部通道写入新值时总线自动发起一次 DMA 突发
+     * @param channel 通道索引 0~3，对应 CH1~CH4
+     */
+    void attach(uint8_t channel);
+
+    /**
+     * @brief 写入某个通道的 11 位数值 (0 为停转，1~47 为命令，48~2047 为油门)
+     * @param channel 通道索引 0~3
+     * @param value 11 位数值
+     * @param telemetry 是否置位遥测请求位
+     */
+    void write(uint8_t channel, uint16_t value, bool telemetry = false);
+
+    /**
+     * @brief 立即将所有通道当前值编码并通过一次 DMA 突发发出
+     * @return 是否成功启动 DMA (上一帧尚未发送完成时返回 false)
+     */
+    bool commit();
+
+    /**
+     * @brief DMA 传输完成处理，应在 HAL_TIM_PeriodElapsedCallback 中调用
+     * @param htim 触发回调的定时器句柄
+     */
+    void handleDmaCplt(TIM_HandleTypeDef* htim);
+
+    /**
+     * @brief 处理一帧 eRPM 回传的边沿时间戳
+     * @details 时间戳由输入捕获得到，解码成功后更新该通道的 eRPM
+     * @param channel 通道索引 0~3
+     * @param edges 边沿时间戳数组 (定时器计数值)
+     * @param count 时间戳个数
+     * @param ticks_per_bit 每个回传比特对应的计数值
+     * @return 解码是否成功
+     */
+    bool processTelemetry(uint8_t channel, const uint32_t* edges, uint8_t count, uint32_t ticks_per_bit);
+
+    bool isInitialized() const { return initialized_; }
+    bool isBidirectional() const { return bidirectional_; }
+    bool isBusy() const { return busy_; }
+    uint32_t getErpm(uint8_t channel) const;
+    uint32_t getFrameCount() const { return frame_count_; }
+    uint32_t getDroppedCount() const { return dropped_count_; }
+
+    /**
+     * @brief 编码 DShot 帧
+     * @param value 11 位数值
+     * @param telemetry 遥测请求位
+     * @param bidirectional 是否为双向 DShot (校验和取反)
+     * @return 16 位帧 [value:11][telemetry:1][crc:4]
+     */
+    static uint16_t encodeFrame(uint16_t value, bool telemetry, bool bidirectional);
+
+    /**
+     * @brief 由输入捕获边沿时间戳还原 21 位 GCR 原始码
+     * @param edges 边沿时间戳数组
+     * @param count 时间戳个数
+     * @param ticks_per_bit 每比特计数值
+     * @return 21 位原始码，比特数不足时返回 0
+     */
+    static uint32_t edgesToRaw(const uint32_t* edges, uint8_t count, uint32_t ticks_per_bit);
+
+    /**
+     * @brief 解码 eRPM 回传帧
+     * @param raw 21 位原始码 (NRZI 编码的 GCR)
+     * @return 电气转速 (eRPM)，0 表示停转，解码或校验失败返回 ERPM_INVALID
+     */
+    static uint32_t decodeErpm(uint32_t raw);
+
+private:
+    TIM_HandleTypeDef* htim_;
+    DShotSpeed speed_;
+    bool bidirectional_;
+    bool initialized_;
+    volatile bool busy_;
+
+    uint32_t bit1_compare_;   // 比特 1 的高电平比较值
+    uint32_t bit0_compare_;   // 比特 0 的高电平比较值
+
+    uint8_t attached_mask_;   // 已注册通道
+    uint8_t pending_mask_;    // 本周期已写入新值的通道
+    uint16_t frames_[CHANNEL_NUM];
+    volatile uint32_t erpm_[CHANNEL_NUM];
+
+    uint32_t frame_count_;
+    uint32_t dropped_count_;
+
+    // DMA 缓冲区，按时隙排列，每个时隙依次为 CCR1~CCR4
+    uint32_t dma_buffer_[SLOT_NUM * CHANNEL_NUM];
+};
+
+class DShotMotor : public Motor {
+public:
+    /**
+     * @brief DShotMotor 构造函数
+     * @param bus 所在的 DShot 总线
+     * @param channel 通道索引 0~3，对应定时器 CH1~CH4
+     * @param reversed 电机是否需要反向。默认为 false。
+     * @param throttle_limit 油门限制因子，范围 [0.0, 1.0]
+     */
+    DShotMotor(DShotBus* bus, uint8_t channel, bool reversed = false, float throttle_limit = 0.98f);
+
+    /**
+     * @brief 初始化总线并注册通道，输出停转值
+     */
+    void init() override;
+
+    /**
+     * @brief 设置电机油门
+     * @param throttle 油门值，范围从 -100.0 到 100.0；DShot 为单向协议，
+     *                 小于等于 0 的油门输出停转值
+     */
+    void setThrottle(float throttle) override;
+
+    /**
+     * @brief 发送 DShot 命令 (1~47)，需在电机停转时使用，命令会在下一次提交时发出
+     * @param command 命令值
+     */
+    void sendCommand(uint8_t command);
+
+    void setThrottleLimitFactor(float factor);
+    float getThrottleLimitFactor() const;
+
+    /**
+     * @brief 获取当前发送的 11 位数值
+     */
+    uint16_t getCurrentValue() const { return current_value_; }
+
+    /**
+     * @brief 获取最近一次 eRPM 回传，未启用双向 DShot 或无有效数据时返回 ERPM_INVALID
+     */
+    uint32_t getErpm() const;
+
+private:
+    DShotBus* bus_;
+    uint8_t channel_;
+    float throttle_limit_factor_;
+    uint16_t current_value_;
+};
+
+#endif // __DSHOT_H__
@@ -0,0 +1,106 @@
+/**
+ * @file dshot_codec.cpp
+ * @brief DShot 帧编码与 eRPM 回传解码
+ * @details 纯计算部分，不访问定时器与 DMA，可在主机上单独编译测试
+ */
+
+#include "dshot.h"
+#include <algorithm> // 用于 std::max
+
+// eRPM 回传帧为 21 比特
+static constexpr uint32_t TELEMETRY_RAW_BITS = 21;
+static constexpr uint32_t TELEMETRY_MIN_BITS = 18;
+
+static constexpr uint8_t GCR_INVALID = 0xFF;
+
+// 5B -> 4B GCR 解码表
+static const uint8_t kGcrDecodeTable[32] = {
+    GCR_INVALID, GCR_INVALID, GCR_INVALID, GCR_INVALID, GCR_INVALID, GCR_INVALID, GCR_INVALID, GCR_INVALID,
+    GCR_INVALID, 9,           10,          11,          GCR_INVALID, 13,          14,          15,
+    GCR_INVALID, GCR_INVALID, 2,           3,           GCR_INVALID, 5,           6,           7,
+    GCR_INVALID, 0,           8,           1,           GCR_INVALID, 4,           12,          GCR_INVALID,
+};
+
+uint16_t DShotBus::encodeFrame(uint16_t value, bool telemetry, bool bidirectional)
+{
+    uint16_t packet = static_cast<uint16_t>(((value & 0x07FFu) << 1) | (telemetry ? 1u : 0u));
+    uint16_t crc = packet ^ (packet >> 4) ^ (packet >> 8);
+    if (bidirectional)
+    {
+        crc = ~crc;
+    }
+    return static_cast<uint16_t>((packet << 4) | (crc & 0x0Fu));
+}
+
+uint32_t DShotBus::edgesToRaw(const uint32_t *edges, uint8_t count, uint32_t ticks_per_bit)
+{
+    if (edges == nullptr || count < 2 || ticks_per_bit == 0)
+    {
+        return 0;
+    }
+
+    // 每个电平翻转对应一个比特 1，其后同电平持续的比特为 0
+    uint32_t value = 0;
+    uint32_t bits = 0;
+    for (uint8_t i = 1; i < count && bits < TELEMETRY_RAW_BITS; i++)
+    {
+        uint32_t len = (edges[i] - edges[i - 1] + ticks_per_bit / 2) / ticks_per_bit;
+        len = std::max<uint32_t>(len, 1);
+        value <<= len;
+        value |= 1u << (len - 1);
+        bits += len;
+    }
+    if (bits < TELEMETRY_MIN_BITS || bits > TELEMETRY_RAW_BITS)
+    {
+        return 0;
+    }
+
+    // 末尾电平不再翻转，补齐剩余比特
+    uint32_t tail = TELEMETRY_RAW_BITS - bits;
+    if (tail > 0)
+    {
+        value <<= tail;
+        value |= 1u << (tail - 1);
+    }
+    return value;
+}
+
+uint32_t DShotBus::decodeErpm(uint32_t raw)
+{
+    // NRZI -> GCR
+    uint32_t gcr = raw ^ (raw >> 1);
+
+    // GCR 5B -> 4B
+    uint32_t decoded = 0;
+    for (uint8_t shift = 0; shift < 16; shift += 4)
+    {
+        uint8_t nibble = kGcrDecodeTable[gcr & 0x1Fu];
+        if (nibble == GCR_INVALID)
+        {
+            return ERPM_INVALID;
+        }
+        decoded |= static_cast<uint32_t>(nibble) << shift;
+        gcr >>= 5;
+    }
+
+    // 校验：16 位数据按半字节异或应为 0xF
+    uint32_t csum = decoded ^ (decoded >> 8);
+    csum ^= (csum >> 4);
+    if ((csum & 0x0Fu) != 0x0Fu)
+    {
+        return ERPM_INVALID;
+    }
+
+    // [exponent:3][mantissa:9]，周期单位 us
+    decoded >>= 4;
+    if (decoded == 0x0FFFu)
+    {
+        return 0; // 电机停转
+    }
+    uint32_t period_us = (decoded & 0x01FFu) << (decoded >> 9);
+    if (period_us == 0)
+    {
+        return ERPM_INVALID;
+    }
+    return (60000000u + period_us / 2) / period_us;
+}
@@ -1,5 +1,7 @@
 #include "appCallback.h"
 #include "config.h"
+#include "fdcan_drv.h"
+#include "trace.h"
 
 
 #ifdef __cplusplus
@@ -9,18 +11,50 @@ extern "C" {
 
 void APP_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
 {
+    TRACE_BEGIN(TRACE_ID_NRF_EXTI_ISR);
     nrf.handleEXTI(GPIO_Pin); // 调用NRF的中断处理函数
+    TRACE_END(TRACE_ID_NRF_EXTI_ISR);
+    control_pipeline.handleEXTI(GPIO_Pin); // IMU数据就绪，唤醒控制流水线
 
 
 }
 void APP_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
 {
-
-    
+    control_pipeline.handleTimer(htim); // 数据就绪中断未接线时由定时器触发控制流水线
+#if CONFIG_MOTOR_USE_DSHOT
+    dshot_bus.handleDmaCplt(htim); // DShot 帧 DMA 突发完成
+#endif
 }
 void APP_UART_RxCpltCallback(UART_HandleTypeDef *huart)
 {
+    TRACE_BEGIN(TRACE_ID_LIDAR_RX_ISR);
     lidar.dmaRxCallback(huart); // 调用Lidar的串口接收回调函数
+    TRACE_END(TRACE_ID_LIDAR_RX_ISR);
+#if CONFIG_OPTICAL_FLOW_ENABLE
+    upt201.rxCallback(huart); // 光流逐字节接收
+#endif
+}
+void APP_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    hc12.txCpltCallback(huart); // 继续发送HC12队列中的数据
+}
+void APP_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    hc12.errorCallback(huart);
+}
+void APP_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    TRACE_BEGIN(TRACE_ID_NRF_SPI_ISR);
+    nrf.handleSpiTxRxCplt(hspi); // 推进NRF的异步状态机
+    TRACE_END(TRACE_ID_NRF_SPI_ISR);
+}
+void APP_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+    nrf.handleSpiError(hspi);
+}
+void APP_FDCAN_RxFifoCallback(FDCAN_HandleTypeDef *hfdcan, uint32_t RxFifo)
+{
+    FdcanDrv_RxFifoCallback(hfdcan, RxFifo); // 取出FIFO中全部帧并分发到订阅者
 }
 
 
@@ -12,6 +12,13 @@ void APP_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim);
 
 void APP_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t size);
 void APP_UART_RxCpltCallback(UART_HandleTypeDef *huart);
+void APP_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+void APP_UART_ErrorCallback(UART_HandleTypeDef *huart);
+
+void APP_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi);
+void APP_SPI_ErrorCallback(SPI_HandleTypeDef *hspi);
+
+void APP_FDCAN_RxFifoCallback(FDCAN_HandleTypeDef *hfdcan, uint32_t RxFifo);
 #ifdef __cplusplus
 }
 #endif
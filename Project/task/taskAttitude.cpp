@@ -4,6 +4,7 @@
 static float roll_deg, pitch_deg, yaw_deg;
 static float gyroBuf[3] = {0};
 static float accelBuf[3] = {0};
+static volatile bool attitude_ready = false; // 姿态任务初始化完成，由启动序列在默认任务中轮询
 
 // 添加extern "C"声明
 extern "C" void taskAttitudeIMU(void *argument);
@@ -11,11 +12,42 @@ extern "C" void taskAttitudeIMU(void *argument);
 void AttitudeIMU_Init(void)
 {
    // osDelay(1000);
+#if CONFIG_PARAMS_ENABLE
+    // 姿态任务优先级最高，首次阻塞前完成参数恢复，其他任务随后才会访问参数存储
+    taskParams_Load();
+#endif
 
     bmi088.init();
+#if CONFIG_GYRO_CALIBRATOR_ENABLE
+    // 零偏在姿态解算循环中静止时校准，未校准前停机模式保持上锁
+    attitude_manager.setGyroCalibrator(&gyro_calibrator);
+#else
+    bmi088.calibrateGyro();
+#endif
+#if CONFIG_ACCEL_CALIBRATOR_ENABLE
+    attitude_manager.setAccelCalibrator(&accel_calibrator);
+#endif
     osDelay(2);
     bmi088.read(gyroBuf, accelBuf);
     mahony_estimator.init(accelBuf);
+    // 陀螺仪FIFO以2kHz输出，经圆锥补偿后按500Hz运行姿态解算
+    attitude_manager.setDeltaAngleIntegrator(&delta_angle_integrator);
+    // 积分与解算前先对三轴陀螺仪和加速度计做低通滤波
+    gyro_filter.setLowpass(CONFIG_GYRO_SAMPLE_RATE_HZ, CONFIG_GYRO_LPF_HZ, CONFIG_GYRO_LPF_STAGES);
+    accel_filter.setLowpass(CONFIG_ACCEL_SAMPLE_RATE_HZ, CONFIG_ACCEL_LPF_HZ, CONFIG_ACCEL_LPF_STAGES);
+    attitude_manager.setImuFilters(&gyro_filter, &accel_filter);
+#if CONFIG_GYRO_DYN_NOTCH_ENABLE
+    // 动态陷波节接在低通节之后，须在设置低通之后初始化
+    if (gyro_dynamic_notch.init(&gyro_filter))
+    {
+        attitude_manager.setDynamicNotch(&gyro_dynamic_notch);
+    }
+#endif
+#if CONFIG_HEADING_FUSION_ENABLE
+    // 雷达 IMU 航向作为延迟偏航观测，由控制流水线转交
+    mahony_estimator.setHeadingKp(CONFIG_HEADING_KP);
+    attitude_manager.setHeadingFusion(CONFIG_HEADING_FUSION_SET);
+#endif
 
     if (!attitude_manager.init())
     {
@@ -25,12 +57,12 @@ void AttitudeIMU_Init(void)
             osDelay(1000);
         }
     }
-
+    attitude_ready = true;
 }
 
-void AttitudeIMU_Update(void)
+bool taskAttitude_IsReady(void)
 {
-    attitude_manager.update();
+    return attitude_ready;
 }
 
 void AttitudeIMU_Debug(void)
@@ -53,21 +85,23 @@ void taskAttitudeIMU(void *argument)
     // 初始化IMU
     AttitudeIMU_Init();
 
+    // 由IMU数据就绪中断(或备用定时器)通过任务通知驱动：
+    // 姿态解算 -> 角度/角速度环 -> 混控 -> 电机输出 在本任务中顺序完成
+    control_pipeline.start();
+#if CONFIG_POSITION_ESTIMATOR_ENABLE
+    control_pipeline.setPositionEstimator(&position_estimator);
+#endif
+#if CONFIG_ALTITUDE_ESTIMATOR_ENABLE
+    control_pipeline.setAltitudeEstimator(&altitude_estimator);
+#endif
+#if CONFIG_HEADING_FUSION_ENABLE
+    control_pipeline.setHeadingSource(&lidar);
+#endif
+
     while (1)
     {
-
-        //记录当前os时间以精确按照2ms为周期触发
-        //uint32_t current_time = xTaskGetTickCount();
-        // 更新IMU数据
-        AttitudeIMU_Update();
+        control_pipeline.spinOnce();
         // 调试输出
         AttitudeIMU_Debug();
-
-        // 计算下次触发时间
-        //uint32_t next_time = current_time + 2; // 2ms周期
-
-        // 线程释放直到下次触发
-        //osDelayUntil(next_time);
-        osDelay(2); // 2ms周期
     }
-}
\ No newline at end of file
+}
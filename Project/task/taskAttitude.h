@@ -4,5 +4,19 @@
 
 #include "cmsis_os.h"
 #include "main.h"
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 姿态任务初始化是否完成 (IMU 与姿态解算器就绪，启动序列的就绪判定)
+ */
+bool taskAttitude_IsReady(void);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif /* TASK_ATTITUDE_H */
\ No newline at end of file
@@ -1,16 +1,14 @@
 #include "taskCommuCheck.h"
 #include "config.h"
-#include "cmsis_os.h" // For osDelay
+#include "cmsis_os.h"
 #include "lidar.h"
 #include "taskNrfResponse.h"
 
-// ========== 轮询周期配置 ==========
-#define COMMU_CHECK_POLL_PERIOD_MS  5    // 5ms轮询周期
-
 // ========== NRF连接检测配置 ==========
 static const uint64_t NRF_DISCONNECT_TIMEOUT_MS = 250;   // 250ms 未收到包则掉线
 static const uint64_t NRF_MAX_PACKET_INTERVAL_MS = 250;  // 恢复期间包之间最大间隔250ms
 static const uint8_t NRF_MIN_RECOVERY_PACKETS = 2;       // 至少连续2个包满足条件才能恢复
+static const uint64_t NRF_PROBE_PERIOD_MS = 1000;        // 模块未响应时重新探测的周期
 
 // ========== Lidar连接检测配置 ==========
 static const uint64_t LIDAR_DISCONNECT_TIMEOUT_MS = 500;   // 500ms 未收到包则掉线
@@ -18,9 +16,19 @@ static const uint64_t LIDAR_MAX_PACKET_INTERVAL_MS = 500;  // 恢复期间包之
 static const uint8_t LIDAR_MIN_RECOVERY_PACKETS = 1;        // 至少连续1个包满足条件才能恢复
 
 // ========== 全局变量定义 ==========
-ground_station_rx_data_t ground_station_rx_data; // NRF接收数据结构体
 ground_station_status_t ground_station_status; // NRF状态数据结构体
 lidar_status_t lidar_status; // Lidar状态数据结构体
+ground_station_rx_data_t gs_rx_data; // 地面站手柄数据快照
+
+// ========== 话题定义 ==========
+Topic<ground_station_rx_data_t> topic_gs_rx("gs_rx");
+Topic<LidarPoseData> topic_lidar_pose("lidar_pose");
+Topic<LidarImuData> topic_lidar_imu("lidar_imu");
+
+// 连接检查使用的订阅者，判断是否收到新数据并拷贝手柄数据快照
+static Subscriber<ground_station_rx_data_t> gs_rx_sub(topic_gs_rx);
+static Subscriber<LidarPoseData> lidar_pose_sub(topic_lidar_pose);
+static Subscriber<LidarImuData> lidar_imu_sub(topic_lidar_imu);
 
 // ========== 内部辅助函数 ==========
 static void update_recovery_state(connection_recovery_state_t* recovery, 
@@ -50,35 +58,44 @@ static void update_recovery_state(connection_recovery_state_t* recovery,
 void ground_station_rx_callback(uint8_t channel, uint8_t* data, uint8_t len)
 {
     if(len != sizeof(ground_station_rx_data_t)) return;
-    ground_station_rx_data = *(ground_station_rx_data_t*)data;
-
-    // 仅设置接收标志位
-    ground_station_status.rx_flag = 1;
+    // 发布到话题，接收标志由订阅者序号判断
+    topic_gs_rx.publish(*(ground_station_rx_data_t*)data);
 }
 
 // ========== Lidar通信回调函数 ==========
 void lidar_pose_rx_callback(const LidarPoseData* pose_data)
 {
     if (!pose_data || !pose_data->valid) return;
-    
-    // 仅设置标志位和增加计数
-    lidar_status.pose_rx_flag = 1;
-    lidar_status.pose_count++;
+
+    topic_lidar_pose.publish(*pose_data);
 }
 
 void lidar_imu_rx_callback(const LidarImuData* imu_data)
 {
     if (!imu_data || !imu_data->valid) return;
-    
-    // 仅设置标志位和增加计数
-    lidar_status.imu_rx_flag = 1;
-    lidar_status.imu_count++;
+
+    topic_lidar_imu.publish(*imu_data);
 }
 
 // ========== 连接状态检查函数 ==========
 static void check_nrf_connection_status(void)
 {
     static uint8_t dummy_packet[4] = {0,0,0,0};
+    static uint64_t probe_elapsed_ms = 0;
+    
+    if (!nrf.isInitialized()) // 上电时模块未响应，按 1Hz 单次探测，不使用带延时重试的 init()
+    {
+        probe_elapsed_ms += COMMU_CHECK_POLL_PERIOD_MS;
+        if (probe_elapsed_ms >= NRF_PROBE_PERIOD_MS)
+        {
+            probe_elapsed_ms = 0;
+            nrf.probe();
+        }
+        return;
+    }
+
+    // 本轮询周期内是否收到新数据，收到则拷贝一份一致的快照供本周期各作业读取
+    ground_station_status.rx_flag = gs_rx_sub.updated() && gs_rx_sub.copy(gs_rx_data);
     
     if (ground_station_status.is_connected)
     {
@@ -121,35 +138,30 @@ static void check_nrf_connection_status(void)
             ground_station_status.recovery.time_since_last_packet_ms = 0;
         }
         
-        taskENTER_CRITICAL();
-        nrf.transmit(dummy_packet, sizeof(dummy_packet)); // 发送虚拟包以维持连接
-        taskEXIT_CRITICAL();
+        nrf.transmit(dummy_packet, sizeof(dummy_packet)); // 发送虚拟包以维持连接（仅入队，不阻塞）
     }
 }
 
 static void check_lidar_connection_status(void)
 {
     static uint8_t rate_calc_counter = 0;
-    static uint64_t last_pose_count = 0;
-    static uint64_t last_imu_count = 0;
     
-    // 每200次循环（1秒）计算一次速率 (200 * 5ms = 1000ms)
+    // 每200次循环（1秒）统计一次所有话题的发布频率 (200 * 5ms = 1000ms)
     rate_calc_counter++;
     if (rate_calc_counter >= (1000 / COMMU_CHECK_POLL_PERIOD_MS))
     {
         rate_calc_counter = 0;
-        
-        // 计算pose速率
-        uint64_t pose_diff = lidar_status.pose_count - last_pose_count;
-        lidar_status.pose_rate = (float)pose_diff;
-        last_pose_count = lidar_status.pose_count;
-        
-        // 计算IMU速率
-        uint64_t imu_diff = lidar_status.imu_count - last_imu_count;
-        lidar_status.imu_rate = (float)imu_diff;
-        last_imu_count = lidar_status.imu_count;
+        TopicBase::updateRates(1000);
+        lidar_status.pose_rate = topic_lidar_pose.getRate();
+        lidar_status.imu_rate = topic_lidar_imu.getRate();
     }
 
+    // 由订阅者序号得到接收标志与计数
+    lidar_status.pose_rx_flag = lidar_pose_sub.consume();
+    lidar_status.imu_rx_flag = lidar_imu_sub.consume();
+    lidar_status.pose_count = topic_lidar_pose.getPublishCount();
+    lidar_status.imu_count = topic_lidar_imu.getPublishCount();
+
     // 处理位姿数据标志位
     if (lidar_status.pose_rx_flag)
     {
@@ -212,22 +224,17 @@ static void check_lidar_connection_status(void)
 }
 
 void check_user(void);
-// ========== 通信检查主任务函数 ==========
-void taskCommuCheck(void *argument)
+// ========== 通信检查作业 ==========
+void taskCommuCheck_Update(void)
 {
-    // 进入主循环
-    while (1)
-    {
-        // 检查各组件连接状态
-        check_nrf_connection_status();
-        check_lidar_connection_status();
-        
-        // TODO: 在这里可以添加其他通信组件的连接检查
-        // 例如：检查其他传感器、模块的连接状态
-        
-        check_user(); // 用户自定义检查函数
-        osDelay(COMMU_CHECK_POLL_PERIOD_MS); // 每5ms检查一次状态
-    }
+    // 检查各组件连接状态
+    check_nrf_connection_status();
+    check_lidar_connection_status();
+    
+    // TODO: 在这里可以添加其他通信组件的连接检查
+    // 例如：检查其他传感器、模块的连接状态
+    
+    check_user(); // 用户自定义检查函数
 }
 
 void check_user(void)
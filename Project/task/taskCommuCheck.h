@@ -2,6 +2,10 @@
 #define TASK_COMMU_CHECK_H
 #include "main.h"
 #include "cmsis_os.h"
+#include "topic.h"
+
+// ========== 轮询周期配置 ==========
+#define COMMU_CHECK_POLL_PERIOD_MS  5    // 5ms轮询周期
 
 // 前向声明
 struct LidarPoseData;
@@ -67,9 +71,16 @@ typedef struct __attribute__((packed))
 } lidar_status_t;
 
 // ========== 全局变量声明 ==========
-extern ground_station_rx_data_t ground_station_rx_data; // NRF接收数据结构体
 extern ground_station_status_t ground_station_status; // NRF状态数据结构体
 extern lidar_status_t lidar_status; // Lidar状态数据结构体
+extern ground_station_rx_data_t gs_rx_data; // 地面站手柄数据快照，每个轮询周期从话题拷贝一次
+
+#ifdef __cplusplus
+// ========== 话题声明 ==========
+extern Topic<ground_station_rx_data_t> topic_gs_rx;    // 地面站手柄数据 (NRF接收中断发布)
+extern Topic<struct LidarPoseData> topic_lidar_pose;    // 雷达位姿 (串口接收中断发布)
+extern Topic<struct LidarImuData> topic_lidar_imu;      // 雷达IMU (串口接收中断发布)
+#endif
 
 // ========== 函数声明 ==========
 #ifdef __cplusplus
@@ -83,8 +94,8 @@ void ground_station_rx_callback(uint8_t channel, uint8_t* data, uint8_t len);
 void lidar_pose_rx_callback(const struct LidarPoseData* pose_data);
 void lidar_imu_rx_callback(const struct LidarImuData* imu_data);
 
-// 通信检查任务主函数
-void taskCommuCheck(void *argument);
+// 通信检查作业，需以 COMMU_CHECK_POLL_PERIOD_MS 为周期调用
+void taskCommuCheck_Update(void);
 
 #ifdef __cplusplus
 }
@@ -92,10 +103,10 @@ void taskCommuCheck(void *argument);
 
 // ========== 便捷宏定义 ==========
 #define GS_IS_CONNECTED     ground_station_status.is_connected
-#define GS_RX_DATA          ground_station_rx_data
-#define GS_FKEY(n)          (bool)(ground_station_rx_data.keyboard.fkeys & ((uint32_t)1 << (uint32_t)n))
-#define GS_SWITCH(n)        (bool)(ground_station_rx_data.keyboard.switchs & ((uint32_t)1 << (uint32_t)n))
-#define GS_ROCKERS          ground_station_rx_data.keyboard.rockers
+#define GS_RX_DATA          gs_rx_data
+#define GS_FKEY(n)          (bool)(GS_RX_DATA.keyboard.fkeys & ((uint32_t)1 << (uint32_t)n))
+#define GS_SWITCH(n)        (bool)(GS_RX_DATA.keyboard.switchs & ((uint32_t)1 << (uint32_t)n))
+#define GS_ROCKERS          GS_RX_DATA.keyboard.rockers
 
 // Lidar便捷宏定义
 #define LIDAR_IS_CONNECTED  lidar_status.is_connected
@@ -11,6 +11,9 @@ void StartDefaultTask(void *argument)
 {
   taskManager_Init(argument);  
 
+  // 稳定、通信检查、NRF响应与运动控制作业均由执行器在本线程中调度
+  taskManager_Run();
+
   for (;;)
   {
     osDelay(100); 
@@ -33,7 +36,8 @@ void StartAttitudeIMUTask(void *argument)
 void StartStabilizeTask(void *argument)
 {
     /* USER CODE BEGIN StartStabilizeTask */
-    taskStabilize(argument); // 调用任务函数
+    // 作业已并入执行器 (默认任务)，线程退出并由空闲任务回收栈
+    osThreadExit();
     /* Infinite loop */
     for (;;)
     {
@@ -45,7 +49,7 @@ void StartStabilizeTask(void *argument)
 void StartGroundStationTask(void *argument)
 {
   /* USER CODE BEGIN StartGroundStationTask */
-  taskCommuCheck(argument); // 调用新的通信检查任务函数
+  osThreadExit(); // 未创建的线程，通信检查已并入执行器
 
   /* Infinite loop */
   for(;;)
@@ -58,7 +62,8 @@ void StartGroundStationTask(void *argument)
 void StartCommuCheckTask(void *argument)
 {
   /* USER CODE BEGIN StartCommuCheckTask */
-  taskCommuCheck(argument); // 重定向到新的通信检查任务函数
+  // 作业已并入执行器 (默认任务)，线程退出并由空闲任务回收栈
+  osThreadExit();
 
   /* Infinite loop */
   for(;;)
@@ -71,7 +76,8 @@ void StartCommuCheckTask(void *argument)
 void StartNrfResponseTask(void *argument)
 {
   /* USER CODE BEGIN StartNrfResponseTask */
-  taskNrfResponse(argument); // 重定向到NRF响应任务函数
+  // 作业已并入执行器 (默认任务)，线程退出并由空闲任务回收栈
+  osThreadExit();
 
   /* Infinite loop */
   for(;;)
@@ -84,7 +90,8 @@ void StartNrfResponseTask(void *argument)
 void StartMoveTask(void *argument)
 {
   /* USER CODE BEGIN StartMoveTask */
-  taskMovement(argument); // 重定向到运动控制任务函数
+  // 作业已并入执行器 (默认任务)，线程退出并由空闲任务回收栈
+  osThreadExit();
 
   /* Infinite loop */
   for(;;)
@@ -1,18 +1,228 @@
 #include "taskManager.h"
 #include "config.h"
 #include "taskCommuCheck.h"  // 包含回调函数声明
+#include "taskNrfResponse.h"
+#include "executor.h"
+#include "boot_sequencer.h"
+#include "runtime_monitor.h"
+#include "topic.h"
+#include "trace.h"
+
+// ========== 运行时统计 ==========
+Topic<RuntimeStatsRecord_t, 2> topic_runtime_stats("runtime_stats"); // 运行时统计记录
+static RuntimeMonitor runtime_monitor;
+
+static void taskManager_RuntimeStats(void)
+{
+    // 采样失败时不提交，槽位留给下一次采样
+    RuntimeStatsRecord_t* record = topic_runtime_stats.claim();
+    if (runtime_monitor.sample(record))
+    {
+        topic_runtime_stats.commit();
+    }
+}
+
+// ========== 延迟统计 ==========
+Topic<LatencyReport_t, 2> topic_latency_report("latency_report"); // 端到端延迟摘要
+
+static void taskManager_LatencyReport(void)
+{
+    control_pipeline.getLatency().getReport(topic_latency_report.claim());
+    topic_latency_report.commit();
+}
+
+// ========== 气压计 ==========
+static void taskManager_Baro(void)
+{
+#if CONFIG_BARO_ENABLE
+    // SPL06 以 8Hz 连续测量，读到新气压且完成地面校准后写入高度估计器
+    if (spl06.update() && spl06.isStable())
+    {
+        altitude_estimator.setBaroAltitude(spl06.getAltitude());
+    }
+#endif
+}
+
+// ========== HC12 导出 ==========
+static bool taskManager_Hc12Write(const uint8_t* data, uint16_t size)
+{
+    return hc12.transmitData(data, size) == HAL_OK; // 发送缓冲区满时下个周期重试
+}
+
+// 追踪导出与延迟直方图导出共用这一个作业，同一时刻只有一个导出流写入 HC12；
+// 追踪导出为连续二进制流，优先且独占，延迟直方图在其结束后继续逐行导出
+static void taskManager_Hc12Export(void)
+{
+    static bool key_prev = false;
+    bool key = GS_FKEY(CONFIG_TRACE_DUMP_FKEY);
+    if (key && !key_prev && !trace_dumping())
+    {
+        trace_dump_start();
+    }
+    key_prev = key;
+
+    if (trace_dumping())
+    {
+        trace_dump_step(taskManager_Hc12Write, 64);
+        return;
+    }
+    control_pipeline.getLatency().dumpStep(taskManager_Hc12Write);
+}
+
+// ========== 执行器作业表 ==========
+// 作业下标，用于声明依赖
+enum {
+    JOB_COMMU_CHECK = 0,
+    JOB_MOVEMENT_SETUP,
+    JOB_MOTOR_INIT,
+    JOB_MOTOR_ARM,
+    JOB_STABILIZE_INIT,
+    JOB_MOVEMENT_INIT,
+    JOB_NRF_RESPONSE_INIT,
+    JOB_NRF_RESPONSE,
+    JOB_MOVEMENT,
+    JOB_STABILIZE,
+    JOB_POSITION,
+    JOB_MOVEMENT_REPORT,
+    JOB_RUNTIME_STATS,
+    JOB_HC12_EXPORT,
+    JOB_LATENCY_REPORT,
+    JOB_BARO,
+    JOB_PARAMS_SAVE,
+    JOB_COUNT,
+};
+#define JOB_BIT(job) (1u << (job))
+
+// 原各线程中的启动延时改为首次释放时刻，周期作业由同一线程按绝对时刻调度；
+// 执行器在启动序列完成 (姿态任务已就绪) 后才运行，电机初始化不再预留等待 IMU 的 1s，
+// 其后的解锁与零油门保持间隔是电调协议要求，保持不变
+static const ExecutorJobConfig_t task_jobs[JOB_COUNT] = {
+    // 名称               作业函数                  周期ms  首次ms  优先级 依赖
+    {"commu_check",      taskCommuCheck_Update,    COMMU_CHECK_POLL_PERIOD_MS, 0, 1, 0},
+    {"movement_setup",   taskMovement_Setup,       0,      0,      4, 0},
+    {"motor_init",       taskStabilize_Init_Motor, 0,      0,      0, 0},
+    {"motor_arm",        taskStabilize_Arm_Motor,  0,      300,    0, JOB_BIT(JOB_MOTOR_INIT)},
+    {"stabilize_init",   taskStabilize_Init,       0,      400,    0, JOB_BIT(JOB_MOTOR_ARM)},
+    {"movement_init",    taskMovement_Init,        0,      1500,   3, JOB_BIT(JOB_MOVEMENT_SETUP)},
+    {"nrf_response_init",taskNrfResponse_Init,     0,      1500,   5, 0},
+    {"nrf_response",     taskNrfResponse_Update,   50,     1500,   5, JOB_BIT(JOB_NRF_RESPONSE_INIT) | JOB_BIT(JOB_COMMU_CHECK)},
+    {"movement",         taskMovement_Update,      20,     2000,   3, JOB_BIT(JOB_MOVEMENT_INIT)},
+    {"stabilize",        taskStabilize_Control,    2,      1400,   0, JOB_BIT(JOB_STABILIZE_INIT) | JOB_BIT(JOB_COMMU_CHECK)},
+    {"position",         taskStabilize_Position,   60,     1400,   2, JOB_BIT(JOB_STABILIZE) | JOB_BIT(JOB_MOVEMENT)},
+    {"movement_report",  taskMovement_Report,      1000,   2000,   6, 0},
+    {"runtime_stats",    taskManager_RuntimeStats, 1000,   1000,   7, 0},
+    {"hc12_export",      taskManager_Hc12Export,   20,     2000,   7, 0},
+    {"latency_report",   taskManager_LatencyReport,1000,   1000,   7, 0},
+    {"baro",             taskManager_Baro,         40,     1000,   4, 0},
+    {"params_save",      taskParams_Save,          10000,  5000,   7, 0},
+};
+
+Executor task_executor(task_jobs, JOB_COUNT);
+
+// ========== 启动序列 ==========
+static bool taskManager_BootLidar(void)
+{
+    return lidar.init() && lidar.start();
+}
+
+static bool taskManager_BootHc12(void)
+{
+    return hc12.init() == HAL_OK;
+}
+
+static bool taskManager_BootBaroReset(void)
+{
+#if CONFIG_BARO_ENABLE
+    spl06.reset();
+#endif
+    return true;
+}
+
+static bool taskManager_BootBaroResetDone(void)
+{
+#if CONFIG_BARO_ENABLE
+    return spl06.isResetDone();
+#else
+    return true;
+#endif
+}
+
+static bool taskManager_BootBaro(void)
+{
+#if CONFIG_BARO_ENABLE
+    if (!spl06.configure())
+    {
+        return false;
+    }
+    float ground_pressure;
+    if (taskParams_GetBaroGround(&ground_pressure))
+    {
+        spl06.setGroundPressure(ground_pressure);
+    }
+#endif
+    return true;
+}
+
+static bool taskManager_BootFlow(void)
+{
+#if CONFIG_OPTICAL_FLOW_ENABLE
+    return upt201.init() && upt201.start();
+#else
+    return true;
+#endif
+}
+
+static bool taskManager_BootCommu(void)
+{
+    // 雷达回调在此注册，不依赖雷达阶段是否成功；NRF 未响应时由通信检查作业按 1Hz 探测重连，不作为启动失败
+    taskCommuCheck_Init(nullptr);
+    return true;
+}
+
+// 阶段下标，用于声明依赖
+enum {
+    BOOT_LIDAR = 0,
+    BOOT_HC12,
+    BOOT_BARO_RESET,
+    BOOT_BARO,
+    BOOT_FLOW,
+    BOOT_COMMU,
+    BOOT_ATTITUDE,
+    BOOT_COUNT,
+};
+#define BOOT_BIT(stage) (1u << (stage))
+
+// 原串行初始化中的固定延时改为就绪判定，互不依赖的设备等待硬件的时间相互重叠
+static const BootStageConfig_t boot_stages[BOOT_COUNT] = {
+    // 名称           启动步骤                    就绪判定                       依赖                      超时ms
+    {"lidar",        taskManager_BootLidar,      nullptr,                       0,                        0},
+    {"hc12",         taskManager_BootHc12,       nullptr,                       0,                        0},
+    {"baro_reset",   taskManager_BootBaroReset,  taskManager_BootBaroResetDone, 0,                        100},
+    {"baro",         taskManager_BootBaro,       nullptr,                       BOOT_BIT(BOOT_BARO_RESET), 0},
+    {"flow",         taskManager_BootFlow,       nullptr,                       0,                        0},
+    {"commu",        taskManager_BootCommu,      nullptr,                       0,                        0},
+    {"attitude",     nullptr,                    taskAttitude_IsReady,          0,                        3000},
+};
+
+BootSequencer boot_sequencer(boot_stages, BOOT_COUNT);
+static volatile bool boot_succeeded = false; // 启动序列是否全部就绪，失败的阶段见 boot_sequencer 统计表
+
 extern "C" {  // 添加 extern "C" 块
 __weak void taskManager_Init(void* argument)
 {
-    lidar.init();
-    osDelay(5);
-    lidar.start();
-    osDelay(5);
-    hc12.init();
-    //upt201.init();
-    //osDelay(5);
-    //upt201.start();
-    taskCommuCheck_Init(argument);
+    // 姿态任务在自身线程中初始化 IMU，这里只等待其就绪，执行器作业开始时姿态解算已运行
+    boot_succeeded = boot_sequencer.run();
+}
+
+bool taskManager_BootSucceeded(void)
+{
+    return boot_succeeded;
+}
+
+// 在调用线程中运行所有周期作业，不返回
+void taskManager_Run(void)
+{
+    task_executor.run();
 }
 
 // 通信检查初始化函数，统一管理NRF等通信组件的初始化
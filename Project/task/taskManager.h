@@ -6,19 +6,31 @@
 #include "taskAttitude.h"
 #include "taskStabilize.h"
 #include "taskMovement.h"  // 添加运动控制任务头文件
+#include "taskParams.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 void taskAttitudeIMU(void *argument);
-void taskStabilize(void *argument);
 void taskManager_Init(void* argument);
+bool taskManager_BootSucceeded(void);      // 启动序列是否全部就绪，失败时稳定控制保持停机
+void taskManager_Run(void);                // 运行执行器 (稳定、通信检查、NRF响应、运动控制作业)
 void taskCommuCheck_Init(void* argument);  // 通信检查初始化函数声明
 void StartCommuCheckTask(void* argument);  // StartCommuCheckTask重定向函数声明
-void taskNrfResponse(void *argument);      // NRF响应任务函数声明
-void taskMovement(void *argument);         // 运动控制任务函数声明
 #ifdef __cplusplus
 }
 #endif
 
+#ifdef __cplusplus
+#include "executor.h"
+#include "boot_sequencer.h"
+#include "runtime_monitor.h"
+#include "latency_monitor.h"
+#include "topic.h"
+extern Executor task_executor; // 周期作业执行器
+extern BootSequencer boot_sequencer; // 启动序列，各阶段耗时可在调试器中查看
+extern Topic<RuntimeStatsRecord_t, 2> topic_runtime_stats; // 运行时统计记录 (1Hz)
+extern Topic<LatencyReport_t, 2> topic_latency_report;      // 端到端延迟摘要 (1Hz)
+#endif
+
 #endif // TASK_MANAGER_H
\ No newline at end of file
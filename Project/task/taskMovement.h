@@ -9,16 +9,25 @@ extern "C" {
 #endif
 
 /**
- * @brief 运动控制任务函数
- * @param argument 任务参数
+ * @brief 加载路径点并配置HC12 (执行器单次作业)
  */
-void taskMovement(void *argument);
+void taskMovement_Setup(void);
 
 /**
- * @brief 运动控制初始化函数
+ * @brief 运动控制初始化函数 (执行器单次作业)
  */
 void taskMovement_Init(void);
 
+/**
+ * @brief 路径跟踪状态更新 (执行器周期作业)
+ */
+void taskMovement_Update(void);
+
+/**
+ * @brief 任务完成后通过HC12上报用时 (执行器周期作业)
+ */
+void taskMovement_Report(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -60,7 +60,8 @@ extern "C" {
 extern NrfCommu_ReceivePackage_t nrf_response_package;
 
 // 函数声明
-void taskNrfResponse(void *argument);
+void taskNrfResponse_Init(void);    // 清空响应数据包 (执行器单次作业)
+void taskNrfResponse_Update(void);  // 发送响应数据包 (执行器周期作业)
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,191 @@
+#include "taskParams.h"
+#include "taskStabilize.h"
+#include "config.h"
+#include <math.h>
+#include <string.h>
+
+// 参数键，同一键的数据格式变化时递增对应版本号，旧记录自动失效
+enum ParamKey : uint16_t {
+    PARAM_KEY_GYRO_BIAS = 1,
+    PARAM_KEY_BARO_GROUND = 2,
+    PARAM_KEY_ALTITUDE_BIAS = 3,
+    PARAM_KEY_PID_GAINS = 4,
+    PARAM_KEY_ACCEL_CAL = 5,
+};
+static const uint16_t PARAM_VERSION_GYRO_BIAS = 1;
+static const uint16_t PARAM_VERSION_BARO_GROUND = 1;
+static const uint16_t PARAM_VERSION_ALTITUDE_BIAS = 1;
+static const uint16_t PARAM_VERSION_PID_GAINS = 1;
+static const uint16_t PARAM_VERSION_ACCEL_CAL = 1;
+
+// 参与保存的 PID，顺序即存储顺序
+static PidController* const param_pids[] = {
+    &pid_roll_rad, &pid_pitch_rad, &pid_yaw_rad,
+    &pid_roll_spd, &pid_pitch_spd, &pid_yaw_spd,
+    &pid_x_vel, &pid_y_vel, &pid_z_vel,
+    &pid_x_pos, &pid_y_pos, &pid_z_pos,
+};
+static const uint32_t PARAM_PID_COUNT = sizeof(param_pids) / sizeof(param_pids[0]);
+
+struct AccelCalRecord {
+    float scale[3];
+    float bias[3];   // 单位：m/s^2
+};
+
+struct PidGainsRecord {
+    uint32_t defaults_crc; // 固件默认参数的 CRC，修改 config.h 中的默认值后旧记录不再使用
+    float gains[PARAM_PID_COUNT][3];
+};
+
+// 已保存的值，用于判断是否需要重新写入
+static struct {
+    bool gyro_valid;
+    float gyro_bias[3];
+    bool baro_valid;
+    float baro_ground;
+    bool altitude_valid;
+    float altitude_bias;
+    bool accel_valid;
+    AccelCalRecord accel;
+    PidGainsRecord pid;
+} params_saved;
+
+static void taskParams_ReadPids(PidGainsRecord& record)
+{
+    for (uint32_t i = 0; i < PARAM_PID_COUNT; i++) {
+        record.gains[i][0] = param_pids[i]->getKp();
+        record.gains[i][1] = param_pids[i]->getKi();
+        record.gains[i][2] = param_pids[i]->getKd();
+    }
+}
+
+void taskParams_Load(void)
+{
+    if (!param_store.mount()) {
+        return;
+    }
+
+    float bias[3];
+    if (param_store.get(PARAM_KEY_GYRO_BIAS, bias, sizeof(bias), PARAM_VERSION_GYRO_BIAS)) {
+        // 上次的零偏作为初值立即可用，静止后后台校准再更新
+        gyro_calibrator.seed(bias);
+        params_saved.gyro_valid = true;
+        for (int i = 0; i < 3; i++) {
+            params_saved.gyro_bias[i] = bias[i];
+        }
+    }
+
+    AccelCalRecord accel;
+    if (param_store.get(PARAM_KEY_ACCEL_CAL, &accel, sizeof(accel), PARAM_VERSION_ACCEL_CAL)) {
+        // 作为当前校正与椭球拟合的先验，之后在新姿态下继续细化
+        accel_calibrator.seed(accel.scale, accel.bias);
+        params_saved.accel_valid = true;
+        params_saved.accel = accel;
+    }
+
+    float value;
+    if (param_store.get(PARAM_KEY_BARO_GROUND, &value, sizeof(value), PARAM_VERSION_BARO_GROUND)) {
+        params_saved.baro_valid = true;
+        params_saved.baro_ground = value;
+    }
+    if (param_store.get(PARAM_KEY_ALTITUDE_BIAS, &value, sizeof(value), PARAM_VERSION_ALTITUDE_BIAS)) {
+        altitude_estimator.setAccelBias(value);
+        params_saved.altitude_valid = true;
+        params_saved.altitude_bias = value;
+    }
+
+    // 此时 PID 中仍是固件默认参数
+    PidGainsRecord defaults;
+    taskParams_ReadPids(defaults);
+    defaults.defaults_crc = utils::crc32(0, defaults.gains, sizeof(defaults.gains));
+
+    PidGainsRecord stored;
+    if (param_store.get(PARAM_KEY_PID_GAINS, &stored, sizeof(stored), PARAM_VERSION_PID_GAINS) &&
+        stored.defaults_crc == defaults.defaults_crc) {
+        for (uint32_t i = 0; i < PARAM_PID_COUNT; i++) {
+            param_pids[i]->setParams(stored.gains[i][0], stored.gains[i][1], stored.gains[i][2]);
+        }
+        params_saved.pid = stored;
+    } else {
+        params_saved.pid = defaults;
+    }
+}
+
+bool taskParams_GetBaroGround(float* pressure)
+{
+    if (!params_saved.baro_valid) {
+        return false;
+    }
+    *pressure = params_saved.baro_ground;
+    return true;
+}
+
+void taskParams_Save(void)
+{
+    // 闪存擦写期间取指停顿，只在停机时写入
+    if (!param_store.isMounted() || !taskStabilize_IsStopped()) {
+        return;
+    }
+
+    if (attitude_manager.isGyroCalibrated()) {
+        float bias[3];
+        attitude_manager.getGyroBias(bias);
+        bool changed = !params_saved.gyro_valid;
+        for (int i = 0; i < 3; i++) {
+            changed |= fabsf(bias[i] - params_saved.gyro_bias[i]) > CONFIG_PARAMS_GYRO_BIAS_TOL;
+        }
+        if (changed && param_store.set(PARAM_KEY_GYRO_BIAS, bias, sizeof(bias), PARAM_VERSION_GYRO_BIAS)) {
+            params_saved.gyro_valid = true;
+            for (int i = 0; i < 3; i++) {
+                params_saved.gyro_bias[i] = bias[i];
+            }
+        }
+    }
+
+#if CONFIG_ACCEL_CALIBRATOR_ENABLE
+    if (accel_calibrator.isCalibrated()) {
+        AccelCalRecord accel;
+        attitude_manager.getAccelCalibration(accel.scale, accel.bias);
+        bool changed = !params_saved.accel_valid;
+        for (int i = 0; i < 3; i++) {
+            changed |= fabsf(accel.scale[i] - params_saved.accel.scale[i]) > CONFIG_PARAMS_ACCEL_SCALE_TOL;
+            changed |= fabsf(accel.bias[i] - params_saved.accel.bias[i]) > CONFIG_PARAMS_ACCEL_BIAS_TOL;
+        }
+        if (changed && param_store.set(PARAM_KEY_ACCEL_CAL, &accel, sizeof(accel), PARAM_VERSION_ACCEL_CAL)) {
+            params_saved.accel_valid = true;
+            params_saved.accel = accel;
+        }
+    }
+#endif
+
+#if CONFIG_BARO_ENABLE
+    if (spl06.isStable()) {
+        float ground = spl06.getGroundPressure();
+        if ((!params_saved.baro_valid || fabsf(ground - params_saved.baro_ground) > CONFIG_PARAMS_BARO_GROUND_TOL) &&
+            param_store.set(PARAM_KEY_BARO_GROUND, &ground, sizeof(ground), PARAM_VERSION_BARO_GROUND)) {
+            params_saved.baro_valid = true;
+            params_saved.baro_ground = ground;
+        }
+    }
+#endif
+
+#if CONFIG_ALTITUDE_ESTIMATOR_ENABLE
+    AltitudeEstimate estimate;
+    altitude_estimator.getEstimate(estimate);
+    if (estimate.valid && estimate.reference == AltitudeReference::LIDAR &&
+        (!params_saved.altitude_valid || fabsf(estimate.accel_bias - params_saved.altitude_bias) > CONFIG_PARAMS_ALTITUDE_BIAS_TOL) &&
+        param_store.set(PARAM_KEY_ALTITUDE_BIAS, &estimate.accel_bias, sizeof(estimate.accel_bias), PARAM_VERSION_ALTITUDE_BIAS)) {
+        params_saved.altitude_valid = true;
+        params_saved.altitude_bias = estimate.accel_bias;
+    }
+#endif
+
+    // 运行中调整过的 PID 参数
+    PidGainsRecord current;
+    current.defaults_crc = params_saved.pid.defaults_crc;
+    taskParams_ReadPids(current);
+    if (memcmp(current.gains, params_saved.pid.gains, sizeof(current.gains)) != 0 &&
+        param_store.set(PARAM_KEY_PID_GAINS, &current, sizeof(current), PARAM_VERSION_PID_GAINS)) {
+        params_saved.pid = current;
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef TASK_PARAMS_H
+#define TASK_PARAMS_H
+
+#include "main.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 挂载参数存储并恢复校准值 (陀螺仪零偏、加速度计比例与零偏)、估计器零偏与 PID 参数
+ * @details 只读存储器映射的闪存，耗时为微秒级；须在姿态任务开始解算之前调用，
+ *          且早于其他任务访问参数存储
+ */
+void taskParams_Load(void);
+
+/**
+ * @brief 获取保存的地面气压
+ * @param pressure 地面气压，单位：Pa
+ * @return 是否存在
+ */
+bool taskParams_GetBaroGround(float* pressure);
+
+/**
+ * @brief 停机时把变化超过阈值的参数写入闪存 (执行器周期作业)
+ */
+void taskParams_Save(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TASK_PARAMS_H
@@ -7,7 +7,6 @@
 
 float motor_all_th = 0.0;
 SlopeSmoother motor_smoother(0.04f, 100.0f, motor_all_th);
-extern PoseDiff pose_diff;
 
 
 void taskStabilize_Init_Motor(void)
@@ -16,21 +15,35 @@ void taskStabilize_Init_Motor(void)
     motor_2.init();
     motor_3.init();
     motor_4.init();
-    osDelay(300);
+}
+
+void taskStabilize_Arm_Motor(void)
+{
+    // 电机初始化后保持一段时间再给零油门，由执行器按释放时刻调度
     motor_1.setThrottle(0.0f);
     motor_2.setThrottle(0.0f);
     motor_3.setThrottle(0.0f);
     motor_4.setThrottle(0.0f);
-    osDelay(100);
 }
 
 void taskStabilize_Init(void)
 {
-    taskStabilize_Init_Motor();
     chassis.init();
     chassis.setThrottleMode(ThrottleMode::DIRECT);
+    // 底盘输出由控制流水线在IMU数据到达后立即计算
+    control_pipeline.enableControl(true);
 }
 
+// 当前控制模式，由 taskStabilize_Control 判定，自动模式下位置环按自身周期执行
+enum class StabilizeMode : uint8_t {
+    STOP,
+    MANUAL,
+    AUTO,
+    DESCEND,
+    EMERGENCY,
+};
+static volatile StabilizeMode stabilize_mode = StabilizeMode::STOP;
+
 float override_throttle = 50.0f; // 油门覆盖值
 SlopeSmoother override_smoother(0.04f, 100.0f, 0.0f);
 
@@ -59,24 +72,12 @@ void taskStabilize_Stop(void)
 
 void taskStabilize_Auto(void)
 {
-    static uint64_t last_ctrl_ms = 0;
-    static const uint64_t ctrl_interval_ms = 60; // 控制间隔60ms
-
-    uint64_t current_ms = xTaskGetTickCount();
-
-    if(current_ms - last_ctrl_ms < ctrl_interval_ms)
-    {
-        // 如果距离上次控制时间小于控制间隔，则直接返回
-        return;
-    }
-    // 更新上次控制时间
-    last_ctrl_ms = current_ms;
-
     Pose guide_pose = path1.getCurrentGuidePose();
 
     move.setTargetPosition(guide_pose.x, guide_pose.y, guide_pose.z); // 这里可以根据需要设置目标位置
     //move.setTargetPosition(0, 0, 1.0f); // 设置目标位置为(0, 0, 1.0)，即在Z轴上升1米
     move.update();
+    control_pipeline.getLatency().recordPoseAge(move.getStatus().poseAgeUs);
 
     float rollCmd, pitchCmd, throttleCmd;
     move.getAttitudeCommand(rollCmd, pitchCmd, throttleCmd);
@@ -92,6 +93,43 @@ void taskStabilize_Auto(void)
     motor_smoother.update(throttleCmd + override_smoother.update(override_throttle));
 }
 
+// 雷达掉线后的缓降目标高度 (已减去原点偏移)
+static float descend_target_z = 0.0f;
+static uint32_t descend_last_tick = 0;
+
+void taskStabilize_Descend(void)
+{
+    // 雷达掉线：水平方向不控制，保持水平姿态，高度环使用气压/惯导高度按固定速率下降
+    uint32_t now = osKernelGetTickCount();
+    descend_target_z -= CONFIG_LIDAR_LOSS_DESCEND_RATE * (float)(now - descend_last_tick) / 1000.0f;
+    descend_last_tick = now;
+
+    float x, y, z;
+    move.getCurrentPosition(x, y, z);
+    move.setTargetPosition(x, y, descend_target_z);
+    move.update();
+
+    float rollCmd, pitchCmd, throttleCmd;
+    move.getAttitudeCommand(rollCmd, pitchCmd, throttleCmd);
+    chassis.setTargetAttitude(0.0f, 0.0f, chassis.getTargetYaw());
+
+    chassis.setThrottleOverride(
+        throttleCmd + override_smoother.update(override_throttle)
+    );
+    motor_smoother.update(throttleCmd + override_smoother.update(override_throttle));
+}
+
+static bool taskStabilize_AltitudeValid(void)
+{
+#if CONFIG_ALTITUDE_ESTIMATOR_ENABLE
+    AltitudeEstimate altitude;
+    altitude_estimator.getEstimate(altitude);
+    return altitude.valid;
+#else
+    return false;
+#endif
+}
+
 void taskStabilize_Emergency(void)
 {
     // 紧急状态
@@ -100,14 +138,28 @@ void taskStabilize_Emergency(void)
     chassis.setTargetAttitude(0.0f, 0.0f, chassis.getCurrentYaw());
 }
 
-void taskStabilize_Update(void)
+static void taskStabilize_SelectMode(void);
+
+void taskStabilize_Control(void)
 {
-    chassis.update();
-    osDelay(2);
+    StabilizeMode prev_mode = stabilize_mode;
+    taskStabilize_SelectMode();
+    // 只在停机时允许后台零偏与加速度计校准 (紧急模式仍有缓降油门)，油门回零期间的振动由静止判定排除
+    attitude_manager.enableGyroCalibration(stabilize_mode == StabilizeMode::STOP);
+    attitude_manager.enableAccelCalibration(stabilize_mode == StabilizeMode::STOP);
+    // 进入停机 (上锁) 时导出本次飞行的延迟直方图
+    if(stabilize_mode == StabilizeMode::STOP && prev_mode != StabilizeMode::STOP)
+    {
+        control_pipeline.getLatency().dumpStart();
+    }
 }
 
+bool taskStabilize_IsStopped(void)
+{
+    return stabilize_mode == StabilizeMode::STOP;
+}
 
-void taskStabilize_Control(void)
+static void taskStabilize_SelectMode(void)
 {
     // 读取手柄是否链接
     bool gs_is_connected = GS_IS_CONNECTED;
@@ -128,19 +180,22 @@ void taskStabilize_Control(void)
     if(!gs_is_connected)
     {
         // 进入紧急状态
+        stabilize_mode = StabilizeMode::EMERGENCY;
         taskStabilize_Emergency();
         return;
     }
     if(force_emergency)
     {
         // 强制进入紧急状态
+        stabilize_mode = StabilizeMode::EMERGENCY;
         taskStabilize_Emergency();
         return;
     }
-    //手柄链接状态，但未启动自稳，说明是停机模式
-    if(!activate_stabilize)
+    //手柄链接状态，但未启动自稳，说明是停机模式；陀螺仪零偏未校准或启动序列有阶段失败时同样保持停机
+    if(!activate_stabilize || !attitude_manager.isGyroCalibrated() || !taskManager_BootSucceeded())
     {
         // 进入停机状态
+        stabilize_mode = StabilizeMode::STOP;
         taskStabilize_Stop();
         return;
     }
@@ -148,31 +203,47 @@ void taskStabilize_Control(void)
     if(!activate_auto)
     {
         // 进入手动控制状态
+        stabilize_mode = StabilizeMode::MANUAL;
         taskStabilize_Manual();
         return;
     }
     // 手柄链接状态，且启动了自稳，且启动了自动控制，说明是自动控制模式
-    // 但雷达掉线，说明是紧急控制模式
+    // 但雷达掉线，高度估计仍有效时按气压/惯导高度缓降，否则进入紧急控制模式
+    if(!lidar_is_connected && taskStabilize_AltitudeValid())
+    {
+        if(stabilize_mode != StabilizeMode::DESCEND)
+        {
+            float x, y, z;
+            move.getCurrentPosition(x, y, z);
+            descend_target_z = z;
+            descend_last_tick = osKernelGetTickCount();
+        }
+        // 缓降由位置环作业 taskStabilize_Position 周期性更新
+        stabilize_mode = StabilizeMode::DESCEND;
+        return;
+    }
     if(!lidar_is_connected)
     {
         // 进入紧急控制状态
+        stabilize_mode = StabilizeMode::EMERGENCY;
         taskStabilize_Emergency();
         return;
     }
     // 手柄链接状态，且启动了自稳，且启动了自动控制，且雷达正常链接，说明是自动控制模式
-    taskStabilize_Auto();
+    // 自动模式的目标由位置环作业 taskStabilize_Position 周期性更新
+    stabilize_mode = StabilizeMode::AUTO;
 }
 
-void taskStabilize(void *argument)
+void taskStabilize_Position(void)
 {
-    static bool gs_is_connected_prev = false;
-    osDelay(1000);
-    taskStabilize_Init();
-    osDelay(1000);
-    
-    while (1)
+    if(stabilize_mode == StabilizeMode::DESCEND)
+    {
+        taskStabilize_Descend();
+        return;
+    }
+    if(stabilize_mode != StabilizeMode::AUTO)
     {
-        taskStabilize_Control();
-        taskStabilize_Update();
-	}
+        return;
+    }
+    taskStabilize_Auto();
 }
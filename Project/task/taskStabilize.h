@@ -3,6 +3,42 @@
 #include "main.h"
 #include "cmsis_os.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
 
+/**
+ * @brief 初始化电机输出 (执行器单次作业)
+ */
+void taskStabilize_Init_Motor(void);
+
+/**
+ * @brief 电机给零油门完成解锁 (执行器单次作业)
+ */
+void taskStabilize_Arm_Motor(void);
+
+/**
+ * @brief 初始化底盘并启用控制流水线 (执行器单次作业)
+ */
+void taskStabilize_Init(void);
+
+/**
+ * @brief 根据手柄与雷达状态判定控制模式并更新目标姿态与油门 (执行器周期作业)
+ */
+void taskStabilize_Control(void);
+
+/**
+ * @brief 自动模式下的位置环，雷达掉线时改为按高度估计缓降 (执行器周期作业)
+ */
+void taskStabilize_Position(void);
+
+/**
+ * @brief 当前是否处于停机模式 (电机停转)
+ */
+bool taskStabilize_IsStopped(void);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif // TASK_STABILIZE_H
\ No newline at end of file
@@ -0,0 +1,130 @@
+// histogram.h
+#ifndef __UTILS_MATH_HISTOGRAM_H__
+#define __UTILS_MATH_HISTOGRAM_H__
+
+#ifdef __cplusplus
+
+#include <stdint.h>
+#include <math.h>
+
+namespace utils {
+
+/**
+ * @brief 等宽区间在线直方图
+ * @details 记录样本落入 [i*w, (i+1)*w) 区间的次数，超出范围的计入溢出区间，
+ *          同时维护计数、最值与均值方差，记录一次为常数时间，不分配内存。
+ *          仅允许单个写者，其他线程读取统计值时可能看到未完成的更新。
+ * @tparam Bins 区间数
+ */
+template<uint32_t Bins>
+class Histogram
+{
+public:
+    explicit Histogram(float bin_width) : bin_width_(bin_width > 0.0f ? bin_width : 1.0f)
+    {
+        reset();
+    }
+
+    /**
+     * @brief 记录一个样本，负值按 0 计
+     */
+    void record(float value)
+    {
+        if (value < 0.0f)
+        {
+            value = 0.0f;
+        }
+        uint32_t index = (uint32_t)(value / bin_width_);
+        if (index < Bins)
+        {
+            bins_[index]++;
+        }
+        else
+        {
+            overflow_++;
+        }
+
+        if (count_ == 0 || value < min_)
+        {
+            min_ = value;
+        }
+        if (count_ == 0 || value > max_)
+        {
+            max_ = value;
+        }
+        count_++;
+        // Welford 递推均值与方差
+        float delta = value - mean_;
+        mean_ += delta / (float)count_;
+        m2_ += delta * (value - mean_);
+    }
+
+    void reset()
+    {
+        for (uint32_t i = 0; i < Bins; i++)
+        {
+            bins_[i] = 0;
+        }
+        overflow_ = 0;
+        count_ = 0;
+        min_ = 0.0f;
+        max_ = 0.0f;
+        mean_ = 0.0f;
+        m2_ = 0.0f;
+    }
+
+    uint32_t count() const { return count_; }
+    float min() const { return min_; }
+    float max() const { return max_; }
+    float mean() const { return mean_; }
+    float stddev() const { return count_ > 1 ? sqrtf(m2_ / (float)(count_ - 1)) : 0.0f; }
+
+    /**
+     * @brief 估计分位数，返回所在区间的上沿 (落入溢出区间时返回最大值)
+     * @param p 分位 (0~1)
+     */
+    float percentile(float p) const
+    {
+        if (count_ == 0)
+        {
+            return 0.0f;
+        }
+        uint32_t target = (uint32_t)ceilf(p * (float)count_);
+        if (target == 0)
+        {
+            target = 1;
+        }
+        uint32_t sum = 0;
+        for (uint32_t i = 0; i < Bins; i++)
+        {
+            sum += bins_[i];
+            if (sum >= target)
+            {
+                float upper = (float)(i + 1) * bin_width_;
+                return upper < max_ ? upper : max_;
+            }
+        }
+        return max_;
+    }
+
+    uint32_t bin(uint32_t index) const { return index < Bins ? bins_[index] : 0; }
+    uint32_t overflow() const { return overflow_; }
+    float binWidth() const { return bin_width_; }
+    static constexpr uint32_t binCount() { return Bins; }
+
+private:
+    float bin_width_;
+    uint32_t bins_[Bins];
+    uint32_t overflow_;
+    uint32_t count_;
+    float min_;
+    float max_;
+    float mean_;
+    float m2_;
+};
+
+} // namespace utils
+
+#endif // __cplusplus
+
+#endif // __UTILS_MATH_HISTOGRAM_H__
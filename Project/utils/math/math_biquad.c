@@ -0,0 +1,85 @@
+#include "math_biquad.h"
+#include "math_const.h"
+#include <math.h>
+
+// 按 a0 归一化后写入系数
+static void biquad_normalize(BiquadCoeffs_t *c, float b0, float b1, float b2, float a0, float a1, float a2) {
+    c->b0 = b0 / a0;
+    c->b1 = b1 / a0;
+    c->b2 = b2 / a0;
+    c->a1 = a1 / a0;
+    c->a2 = a2 / a0;
+}
+
+// 直通
+void Biquad_Passthrough(BiquadCoeffs_t *c) {
+    if (!c) {
+        return;
+    }
+    c->b0 = 1.0f;
+    c->b1 = 0.0f;
+    c->b2 = 0.0f;
+    c->a1 = 0.0f;
+    c->a2 = 0.0f;
+}
+
+// 二阶低通
+void Biquad_Lowpass(BiquadCoeffs_t *c, float sampleFreq, float cutoffFreq, float q) {
+    if (!c) {
+        return;
+    }
+    if (cutoffFreq <= 0.0f || q <= 0.0f || cutoffFreq >= sampleFreq / 2.0f) {
+        Biquad_Passthrough(c);
+        return;
+    }
+
+    const float omega = 2.0f * M_PI * cutoffFreq / sampleFreq;
+    const float sn = sinf(omega);
+    const float cs = cosf(omega);
+    const float alpha = sn / (2.0f * q);
+
+    biquad_normalize(c, (1.0f - cs) / 2.0f, 1.0f - cs, (1.0f - cs) / 2.0f,
+                     1.0f + alpha, -2.0f * cs, 1.0f - alpha);
+}
+
+// 陷波，q = 中心频率 / -3dB 带宽
+void Biquad_Notch(BiquadCoeffs_t *c, float sampleFreq, float centerFreq, float q) {
+    if (!c) {
+        return;
+    }
+    if (centerFreq <= 0.0f || q <= 0.0f || centerFreq >= sampleFreq / 2.0f) {
+        Biquad_Passthrough(c);
+        return;
+    }
+
+    const float omega = 2.0f * M_PI * centerFreq / sampleFreq;
+    const float sn = sinf(omega);
+    const float cs = cosf(omega);
+    const float alpha = sn / (2.0f * q);
+
+    biquad_normalize(c, 1.0f, -2.0f * cs, 1.0f,
+                     1.0f + alpha, -2.0f * cs, 1.0f - alpha);
+}
+
+// 带阻，阻带为 [lowFreq, highFreq]，中心取几何平均
+void Biquad_Bandstop(BiquadCoeffs_t *c, float sampleFreq, float lowFreq, float highFreq) {
+    if (!c) {
+        return;
+    }
+    if (lowFreq <= 0.0f || highFreq <= lowFreq) {
+        Biquad_Passthrough(c);
+        return;
+    }
+
+    const float center = sqrtf(lowFreq * highFreq);
+    Biquad_Notch(c, sampleFreq, center, center / (highFreq - lowFreq));
+}
+
+// 巴特沃斯极点对的品质因子：Q_k = 1 / (2 sin((2k+1) pi / 2N))，阶数 N = 2*stages
+float Biquad_ButterworthQ(uint32_t stages, uint32_t stage) {
+    if (stages == 0 || stage >= stages) {
+        return 0.70710678f;
+    }
+    const float order = 2.0f * (float)stages;
+    return 1.0f / (2.0f * sinf((2.0f * (float)stage + 1.0f) * M_PI / (2.0f * order)));
+}
@@ -0,0 +1,251 @@
+#ifndef __MATH_BIQUAD_H__
+#define __MATH_BIQUAD_H__
+
+#include <stdint.h>
+
+// 目标平台使用 CMSIS-DSP 块处理，主机编译 (仿真/离线分析) 使用可移植实现
+#ifndef MATH_BIQUAD_USE_CMSIS
+#if defined(__arm__) || defined(__ARMCC_VERSION)
+#define MATH_BIQUAD_USE_CMSIS 1
+#else
+#define MATH_BIQUAD_USE_CMSIS 0
+#endif
+#endif
+
+#if MATH_BIQUAD_USE_CMSIS
+#include "arm_math.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 二阶节 (biquad) 系数，已按 a0 归一化
+ * @details y[n] = b0*x[n] + b1*x[n-1] + b2*x[n-2] - a1*y[n-1] - a2*y[n-2]
+ */
+typedef struct {
+    float b0;
+    float b1;
+    float b2;
+    float a1;
+    float a2;
+} BiquadCoeffs_t;
+
+// 系数设计 (RBJ Audio EQ Cookbook)，频率参数超出奈奎斯特频率或非正时退化为直通
+void Biquad_Passthrough(BiquadCoeffs_t *c);
+void Biquad_Lowpass(BiquadCoeffs_t *c, float sampleFreq, float cutoffFreq, float q);
+void Biquad_Notch(BiquadCoeffs_t *c, float sampleFreq, float centerFreq, float q);
+void Biquad_Bandstop(BiquadCoeffs_t *c, float sampleFreq, float lowFreq, float highFreq);
+
+// 2N 阶巴特沃斯低通中第 stage 个二阶节的品质因子
+float Biquad_ButterworthQ(uint32_t stages, uint32_t stage);
+
+/**
+ * @brief 单通道单节转置直接II型滤波
+ * @param state 状态变量 [d1, d2]
+ */
+static inline float Biquad_Apply(const BiquadCoeffs_t *c, float state[2], float x)
+{
+    const float y = c->b0 * x + state[0];
+    state[0] = c->b1 * x - c->a1 * y + state[1];
+    state[1] = c->b2 * x - c->a2 * y;
+    return y;
+}
+
+#ifdef __cplusplus
+}
+
+namespace utils {
+
+/**
+ * @brief 多通道级联二阶节滤波器组
+ * @details 所有通道共用同一组级联系数 (如陀螺仪三轴)，转置直接II型结构。
+ *          样本按通道分组存放 (结构数组)：data[ch] 指向该通道连续的 block 个样本，
+ *          目标平台上每个通道调用一次 arm_biquad_cascade_df2T_f32，主机上使用等价的标量实现。
+ *          单样本的 apply() 以节为外层、通道为内层循环，避免逐样本调用 CMSIS 的开销。
+ *          非线程安全，配置与滤波应在同一线程中进行。
+ * @tparam Channels 通道数
+ * @tparam MaxStages 最大级联节数
+ */
+template<uint32_t Channels, uint32_t MaxStages>
+class BiquadBank
+{
+public:
+    BiquadBank() : stages_(0)
+    {
+        reset();
+#if MATH_BIQUAD_USE_CMSIS
+        bindInstances();
+#endif
+    }
+
+    /**
+     * @brief 设置第 stage 节的系数，节数随之扩展到 stage+1
+     * @return stage 超出范围时返回 false
+     */
+    bool setStage(uint32_t stage, const BiquadCoeffs_t &c)
+    {
+        if (stage >= MaxStages)
+        {
+            return false;
+        }
+        // CMSIS 约定：反馈系数取反存放
+        float *dst = &coeffs_[5 * stage];
+        dst[0] = c.b0;
+        dst[1] = c.b1;
+        dst[2] = c.b2;
+        dst[3] = -c.a1;
+        dst[4] = -c.a2;
+        if (stage >= stages_)
+        {
+            for (uint32_t s = stages_; s < stage; s++)
+            {
+                setPassthrough(s);
+            }
+            stages_ = stage + 1;
+#if MATH_BIQUAD_USE_CMSIS
+            bindInstances();
+#endif
+        }
+        return true;
+    }
+
+    /**
+     * @brief 清空全部节，滤波器变为直通
+     */
+    void clear()
+    {
+        stages_ = 0;
+        reset();
+#if MATH_BIQUAD_USE_CMSIS
+        bindInstances();
+#endif
+    }
+
+    /**
+     * @brief 配置为 2*stages 阶巴特沃斯低通，占用前 stages 节
+     * @return stages 为 0 或超出范围时返回 false
+     */
+    bool setLowpass(float sampleFreq, float cutoffFreq, uint32_t stages = 1)
+    {
+        if (stages == 0 || stages > MaxStages)
+        {
+            return false;
+        }
+        clear();
+        for (uint32_t s = 0; s < stages; s++)
+        {
+            BiquadCoeffs_t c;
+            Biquad_Lowpass(&c, sampleFreq, cutoffFreq, Biquad_ButterworthQ(stages, s));
+            setStage(s, c);
+        }
+        return true;
+    }
+
+    /**
+     * @brief 清零所有通道的状态变量
+     */
+    void reset()
+    {
+        for (uint32_t ch = 0; ch < Channels; ch++)
+        {
+            for (uint32_t i = 0; i < 2 * MaxStages; i++)
+            {
+                state_[ch][i] = 0.0f;
+            }
+        }
+    }
+
+    /**
+     * @brief 就地滤波每个通道的一段连续样本
+     * @param data 各通道的样本数组
+     * @param block 每个通道的样本数
+     */
+    void process(float *const data[Channels], uint32_t block)
+    {
+        if (stages_ == 0 || block == 0)
+        {
+            return;
+        }
+        for (uint32_t ch = 0; ch < Channels; ch++)
+        {
+#if MATH_BIQUAD_USE_CMSIS
+            arm_biquad_cascade_df2T_f32(&instances_[ch], data[ch], data[ch], block);
+#else
+            float *x = data[ch];
+            for (uint32_t n = 0; n < block; n++)
+            {
+                float y = x[n];
+                for (uint32_t s = 0; s < stages_; s++)
+                {
+                    y = step(s, state_[ch][2 * s], state_[ch][2 * s + 1], y);
+                }
+                x[n] = y;
+            }
+#endif
+        }
+    }
+
+    /**
+     * @brief 就地滤波所有通道的一个样本
+     * @param x 各通道的当前样本
+     */
+    void apply(float x[Channels])
+    {
+        for (uint32_t s = 0; s < stages_; s++)
+        {
+            for (uint32_t ch = 0; ch < Channels; ch++)
+            {
+                x[ch] = step(s, state_[ch][2 * s], state_[ch][2 * s + 1], x[ch]);
+            }
+        }
+    }
+
+    uint32_t stages() const { return stages_; }
+    static constexpr uint32_t channels() { return Channels; }
+
+private:
+    float coeffs_[5 * MaxStages];
+    float state_[Channels][2 * MaxStages]; // 每个通道 [d1, d2] x 节数，与 CMSIS 状态布局一致
+    uint32_t stages_;
+#if MATH_BIQUAD_USE_CMSIS
+    arm_biquad_cascade_df2T_instance_f32 instances_[Channels];
+
+    void bindInstances()
+    {
+        for (uint32_t ch = 0; ch < Channels; ch++)
+        {
+            // 只绑定指针与节数，不清零状态
+            instances_[ch].numStages = (uint8_t)stages_;
+            instances_[ch].pCoeffs = coeffs_;
+            instances_[ch].pState = state_[ch];
+        }
+    }
+#endif
+
+    float step(uint32_t s, float &d1, float &d2, float x) const
+    {
+        const float *c = &coeffs_[5 * s];
+        const float y = c[0] * x + d1;
+        d1 = c[1] * x + c[3] * y + d2;
+        d2 = c[2] * x + c[4] * y;
+        return y;
+    }
+
+    void setPassthrough(uint32_t s)
+    {
+        float *dst = &coeffs_[5 * s];
+        dst[0] = 1.0f;
+        dst[1] = 0.0f;
+        dst[2] = 0.0f;
+        dst[3] = 0.0f;
+        dst[4] = 0.0f;
+    }
+};
+
+} // namespace utils
+
+#endif // __cplusplus
+
+#endif // __MATH_BIQUAD_H__
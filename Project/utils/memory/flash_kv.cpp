@@ -0,0 +1,414 @@
+// flash_kv.cpp
+#include "flash_kv.h"
+#include <string.h>
+
+namespace utils {
+
+namespace {
+
+const uint32_t SECTOR_MAGIC = 0x564B5841u; // "AXKV"
+const uint16_t BLANK_KEY = 0xFFFFu;
+
+// 扇区头，占用扇区的第一个编程单元
+struct SectorHeader
+{
+    uint32_t magic;
+    uint16_t format;
+    uint16_t reserved;
+    uint32_t sequence; // 每次整理后加一，两个扇区都有效时取较新的
+    uint32_t crc;      // 前 12 字节的 CRC
+};
+
+// 记录头，数据紧随其后，整条记录按编程单元对齐
+struct RecordHeader
+{
+    uint16_t key;
+    uint16_t version;
+    uint16_t size;
+    uint16_t reserved;
+    uint32_t crc;      // 前 8 字节与数据的 CRC
+};
+
+const uint32_t RECORD_HEADER_SIZE = sizeof(RecordHeader);
+
+// 半字节查表，表只有 64 字节
+const uint32_t CRC32_TABLE[16] = {
+    0x00000000u, 0x1DB71064u, 0x3B6E20C8u, 0x26D930ACu,
+    0x76DC4190u, 0x6B6B51F4u, 0x4DB26158u, 0x5005713Cu,
+    0xEDB88320u, 0xF00F9344u, 0xD6D6A3E8u, 0xCB61B38Cu,
+    0x9B64C2B0u, 0x86D3D2D4u, 0xA00AE278u, 0xBDBDF21Cu,
+};
+
+uint32_t recordCrc(const RecordHeader& header, const void* data)
+{
+    uint32_t crc = crc32(0, &header, offsetof(RecordHeader, crc));
+    return crc32(crc, data, header.size);
+}
+
+bool isBlank(const uint8_t* data, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++)
+    {
+        if (data[i] != 0xFFu)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+uint32_t crc32(uint32_t crc, const void* data, uint32_t size)
+{
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (uint32_t i = 0; i < size; i++)
+    {
+        crc ^= p[i];
+        crc = (crc >> 4) ^ CRC32_TABLE[crc & 0x0Fu];
+        crc = (crc >> 4) ^ CRC32_TABLE[crc & 0x0Fu];
+    }
+    return ~crc;
+}
+
+FlashKV::FlashKV(FlashDevice* device)
+    : device_(device), mounted_(false), active_(0), sequence_(0), write_offset_(0), unit_(0),
+      key_count_(0), corrupt_count_(0)
+{
+}
+
+bool FlashKV::mount()
+{
+    mounted_ = false;
+    if (device_ == nullptr || device_->sectorCount() < 2)
+    {
+        return false;
+    }
+    unit_ = device_->programUnit();
+    if (unit_ < sizeof(SectorHeader) || unit_ > sizeof(buffer_) - MAX_VALUE)
+    {
+        return false;
+    }
+
+    uint32_t seq0 = 0, seq1 = 0;
+    bool valid0 = readSectorHeader(0, seq0);
+    bool valid1 = readSectorHeader(1, seq1);
+    if (!valid0 && !valid1)
+    {
+        return format();
+    }
+
+    if (valid0 && valid1)
+    {
+        active_ = ((int32_t)(seq1 - seq0) > 0) ? 1 : 0;
+    }
+    else
+    {
+        active_ = valid0 ? 0 : 1;
+    }
+    sequence_ = (active_ == 0) ? seq0 : seq1;
+
+    scan();
+    mounted_ = true;
+    return true;
+}
+
+bool FlashKV::format()
+{
+    mounted_ = false;
+    if (device_ == nullptr || unit_ == 0)
+    {
+        return false;
+    }
+    // 先擦除另一扇区，避免其中较新的扇区头在下次挂载时胜出
+    if (!device_->erase(1) || !formatSector(0, 1))
+    {
+        return false;
+    }
+    active_ = 0;
+    sequence_ = 1;
+    write_offset_ = unit_;
+    key_count_ = 0;
+    mounted_ = true;
+    return true;
+}
+
+bool FlashKV::get(uint16_t key, void* data, uint32_t size, uint16_t version) const
+{
+    const IndexEntry* entry = find(key);
+    if (!mounted_ || entry == nullptr)
+    {
+        return false;
+    }
+    RecordHeader header;
+    if (!device_->read(active_, entry->offset, &header, RECORD_HEADER_SIZE) ||
+        header.size != size || header.version != version)
+    {
+        return false;
+    }
+    return device_->read(active_, entry->offset + RECORD_HEADER_SIZE, data, size);
+}
+
+bool FlashKV::set(uint16_t key, const void* data, uint32_t size, uint16_t version)
+{
+    if (!mounted_ || key == BLANK_KEY || size > MAX_VALUE)
+    {
+        return false;
+    }
+
+    IndexEntry* entry = find(key);
+    if (entry != nullptr)
+    {
+        // 内容未变化时不写入，减少磨损
+        RecordHeader header;
+        if (device_->read(active_, entry->offset, &header, RECORD_HEADER_SIZE) &&
+            header.size == size && header.version == version &&
+            device_->read(active_, entry->offset + RECORD_HEADER_SIZE, buffer_, size) &&
+            memcmp(buffer_, data, size) == 0)
+        {
+            return true;
+        }
+    }
+    else if (key_count_ >= MAX_KEYS)
+    {
+        return false;
+    }
+
+    const uint32_t length = align(RECORD_HEADER_SIZE + size);
+    if (write_offset_ + length > device_->sectorSize())
+    {
+        if (!compact() || write_offset_ + length > device_->sectorSize())
+        {
+            return false;
+        }
+        entry = find(key);
+    }
+
+    RecordHeader header;
+    header.key = key;
+    header.version = version;
+    header.size = (uint16_t)size;
+    header.reserved = 0xFFFFu;
+    header.crc = recordCrc(header, data);
+
+    memset(buffer_, 0xFF, length);
+    memcpy(buffer_, &header, RECORD_HEADER_SIZE);
+    memcpy(buffer_ + RECORD_HEADER_SIZE, data, size);
+
+    const uint32_t offset = write_offset_;
+    // 写入失败时该段空间状态未知，同样跳过
+    write_offset_ += length;
+    if (!device_->program(active_, offset, buffer_, length))
+    {
+        return false;
+    }
+
+    if (entry == nullptr)
+    {
+        entry = &index_[key_count_++];
+        entry->key = key;
+    }
+    entry->offset = offset;
+    return true;
+}
+
+bool FlashKV::readSectorHeader(uint32_t sector, uint32_t& sequence)
+{
+    SectorHeader header;
+    if (!device_->read(sector, 0, &header, sizeof(header)))
+    {
+        return false;
+    }
+    if (header.magic != SECTOR_MAGIC || header.format != FORMAT_VERSION ||
+        header.crc != crc32(0, &header, offsetof(SectorHeader, crc)))
+    {
+        return false;
+    }
+    sequence = header.sequence;
+    return true;
+}
+
+bool FlashKV::writeSectorHeader(uint32_t sector, uint32_t sequence)
+{
+    SectorHeader header;
+    header.magic = SECTOR_MAGIC;
+    header.format = FORMAT_VERSION;
+    header.reserved = 0xFFFFu;
+    header.sequence = sequence;
+    header.crc = crc32(0, &header, offsetof(SectorHeader, crc));
+
+    memset(buffer_, 0xFF, unit_);
+    memcpy(buffer_, &header, sizeof(header));
+    return device_->program(sector, 0, buffer_, unit_);
+}
+
+bool FlashKV::formatSector(uint32_t sector, uint32_t sequence)
+{
+    return device_->erase(sector) && writeSectorHeader(sector, sequence);
+}
+
+void FlashKV::scan()
+{
+    key_count_ = 0;
+    const uint32_t end = device_->sectorSize();
+    uint32_t offset = unit_;
+
+    // 只读记录头，建立各键最新记录的索引
+    while (offset + unit_ <= end)
+    {
+        RecordHeader header;
+        bool readable = device_->read(active_, offset, &header, RECORD_HEADER_SIZE);
+        if (readable && header.key == BLANK_KEY && header.size == 0xFFFFu)
+        {
+            // 整个编程单元都是擦除值才算日志结束，写入中途掉电的单元不能再次编程
+            readable = device_->read(active_, offset, buffer_, unit_);
+            if (readable && isBlank(buffer_, unit_))
+            {
+                break;
+            }
+        }
+        const uint32_t length = align(RECORD_HEADER_SIZE + header.size);
+        if (!readable || header.key == BLANK_KEY || header.size > MAX_VALUE || offset + length > end)
+        {
+            // 记录头损坏，无法确定后续位置：剩余空间不再使用，下次写入时整理
+            corrupt_count_++;
+            offset = end;
+            break;
+        }
+        IndexEntry* entry = find(header.key);
+        if (entry == nullptr && key_count_ < MAX_KEYS)
+        {
+            entry = &index_[key_count_++];
+            entry->key = header.key;
+        }
+        if (entry != nullptr)
+        {
+            entry->offset = offset;
+        }
+        offset += length;
+    }
+    write_offset_ = offset;
+
+    // 校验各键最新记录，损坏 (写入中途掉电) 时回退到该键更早的有效记录
+    for (uint32_t i = 0; i < key_count_;)
+    {
+        uint32_t length;
+        if (readRecord(active_, index_[i].offset, length, true))
+        {
+            i++;
+            continue;
+        }
+        corrupt_count_++;
+
+        bool found = false;
+        uint32_t fallback = 0;
+        for (uint32_t pos = unit_; pos < index_[i].offset; pos += length)
+        {
+            RecordHeader header;
+            if (!device_->read(active_, pos, &header, RECORD_HEADER_SIZE))
+            {
+                break;
+            }
+            length = align(RECORD_HEADER_SIZE + header.size);
+            uint32_t checked;
+            if (header.key == index_[i].key && readRecord(active_, pos, checked, true))
+            {
+                fallback = pos;
+                found = true;
+            }
+        }
+        if (found)
+        {
+            index_[i].offset = fallback;
+            i++;
+        }
+        else
+        {
+            index_[i] = index_[--key_count_];
+        }
+    }
+}
+
+bool FlashKV::readRecord(uint32_t sector, uint32_t offset, uint32_t& length, bool verify)
+{
+    RecordHeader header;
+    if (!device_->read(sector, offset, &header, RECORD_HEADER_SIZE) || header.size > MAX_VALUE)
+    {
+        return false;
+    }
+    length = align(RECORD_HEADER_SIZE + header.size);
+    if (!device_->read(sector, offset, buffer_, RECORD_HEADER_SIZE + header.size))
+    {
+        return false;
+    }
+    // 对齐填充保持擦除值，整条记录可原样搬移
+    memset(buffer_ + RECORD_HEADER_SIZE + header.size, 0xFF, length - RECORD_HEADER_SIZE - header.size);
+    return !verify || header.crc == recordCrc(header, buffer_ + RECORD_HEADER_SIZE);
+}
+
+FlashKV::IndexEntry* FlashKV::find(uint16_t key)
+{
+    for (uint32_t i = 0; i < key_count_; i++)
+    {
+        if (index_[i].key == key)
+        {
+            return &index_[i];
+        }
+    }
+    return nullptr;
+}
+
+const FlashKV::IndexEntry* FlashKV::find(uint16_t key) const
+{
+    for (uint32_t i = 0; i < key_count_; i++)
+    {
+        if (index_[i].key == key)
+        {
+            return &index_[i];
+        }
+    }
+    return nullptr;
+}
+
+bool FlashKV::compact()
+{
+    const uint32_t target = (active_ == 0) ? 1 : 0;
+    if (!device_->erase(target))
+    {
+        return false;
+    }
+
+    // 各键最新记录依次搬到目标扇区，全部写完后才写扇区头，中途掉电时旧扇区仍然有效
+    uint32_t offsets[MAX_KEYS];
+    uint32_t offset = unit_;
+    for (uint32_t i = 0; i < key_count_; i++)
+    {
+        uint32_t length;
+        if (!readRecord(active_, index_[i].offset, length, false))
+        {
+            return false;
+        }
+        if (!device_->program(target, offset, buffer_, length))
+        {
+            return false;
+        }
+        offsets[i] = offset;
+        offset += length;
+    }
+    if (!writeSectorHeader(target, sequence_ + 1))
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < key_count_; i++)
+    {
+        index_[i].offset = offsets[i];
+    }
+    active_ = target;
+    sequence_++;
+    write_offset_ = offset;
+    return true;
+}
+
+} // namespace utils
@@ -0,0 +1,138 @@
+// flash_kv.h
+#ifndef __UTILS_MEMORY_FLASH_KV_H__
+#define __UTILS_MEMORY_FLASH_KV_H__
+
+#ifdef __cplusplus
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace utils {
+
+/**
+ * @brief 扇区式闪存设备抽象
+ * @details 只要求按扇区擦除、按编程单元对齐写入，擦除后的内容为 0xFF，
+ *          同一编程单元擦除后只写一次。片内闪存与主机上的文件模拟均实现此接口
+ */
+class FlashDevice
+{
+public:
+    virtual uint32_t sectorSize() const = 0;   // 扇区大小，单位：字节
+    virtual uint32_t sectorCount() const = 0;  // 可用扇区数
+    virtual uint32_t programUnit() const = 0;  // 编程单元大小，单位：字节
+
+    /**
+     * @brief 读取扇区内数据
+     */
+    virtual bool read(uint32_t sector, uint32_t offset, void* data, uint32_t size) = 0;
+
+    /**
+     * @brief 写入扇区内数据，offset 与 size 须为编程单元的整数倍
+     */
+    virtual bool program(uint32_t sector, uint32_t offset, const void* data, uint32_t size) = 0;
+
+    /**
+     * @brief 擦除整个扇区
+     */
+    virtual bool erase(uint32_t sector) = 0;
+
+    virtual ~FlashDevice() = default;
+};
+
+/**
+ * @brief 磨损均衡的闪存键值存储
+ * @details 两个扇区轮换的日志结构：每次 set() 在当前扇区末尾追加一条记录 (键、版本、长度、CRC32 与数据)，
+ *          同一键以最新的有效记录为准，扇区写满时把各键的最新记录整理到另一扇区，
+ *          最后写入带递增序号的扇区头完成切换，整理中途掉电时旧扇区仍然有效。
+ *          写入中途掉电的记录 CRC 不符或读取失败 (片内闪存 ECC 双位错误)，挂载时回退到该键更早的有效记录，
+ *          残缺的编程单元不会再次写入。
+ *          每条记录占用新的编程单元，所有编程单元轮流使用，擦除次数均摊到整个扇区。
+ *          mount() 只遍历记录头建立索引并校验各键最新记录的 CRC，之后 get() 直接按索引读取。
+ *          mount()/get() 与 set() 不可并发调用；片内闪存擦写期间 CPU 取指会停顿，
+ *          set() 只应在电机停转时调用。
+ */
+class FlashKV
+{
+public:
+    static const uint32_t MAX_KEYS = 32;     // 最多容纳的键数
+    static const uint32_t MAX_VALUE = 224;   // 单条记录数据的最大长度，单位：字节
+    static const uint16_t FORMAT_VERSION = 1;
+
+    explicit FlashKV(FlashDevice* device);
+
+    /**
+     * @brief 挂载存储，建立键索引
+     * @details 没有有效扇区时格式化第一个扇区
+     * @return 是否成功
+     */
+    bool mount();
+
+    /**
+     * @brief 读取一个键的值
+     * @param key 键，0xFFFF 保留
+     * @param data 输出缓冲区
+     * @param size 期望的数据长度，与存储的长度不同时视为不存在
+     * @param version 期望的数据格式版本，与存储的版本不同时视为不存在
+     * @return 是否读到
+     */
+    bool get(uint16_t key, void* data, uint32_t size, uint16_t version) const;
+
+    /**
+     * @brief 写入一个键的值
+     * @details 与已存储内容完全相同时不写入；空间不足时先整理再写入
+     * @return 是否成功
+     */
+    bool set(uint16_t key, const void* data, uint32_t size, uint16_t version);
+
+    /**
+     * @brief 删除全部内容并重新格式化
+     */
+    bool format();
+
+    bool isMounted() const { return mounted_; }
+    uint32_t getKeyCount() const { return key_count_; }
+    uint32_t getUsedBytes() const { return write_offset_; }
+    uint32_t getSequence() const { return sequence_; }   // 整理次数 + 1
+    uint32_t getCorruptCount() const { return corrupt_count_; }
+
+private:
+    struct IndexEntry
+    {
+        uint16_t key;
+        uint32_t offset; // 最新记录在当前扇区内的偏移
+    };
+
+    FlashDevice* device_;
+    bool mounted_;
+    uint32_t active_;       // 当前扇区
+    uint32_t sequence_;
+    uint32_t write_offset_; // 下一条记录的写入偏移
+    uint32_t unit_;
+
+    IndexEntry index_[MAX_KEYS];
+    uint32_t key_count_;
+    uint32_t corrupt_count_;
+
+    uint8_t buffer_[MAX_VALUE + 32]; // 记录组装/搬移缓冲区，不小于最大记录长度
+
+    uint32_t align(uint32_t size) const { return (size + unit_ - 1) / unit_ * unit_; }
+    bool readSectorHeader(uint32_t sector, uint32_t& sequence);
+    bool writeSectorHeader(uint32_t sector, uint32_t sequence);
+    bool formatSector(uint32_t sector, uint32_t sequence);
+    void scan();
+    bool readRecord(uint32_t sector, uint32_t offset, uint32_t& length, bool verify);
+    IndexEntry* find(uint16_t key);
+    const IndexEntry* find(uint16_t key) const;
+    bool compact();
+};
+
+/**
+ * @brief CRC-32 (IEEE 802.3)，可分段计算，首段 crc 传 0
+ */
+uint32_t crc32(uint32_t crc, const void* data, uint32_t size);
+
+} // namespace utils
+
+#endif // __cplusplus
+
+#endif // __UTILS_MEMORY_FLASH_KV_H__
@@ -0,0 +1,76 @@
+// seqlock.h
+#ifndef __UTILS_MEMORY_SEQLOCK_H__
+#define __UTILS_MEMORY_SEQLOCK_H__
+
+#ifdef __cplusplus
+
+#include <atomic>
+#include <stdint.h>
+
+namespace utils {
+
+/**
+ * @brief 单写者多读者的无锁快照 (双副本 seqlock)
+ * @details 写者先将序号加一 (奇数) 使读者转向副本1，改写副本0，
+ *          再将序号加一 (偶数) 使读者转向副本0，最后改写副本1。
+ *          读者按序号奇偶选择当前稳定的副本拷贝，拷贝前后序号不变即视为一致。
+ *          读者无需等待写者完成，即使高优先级读者抢占了写者也不会自旋，
+ *          全程不关中断、不使用互斥量。
+ * @tparam T 快照类型，须可平凡拷贝
+ */
+template<typename T>
+class SeqLock
+{
+public:
+    SeqLock() : seq_(0), data_{} {}
+
+    /**
+     * @brief 发布新快照，仅允许单个写者调用
+     * @param value 新快照
+     */
+    void write(const T& value)
+    {
+        uint32_t seq = seq_.load(std::memory_order_relaxed);
+
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        data_[0] = value;
+
+        std::atomic_thread_fence(std::memory_order_release);
+        seq_.store(seq + 2, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        data_[1] = value;
+    }
+
+    /**
+     * @brief 读取一致的快照，可在任意任务或中断中调用
+     * @param out 输出快照
+     * @return 本次读取对应的序号
+     */
+    uint32_t read(T& out) const
+    {
+        uint32_t seq;
+        do
+        {
+            seq = seq_.load(std::memory_order_acquire);
+            out = data_[seq & 1u];
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while (seq_.load(std::memory_order_relaxed) != seq);
+        return seq;
+    }
+
+    /**
+     * @brief 获取当前序号，每次发布递增 2
+     */
+    uint32_t sequence() const { return seq_.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<uint32_t> seq_;
+    T data_[2];
+};
+
+} // namespace utils
+
+#endif // __cplusplus
+
+#endif // __UTILS_MEMORY_SEQLOCK_H__
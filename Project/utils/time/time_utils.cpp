@@ -31,6 +31,17 @@ uint64_t TimeUtils_GetGlobalTick(void)
 
 #undef __TIMEUTILS_GET_SYSTICK_VAL
 
+void TimeUtils_EnableCycleCounter(void)
+{
+    if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) != 0)
+    {
+        return; // 已开启，不重复解锁
+    }
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->LAR = 0xC5ACCE55; // Cortex-M7 需先解锁 DWT
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -43,6 +54,10 @@ uint64_t getGlobalTick() {
     return TimeUtils_GetGlobalTick();
 }
 
+void enableCycleCounter() {
+    TimeUtils_EnableCycleCounter();
+}
+
 } // namespace time
 } // namespace utils
 #endif // __cplusplus
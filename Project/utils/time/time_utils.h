@@ -12,6 +12,7 @@ extern "C" {
 #endif
 
 uint64_t TimeUtils_GetGlobalTick(void);
+void TimeUtils_EnableCycleCounter(void);
 
 #ifdef __cplusplus
 } // extern "C"
@@ -24,6 +25,9 @@ namespace time {
 // 获取全局时钟函数
 uint64_t getGlobalTick();
 
+// 开启 DWT 周期计数器，可重复调用
+void enableCycleCounter();
+
 } // namespace time
 } // namespace utils
 #endif // __cplusplus
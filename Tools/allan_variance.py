@@ -0,0 +1,424 @@
+#!/usr/bin/env python3
+"""由静置录制的 BMI088 / SPL06 数据计算 Allan 偏差，提取噪声参数并给出估计器参数建议。
+
+用法:
+    python3 allan_variance.py --imu imu.csv [--baro baro.csv] [-o adev.csv] [--json params.json]
+
+输入为静置 (放在桌面上、电机不转) 数小时的录制，按行逐块读取，内存占用与文件长度无关：
+    imu.csv   每行 t,gx,gy,gz,ax,ay,az
+              t 单位 s，陀螺仪 rad/s (--gyro-dps 时为 deg/s)，加速度计 m/s^2 (--accel-g 时为 g)，
+              与 ImuSample 一致；扩展名为 .bin 时按小端 float32 的 7 列记录读取
+    baro.csv  每行 t,pressure,temperature，气压 Pa，温度 degC；扩展名为 .bin 时为 3 列 float32
+非数字行 (表头、注释) 被跳过。录制须为连续等间隔采样，采样率取时间戳间隔的中位数，
+可用 --imu-rate / --baro-rate 指定。
+
+Allan 偏差为重叠估计：角度 theta 为角速度累加和，
+AVAR(m) = <(theta[k+2m] - 2 theta[k+m] + theta[k])^2> / (2 m^2 tau0^2)。
+簇长 m 按每倍频程若干点对数分布，第 L 级只保存下标为 2^L 倍数的 theta，
+负责 m = j * 2^L (j 在 [BASE, 2*BASE) 内) 的簇，起点间隔 2^L 不超过 m/BASE，与完全重叠几乎等价；
+每级只保留最近 4*BASE 个 theta。第 L 级每 2^L 个样本计算一次，每个样本的总计算量为常数，
+全部 O(log N) 个簇长合计 O(N)，比逐簇长在完整序列上计算的 O(N log N) 更省，且内存与录制长度无关。
+
+噪声参数 (IEEE Std 952 斜率法):
+    N  角度/速度随机游走，-1/2 斜率段在 tau = 1 s 处的值
+    B  零偏不稳定性，Allan 偏差最小值 / 0.664
+    K  角速率/加速度随机游走，+1/2 斜率段在 tau = 3 s 处的值；录制不够长时给出上界
+
+参数建议 (按稳态卡尔曼增益):
+    QuaternionEKF  Q 四元数分量 0.25 N_g^2 dt，零偏分量 K_g^2 dt；R = ((N_a^2 / dt + B_a^2) / g^2)
+    MahonyAHRS     sigma = N_a / g 为加速度计倾角噪声密度，Kp = sqrt(N_g^2/sigma^2 + 2 K_g/sigma)，Ki = K_g/sigma
+    AltitudeEstimator  baro_tau = (r / q)^(1/4)，r 为气压高度白噪声密度平方，q = N_az^2
+静置数据不含飞行振动，--accel-scale 可按振动放大加速度计噪声后再给出建议。
+
+依赖 numpy。
+"""
+
+import argparse
+import itertools
+import json
+import math
+import sys
+
+import numpy as np
+
+GRAVITY = 9.80665
+GAS_CONSTANT = 287.05       # 干空气比气体常数，J/(kg K)
+BIAS_INSTABILITY_FACTOR = 0.664
+
+IMU_CHANNELS = ["gx", "gy", "gz", "ax", "ay", "az"]
+BARO_CHANNELS = ["pressure"]
+
+CHUNK_ROWS = 1 << 18
+BASE = 8                    # 每级负责的 j 范围 [BASE, 2*BASE)
+POINTS_PER_OCTAVE = 8
+MAX_LEVELS = 40
+NUMERIC_START = set("0123456789+-.")
+
+
+def octave_lags(lo, hi):
+    """[lo, hi) 内按每倍频程 POINTS_PER_OCTAVE 点对数分布的整数"""
+    lags = set()
+    k = 0
+    while True:
+        j = int(round(lo * 2.0 ** (k / POINTS_PER_OCTAVE)))
+        if j >= hi:
+            break
+        lags.add(max(j, lo))
+        k += 1
+    return sorted(lags)
+
+
+class StreamingAllan:
+    """多通道流式重叠 Allan 方差"""
+
+    def __init__(self, channels):
+        self.channels = channels
+        self.total = np.zeros(channels)     # 当前 theta (样本累加和)
+        self.count = 0                      # 已输入样本数，即 theta 的下标
+        self.offset = None
+        self.levels = []
+        for level in range(MAX_LEVELS):
+            lags = octave_lags(1, 2 * BASE) if level == 0 else octave_lags(BASE, 2 * BASE)
+            self.levels.append({
+                "lags": lags,
+                "tail": np.zeros((1, channels)),    # theta[0] = 0
+                "sum": np.zeros((len(lags), channels)),
+                "n": np.zeros(len(lags), dtype=np.int64),
+            })
+
+    def push(self, x):
+        """输入一块样本 (行为时间，列为通道)"""
+        if len(x) == 0:
+            return
+        if self.offset is None:
+            self.offset = x.mean(axis=0)    # 扣除常值不影响二阶差分，避免长时间累加损失精度
+        theta = self.total + np.cumsum(x - self.offset, axis=0, dtype=np.float64)
+        first = self.count + 1              # theta 块内第一个值的下标
+        self.count += len(x)
+        self.total = theta[-1].copy()
+
+        for level, state in enumerate(self.levels):
+            stride = 1 << level
+            if stride > self.count:
+                break
+            offset = (-first) % stride      # 块内第一个 stride 倍数下标的位置
+            picked = theta[offset::stride]
+            if len(picked) == 0:
+                continue
+            tail = state["tail"]
+            seq = np.concatenate((tail, picked))
+            start = len(tail)
+            for i, j in enumerate(state["lags"]):
+                lo = max(start, 2 * j)
+                if lo >= len(seq):
+                    continue
+                end = len(seq)
+                d = seq[lo:] + seq[lo - 2 * j:end - 2 * j]
+                mid = seq[lo - j:end - j]
+                np.subtract(d, mid, out=d)
+                np.subtract(d, mid, out=d)
+                state["sum"][i] += np.einsum("ij,ij->j", d, d)
+                state["n"][i] += len(d)
+            state["tail"] = seq[-4 * BASE:]
+
+    def result(self, tau0, max_fraction=0.125):
+        """返回按 tau 排序的 (tau, adev[通道])，只保留簇长不超过样本数 max_fraction 倍的点"""
+        points = {}
+        for level, state in enumerate(self.levels):
+            for i, j in enumerate(state["lags"]):
+                m = j << level
+                n = state["n"][i]
+                if n == 0 or m > self.count * max_fraction or m in points:
+                    continue
+                # theta 为样本累加和，角度为 theta * tau0，分母 2 (m tau0)^2 中的 tau0 与之抵消
+                avar = state["sum"][i] / n / (2.0 * m * m)
+                points[m] = np.sqrt(avar)
+        ms = sorted(points)
+        taus = np.array(ms, dtype=np.float64) * tau0
+        adev = np.array([points[m] for m in ms]) if ms else np.zeros((0, self.channels))
+        return taus, adev
+
+
+def iter_chunks(path, columns):
+    """逐块读取记录，产出 (n, columns) 的 float64 数组"""
+    if path.endswith(".bin"):
+        with open(path, "rb") as f:
+            while True:
+                block = np.fromfile(f, dtype="<f4", count=CHUNK_ROWS * columns)
+                rows = len(block) // columns
+                if rows == 0:
+                    return
+                yield block[:rows * columns].reshape(rows, columns).astype(np.float64)
+        return
+
+    with open(path, "r", errors="replace") as f:
+        while True:
+            lines = list(itertools.islice(f, CHUNK_ROWS))
+            if not lines:
+                return
+            try:
+                data = np.loadtxt(lines, delimiter=",", ndmin=2)
+            except ValueError:
+                # 表头、注释行：去掉后重试，仍失败 (残缺行) 时逐行解析
+                lines = [line for line in lines if line[:1] in NUMERIC_START]
+                try:
+                    data = np.loadtxt(lines, delimiter=",", ndmin=2)
+                except ValueError:
+                    data = parse_lines(lines, columns)
+                if len(data) == 0:
+                    continue
+            if data.shape[1] < columns:
+                raise ValueError("%s: expected at least %d columns, got %d" % (path, columns, data.shape[1]))
+            yield data
+
+
+def parse_lines(lines, columns):
+    """含表头或残缺行时逐行解析，跳过非数字行"""
+    rows = []
+    for line in lines:
+        try:
+            values = [float(v) for v in line.split(",")]
+        except ValueError:
+            continue
+        if len(values) >= columns:
+            rows.append(values[:columns])
+    return np.array(rows, dtype=np.float64).reshape(-1, columns)
+
+
+def analyze(path, columns, channels, rate, convert):
+    """流式读取并计算 Allan 偏差，返回 (tau, adev, 采样率, 样本数, 各列均值)"""
+    allan = StreamingAllan(len(channels))
+    dts = []
+    prev_t = None
+    col_sum = np.zeros(columns)
+    rows = 0
+    for block in iter_chunks(path, columns):
+        block = block[:, :columns]
+        if rate is None and len(dts) < 100000:
+            t = block[:, 0]
+            if prev_t is not None:
+                t = np.concatenate(([prev_t], t))
+            dts.extend(np.diff(t)[:100000 - len(dts)])
+            prev_t = block[-1, 0]
+        col_sum += block.sum(axis=0)
+        rows += len(block)
+        allan.push(convert(block[:, 1:1 + len(channels)]))
+
+    if rows < 4 * BASE:
+        raise ValueError("%s: only %d samples" % (path, rows))
+    if rate is None:
+        dt = float(np.median(dts))
+        if dt <= 0.0:
+            raise ValueError("%s: timestamps are not increasing, use --imu-rate/--baro-rate" % path)
+        rate = 1.0 / dt
+    tau0 = 1.0 / rate
+    taus, adev = allan.result(tau0)
+    return taus, adev, rate, rows, col_sum / rows
+
+
+def local_slopes(taus, adev):
+    """对数坐标下相邻三点的斜率"""
+    lt = np.log(taus)
+    la = np.log(np.maximum(adev, 1e-300))
+    return np.gradient(la, lt)
+
+
+def noise_terms(taus, adev):
+    """由单通道 Allan 偏差曲线提取 (N, B, tau_B, K, K 是否为上界)"""
+    if len(taus) < 3:
+        return None
+    slopes = local_slopes(taus, adev)
+    i_min = int(np.argmin(adev))
+    bias = adev[i_min] / BIAS_INSTABILITY_FACTOR
+
+    lt = np.log(taus)
+    la = np.log(adev)
+
+    arw_sel = np.where((slopes[:i_min + 1] > -0.75) & (slopes[:i_min + 1] < -0.25))[0]
+    if len(arw_sel) == 0:
+        arw_sel = np.array([0])     # 量化噪声占主导时以最短簇长的值作为上界
+    n = math.exp(float(np.mean(la[arw_sel] + 0.5 * lt[arw_sel])))
+
+    rrw_sel = np.where((slopes[i_min + 1:] > 0.25) & (slopes[i_min + 1:] < 0.75))[0] + i_min + 1
+    if len(rrw_sel) > 0:
+        k = math.exp(float(np.mean(la[rrw_sel] - 0.5 * lt[rrw_sel] + 0.5 * math.log(3.0))))
+        k_bound = False
+    else:
+        # 录制未到达 +1/2 段：过最长簇长点的 +1/2 直线给出上界
+        k = adev[-1] * math.sqrt(3.0 / taus[-1])
+        k_bound = True
+    return n, bias, float(taus[i_min]), k, k_bound
+
+
+def recommend(imu_terms, args, baro=None):
+    """由噪声参数给出估计器参数建议"""
+    gyro = [imu_terms[c] for c in IMU_CHANNELS[:3]]
+    accel = [imu_terms[c] for c in IMU_CHANNELS[3:]]
+    dt = 1.0 / args.ekf_rate
+    scale = args.accel_scale
+
+    n_g = sum(t[0] for t in gyro) / 3.0
+    k_g = [t[3] for t in gyro]
+    n_a = [t[0] * scale for t in accel]
+    b_a = [t[1] for t in accel]
+
+    q_quat = 0.25 * n_g * n_g * dt
+    q_bias = [k * k * dt for k in k_g]
+    r = [(n * n / dt + b * b) / (GRAVITY * GRAVITY) for n, b in zip(n_a, b_a)]
+
+    # 倾角只由水平两轴的加速度观测，取 x/y 平均
+    sigma = (n_a[0] + n_a[1]) / 2.0 / GRAVITY
+    k_tilt = (k_g[0] + k_g[1]) / 2.0
+    n_tilt = (gyro[0][0] + gyro[1][0]) / 2.0
+    kp = math.sqrt(n_tilt * n_tilt / (sigma * sigma) + 2.0 * k_tilt / sigma)
+    ki = k_tilt / sigma
+
+    result = {
+        "ekf_rate_hz": args.ekf_rate,
+        "accel_scale": scale,
+        "QuaternionEKF": {
+            "Q_diag": [q_quat] * 4 + q_bias,
+            "R_diag": r,
+        },
+        "MahonyAHRS": {"Kp": kp, "Ki": ki},
+        "bias_upper_bound": any(t[4] for t in gyro),
+    }
+
+    if baro is not None:
+        terms, mean_p, mean_temp = baro
+        # dh/dp = -1/(rho g)，rho = p / (R T)
+        rho = mean_p / (GAS_CONSTANT * (mean_temp + 273.15))
+        meters_per_pa = 1.0 / (rho * GRAVITY)
+        n_h = terms[0] * meters_per_pa
+        q = (n_a[2]) ** 2
+        baro_tau = (n_h * n_h / q) ** 0.25 if q > 0.0 else float("nan")
+        result["AltitudeEstimator"] = {
+            "meters_per_pa": meters_per_pa,
+            "altitude_white_m_sqrt_s": n_h,
+            "altitude_bias_instability_m": terms[1] * meters_per_pa,
+            "baro_tau": baro_tau,
+        }
+    return result
+
+
+def format_report(imu, baro, rec):
+    lines = []
+    taus, adev, rate, rows, terms = imu
+    lines.append("IMU: %d samples at %.1f Hz (%.2f h), tau %.4g .. %.4g s"
+                 % (rows, rate, rows / rate / 3600.0, taus[0], taus[-1]))
+    lines.append("  %-3s %12s %12s %10s %12s" % ("", "N", "B", "tau_B[s]", "K"))
+    units = {"g": ("rad/s/rtHz", "rad/s", "rad/s^2/rtHz"), "a": ("m/s/rtHz", "m/s^2", "m/s^3/rtHz")}
+    for c in IMU_CHANNELS:
+        n, b, tb, k, bound = terms[c]
+        lines.append("  %-3s %12.4e %12.4e %10.1f %s%11.4e" % (c, n, b, tb, "<" if bound else " ", k))
+    lines.append("  units: gyro N %s, B %s, K %s; accel N %s, B %s, K %s"
+                 % (units["g"] + units["a"]))
+    lines.append("  (\"<\": recording too short for the +1/2 slope, K is an upper bound)")
+
+    if baro is not None:
+        btaus, badev, brate, brows, bterms = baro
+        n, b, tb, k, bound = bterms
+        alt = rec["AltitudeEstimator"]
+        lines.append("")
+        lines.append("SPL06: %d samples at %.1f Hz (%.2f h)" % (brows, brate, brows / brate / 3600.0))
+        lines.append("  pressure  N %.4e Pa*rts  B %.4e Pa (tau %.1f s)  K %s%.4e Pa/rts"
+                     % (n, b, tb, "<" if bound else "", k))
+        lines.append("  altitude  N %.4e m*rts   B %.4e m  (%.4f m/Pa)"
+                     % (alt["altitude_white_m_sqrt_s"], alt["altitude_bias_instability_m"], alt["meters_per_pa"]))
+
+    q = rec["QuaternionEKF"]["Q_diag"]
+    r = rec["QuaternionEKF"]["R_diag"]
+    lines.append("")
+    lines.append("// QuaternionEKF, %.0f Hz update, accel noise x%.2f" % (rec["ekf_rate_hz"], rec["accel_scale"]))
+    lines.append("float Q[7][7] = {};")
+    for i, v in enumerate(q):
+        lines.append("Q[%d][%d] = %.3ef;" % (i, i, v))
+    lines.append("float R[3][3] = {};")
+    for i, v in enumerate(r):
+        lines.append("R[%d][%d] = %.3ef;" % (i, i, v))
+    lines.append("ekf.setProcessNoise(Q);")
+    lines.append("ekf.setMeasurementNoise(R);")
+    lines.append("")
+    lines.append("// MahonyAHRS")
+    lines.append("mahony.setKp(%.4ff);" % rec["MahonyAHRS"]["Kp"])
+    lines.append("mahony.setKi(%.4ff);" % rec["MahonyAHRS"]["Ki"])
+    if rec["bias_upper_bound"]:
+        lines.append("// gyro K is an upper bound: bias Q and Ki are conservative (too large)")
+    if "AltitudeEstimator" in rec:
+        lines.append("")
+        lines.append("// AltitudeEstimatorConfig_t")
+        lines.append(".baro_tau = %.2ff," % rec["AltitudeEstimator"]["baro_tau"])
+    return "\n".join(lines)
+
+
+def write_curves(path, curves):
+    """把各通道 Allan 偏差曲线写成 CSV (tau 不同的记录分段写出)"""
+    with open(path, "w") as f:
+        for name, taus, adev, channels in curves:
+            f.write("# %s\n" % name)
+            f.write("tau," + ",".join(channels) + "\n")
+            for t, row in zip(taus, adev):
+                f.write("%.6g," % t + ",".join("%.6e" % v for v in row) + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--imu", required=True, help="static IMU recording: t,gx,gy,gz,ax,ay,az (.csv or float32 .bin)")
+    parser.add_argument("--baro", help="static SPL06 recording: t,pressure,temperature (.csv or float32 .bin)")
+    parser.add_argument("--imu-rate", type=float, help="IMU sample rate in Hz (default: from timestamps)")
+    parser.add_argument("--baro-rate", type=float, help="baro sample rate in Hz (default: from timestamps)")
+    parser.add_argument("--gyro-dps", action="store_true", help="gyro columns are deg/s")
+    parser.add_argument("--accel-g", action="store_true", help="accel columns are g")
+    parser.add_argument("--ekf-rate", type=float, default=500.0, help="estimator update rate in Hz (default: 500)")
+    parser.add_argument("--accel-scale", type=float, default=1.0,
+                        help="multiply accel white noise before tuning, to allow for flight vibration (default: 1)")
+    parser.add_argument("-o", "--output", help="write Allan deviation curves to CSV")
+    parser.add_argument("--json", help="write noise terms and recommendations to JSON")
+    args = parser.parse_args()
+
+    gyro_k = math.pi / 180.0 if args.gyro_dps else 1.0
+    accel_k = GRAVITY if args.accel_g else 1.0
+    imu_convert = lambda x: x * np.array([gyro_k] * 3 + [accel_k] * 3)
+
+    try:
+        taus, adev, rate, rows, _ = analyze(args.imu, 7, IMU_CHANNELS, args.imu_rate, imu_convert)
+        terms = {}
+        for i, c in enumerate(IMU_CHANNELS):
+            t = noise_terms(taus, adev[:, i])
+            if t is None:
+                raise ValueError("%s: recording too short for Allan analysis" % args.imu)
+            terms[c] = t
+        imu = (taus, adev, rate, rows, terms)
+
+        baro = None
+        baro_in = None
+        curves = [("imu", taus, adev, IMU_CHANNELS)]
+        if args.baro:
+            btaus, badev, brate, brows, means = analyze(args.baro, 3, BARO_CHANNELS, args.baro_rate, lambda x: x)
+            bterms = noise_terms(btaus, badev[:, 0])
+            if bterms is None:
+                raise ValueError("%s: recording too short for Allan analysis" % args.baro)
+            baro = (btaus, badev, brate, brows, bterms)
+            baro_in = (bterms, means[1], means[2])
+            curves.append(("baro", btaus, badev, BARO_CHANNELS))
+    except (OSError, ValueError) as e:
+        sys.exit("allan_variance: %s" % e)
+
+    rec = recommend(terms, args, baro_in)
+    print(format_report(imu, baro, rec))
+
+    if args.output:
+        write_curves(args.output, curves)
+    if args.json:
+        out = {
+            "imu": {c: dict(zip(("N", "B", "tau_B", "K", "K_upper_bound"), terms[c])) for c in IMU_CHANNELS},
+            "recommend": rec,
+        }
+        if baro is not None:
+            out["baro"] = dict(zip(("N", "B", "tau_B", "K", "K_upper_bound"), baro[4]))
+        with open(args.json, "w") as f:
+            json.dump(out, f, indent=2)
+
+
+if __name__ == "__main__":
+    main()
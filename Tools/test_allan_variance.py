@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+"""allan_variance.py 的单元测试。
+
+用法:
+    python3 test_allan_variance.py [-v]
+
+用已知参数的合成噪声检查：流式重叠 Allan 方差与直接按定义计算的结果一致且与分块方式无关；
+斜率法从白噪声与角速率随机游走中还原 N 与 K；CSV (含表头) 与 float32 .bin 读取结果一致。
+依赖 numpy。
+"""
+
+import math
+import os
+import sys
+import tempfile
+import unittest
+
+import numpy as np
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import allan_variance as av  # noqa: E402
+
+
+def direct_adev(x, m):
+    """按定义计算的完全重叠 Allan 偏差 (tau0 = 1，theta 为样本累加和)"""
+    theta = np.concatenate(([0.0], np.cumsum(x - x.mean())))
+    d = theta[2 * m:] - 2.0 * theta[m:-m] + theta[:-2 * m]
+    return math.sqrt(np.mean(d * d) / (2.0 * m * m))
+
+
+def white_and_walk(rng, rows, rate, n, k):
+    """白噪声密度 n 与随机游走 k 叠加的单通道序列"""
+    dt = 1.0 / rate
+    white = rng.standard_normal(rows) * n / math.sqrt(dt)
+    walk = np.cumsum(rng.standard_normal(rows) * k * math.sqrt(dt))
+    return white + walk
+
+
+class StreamingAllanTest(unittest.TestCase):
+    def setUp(self):
+        self.rng = np.random.default_rng(1)
+        self.x = self.rng.standard_normal((20000, 2))
+
+    def run_allan(self, chunks):
+        allan = av.StreamingAllan(2)
+        for block in chunks:
+            allan.push(block)
+        return allan.result(1.0)
+
+    def test_matches_definition(self):
+        taus, adev = self.run_allan([self.x])
+        for tau, row in zip(taus, adev):
+            m = int(round(tau))
+            for c in range(2):
+                expected = direct_adev(self.x[:, c], m)
+                if m < 2 * av.BASE:
+                    # 第 0 级逐样本取起点，与定义完全相同
+                    self.assertAlmostEqual(row[c] / expected, 1.0, places=9, msg="m=%d" % m)
+                else:
+                    # 更高级的起点间隔为 2^L，只与完全重叠近似相等
+                    self.assertAlmostEqual(row[c] / expected, 1.0, delta=0.05, msg="m=%d" % m)
+
+    def test_chunking_invariant(self):
+        whole_taus, whole = self.run_allan([self.x])
+        bounds = np.cumsum(self.rng.integers(1, 700, size=200))
+        bounds = bounds[bounds < len(self.x)]
+        taus, split = self.run_allan(np.split(self.x, bounds))
+        np.testing.assert_array_equal(taus, whole_taus)
+        np.testing.assert_allclose(split, whole, rtol=1e-9)
+
+    def test_short_record_limits_tau(self):
+        taus, _ = self.run_allan([self.x[:1000]])
+        self.assertLessEqual(taus[-1], 1000 * 0.125)
+
+
+class NoiseTermsTest(unittest.TestCase):
+    def test_white_noise(self):
+        rng = np.random.default_rng(2)
+        rate, n = 200.0, 0.004
+        x = white_and_walk(rng, 200000, rate, n, 0.0)
+        allan = av.StreamingAllan(1)
+        allan.push(x[:, None])
+        taus, adev = allan.result(1.0 / rate)
+        n_est, _, _, _, bound = av.noise_terms(taus, adev[:, 0])
+        self.assertAlmostEqual(n_est / n, 1.0, delta=0.05)
+        self.assertTrue(bound)  # 没有 +1/2 段，K 只能给出上界
+
+    def test_white_noise_and_rate_random_walk(self):
+        rng = np.random.default_rng(3)
+        rate, n, k = 100.0, 0.01, 1e-3
+        x = white_and_walk(rng, 1 << 20, rate, n, k)
+        allan = av.StreamingAllan(1)
+        for block in np.array_split(x[:, None], 16):
+            allan.push(block)
+        taus, adev = allan.result(1.0 / rate)
+        n_est, b_est, tau_b, k_est, bound = av.noise_terms(taus, adev[:, 0])
+        self.assertAlmostEqual(n_est / n, 1.0, delta=0.05)
+        self.assertFalse(bound)
+        self.assertAlmostEqual(k_est / k, 1.0, delta=0.3)
+        # 两段交点 tau = 3 N / K 附近取得最小值
+        self.assertGreater(tau_b, 3.0)
+        self.assertLess(tau_b, 300.0)
+        self.assertGreater(b_est, 0.0)
+
+
+class ReadTest(unittest.TestCase):
+    def test_csv_and_bin_agree(self):
+        rng = np.random.default_rng(4)
+        rows, rate = 5000, 400.0
+        data = np.empty((rows, 7), dtype=np.float32)
+        data[:, 0] = np.arange(rows) / rate
+        data[:, 1:] = rng.standard_normal((rows, 6)) * 0.01
+        data[:, 6] += 9.8
+
+        with tempfile.TemporaryDirectory() as tmp:
+            csv_path = os.path.join(tmp, "imu.csv")
+            bin_path = os.path.join(tmp, "imu.bin")
+            with open(csv_path, "w") as f:
+                f.write("t,gx,gy,gz,ax,ay,az\n")
+                for i, row in enumerate(data):
+                    if i == rows // 2:
+                        f.write("# comment\n")
+                    f.write(",".join("%.9g" % v for v in row) + "\n")
+            data.astype("<f4").tofile(bin_path)
+
+            convert = lambda x: x
+            c_taus, c_adev, c_rate, c_rows, c_mean = av.analyze(csv_path, 7, av.IMU_CHANNELS, None, convert)
+            b_taus, b_adev, b_rate, b_rows, b_mean = av.analyze(bin_path, 7, av.IMU_CHANNELS, None, convert)
+
+        self.assertEqual(c_rows, rows)
+        self.assertEqual(b_rows, rows)
+        self.assertAlmostEqual(c_rate, rate, delta=0.01)
+        self.assertAlmostEqual(b_rate, rate, delta=0.01)
+        np.testing.assert_allclose(c_taus, b_taus, rtol=1e-5)   # .bin 时间戳为 float32
+        np.testing.assert_allclose(c_adev, b_adev, rtol=1e-6)
+        self.assertAlmostEqual(c_mean[6], 9.8, delta=0.01)
+
+
+if __name__ == "__main__":
+    unittest.main()
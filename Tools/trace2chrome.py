@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""将飞控导出的事件追踪数据 (trace.cpp) 转换为 Chrome trace JSON。
+
+生成的文件可在 chrome://tracing 或 https://ui.perfetto.dev 中打开。
+
+用法:
+    python3 trace2chrome.py dump.bin -o trace.json
+
+dump.bin 为 HC12 串口收到的原始字节，前后可以夹杂其他数据，
+脚本会查找 "TRC1" 头并校验 "TEND" 结束标记。
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+HEADER = struct.Struct("<4sIIIHH")
+EVENT = struct.Struct("<IHBB")
+END_MAGIC = b"TEND"
+
+TYPE_BEGIN, TYPE_END, TYPE_SWITCH, TYPE_INSTANT = range(4)
+
+# 与 trace.h 中的 TraceId_t 保持一致
+EVENT_NAMES = {
+    1: "Scheduler::timerCallback",
+    2: "Chassis::update",
+    3: "AttitudeManager::update",
+    4: "Lidar RX ISR",
+    5: "NRF EXTI ISR",
+    6: "NRF SPI ISR",
+}
+
+# Cortex-M 异常号 (IPSR) 到中断名，异常号 = IRQn + 16
+IRQ_NAMES = {
+    11: "SVCall",
+    14: "PendSV",
+    15: "SysTick",
+    16 + 11: "DMA1_Stream0",
+    16 + 12: "DMA1_Stream1",
+    16 + 13: "DMA1_Stream2",
+    16 + 14: "DMA1_Stream3",
+    16 + 15: "DMA1_Stream4",
+    16 + 16: "DMA1_Stream5",
+    16 + 17: "DMA1_Stream6",
+    16 + 19: "FDCAN1_IT0",
+    16 + 20: "FDCAN2_IT0",
+    16 + 37: "USART1",
+    16 + 39: "USART3",
+    16 + 40: "EXTI15_10",
+    16 + 47: "DMA1_Stream7",
+    16 + 52: "UART4",
+    16 + 54: "TIM6_DAC",
+    16 + 55: "TIM7",
+    16 + 83: "UART8",
+    16 + 84: "SPI4",
+}
+
+CPU_TID = 0
+TASK_TID_BASE = 100
+IRQ_TID_BASE = 1000
+
+
+def event_name(event_id):
+    if event_id in EVENT_NAMES:
+        return EVENT_NAMES[event_id]
+    if event_id >= 0x100:
+        return "user_%d" % (event_id - 0x100)
+    return "event_%d" % event_id
+
+
+def parse(data):
+    start = data.find(b"TRC1")
+    if start < 0:
+        raise ValueError("no TRC1 header found")
+    magic, clock_hz, count, first_index, task_count, name_len = HEADER.unpack_from(data, start)
+    pos = start + HEADER.size
+
+    tasks = []
+    for _ in range(task_count):
+        raw = data[pos:pos + name_len]
+        tasks.append(raw.split(b"\0", 1)[0].decode("ascii", "replace"))
+        pos += name_len
+
+    need = count * EVENT.size + len(END_MAGIC)
+    if len(data) - pos < need:
+        raise ValueError("truncated dump: expected %d event bytes, got %d" % (need, len(data) - pos))
+    events = [EVENT.unpack_from(data, pos + i * EVENT.size) for i in range(count)]
+    pos += count * EVENT.size
+    if data[pos:pos + len(END_MAGIC)] != END_MAGIC:
+        raise ValueError("missing TEND marker")
+    return clock_hz, tasks, events
+
+
+def unwrap(events):
+    """按记录顺序展开 32 位周期计数，允许抢占造成的少量乱序"""
+    if not events:
+        return []
+    result = []
+    base = 0
+    prev = events[0][0]
+    for cycles, event_id, etype, irq in events:
+        delta = (cycles - prev) & 0xFFFFFFFF
+        if delta >= 0x80000000:
+            delta -= 0x100000000
+        base += delta
+        prev = cycles
+        result.append((base, event_id, etype, irq))
+    origin = min(e[0] for e in result)
+    return sorted(((t - origin, i, ty, q) for t, i, ty, q in result), key=lambda e: e[0])
+
+
+def convert(clock_hz, tasks, events):
+    us = 1e6 / clock_hz
+    out = []
+
+    def meta(tid, name):
+        out.append({"ph": "M", "name": "thread_name", "pid": 0, "tid": tid, "args": {"name": name}})
+
+    meta(CPU_TID, "CPU")
+    for index, name in enumerate(tasks):
+        meta(TASK_TID_BASE + index, name)
+    irqs = set()
+
+    current = None  # (task index, start time)
+    for t, event_id, etype, irq in unwrap(events):
+        ts = t * us
+        if etype == TYPE_SWITCH:
+            if current is not None:
+                out.append({"ph": "X", "name": task_label(tasks, current[0]), "pid": 0, "tid": CPU_TID,
+                            "ts": current[1], "dur": ts - current[1]})
+            current = (event_id, ts)
+            continue
+
+        if irq:
+            tid = IRQ_TID_BASE + irq
+            irqs.add(irq)
+        elif current is not None:
+            tid = TASK_TID_BASE + current[0]
+        else:
+            tid = CPU_TID
+
+        if etype == TYPE_BEGIN:
+            out.append({"ph": "B", "name": event_name(event_id), "pid": 0, "tid": tid, "ts": ts})
+        elif etype == TYPE_END:
+            out.append({"ph": "E", "name": event_name(event_id), "pid": 0, "tid": tid, "ts": ts})
+        elif etype == TYPE_INSTANT:
+            out.append({"ph": "i", "s": "t", "name": event_name(event_id), "pid": 0, "tid": tid, "ts": ts})
+
+    for irq in sorted(irqs):
+        meta(IRQ_TID_BASE + irq, "IRQ " + IRQ_NAMES.get(irq, str(irq)))
+    return {"traceEvents": out, "displayTimeUnit": "ns"}
+
+
+def task_label(tasks, index):
+    if index < len(tasks):
+        return tasks[index]
+    return "task_%d" % index
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("dump", help="raw dump captured from the HC12 link")
+    parser.add_argument("-o", "--output", help="output JSON file (default: stdout)")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as f:
+        data = f.read()
+    try:
+        clock_hz, tasks, events = parse(data)
+    except ValueError as e:
+        sys.exit("trace2chrome: %s" % e)
+
+    result = convert(clock_hz, tasks, events)
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(result, f)
+    else:
+        json.dump(result, sys.stdout)
+    print("%d events, %d tasks, %.1f MHz" % (len(events), len(tasks), clock_hz / 1e6), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()